@@ -0,0 +1,81 @@
+#ifndef _evb_ActivityFlag_h_
+#define _evb_ActivityFlag_h_
+
+#include <stdint.h>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+
+namespace evb {
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Flag telling if a work loop is active
+   *
+   * The work loop sets the flag while it is processing. Other threads
+   * can wait until the work loop has finished instead of polling the flag.
+   */
+  class ActivityFlag
+  {
+  public:
+
+    explicit ActivityFlag(const bool active = false) :
+      active_(active), changes_(0) {}
+
+    ActivityFlag& operator=(const bool active)
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      if ( active_ != active )
+      {
+        active_ = active;
+        ++changes_;
+        changed_.notify_all();
+      }
+      return *this;
+    }
+
+    operator bool() const
+    { return active_; }
+
+    /**
+     * Wait until the flag is cleared
+     */
+    void waitUntilIdle() const
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      while ( active_ ) changed_.wait(sl);
+    }
+
+    /**
+     * Wait until the flag is set or cleared the next time,
+     * but at most for the given time in microseconds
+     */
+    void waitForChange(const uint32_t timeoutUS) const
+    {
+      boost::mutex::scoped_lock sl(mutex_);
+      const uint64_t changes = changes_;
+      const boost::system_time timeout = boost::get_system_time() + boost::posix_time::microseconds(timeoutUS);
+      while ( changes == changes_ && changed_.timed_wait(sl,timeout) ) {};
+    }
+
+  private:
+
+    volatile bool active_;
+    uint64_t changes_;
+    mutable boost::mutex mutex_;
+    mutable boost::condition_variable changed_;
+  };
+
+} // namespace evb
+
+#endif // _evb_ActivityFlag_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -48,6 +48,12 @@ namespace evb {
      */
     uint32_t crc32c(uint32_t crc, const unsigned char *buf, size_t len) const;
 
+    /**
+     * Return the CRC32-C of two consecutive buffers from
+     * their individual CRCs and the length of the second buffer
+     */
+    uint32_t crc32cCombine(uint32_t crc1, uint32_t crc2, size_t len2) const;
+
 
   private:
 
@@ -85,6 +91,7 @@ namespace evb {
 
 extern uint32_t crc32c_sw(uint32_t crc, const unsigned char *buf, size_t len);
 extern uint32_t crc32c_hw(uint32_t crc, const unsigned char *buf, size_t len);
+extern uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2);
 
 #endif // _evb_CRCCalculator_h_
 
@@ -5,6 +5,8 @@
 #include <boost/thread/mutex.hpp>
 
 #include <stdint.h>
+#include <sys/uio.h>
+#include <vector>
 
 #include "cgicc/HTMLClasses.h"
 #include "evb/EvBApplication.h"
@@ -83,7 +85,9 @@ namespace evb {
       void startWorkLoops();
       bool generating(toolbox::task::WorkLoop*);
       void updateCounters(toolbox::mem::Reference*);
-      void sendData(toolbox::mem::Reference*);
+      void sendFrames();
+      void releaseFrames();
+      void waitForBandwidth(const uint64_t bytes);
       void getPerformance(PerformanceMonitor&);
 
       int sockfd_;
@@ -96,6 +100,10 @@ namespace evb {
 
       dummyFEROL::FragmentGenerator fragmentGenerator_;
       uint32_t lastResync_;
+      typedef std::vector<toolbox::mem::Reference*> Frames;
+      Frames frames_;
+      std::vector<struct iovec> iovecs_;
+      uint64_t nextSendTime_;
 
       PerformanceMonitor dataMonitoring_;
       mutable boost::mutex dataMonitoringMutex_;
@@ -0,0 +1,143 @@
+#ifndef _evb_Dumper_h_
+#define _evb_Dumper_h_
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include <deque>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+namespace evb {
+
+  /**
+   * \ingroup xdaqApps
+   * \brief The content of a binary dump of an event or a FED fragment
+   */
+  struct Dump
+  {
+    uint32_t runNumber;
+    uint32_t eventNumber;
+    uint32_t fedId;
+    uint32_t badChunk;
+    std::string description;
+    std::vector<uint32_t> chunkSizes;
+    std::vector<unsigned char> data;
+
+    static const uint32_t noFedId = 0xffffffff;
+    static const uint32_t noBadChunk = 0xffffffff;
+
+    Dump(const uint32_t runNumber, const uint32_t eventNumber, const uint32_t fedId = noFedId);
+
+    /**
+     * Append a copy of the given data as new chunk
+     */
+    void addChunk(const void* location, const uint32_t size);
+  };
+
+  typedef boost::shared_ptr<Dump> DumpPtr;
+
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Write binary dumps of events and FED fragments on a dedicated thread.
+   *
+   * The dumps are written as dump_runRRRRRR_eventEEEEEEEE[_fedFFFF].dump files,
+   * which are rendered as text by scripts/renderDump.py. The file starts with
+   * a header of 10 native 32-bit words: the magic 'EvBdump\0', the format version,
+   * the header size in bytes, the run and event number, the FED id or 0xffffffff
+   * for complete events, the index of the bad chunk or 0xffffffff, the number of
+   * chunks and the size of the description. The description, the size of each
+   * chunk as 32-bit word and the chunk data follow.
+   */
+  class Dumper
+  {
+  public:
+
+    Dumper(const std::string& dumpDir = "/tmp");
+
+    ~Dumper();
+
+    /**
+     * Set the maximum number of dumps waiting to be written
+     * and the maximum rate of dumps accepted
+     */
+    void configure(const uint32_t fifoCapacity, const uint32_t maxDumpsPerSecond);
+
+    /**
+     * Return true if a dump will be accepted. Forced dumps are only limited by the
+     * capacity of the queue. Otherwise, at most maxDumpsPerSecond are accepted,
+     * with bursts of up to maxDumpsPerSecond dumps. A rejected dump is counted as dropped.
+     */
+    bool accept(const bool force = false);
+
+    /**
+     * Queue the dump to be written. Any dump previously accepted is queued.
+     */
+    void write(const DumpPtr&);
+
+    /**
+     * Wait until all queued dumps have been written
+     */
+    void drain();
+
+    /**
+     * Return the number of dumps written
+     */
+    uint32_t getNbDumpsWritten() const
+    { return nbDumpsWritten_; }
+
+    /**
+     * Return the number of dumps dropped because of the rate limit or a full queue
+     */
+    uint32_t getNbDumpsDropped() const
+    { return nbDumpsDropped_; }
+
+    /**
+     * Return the name of the file for the given dump
+     */
+    std::string getFileName(const Dump&) const;
+
+    /**
+     * Write the given dump to a file. Returns false if the file cannot be written
+     */
+    bool writeFile(const Dump&) const;
+
+  private:
+
+    void writeDumps();
+    uint64_t now() const;
+
+    const std::string dumpDir_;
+    uint32_t fifoCapacity_;
+    uint32_t maxDumpsPerSecond_;
+
+    std::deque<DumpPtr> dumps_;
+    bool writing_;
+    bool stop_;
+    boost::mutex mutex_;
+    boost::condition_variable dumpQueued_;
+    boost::condition_variable dumpsWritten_;
+    boost::thread dumperThread_;
+
+    double tokens_;
+    uint64_t timeOfLastToken_; // us
+    volatile uint32_t nbDumpsWritten_;
+    volatile uint32_t nbDumpsDropped_;
+  };
+
+  typedef boost::shared_ptr<Dumper> DumperPtr;
+
+} // namespace evb
+
+#endif // _evb_Dumper_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
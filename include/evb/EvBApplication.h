@@ -5,13 +5,17 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/regex.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 
 #include <map>
+#include <sstream>
 #include <string>
 #include <time.h>
 
 #include "cgicc/HTMLClasses.h"
+#include "evb/Dumper.h"
 #include "evb/Exception.h"
+#include "evb/HugePageAllocator.h"
 #include "evb/InfoSpaceItems.h"
 #include "evb/EvBStateMachine.h"
 #include "evb/version.h"
@@ -40,6 +44,7 @@
 #include "xgi/framework/Method.h"
 #include "xgi/framework/UIManager.h"
 #include "xgi/Input.h"
+#include "xgi/Method.h"
 #include "xgi/Output.h"
 #include "xoap/MessageFactory.h"
 #include "xoap/MessageReference.h"
@@ -78,6 +83,7 @@ namespace evb {
     const std::string& getSubSystem() const { return subSystem_; }
     boost::shared_ptr<Configuration> getConfiguration() const { return configuration_; }
     boost::shared_ptr<StateMachine> getStateMachine() const { return stateMachine_; }
+    DumperPtr getDumper() const { return dumper_; }
     toolbox::mem::Pool* getMsgPool() const;
 
     uint32_t postMessage
@@ -89,6 +95,16 @@ namespace evb {
     typedef boost::function<cgicc::div()> QueueContentFunction;
     void registerQueueCallback(const std::string name, QueueContentFunction);
 
+    /**
+     * Register the functions returning the number of elements and the size
+     * of the given queue. They are exported on the metrics page until the
+     * queue unregisters itself.
+     */
+    typedef boost::function<uint32_t()> QueueFillLevelFunction;
+    void registerQueueFillLevel(const std::string name, const void* queue,
+                                QueueFillLevelFunction elements, QueueFillLevelFunction size);
+    void unregisterQueueFillLevel(const std::string name, const void* queue);
+
   protected:
 
     void initialize();
@@ -116,6 +132,7 @@ namespace evb {
     xdata::InfoSpace *monitoringInfoSpace_;
 
     const boost::shared_ptr<Configuration> configuration_;
+    const DumperPtr dumper_;
     boost::shared_ptr<StateMachine> stateMachine_;
     xdaq2rc::SOAPParameterExtractor soapParameterExtractor_;
 
@@ -148,11 +165,28 @@ namespace evb {
 
     void defaultWebPage(xgi::Input*, xgi::Output*) throw (xgi::exception::Exception);
     void queueWebPage(xgi::Input*, xgi::Output*) throw (xgi::exception::Exception);
+    void metricsPage(xgi::Input*, xgi::Output*) throw (xgi::exception::Exception);
+    void updateMetricsSnapshot();
+    std::string getMetricsLabels() const;
     std::string getCurrentTimeUTC() const;
 
     typedef std::map<std::string,QueueContentFunction> QueueContents;
     QueueContents queueContents_;
 
+    struct QueueFillLevel
+    {
+      const void* queue;
+      QueueFillLevelFunction elements;
+      QueueFillLevelFunction size;
+    };
+    typedef std::map<std::string,QueueFillLevel> QueueFillLevels;
+    QueueFillLevels queueFillLevels_;
+    boost::mutex queueFillLevelsMutex_;
+
+    InfoSpaceItems monitoringItems_;
+    boost::shared_ptr<const std::string> metricsSnapshot_;
+    boost::mutex metricsSnapshotMutex_;
+
     toolbox::task::WorkLoop* monitoringWorkLoop_;
 
   }; // template class EvBApplication
@@ -173,6 +207,7 @@ evb::EvBApplication<Configuration,StateMachine>::EvBApplication
   xdaq::Application(stub),
   xgi::framework::UIManager(this),
   configuration_(new Configuration()),
+  dumper_(new Dumper()),
   soapParameterExtractor_(this),
   subSystem_("unknown subsystem"),
   urn_(getApplicationDescriptor()->getURN()),
@@ -287,15 +322,13 @@ void evb::EvBApplication<Configuration,StateMachine>::initMonitoringInfoSpace()
 {
   try
   {
-    InfoSpaceItems monitoringParams;
-
-    appendMonitoringInfoSpaceItems(monitoringParams);
+    appendMonitoringInfoSpaceItems(monitoringItems_);
 
     // Create info space for monitoring
     toolbox::net::URN urn = createQualifiedInfoSpace(xmlClass_);
     monitoringInfoSpace_ = xdata::getInfoSpaceFactory()->get(urn.toString());
 
-    monitoringParams.putIntoInfoSpace(monitoringInfoSpace_, this);
+    monitoringItems_.putIntoInfoSpace(monitoringInfoSpace_, this);
   }
   catch(xcept::Exception& e)
   {
@@ -530,6 +563,7 @@ bool evb::EvBApplication<Configuration,StateMachine>::updateMonitoringInfo
     monitoringInfoSpace_->lock();
 
     do_updateMonitoringInfo();
+    updateMetricsSnapshot();
 
     monitoringInfoSpace_->unlock();
   }
@@ -583,6 +617,10 @@ void evb::EvBApplication<Configuration,StateMachine>::bindXgiCallbacks()
                                &evb::EvBApplication<Configuration,StateMachine>::defaultWebPage,
                                "Default");
 
+  xgi::bind(this,
+            &evb::EvBApplication<Configuration,StateMachine>::metricsPage,
+            "metrics");
+
   bindNonDefaultXgiCallbacks();
 }
 
@@ -654,6 +692,100 @@ throw (xgi::exception::Exception)
 }
 
 
+template<class Configuration,class StateMachine>
+void evb::EvBApplication<Configuration,StateMachine>::registerQueueFillLevel
+(
+  const std::string name,
+  const void* queue,
+  QueueFillLevelFunction elements,
+  QueueFillLevelFunction size
+)
+{
+  QueueFillLevel fillLevel;
+  fillLevel.queue = queue;
+  fillLevel.elements = elements;
+  fillLevel.size = size;
+
+  boost::mutex::scoped_lock sl(queueFillLevelsMutex_);
+  queueFillLevels_[name] = fillLevel;
+}
+
+
+template<class Configuration,class StateMachine>
+void evb::EvBApplication<Configuration,StateMachine>::unregisterQueueFillLevel
+(
+  const std::string name,
+  const void* queue
+)
+{
+  boost::mutex::scoped_lock sl(queueFillLevelsMutex_);
+
+  // a new queue with the same name might have replaced this one already
+  const typename QueueFillLevels::iterator pos = queueFillLevels_.find(name);
+  if ( pos != queueFillLevels_.end() && pos->second.queue == queue )
+    queueFillLevels_.erase(pos);
+}
+
+
+template<class Configuration,class StateMachine>
+std::string evb::EvBApplication<Configuration,StateMachine>::getMetricsLabels() const
+{
+  std::ostringstream labels;
+  labels << "class=\"" << xmlClass_ << "\",instance=\"" << instance_.value_ << "\"";
+  return labels.str();
+}
+
+
+template<class Configuration,class StateMachine>
+void evb::EvBApplication<Configuration,StateMachine>::updateMetricsSnapshot()
+{
+  // called by the monitoring workloop while the monitoring info space is locked
+  std::ostringstream metrics;
+  monitoringItems_.writePrometheusMetrics(metrics, "evb_", getMetricsLabels());
+  const boost::shared_ptr<const std::string> snapshot( new std::string(metrics.str()) );
+
+  boost::mutex::scoped_lock sl(metricsSnapshotMutex_);
+  metricsSnapshot_ = snapshot;
+}
+
+
+template<class Configuration,class StateMachine>
+void evb::EvBApplication<Configuration,StateMachine>::metricsPage
+(
+  xgi::Input  *in,
+  xgi::Output *out
+)
+throw (xgi::exception::Exception)
+{
+  out->getHTTPResponseHeader().addHeader("Content-Type", "text/plain; version=0.0.4");
+
+  // the monitoring items are served from the last snapshot taken by the monitoring workloop.
+  // The queue fill levels are read directly, which does not lock the queues.
+  boost::shared_ptr<const std::string> snapshot;
+  {
+    boost::mutex::scoped_lock sl(metricsSnapshotMutex_);
+    snapshot = metricsSnapshot_;
+  }
+  if ( snapshot.get() )
+    *out << *snapshot;
+
+  const std::string labels = getMetricsLabels();
+  std::ostringstream elements;
+  std::ostringstream size;
+  {
+    boost::mutex::scoped_lock sl(queueFillLevelsMutex_);
+    for (typename QueueFillLevels::const_iterator it = queueFillLevels_.begin(), itEnd = queueFillLevels_.end();
+         it != itEnd; ++it)
+    {
+      elements << "evb_queueElements{" << labels << ",queue=\"" << it->first << "\"} " << it->second.elements() << "\n";
+      size << "evb_queueSize{" << labels << ",queue=\"" << it->first << "\"} " << it->second.size() << "\n";
+    }
+  }
+  *out << "# TYPE evb_queueElements gauge\n" << elements.str();
+  *out << "# TYPE evb_queueSize gauge\n" << size.str();
+}
+
+
 template<class Configuration,class StateMachine>
 cgicc::div evb::EvBApplication<Configuration,StateMachine>::getWebPageHeader() const
 {
@@ -750,6 +882,21 @@ xoap::MessageReference evb::EvBApplication<Configuration,StateMachine>::createFs
 template<class Configuration,class StateMachine>
 toolbox::mem::Pool* evb::EvBApplication<Configuration,StateMachine>::getMsgPool() const
 {
+  if ( configuration_->hugePageSize.value_ > 0 )
+  {
+    try
+    {
+      return getHugePagePool(configuration_->sendPoolName.value_+"_hugepages",
+                             configuration_->hugePageSize.value_*1024ULL,
+                             configuration_->msgPoolSize.value_,
+                             configuration_->numaNode.value_);
+    }
+    catch(toolbox::mem::exception::Exception& e)
+    {
+      XCEPT_RETHROW(exception::OutOfMemory, "Failed to create hugepage-backed I2O message memory pool", e);
+    }
+  }
+
   toolbox::mem::Pool* pool = 0;
   toolbox::net::URN urn("toolbox-mem-pool", configuration_->sendPoolName);
 
@@ -7,17 +7,22 @@
 #include <boost/statechart/state.hpp>
 #include <boost/statechart/state_machine.hpp>
 #include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
 #include "evb/Exception.h"
 #include "evb/InfoSpaceItems.h"
+#include "evb/TimeStamp.h"
 #include "log4cplus/logger.h"
 #include "log4cplus/loggingmacros.h"
 #include "xcept/tools.h"
 #include "xdaq/Application.h"
 #include "xdaq2rc/RcmsStateNotifier.h"
 #include "xdata/String.h"
+#include "xdata/UnsignedInteger32.h"
+#include "xdata/Vector.h"
 
+#include <map>
 #include <string>
 
 
@@ -77,6 +82,12 @@ namespace evb {
     void appendMonitoringItems(InfoSpaceItems&);
     void updateMonitoringItems();
 
+    /**
+     * Record the time in ms the component took for the transition since the
+     * monotonic startTime. Returns the current time to time the next step.
+     */
+    uint64_t recordTransitionTime(const std::string& transition, const std::string& component, const uint64_t startTime);
+
     void notifyRCMS(const std::string& stateName);
     void failEvent(const Fail&);
     void unconsumed_event(const boost::statechart::event_base&);
@@ -108,9 +119,15 @@ namespace evb {
     xdata::UnsignedInteger32 runNumber_;
     std::string stateName_;
 
+    typedef std::map<std::string,uint32_t> TransitionTimes;
+    TransitionTimes transitionTimes_;
+    boost::mutex transitionTimesMutex_;
+
     xdata::UnsignedInteger32 monitoringRunNumber_;
     xdata::String monitoringStateName_;
     xdata::String monitoringErrorMsg_;
+    xdata::Vector<xdata::String> monitoringTransitionSteps_;
+    xdata::Vector<xdata::UnsignedInteger32> monitoringTransitionTimes_;
   };
 
 
@@ -323,10 +340,14 @@ void evb::EvBStateMachine<MostDerived,InitialState>::appendMonitoringItems
   monitoringRunNumber_ = 0;
   monitoringStateName_ = "Halted";
   monitoringErrorMsg_ = "";
+  monitoringTransitionSteps_.clear();
+  monitoringTransitionTimes_.clear();
 
   items.add("runNumber", &monitoringRunNumber_);
   items.add("stateName", &monitoringStateName_);
   items.add("errorMsg", &monitoringErrorMsg_);
+  items.add("transitionSteps", &monitoringTransitionSteps_);
+  items.add("transitionTimes", &monitoringTransitionTimes_);
 }
 
 
@@ -337,6 +358,34 @@ void evb::EvBStateMachine<MostDerived,InitialState>::updateMonitoringItems()
   monitoringStateName_ = stateName_;
   monitoringRunNumber_ = runNumber_;
   monitoringErrorMsg_ = reasonForError_;
+
+  boost::mutex::scoped_lock sl(transitionTimesMutex_);
+  monitoringTransitionSteps_.clear();
+  monitoringTransitionTimes_.clear();
+  for (TransitionTimes::const_iterator it = transitionTimes_.begin(), itEnd = transitionTimes_.end();
+       it != itEnd; ++it)
+  {
+    monitoringTransitionSteps_.push_back(it->first);
+    monitoringTransitionTimes_.push_back(it->second);
+  }
+}
+
+
+template <class MostDerived,class InitialState>
+uint64_t evb::EvBStateMachine<MostDerived,InitialState>::recordTransitionTime
+(
+  const std::string& transition,
+  const std::string& component,
+  const uint64_t startTime
+)
+{
+  const uint64_t now = getMonotonicTimeStamp();
+  const uint32_t duration = (now - startTime) / 1000000;
+
+  boost::mutex::scoped_lock sl(transitionTimesMutex_);
+  transitionTimes_[transition+"/"+component] = duration;
+
+  return now;
 }
 
 
@@ -10,6 +10,7 @@
 #include "evb/CRCCalculator.h"
 #include "evb/EvBid.h"
 #include "evb/FragmentSize.h"
+#include "evb/TriggerPacer.h"
 
 
 namespace evb {
@@ -37,9 +38,16 @@ namespace evb {
     void startRun();
 
     /**
-    */
+     * Set the maximum trigger rate in Hz. 0 means no limitation
+     */
     void setMaxTriggerRate(const uint32_t rate)
-    { maxTriggerRate_ = rate; }
+    { triggerPacer_.setRate(rate); }
+
+    /**
+     * Configure the pattern, rules and dead time of the emulated triggers
+     */
+    void configureTriggers(const std::string& pattern, const std::string& rules, const uint32_t deadTime)
+    { triggerPacer_.configure(pattern,rules,deadTime); }
 
     /**
      * Starts a new FED fragment with the specified event number.
@@ -47,6 +55,12 @@ namespace evb {
      */
     uint32_t startFragment(const EvBid&);
 
+    /**
+     * Wait until the next trigger is available
+     * according to the trigger pacing
+     */
+    void waitForNextTrigger();
+
     /**
      * Fill the FED data into the payload using at most
      * nbBytesAvailable Bytes. It returns the number of
@@ -61,8 +75,6 @@ namespace evb {
 
   private:
 
-    void waitForNextTrigger();
-
     CRCCalculator crcCalculator_;
     boost::scoped_ptr<FragmentSize> fragmentSize_;
 
@@ -77,14 +89,14 @@ namespace evb {
     const uint32_t fedSize_;
     const uint32_t minFedSize_;
     const uint32_t maxFedSize_;
-    uint32_t maxTriggerRate_;
     const bool computeCRC_;
     uint16_t fedCRC_;
     FedComponent typeOfNextComponent_;
     uint32_t currentFedSize_;
     uint32_t remainingFedSize_;
     EvBid evbId_;
-    uint64_t lastTime_;
+    TriggerPacer triggerPacer_;
+    uint64_t triggerNumber_;
     uint32_t availableTriggers_;
   };
 
@@ -0,0 +1,110 @@
+#ifndef _evb_HugePageAllocator_h_
+#define _evb_HugePageAllocator_h_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#include "cgicc/HTMLClasses.h"
+#include "toolbox/mem/Allocator.h"
+#include "toolbox/mem/Buffer.h"
+#include "toolbox/mem/MemoryPartition.h"
+#include "toolbox/mem/Pool.h"
+#include "toolbox/mem/exception/FailedAllocation.h"
+#include "toolbox/mem/exception/FailedCreation.h"
+#include "toolbox/mem/exception/FailedDispose.h"
+
+
+namespace evb {
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Allocator for a committed memory pool backed by hugepages
+   *
+   * The memory is mapped with 2 MB or 1 GB hugepages, bound to the
+   * given NUMA node, and pre-faulted when the allocator is created.
+   * The hugepages have to be reserved beforehand, e.g. in
+   * /sys/kernel/mm/hugepages/hugepages-2048kB/nr_hugepages.
+   */
+  class HugePageAllocator : public toolbox::mem::Allocator
+  {
+  public:
+
+    /**
+     * Map committedSize Bytes rounded up to the hugePageSize.
+     * If numaNode is negative, the default memory policy is used.
+     */
+    HugePageAllocator(const size_t committedSize, const size_t hugePageSize, const int32_t numaNode)
+    throw (toolbox::mem::exception::FailedCreation);
+
+    ~HugePageAllocator();
+
+    toolbox::mem::Buffer* alloc(size_t size, toolbox::mem::Pool*)
+    throw (toolbox::mem::exception::FailedAllocation);
+
+    void free(toolbox::mem::Buffer*)
+    throw (toolbox::mem::exception::FailedDispose);
+
+    std::string type()
+    { return "hugepage"; }
+
+    bool isCommittedSizeSupported()
+    { return true; }
+
+    size_t getCommittedSize()
+    { return committedSize_; }
+
+    size_t getUsed();
+
+    size_t getHugePageSize() const
+    { return hugePageSize_; }
+
+    int32_t getNumaNode() const
+    { return numaNode_; }
+
+    /**
+     * Return the number of page faults taken when pre-faulting the memory
+     */
+    uint64_t getPrefaultPageFaults() const
+    { return prefaultPageFaults_; }
+
+  private:
+
+    const size_t hugePageSize_;
+    const int32_t numaNode_;
+    size_t committedSize_;
+    void* memory_;
+    uint64_t prefaultPageFaults_;
+    toolbox::mem::MemoryPartition memPartition_;
+  };
+
+
+  /**
+   * Find or create the memory pool with the given name backed by poolSize Bytes
+   * of hugepages on the numaNode. An existing pool with different settings
+   * is destroyed and recreated.
+   */
+  toolbox::mem::Pool* getHugePagePool
+  (
+    const std::string& poolName,
+    const size_t hugePageSize,
+    const size_t poolSize,
+    const int32_t numaNode
+  );
+
+  /**
+   * Add the occupancy of the pool and the page faults of the process to the table
+   */
+  void addMemoryPoolRows(cgicc::table&, toolbox::mem::Pool*, const std::string& poolName);
+
+} // namespace evb
+
+#endif // _evb_HugePageAllocator_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -2,6 +2,8 @@
 #define _evb_I2OMessages_h_
 
 #include <iostream>
+#include <stddef.h>
+#include <stdexcept>
 #include <stdint.h>
 #include <vector>
 
@@ -17,6 +19,51 @@ namespace evb {
     typedef std::vector<I2O_TID> RUtids;
     typedef std::vector<uint16_t> FedIds;
 
+    /**
+     * Version of the layout of the data-block messages and the super-fragment headers.
+     * It must be incremented whenever the layout changes. RUs and BUs must be built
+     * with the same version.
+     */
+    const uint32_t dataBlockVersion = 2;
+
+
+    /**
+     * Read-only view of consecutive ids, e.g. in an I2O message, which does not
+     * copy them. The view is only valid as long as the underlying memory is.
+     */
+    template<typename T>
+    class ArrayView
+    {
+    public:
+
+      typedef const T* const_iterator;
+
+      ArrayView() : begin_(0), size_(0) {}
+      ArrayView(const T* begin, const size_t size) : begin_(begin), size_(size) {}
+      ArrayView(const std::vector<T>& ids) : begin_(ids.empty() ? 0 : &ids[0]), size_(ids.size()) {}
+
+      const_iterator begin() const { return begin_; }
+      const_iterator end() const { return begin_ + size_; }
+      size_t size() const { return size_; }
+      bool empty() const { return ( size_ == 0 ); }
+      const T& operator[](const size_t i) const { return begin_[i]; }
+
+      const T& at(const size_t i) const
+      {
+        if ( i >= size_ ) throw std::out_of_range("evb::msg::ArrayView::at");
+        return begin_[i];
+      }
+
+    private:
+
+      const T* begin_;
+      size_t size_;
+    };
+
+    typedef ArrayView<EvBid> EvBidsView;
+    typedef ArrayView<I2O_TID> RUtidsView;
+
+
     /**
      * Event request for one or more events identified by the event-builder ids to be sent
      * to the BU TID specified. The EVM ignores the evbIds and sends the next nbRequests
@@ -36,8 +83,12 @@ namespace evb {
       EvBid evbIds[];                            // EvBids
       I2O_TID ruTids[];                          // List of RU TIDs participating in the event building
 
-      void getEvBids(EvBids&) const;
-      void getRUtids(RUtids&) const;
+      /**
+       * Return views of the ids in the request. An exception is raised
+       * if they do not fit into the msgSize.
+       */
+      EvBidsView getEvBids() const;
+      RUtidsView getRUtids() const;
     };
 
 
@@ -62,6 +113,8 @@ namespace evb {
       uint16_t superFragmentNb;                  // Index of the super fragment
       uint32_t totalSize;                        // Total size of the super fragment
       uint32_t partSize;                         // Partial size of the super-fragment contained in this message
+      uint32_t crc32c;                           // CRC32c of the partial super-fragment if hasCRC32c is set
+      uint16_t hasCRC32c;                        // Set if the RU calculated the crc32c
       uint16_t nbDroppedFeds;                    // Number of FEDs dropped from the super fragment
       uint16_t fedIds[];                         // List of dropped FED ids
 
@@ -80,14 +133,19 @@ namespace evb {
       uint16_t buResourceId;                     // Index of BU resource used to built the event
       uint32_t nbBlocks;                         // Total number of I2O blocks
       uint32_t blockNb;                          // Index of the this block
+      uint32_t version;                          // Layout version of the message (dataBlockVersion)
       uint64_t timeStampNS;                      // time stamp in ns set by the BU when sending request
       uint16_t nbSuperFragments;                 // Total number of super fragments
       uint16_t nbRUtids;                         // Number of RU TIDs
       EvBid evbIds[];                            // The EvBids of the super fragments
       I2O_TID ruTids[];                          // List of RU TIDs participating in the event building
 
-      void getEvBids(EvBids&) const;
-      void getRUtids(RUtids&) const;
+      /**
+       * Return views of the ids in the first block. An exception is raised
+       * if they do not fit into the headerSize.
+       */
+      EvBidsView getEvBids() const;
+      RUtidsView getRUtids() const;
 
     };
 
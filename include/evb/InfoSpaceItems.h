@@ -4,6 +4,7 @@
 #include "xdata/InfoSpace.h"
 #include "xdata/Serializable.h"
 
+#include <ostream>
 #include <utility>
 #include <vector>
 #include <string>
@@ -43,6 +44,13 @@ namespace evb {
      */
     void putIntoInfoSpace(xdata::InfoSpace*, xdata::ActionListener*) const;
 
+    /**
+     * Write the numerical items in the Prometheus text exposition format.
+     * The metric names are the item names with the given prefix, and the
+     * labels are added to each sample. Vectors get an additional index label.
+     */
+    void writePrometheusMetrics(std::ostream&, const std::string& prefix, const std::string& labels) const;
+
   private:
 
     typedef std::vector< std::pair<std::string, std::pair<xdata::Serializable*,Listeners> > > Items;
@@ -0,0 +1,144 @@
+#ifndef _evb_LumiSectionCounters_h_
+#define _evb_LumiSectionCounters_h_
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <stdint.h>
+#include <vector>
+
+
+namespace evb {
+
+  /**
+   * \ingroup xdaqApps
+   * \brief A fixed-size ring of event counters per lumi section
+   *
+   * The counters of lumi section ls are held in the slot ls % window.
+   * Each slot has one counter per thread, thus any number of threads can
+   * count events concurrently without locking as long as each thread uses
+   * its own counter. Only one thread may open lumi sections. Readers get a
+   * consistent count or 0 if the lumi section is not (or no longer) held
+   * in the ring.
+   *
+   * Lumi sections can be closed by a single thread. An event counted with
+   * incrementIfNotClosed is either seen by the thread closing its lumi
+   * section, or the counting thread learns that it came too late.
+   */
+  class LumiSectionCounters
+  {
+  public:
+
+    LumiSectionCounters(const uint32_t window = 1024, const uint16_t nbThreads = 1);
+
+    /**
+     * Resize the ring and forget all lumi sections.
+     * This method is not thread safe.
+     */
+    void resize(const uint32_t window, const uint16_t nbThreads);
+
+    /**
+     * Forget all lumi sections.
+     * This method is not thread safe.
+     */
+    void clear();
+
+    /**
+     * Open the lumi section by resetting the counters of its slot.
+     * Any lumi section previously held in the slot is dropped,
+     * i.e. its events must no longer be counted.
+     */
+    void open(const uint32_t lumiSection);
+
+    /**
+     * Return true if the lumi section is held in the ring
+     */
+    bool isOpen(const uint32_t lumiSection) const
+    { return ( slots_[lumiSection % window_].lumiSection == lumiSection ); }
+
+    /**
+     * Count an event for the open lumi section using the counter of the given thread
+     */
+    void increment(const uint32_t lumiSection, const uint16_t thread = 0)
+    { ++counters_[thread*window_ + lumiSection % window_].count; }
+
+    /**
+     * Count an event unless the lumi section has been closed. If the lumi
+     * section is being closed concurrently, wait until the closing thread
+     * is done. Return false if the lumi section has been closed without
+     * the event.
+     */
+    bool incrementIfNotClosed(const uint32_t lumiSection, const uint16_t thread = 0);
+
+    /**
+     * Close the lumi section and all earlier ones if nbEvents have been
+     * counted for it and no event is being counted for it concurrently.
+     * Return true if the lumi section has been closed.
+     */
+    bool closeIfCountIs(const uint32_t lumiSection, const uint32_t nbEvents);
+
+    /**
+     * Close the lumi section and all earlier ones regardless of the events counted
+     */
+    void close(const uint32_t lumiSection)
+    { oldestOpen_ = lumiSection + 1; }
+
+    /**
+     * Return the oldest lumi section which has not been closed
+     */
+    uint32_t getOldestOpen() const
+    { return oldestOpen_; }
+
+    /**
+     * Return the number of events counted by all threads for the lumi section,
+     * or 0 if the lumi section is not held in the ring
+     */
+    uint32_t getCount(const uint32_t lumiSection) const;
+
+    /**
+     * Return the number of lumi sections held in the ring
+     */
+    uint32_t getWindow() const
+    { return window_; }
+
+    static const uint32_t noLumiSection = 0xffffffff;
+
+  private:
+
+    bool isIncrementing(const uint32_t lumiSection) const;
+
+    struct Slot
+    {
+      volatile uint32_t lumiSection;
+    };
+    typedef std::vector<Slot> Slots;
+
+    struct Counter
+    {
+      volatile uint32_t count;
+    };
+    typedef std::vector<Counter> Counters;
+
+    uint32_t window_;
+    uint16_t nbThreads_;
+    Slots slots_;
+    Counters counters_; // the counters of one thread are contiguous
+    Slots incrementing_; // the lumi section each thread is counting an event for
+
+    volatile uint32_t oldestOpen_;
+    volatile uint32_t closing_;
+    boost::mutex closingMutex_;
+    boost::condition_variable closingDone_;
+  };
+
+} // namespace evb
+
+#endif // _evb_LumiSectionCounters_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
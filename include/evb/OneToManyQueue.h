@@ -0,0 +1,275 @@
+#ifndef _evb_OneToManyQueue_h_
+#define _evb_OneToManyQueue_h_
+
+#include <stdint.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "cgicc/HTMLClasses.h"
+#include "evb/Exception.h"
+
+
+namespace evb {
+
+  /**
+   * \ingroup xdaqApps
+   * \brief A lock-free queue which is threadsafe if there is
+   * only one producer. Any number of consumers can dequeue
+   * concurrently. The elements are handed out in the order
+   * they have been enqueued.
+   */
+
+  template <class T>
+  class OneToManyQueue
+  {
+  public:
+
+    template <class C>
+    OneToManyQueue(C* evbApplication, const std::string& name);
+
+    ~OneToManyQueue();
+
+    /**
+     * Enqueue the element.
+     * Return false if the element cannot be enqueued.
+     */
+    bool enq(const T&);
+
+    /**
+     * Enqueue the element.
+     * If the queue is full wait until it becomes non-full
+     * or until the condition becomes false.
+     */
+    void enqWait(const T&, volatile bool& condition);
+
+    /**
+     * Dequeue the oldest element.
+     * Return false if no element can be dequeued.
+     */
+    bool deq(T&);
+
+    /**
+     * Return the number of elements in the queue.
+     */
+    uint32_t elements() const;
+
+    /**
+     * Return the queue size
+     */
+    uint32_t size() const;
+
+    /**
+     * Returns true if the queue is empty.
+     */
+    bool empty() const;
+
+    /**
+     * Resizes the queue. The size is rounded up to the next power of 2.
+     * Throws an exception if queue is not empty.
+     */
+    void resize(const uint32_t size);
+
+    /**
+     * Remove all elements from the queue
+     */
+    void clear();
+
+    /**
+     * Return a cgicc snipped representing the queue
+     */
+    cgicc::div getHtmlSnipped() const;
+
+
+  private:
+
+    // The sequence of a slot tells who may access it next:
+    // the producer of element n waits for the sequence n,
+    // the consumer of element n waits for the sequence n+1.
+    struct Slot
+    {
+      volatile uint32_t sequence;
+      T element;
+    };
+    typedef std::vector<Slot> Slots;
+
+    const std::string name_;
+    volatile uint32_t readPointer_;
+    volatile uint32_t writePointer_;
+    Slots slots_;
+    // the pointers are running counters, thus the size must divide 2^32
+    uint32_t mask_;
+    boost::function<void()> unregisterFillLevel_;
+  };
+
+
+  //------------------------------------------------------------------
+  // Implementation follows
+  //------------------------------------------------------------------
+
+  template <class T>
+  template <class C>
+  OneToManyQueue<T>::OneToManyQueue(C* evbApplication,const std::string& name) :
+    name_(name),
+    readPointer_(0),
+    writePointer_(0),
+    mask_(0)
+  {
+    resize(1);
+    evbApplication->registerQueueFillLevel(name,this,
+                                           boost::bind(&OneToManyQueue<T>::elements,this),
+                                           boost::bind(&OneToManyQueue<T>::size,this));
+    unregisterFillLevel_ = boost::bind(&C::unregisterQueueFillLevel,evbApplication,name,this);
+  }
+
+
+  template <class T>
+  OneToManyQueue<T>::~OneToManyQueue()
+  {
+    unregisterFillLevel_();
+  }
+
+
+  template <class T>
+  inline uint32_t OneToManyQueue<T>::elements() const
+  {
+    volatile const uint32_t cachedReadPointer = readPointer_;
+    volatile const uint32_t cachedWritePointer = writePointer_;
+    // the pointers are running counters, thus the difference is correct even if they wrapped
+    return cachedWritePointer - cachedReadPointer;
+  }
+
+
+  template <class T>
+  inline uint32_t OneToManyQueue<T>::size() const
+  {
+    return slots_.size();
+  }
+
+
+  template <class T>
+  bool OneToManyQueue<T>::empty() const
+  { return (readPointer_ == writePointer_); }
+
+
+  template <class T>
+  void OneToManyQueue<T>::resize(const uint32_t size)
+  {
+    if ( !empty() )
+    {
+      XCEPT_RAISE(exception::FIFO,
+                  "Cannot resize the non-empty queue " + name_);
+    }
+
+    uint32_t roundedSize = 1;
+    while ( roundedSize < size ) roundedSize <<= 1;
+
+    slots_.clear();
+    slots_.resize(roundedSize);
+    for (uint32_t i = 0; i < roundedSize; ++i)
+      slots_[i].sequence = i;
+    mask_ = roundedSize - 1;
+    readPointer_ = writePointer_ = 0;
+  }
+
+
+  template <class T>
+  bool OneToManyQueue<T>::enq(const T& element)
+  {
+    const uint32_t pos = writePointer_;
+    Slot& slot = slots_[pos & mask_];
+    if ( slot.sequence != pos ) return false;
+
+    slot.element = element;
+    writePointer_ = pos + 1;
+    __sync_synchronize();
+    slot.sequence = pos + 1;
+    return true;
+  }
+
+
+  template <class T>
+  void OneToManyQueue<T>::enqWait(const T& element, volatile bool& condition)
+  {
+    while ( !enq(element) && condition ) ::usleep(10);
+  }
+
+
+  template <class T>
+  bool OneToManyQueue<T>::deq(T& element)
+  {
+    while (1)
+    {
+      const uint32_t pos = readPointer_;
+      Slot& slot = slots_[pos & mask_];
+      const int32_t diff = static_cast<int32_t>(slot.sequence - (pos + 1));
+
+      if ( diff < 0 ) return false; // the element has not been enqueued yet
+
+      // reserve the element unless another consumer was quicker
+      if ( diff == 0 && __sync_bool_compare_and_swap(&readPointer_, pos, pos + 1) )
+      {
+        element = slot.element;
+        slot.element = T();
+        __sync_synchronize();
+        slot.sequence = pos + slots_.size();
+        return true;
+      }
+    }
+  }
+
+
+  template <class T>
+  void OneToManyQueue<T>::clear()
+  {
+    T element;
+    while ( deq(element) ) {};
+  }
+
+
+  template <class T>
+  cgicc::div OneToManyQueue<T>::getHtmlSnipped() const
+  {
+    // cache values which might change during the printout
+    const uint32_t cachedSize = size();
+    const uint32_t cachedElements = elements();
+    const double fillFraction = cachedSize > 0 ? 100. * cachedElements / cachedSize : 0;
+    const uint16_t fullWidth = static_cast<uint8_t>(fillFraction + 0.5);
+    const uint16_t emptyWidth = static_cast<uint8_t>((100-fillFraction) + 0.5);
+
+    using namespace cgicc;
+
+    table queueTable;
+    queueTable.add(colgroup()
+                   .add(col().set("style","width:"+boost::lexical_cast<std::string>(fullWidth)+"%"))
+                   .add(col().set("style","width:"+boost::lexical_cast<std::string>(emptyWidth)+"%")));
+    queueTable.add(tr()
+                   .add(th(name_).set("colspan","2")));
+    queueTable.add(tr()
+                   .add(td(" ").set("class","xdaq-evb-queue-full"))
+                   .add(td(" ").set("class","xdaq-evb-queue-empty")));
+    queueTable.add(tr()
+                   .add(td(boost::lexical_cast<std::string>(cachedElements)+" / "+boost::lexical_cast<std::string>(cachedSize))
+                        .set("colspan","2")));
+
+    cgicc::div div;
+    div.set("class","xdaq-evb-queue");
+    div.add(queueTable);
+
+    return div;
+  }
+
+} // namespace evb
+
+#endif // _evb_OneToManyQueue_h_
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -3,9 +3,11 @@
 
 #include <stdexcept>
 #include <stdint.h>
+#include <string.h>
 #include <vector>
 
 #include <boost/bind.hpp>
+#include <boost/function.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/type_traits/is_pointer.hpp>
@@ -96,7 +98,8 @@ namespace evb {
     bool full() const;
 
     /**
-     * Resizes the queue.
+     * Resizes the queue and pre-faults its memory.
+     * The memory is reused if the size does not change.
      * Throws an exception if queue is not empty.
      */
     void resize(const uint32_t size);
@@ -141,6 +144,7 @@ namespace evb {
     T* container_;
     volatile uint32_t size_;
     mutable volatile bool printingElements_;
+    boost::function<void()> unregisterFillLevel_;
   };
 
 
@@ -187,12 +191,17 @@ namespace evb {
   {
     evbApplication->registerQueueCallback(name,
                                           boost::bind(&OneToOneQueue<T>::getHtmlSnippedVertical,this));
+    evbApplication->registerQueueFillLevel(name,this,
+                                           boost::bind(&OneToOneQueue<T>::elements,this),
+                                           boost::bind(&OneToOneQueue<T>::size,this));
+    unregisterFillLevel_ = boost::bind(&C::unregisterQueueFillLevel,evbApplication,name,this);
   }
 
 
   template <class T>
   OneToOneQueue<T>::~OneToOneQueue()
   {
+    unregisterFillLevel_();
     clear();
   }
 
@@ -240,6 +249,13 @@ namespace evb {
                   "Cannot resize the non-empty queue " + name_);
     }
 
+    if ( container_ && size_ == size+1 )
+    {
+      // keep the already allocated and pre-faulted memory
+      readPointer_ = writePointer_ = 0;
+      return;
+    }
+
     toolbox::net::URN urn(name_, "alloc");
     toolbox::PolicyFactory* factory = toolbox::getPolicyFactory();
     toolbox::AllocPolicy* policy = static_cast<toolbox::AllocPolicy*>(factory->getPolicy(urn, "alloc"));
@@ -260,6 +276,9 @@ namespace evb {
       msg << "Failed to allocate memory for " << size << " elements in queue " << name_;
       XCEPT_RETHROW (exception::FIFO, msg.str(), e);
     }
+
+    // touch the memory now to avoid page faults when the queue fills up for the first time
+    memset(static_cast<void*>(container_), 0, sizeof(T) * size_);
   }
 
 
@@ -2,6 +2,7 @@
 #define _evb_PerformaceMonitor_h_
 
 #include "evb/Constants.h"
+#include "evb/TimeStamp.h"
 
 #include <math.h>
 #include <stdint.h>
@@ -26,7 +27,7 @@ namespace evb {
 
     double deltaT() const
     {
-      const uint64_t now = getTimeStamp();
+      const uint64_t now = getMonotonicTimeStamp();
       return (now>startTime ? (now-startTime)/1e9 : 0);
     }
 
@@ -89,7 +90,7 @@ namespace evb {
       retryCount = 0;
       sumOfSizes = 0;
       sumOfSquares = 0;
-      startTime = getTimeStamp();
+      startTime = getMonotonicTimeStamp();
     }
 
     PerformanceMonitor& operator=(const PerformanceMonitor& other)
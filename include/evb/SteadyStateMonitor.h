@@ -0,0 +1,70 @@
+#ifndef _evb_SteadyStateMonitor_h_
+#define _evb_SteadyStateMonitor_h_
+
+#include <stdint.h>
+#include <vector>
+
+
+namespace evb {
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Measure the time it takes to reach the steady-state rate after enabling
+   *
+   * The events are counted in bins of 10 ms during the observation time
+   * after the start. The mean rate during the second half of the observation
+   * time is taken as steady-state rate. The time to steady state is the start
+   * of the first window reaching 90% of this rate. The class is not thread safe,
+   * i.e. the caller has to protect it with the lock of its monitoring counters.
+   */
+  class SteadyStateMonitor
+  {
+  public:
+
+    SteadyStateMonitor(const uint32_t observationTimeMS = 10000);
+
+    /**
+     * Start a new observation, e.g. when enabling
+     */
+    void start();
+
+    /**
+     * Account the given number of events
+     */
+    void eventsDone(const uint32_t count)
+    {
+      if ( observing_ ) countEvents(count);
+    }
+
+    /**
+     * Return the time in ms from the start until the steady-state
+     * rate was reached, or -1 if it is not known (yet)
+     */
+    int32_t getTimeToSteadyState();
+
+  private:
+
+    void countEvents(const uint32_t count);
+    void analyse();
+
+    static const uint32_t binWidthMS = 10;
+    static const uint32_t minEventsPerWindow = 100;
+
+    const uint32_t nbBins_;
+    std::vector<uint32_t> counts_;
+    uint64_t startTime_;
+    bool observing_;
+    int32_t timeToSteadyState_;
+  };
+
+} // namespace evb
+
+#endif // _evb_SteadyStateMonitor_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
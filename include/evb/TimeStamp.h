@@ -0,0 +1,102 @@
+#ifndef _evb_TimeStamp_h_
+#define _evb_TimeStamp_h_
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+namespace evb {
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Monotonic clock for measuring time intervals within a node
+   *
+   * On CPUs with an invariant time-stamp counter, the time is derived from the
+   * TSC once it has been calibrated against CLOCK_MONOTONIC_RAW by calibrate().
+   * Otherwise, or before the calibration is done, CLOCK_MONOTONIC_RAW is read.
+   * The time does not jump when the wall clock is adjusted, but it has an
+   * arbitrary origin. Thus, it must not be sent to other nodes. Use
+   * evb::getTimeStamp() for time stamps compared between nodes.
+   */
+  class MonotonicClock
+  {
+  public:
+
+    /**
+     * Return the time in ns since an arbitrary origin
+     */
+    static uint64_t now()
+    {
+      #if defined(__x86_64__) || defined(__i386__)
+      if ( useTSC_ )
+      {
+        // the TSC read on another core might be slightly behind the calibration
+        const uint64_t tsc = __rdtsc();
+        const uint64_t ticks = tsc > tscAtCalibration_ ? tsc - tscAtCalibration_ : 0;
+        return timeAtCalibration_ + static_cast<uint64_t>((static_cast<unsigned __int128>(ticks) * nsPerTick_) >> nsPerTickShift);
+      }
+      #endif
+      return getRawTime();
+    }
+
+    /**
+     * Calibrate the time-stamp counter. The first call takes about 20 ms,
+     * any later call returns immediately. It is safe to call it concurrently.
+     */
+    static void calibrate();
+
+    /**
+     * Return true if the time is derived from the time-stamp counter
+     */
+    static bool usesTSC()
+    { return useTSC_; }
+
+    /**
+     * Return the calibrated frequency of the time-stamp counter in GHz, or 0 if the TSC is not used
+     */
+    static double getTSCfrequency();
+
+    /**
+     * Read CLOCK_MONOTONIC_RAW in ns
+     */
+    static uint64_t getRawTime()
+    {
+      struct timespec ts;
+      clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+      return (ts.tv_sec*1000000000ULL + ts.tv_nsec);
+    }
+
+  private:
+
+    static void doCalibrate();
+
+    static const uint32_t nsPerTickShift = 32;
+
+    static bool useTSC_;
+    static uint64_t tscAtCalibration_;
+    static uint64_t timeAtCalibration_;
+    static uint64_t nsPerTick_; // fixed point with nsPerTickShift fractional bits
+  };
+
+
+  /**
+   * Return a monotonic time stamp in ns for measuring intervals within a node
+   */
+  inline uint64_t getMonotonicTimeStamp()
+  { return MonotonicClock::now(); }
+
+} // namespace evb
+
+#endif // _evb_TimeStamp_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,118 @@
+#ifndef _evb_TriggerPacer_h_
+#define _evb_TriggerPacer_h_
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+
+namespace evb {
+
+  /**
+   * \ingroup xdaqApps
+   * \brief Generate the arrival times of emulated triggers
+   *
+   * The pacer generates a schedule of trigger times following a constant,
+   * Poisson, or LHC bunch-train pattern at the given mean rate. Triggers
+   * violating the trigger rules or falling into the dead time of the
+   * previous trigger are vetoed. All streams sharing a pacer ask for the
+   * same sequence of triggers and are thus driven in lockstep. A stream
+   * waiting for a trigger sleeps until the trigger is due, and then
+   * gets all triggers due at once.
+   */
+  class TriggerPacer
+  {
+  public:
+
+    TriggerPacer();
+
+    /**
+     * Configure the trigger pattern ("constant", "poisson" or "bunchTrain"),
+     * the trigger rules as comma-separated list of "N/W", i.e. at most N triggers
+     * in any window of W bunch crossings, and the dead time in ns after each trigger.
+     */
+    void configure(const std::string& pattern, const std::string& rules, const uint32_t deadTime);
+
+    /**
+     * Set the mean trigger rate in Hz. 0 means no limitation
+     */
+    void setRate(const uint32_t rate);
+
+    /**
+     * Start a new schedule with the first trigger being number 0
+     */
+    void start();
+
+    /**
+     * Stop pacing the triggers and wake up any waiting stream
+     */
+    void stop();
+
+    /**
+     * Wait until the trigger with the given sequence number is due.
+     * Return the number of consecutive triggers starting at this
+     * number which are due, at least 1.
+     */
+    uint32_t waitForTrigger(const uint64_t triggerNumber);
+
+    /**
+     * Return the number of triggers vetoed by the trigger rules or the dead time
+     */
+    uint64_t getNbVetoedTriggers() const;
+
+  private:
+
+    enum Pattern { CONSTANT, POISSON, BUNCH_TRAIN };
+
+    void rebase(const uint64_t now);
+    uint64_t getTriggerTime(const uint64_t triggerNumber);
+    void scheduleNextTrigger();
+    uint64_t getNextCandidate();
+    bool isVetoed(const uint64_t candidate) const;
+    double getUniform();
+
+    static const uint32_t scheduleSize = 4096;       // must be a power of 2
+    static const uint32_t maxTriggersPerCall = 256;
+    static const uint32_t bunchCrossingsPerOrbit = 3564;
+
+    Pattern pattern_;
+    uint32_t rate_;
+    uint64_t deadTime_;
+    typedef std::vector< std::pair<uint32_t,uint64_t> > Rules; // number of triggers, window in ns
+    Rules rules_;
+    std::vector<uint16_t> filledBunches_;
+
+    std::vector<uint64_t> schedule_;
+    uint64_t firstRetained_;
+    uint64_t nextTrigger_;
+    uint64_t highestRequested_;
+    uint64_t baseTime_;
+    double offset_;
+    uint64_t filledBunchCount_;
+    bool stopped_;
+    uint64_t nbVetoedTriggers_;
+
+    boost::mt19937 rng_;
+    mutable boost::mutex mutex_;
+    boost::condition_variable scheduleChanged_;
+  };
+
+  typedef boost::shared_ptr<TriggerPacer> TriggerPacerPtr;
+
+} // namespace evb
+
+#endif // _evb_TriggerPacer_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,82 @@
+#ifndef _evb_bu_CompressedFrame_h_
+#define _evb_bu_CompressedFrame_h_
+
+#include <boost/shared_ptr.hpp>
+
+#include <stdint.h>
+#include <vector>
+
+#include "evb/bu/Compression.h"
+#include "evb/bu/Event.h"
+
+
+namespace evb {
+  namespace bu {
+
+    /**
+     * \ingroup xdaqApps
+     * \brief A number of events compressed into an independently decodable frame
+     */
+
+    class CompressedFrame
+    {
+    public:
+
+      CompressedFrame();
+
+      /**
+       * Add the event to the frame. The event is kept until the frame is compressed.
+       */
+      void addEvent(const EventPtr&);
+
+      /**
+       * Compress the events using the given codec and release them.
+       * The scratch buffer is used to gather the event data.
+       */
+      void compress(compression::Codec&, std::vector<unsigned char>& scratch);
+
+      /**
+       * Return true once the frame has been compressed
+       */
+      bool isDone() const { return done_; }
+
+      /**
+       * Return the frame header followed by the compressed data
+       */
+      const unsigned char* data() const { return &buffer_[0]; }
+      size_t size() const { return buffer_.size(); }
+
+      uint32_t nbEvents() const { return nbEvents_; }
+      uint32_t firstEventNumber() const { return firstEventNumber_; }
+      uint64_t uncompressedSize() const { return uncompressedSize_; }
+      uint64_t compressionTime() const { return compressionTime_; }
+      uint64_t creationTime() const { return creationTime_; }
+
+    private:
+
+      typedef std::vector<EventPtr> Events;
+      Events events_;
+      std::vector<unsigned char> buffer_;
+
+      const uint64_t creationTime_;
+      uint32_t nbEvents_;
+      uint32_t firstEventNumber_;
+      uint64_t uncompressedSize_;
+      uint64_t compressionTime_;
+      volatile bool done_;
+
+    }; // CompressedFrame
+
+    typedef boost::shared_ptr<CompressedFrame> CompressedFramePtr;
+
+  } } // namespace evb::bu
+
+#endif // _evb_bu_CompressedFrame_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
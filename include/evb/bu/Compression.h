@@ -0,0 +1,157 @@
+#ifndef _evb_bu_Compression_h_
+#define _evb_bu_Compression_h_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+
+namespace evb {
+  namespace bu {
+    namespace compression { // namespace evb::bu::compression
+
+      /**
+       * Layout of a compressed raw-data file:
+       *
+       * FrameHeader | compressed events | FrameHeader | compressed events | ...
+       * IndexEntry for each frame | FileTrailer
+       *
+       * Each frame holds the EventInfo and data of a number of events.
+       * The frames can be decompressed independently of each other.
+       */
+
+      enum Algorithm
+      {
+        NONE = 0,
+        LZ4  = 1,
+        ZSTD = 2
+      };
+
+      /**
+       * Return the algorithm for the given name (none, lz4, or zstd).
+       * Raise an exception::Configuration if the name is unknown.
+       */
+      Algorithm getAlgorithm(const std::string& name);
+
+      /**
+       * Return the name of the algorithm
+       */
+      std::string getName(const Algorithm);
+
+      const uint32_t frameMagic = 0x5a427645;   // "EvBZ"
+      const uint32_t trailerMagic = 0x49427645; // "EvBI"
+
+      struct FrameHeader
+      {
+        uint32_t magic;
+        uint32_t algorithm;
+        uint32_t nbEvents;
+        uint32_t firstEventNumber;
+        uint32_t uncompressedSize;
+        uint32_t compressedSize;         // Size of the payload following the header
+      };
+
+      struct IndexEntry
+      {
+        uint64_t offset;                 // Offset of the FrameHeader in the file
+        uint32_t firstEventNumber;
+        uint32_t nbEvents;
+        uint32_t uncompressedSize;
+        uint32_t compressedSize;
+      };
+
+      struct FileTrailer
+      {
+        uint64_t indexOffset;
+        uint32_t nbFrames;
+        uint32_t magic;
+      };
+
+
+      /**
+       * \ingroup xdaqApps
+       * \brief Compress and decompress memory blocks with LZ4 or Zstd.
+       * A codec keeps its own state and must not be shared between threads.
+       */
+      class Codec
+      {
+      public:
+
+        Codec(const Algorithm, const int32_t level);
+
+        ~Codec();
+
+        /**
+         * Return the maximum compressed size of the given number of bytes
+         */
+        size_t compressBound(const size_t size) const;
+
+        /**
+         * Compress the source into the destination buffer.
+         * Return the compressed size.
+         */
+        size_t compress(const void* src, const size_t srcSize, void* dst, const size_t dstCapacity);
+
+        /**
+         * Decompress the source into the destination buffer which
+         * must hold exactly the uncompressed size
+         */
+        void decompress(const void* src, const size_t srcSize, void* dst, const size_t dstSize);
+
+        Algorithm getAlgorithm() const { return algorithm_; }
+
+      private:
+
+        const Algorithm algorithm_;
+        const int32_t level_;
+        void* compressionContext_;
+        void* decompressionContext_;
+
+      }; // Codec
+
+
+      /**
+       * \ingroup xdaqApps
+       * \brief Read back a compressed raw-data file using the frame index
+       */
+      class FileReader
+      {
+      public:
+
+        FileReader(const std::string& fileName);
+
+        ~FileReader();
+
+        uint32_t getNbFrames() const { return index_.size(); }
+        const IndexEntry& getIndexEntry(const uint32_t frame) const { return index_.at(frame); }
+
+        /**
+         * Decompress the given frame into the buffer.
+         * Return the frame header.
+         */
+        FrameHeader readFrame(const uint32_t frame, std::vector<unsigned char>& buffer);
+
+      private:
+
+        void readIndex();
+        void read(void* buffer, const size_t size, const uint64_t offset);
+
+        const std::string fileName_;
+        FILE* file_;
+        std::vector<IndexEntry> index_;
+        std::vector<unsigned char> compressedData_;
+
+      }; // FileReader
+
+    } } } // namespace evb::bu::compression
+
+#endif // _evb_bu_Compression_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,166 @@
+#ifndef _evb_bu_Compressor_h_
+#define _evb_bu_Compressor_h_
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <stdint.h>
+#include <vector>
+
+#include "cgicc/HTMLClasses.h"
+#include "evb/InfoSpaceItems.h"
+#include "evb/OneToOneQueue.h"
+#include "evb/bu/CompressedFrame.h"
+#include "evb/bu/Compression.h"
+#include "evb/bu/Configuration.h"
+#include "toolbox/lang/Class.h"
+#include "toolbox/task/Action.h"
+#include "toolbox/task/WaitingWorkLoop.h"
+#include "xdata/Double.h"
+
+
+namespace evb {
+
+  class BU;
+
+  namespace bu {
+
+    class StateMachine;
+
+    /**
+     * \ingroup xdaqApps
+     * \brief Compress frames of events on a pool of worker threads
+     */
+
+    class Compressor : public toolbox::lang::Class
+    {
+    public:
+
+      Compressor(BU*);
+
+      ~Compressor();
+
+      /**
+       * Queue the frame for compression. The caller has to wait
+       * until the frame is done before writing it.
+       */
+      void compress(const CompressedFramePtr&);
+
+      /**
+       * Wait until the frame has been compressed
+       */
+      void waitUntilDone(const CompressedFramePtr&) const;
+
+      /**
+       * Return true if the output shall be compressed
+       */
+      bool isEnabled() const
+      { return algorithm_ != compression::NONE; }
+
+      /**
+       * Return the compression algorithm used
+       */
+      compression::Algorithm getAlgorithm() const
+      { return algorithm_; }
+
+      /**
+       * Configure
+       */
+      void configure();
+
+      /**
+       * Start processing messages
+       */
+      void startProcessing();
+
+      /**
+       * Stop processing messages
+       */
+      void stopProcessing();
+
+      /**
+       * Register the state machine
+       */
+      void registerStateMachine(boost::shared_ptr<StateMachine> stateMachine)
+      { stateMachine_ = stateMachine; }
+
+      /**
+       * Append the info space items to be published in the
+       * monitoring info space to the InfoSpaceItems
+       */
+      void appendMonitoringItems(InfoSpaceItems&);
+
+      /**
+       * Update all values of the items put into the monitoring
+       * info space. The caller has to make sure that the info
+       * space where the items reside is locked and properly unlocked
+       * after the call.
+       */
+      void updateMonitoringItems();
+
+      /**
+       * Return monitoring information as cgicc snipped
+       */
+      cgicc::div getHtmlSnipped() const;
+
+    private:
+
+      void resetMonitoringCounters();
+      void createProcessingWorkLoops();
+      bool process(toolbox::task::WorkLoop*);
+
+      BU* bu_;
+      boost::shared_ptr<StateMachine> stateMachine_;
+      const ConfigurationPtr configuration_;
+      compression::Algorithm algorithm_;
+
+      typedef OneToOneQueue<CompressedFramePtr> FrameFIFO;
+      typedef boost::shared_ptr<FrameFIFO> FrameFIFOPtr;
+      typedef std::vector<FrameFIFOPtr> FrameFIFOs;
+      FrameFIFOs frameFIFOs_;
+      uint32_t nextFIFO_;
+      boost::mutex frameFIFOsMutex_;
+      boost::mutex frameQueuedMutex_;
+      boost::condition_variable frameQueued_;
+      mutable boost::mutex frameDoneMutex_;
+      mutable boost::condition_variable frameDone_;
+
+      typedef std::vector<toolbox::task::WorkLoop*> WorkLoops;
+      WorkLoops workerWorkLoops_;
+      toolbox::task::ActionSignature* workerAction_;
+
+      volatile bool doProcessing_;
+      boost::dynamic_bitset<> processesActive_;
+      mutable boost::mutex processesActiveMutex_;
+      boost::condition_variable processesIdle_;
+
+      struct CompressionMonitoring
+      {
+        uint64_t nbFrames;
+        uint64_t nbEvents;
+        uint64_t uncompressedBytes;
+        uint64_t compressedBytes;
+        uint64_t compressionTime;
+      } compressionMonitoring_;
+      mutable boost::mutex compressionMonitoringMutex_;
+
+      xdata::Double compressionRatio_;
+      xdata::Double compressionThroughput_;
+
+    }; // Compressor
+
+    typedef boost::shared_ptr<Compressor> CompressorPtr;
+
+  } } // namespace evb::bu
+
+#endif // _evb_bu_Compressor_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -12,6 +12,7 @@
 #include "xdata/String.h"
 #include "xdata/Integer32.h"
 #include "xdata/UnsignedInteger32.h"
+#include "xdata/UnsignedInteger64.h"
 #include "xdata/Vector.h"
 
 
@@ -26,6 +27,9 @@ namespace evb {
     struct Configuration
     {
       xdata::String sendPoolName;                          // The pool name used for evb messages
+      xdata::UnsignedInteger32 hugePageSize;               // Size in kB of the hugepages backing the message pool (2048 or 1048576). 0 uses the heap
+      xdata::UnsignedInteger64 msgPoolSize;                // Size in Bytes of the message pool when backed by hugepages
+      xdata::Integer32 numaNode;                           // NUMA node for the hugepage-backed message pool. -1 uses the default memory policy
       xdata::Integer32 evmInstance;                        // Instance of the EVM. If not set, discover the EVM over I2O.
       xdata::UnsignedInteger32 maxEvtsUnderConstruction;   // Maximum number of events in BU
       xdata::UnsignedInteger32 eventsPerRequest;           // Number of events requested at a time
@@ -37,11 +41,13 @@ namespace evb {
       xdata::UnsignedInteger32 lumiSectionLatencyLow;      // Low water mark on how many LS may be queued for the FUs
       xdata::UnsignedInteger32 lumiSectionLatencyHigh;     // High water mark on how many LS may be queued for the FUs
       xdata::UnsignedInteger32 maxFuLumiSectionLatency;    // Maximum number of lumi sections the FUs may lag behind
-      xdata::UnsignedInteger32 maxTriesFUsStale;           // Maximum number of consecutive tests for FU staleness before failing
+      xdata::UnsignedInteger32 maxTriesFUsStale;           // Number of seconds all FUs may be stale before failing
       xdata::UnsignedInteger32 staleResourceTime;          // Number of seconds after which a FU resource is no longer considered
       xdata::UnsignedInteger32 superFragmentFIFOCapacity;  // Capacity of the FIFO for super-fragment
       xdata::Boolean dropEventData;                        // If true, drop the data as soon as the event is complete
       xdata::UnsignedInteger32 numberOfBuilders;           // Number of threads used to build/write events
+      xdata::UnsignedInteger32 numberOfCheckers;           // Number of threads used to check the events before they are written (0 checks them on the builder threads)
+      xdata::Boolean balanceBuilders;                      // If true, resources are handed to the builder with the fewest queued super fragments
       xdata::String rawDataDir;                            // Path to the top directory used to write the event data
       xdata::String metaDataDir;                           // Path to the top directory used to write the meta data (JSON)
       xdata::String jsdDirName;                            // Directory name under the run directory used for JSON definition files
@@ -52,17 +58,37 @@ namespace evb {
       xdata::Double rawDataLowWaterMark;
       xdata::Double metaDataHighWaterMark;
       xdata::Double metaDataLowWaterMark;
+      xdata::UnsignedInteger32 diskUsagePredictionHorizon; // Time in seconds over which the disk usage is extrapolated from its net growth rate (0 disables it)
       xdata::UnsignedInteger32 checkCRC;                   // Check the CRC of the FED fragments for every Nth event
       xdata::Boolean calculateCRC32c;                      // If set to true, a CRC32c checksum of data blob of each event is calculated
+      xdata::UnsignedInteger32 maxDumpsPerSecond;          // Maximum rate of dumps of corrupted events. Additional dumps are dropped
+      xdata::UnsignedInteger32 dumpFIFOCapacity;           // Maximum number of event dumps waiting to be written
       xdata::Boolean deleteRawDataFiles;                   // If true, delete raw data files when the high-water mark is reached
       xdata::Boolean ignoreResourceSummary;                // If true, ignore the resource_summary file from hltd
       xdata::Boolean closeOldRuns;                         // If true, create empty EoR files in any old run directories without EoR files
       xdata::Boolean usePriorities;                        // If true, prioritize the event requests to the EVM
       xdata::UnsignedInteger32 minPriority;                // Minimum priority for requesting events
       xdata::UnsignedInteger32 maxEventsPerFile;           // Maximum number of events written into one file
+      xdata::UnsignedInteger32 eventsPerWrite;             // Number of events combined into a single write call (1 disables write combining)
+      xdata::UnsignedInteger32 bytesPerWrite;              // Maximum number of bytes combined into a single write call
+      xdata::UnsignedInteger32 writeCombiningTimeout;      // Time in ms after which events queued for write combining are written
+      xdata::Boolean useDirectIO;                          // If true, write the raw data with O_DIRECT through aligned staging buffers
+      xdata::UnsignedInteger32 stagingBufferSize;          // Size in bytes of the staging buffer used for each stream when using direct I/O
+      xdata::Boolean writeEventIndex;                      // If true, write an index file with the event and FED offsets for each uncompressed raw file
+      xdata::String compressionAlgorithm;                  // Compression of the raw data: none, lz4, or zstd
+      xdata::Integer32 compressionLevel;                   // Compression level for zstd or acceleration factor for lz4
+      xdata::UnsignedInteger32 eventsPerCompressedFrame;   // Number of events compressed into one independently decodable frame
+      xdata::UnsignedInteger32 numberOfCompressionWorkers; // Number of threads used to compress the raw data
+      xdata::UnsignedInteger32 compressionFIFOCapacity;    // Capacity of the FIFO for frames to be compressed by each worker
+      xdata::Boolean useSharedMemory;                      // If true, publish the events into a shared-memory ring per builder instead of writing raw files
+      xdata::UnsignedInteger32 sharedMemorySlots;          // Number of event slots in each shared-memory ring
+      xdata::UnsignedInteger32 sharedMemorySlotSize;       // Maximum size in bytes of an event in the shared-memory ring
       xdata::UnsignedInteger32 fileStatisticsFIFOCapacity; // Capacity of the FIFO used for file accounting
       xdata::UnsignedInteger32 lumiSectionFIFOCapacity;    // Capacity of the FIFO used for lumi-section accounting
       xdata::UnsignedInteger32 lumiSectionTimeout;         // Time in seconds after which a lumi-section is considered complete
+      xdata::UnsignedInteger32 metaDataFIFOCapacity;       // Capacity of the FIFO of pending file moves and JSON files
+      xdata::UnsignedInteger32 metaDataBatchSize;          // Maximum number of JSON files written in one batch
+      xdata::Boolean syncMetaData;                         // If true, sync the file system before the JSON files of a batch are renamed
       xdata::String hltParameterSetURL;                    // URL of the HLT menu
       xdata::Vector<xdata::String> hltFiles;               // List of file names to retrieve from hltParameterSetURL
       xdata::String blacklistName;                         // Name of the blacklist file
@@ -73,6 +99,9 @@ namespace evb {
 
       Configuration()
         : sendPoolName("sudapl"),
+          hugePageSize(0),
+          msgPoolSize(1073741824),
+          numaNode(-1),
           evmInstance(-1), // Explicitly indicate parameter not set
           maxEvtsUnderConstruction(256),
           eventsPerRequest(8),
@@ -89,6 +118,8 @@ namespace evb {
           superFragmentFIFOCapacity(3072),
           dropEventData(false),
           numberOfBuilders(5),
+          numberOfCheckers(0),
+          balanceBuilders(true),
           rawDataDir("/tmp/fff"),
           metaDataDir("/tmp/fff"),
           jsdDirName("jsd"),
@@ -99,17 +130,37 @@ namespace evb {
           rawDataLowWaterMark(0.75),
           metaDataHighWaterMark(0.95),
           metaDataLowWaterMark(0.75),
+          diskUsagePredictionHorizon(5),
           checkCRC(1),
           calculateCRC32c(true),
+          maxDumpsPerSecond(10),
+          dumpFIFOCapacity(16),
           deleteRawDataFiles(false),
           ignoreResourceSummary(false),
           closeOldRuns(true),
           usePriorities(true),
           minPriority(0),
           maxEventsPerFile(100),
+          eventsPerWrite(1),
+          bytesPerWrite(4194304),
+          writeCombiningTimeout(100),
+          useDirectIO(false),
+          stagingBufferSize(8388608),
+          writeEventIndex(true),
+          compressionAlgorithm("none"),
+          compressionLevel(1),
+          eventsPerCompressedFrame(16),
+          numberOfCompressionWorkers(4),
+          compressionFIFOCapacity(64),
+          useSharedMemory(false),
+          sharedMemorySlots(32),
+          sharedMemorySlotSize(4194304),
           fileStatisticsFIFOCapacity(128),
           lumiSectionFIFOCapacity(128),
           lumiSectionTimeout(30),
+          metaDataFIFOCapacity(1024),
+          metaDataBatchSize(32),
+          syncMetaData(false),
           hltParameterSetURL(""),
           blacklistName("blacklist"),
           fuBlacklist("[]"),
@@ -127,6 +178,9 @@ namespace evb {
       )
       {
         params.add("sendPoolName", &sendPoolName);
+        params.add("hugePageSize", &hugePageSize);
+        params.add("msgPoolSize", &msgPoolSize);
+        params.add("numaNode", &numaNode);
         params.add("evmInstance", &evmInstance);
         params.add("maxEvtsUnderConstruction", &maxEvtsUnderConstruction);
         params.add("eventsPerRequest", &eventsPerRequest);
@@ -143,6 +197,8 @@ namespace evb {
         params.add("superFragmentFIFOCapacity", &superFragmentFIFOCapacity);
         params.add("dropEventData", &dropEventData);
         params.add("numberOfBuilders", &numberOfBuilders);
+        params.add("numberOfCheckers", &numberOfCheckers);
+        params.add("balanceBuilders", &balanceBuilders);
         params.add("rawDataDir", &rawDataDir);
         params.add("metaDataDir", &metaDataDir);
         params.add("jsdDirName", &jsdDirName);
@@ -153,17 +209,37 @@ namespace evb {
         params.add("rawDataLowWaterMark", &rawDataLowWaterMark);
         params.add("metaDataHighWaterMark", &metaDataHighWaterMark);
         params.add("metaDataLowWaterMark", &metaDataLowWaterMark);
+        params.add("diskUsagePredictionHorizon", &diskUsagePredictionHorizon);
         params.add("checkCRC", &checkCRC);
         params.add("calculateCRC32c", &calculateCRC32c);
+        params.add("maxDumpsPerSecond", &maxDumpsPerSecond);
+        params.add("dumpFIFOCapacity", &dumpFIFOCapacity);
         params.add("deleteRawDataFiles", &deleteRawDataFiles);
         params.add("ignoreResourceSummary", &ignoreResourceSummary);
         params.add("closeOldRuns", &closeOldRuns);
         params.add("usePriorities", &usePriorities);
         params.add("minPriority", &minPriority);
         params.add("maxEventsPerFile", &maxEventsPerFile);
+        params.add("eventsPerWrite", &eventsPerWrite);
+        params.add("bytesPerWrite", &bytesPerWrite);
+        params.add("writeCombiningTimeout", &writeCombiningTimeout);
+        params.add("useDirectIO", &useDirectIO);
+        params.add("stagingBufferSize", &stagingBufferSize);
+        params.add("writeEventIndex", &writeEventIndex);
+        params.add("compressionAlgorithm", &compressionAlgorithm);
+        params.add("compressionLevel", &compressionLevel);
+        params.add("eventsPerCompressedFrame", &eventsPerCompressedFrame);
+        params.add("numberOfCompressionWorkers", &numberOfCompressionWorkers);
+        params.add("compressionFIFOCapacity", &compressionFIFOCapacity);
+        params.add("useSharedMemory", &useSharedMemory);
+        params.add("sharedMemorySlots", &sharedMemorySlots);
+        params.add("sharedMemorySlotSize", &sharedMemorySlotSize);
         params.add("fileStatisticsFIFOCapacity", &fileStatisticsFIFOCapacity);
         params.add("lumiSectionFIFOCapacity", &lumiSectionFIFOCapacity);
         params.add("lumiSectionTimeout", &lumiSectionTimeout);
+        params.add("metaDataFIFOCapacity", &metaDataFIFOCapacity);
+        params.add("metaDataBatchSize", &metaDataBatchSize);
+        params.add("syncMetaData", &syncMetaData);
         params.add("hltParameterSetURL", &hltParameterSetURL);
         params.add("hltFiles", &hltFiles);
         params.add("blacklistName", &blacklistName);
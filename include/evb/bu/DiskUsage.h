@@ -25,7 +25,8 @@ namespace evb {
       (
         const boost::filesystem::path& path,
         const float lowWaterMark,
-        const float highWaterMark
+        const float highWaterMark,
+        const uint32_t predictionHorizon = 0
       );
 
       ~DiskUsage();
@@ -36,9 +37,25 @@ namespace evb {
        */
       void update();
 
+      /**
+       * Account for the given number of bytes written
+       * to the disk since the last update
+       */
+      void bytesWritten(const uint64_t bytes)
+      { __sync_fetch_and_add(&bytesWritten_,bytes); }
+
+      /**
+       * Account for the given number of bytes deleted
+       * from the disk since the last update
+       */
+      void bytesDeleted(const uint64_t bytes)
+      { __sync_fetch_and_add(&bytesDeleted_,bytes); }
+
       /**
        * Returns the change in the relative disk usage
-       * btw the low and high water mark.
+       * btw the low and high water mark. If a prediction
+       * horizon is set, the disk usage expected at the
+       * end of the horizon is used if it is higher.
        */
       float overThreshold();
 
@@ -52,6 +69,12 @@ namespace evb {
        */
       float relDiskUsage();
 
+      /**
+       * Return the predicted time in seconds until the high-water
+       * mark is reached, or -1 if the disk usage is not increasing
+       */
+      float timeToFull();
+
       /**
        * Return the path being monitored
        */
@@ -61,10 +84,13 @@ namespace evb {
     private:
 
       void doStatFs();
+      float estimateDiskUsage();
+      int64_t estimateUsedBytes();
 
       const boost::filesystem::path path_;
       const float lowWaterMark_;
       const float highWaterMark_;
+      const uint32_t predictionHorizon_;
 
       enum State { IDLE, UPDATE, UPDATING, STOP };
       State state_;
@@ -74,6 +100,19 @@ namespace evb {
       float diskSizeGB_;
       float relDiskUsage_;
       bool valid_;
+
+      // bytes accounted by the BU since the start, used to
+      // extrapolate the disk usage between statfs calls
+      volatile uint64_t bytesWritten_;
+      volatile uint64_t bytesDeleted_;
+      uint64_t diskSizeBytes_;
+      uint64_t usedBytesAtStatFs_;
+      int64_t accountedBytesAtStatFs_;
+
+      // net rate at which the disk fills, derived from successive statfs calls
+      int64_t usedBytesAtLastRate_;
+      uint64_t timeOfLastRate_;
+      double usageRate_; // Bytes/s
     };
 
     typedef boost::shared_ptr<DiskUsage> DiskUsagePtr;
@@ -6,18 +6,25 @@
 #include <boost/thread/mutex.hpp>
 
 #include <curl/curl.h>
+#include <list>
 #include <map>
 #include <stdint.h>
+#include <vector>
 
 #include "cgicc/HTMLClasses.h"
+#include "evb/ActivityFlag.h"
+#include "evb/bu/Compressor.h"
 #include "evb/bu/Configuration.h"
 #include "evb/bu/FileStatistics.h"
+#include "evb/bu/MetaDataWriter.h"
 #include "evb/bu/StreamHandler.h"
 #include "evb/InfoSpaceItems.h"
 #include "toolbox/lang/Class.h"
 #include "toolbox/task/Action.h"
 #include "toolbox/task/WorkLoop.h"
+#include "xdata/Double.h"
 #include "xdata/UnsignedInteger32.h"
+#include "xdata/Vector.h"
 
 
 namespace evb {
@@ -74,7 +81,11 @@ namespace evb {
        * Register the state machine
        */
       void registerStateMachine(boost::shared_ptr<StateMachine> stateMachine)
-      { stateMachine_ = stateMachine; }
+      {
+        stateMachine_ = stateMachine;
+        compressor_->registerStateMachine(stateMachine);
+        metaDataWriter_->registerStateMachine(stateMachine);
+      }
 
       /**
        * Start processing messages
@@ -86,6 +97,11 @@ namespace evb {
        */
       void drain();
 
+      /**
+       * Stop any builder waiting for free slots in the shared-memory rings
+       */
+      void abortStreams();
+
       /**
        * Stop processing messages
        */
@@ -111,13 +127,15 @@ namespace evb {
         uint32_t nbEvents;
         uint32_t nbEventsWritten;
         uint64_t nbBytesWritten;
+        uint64_t nbUncompressedBytes;
+        uint64_t compressionTime;
         uint32_t nbIncompleteEvents;
         uint32_t fileCount;
         uint32_t index;
         bool isEmpty;
 
         LumiInfo(const uint32_t ls)
-          : lumiSection(ls),totalEvents(0),nbEvents(0),nbEventsWritten(0),nbBytesWritten(0),nbIncompleteEvents(0),fileCount(0),index(0),isEmpty(false) {};
+          : lumiSection(ls),totalEvents(0),nbEvents(0),nbEventsWritten(0),nbBytesWritten(0),nbUncompressedBytes(0),compressionTime(0),nbIncompleteEvents(0),fileCount(0),index(0),isEmpty(false) {};
 
         bool isComplete() const
         { return isEmpty || (nbEvents > 0 && nbEvents == nbEventsWritten+nbIncompleteEvents); }
@@ -134,9 +152,12 @@ namespace evb {
       bool fileMover(toolbox::task::WorkLoop*);
       void doLumiSectionAccounting(const bool completeLumiSectionsOnly);
       void moveFiles();
+      void updateStreamMonitoring();
       void handleRawDataFile(const FileStatisticsPtr&);
+      void removeOrphanedIndexFiles();
       LumiStatistics::iterator getLumiStatistics(const uint32_t lumiSection);
       void createDir(const boost::filesystem::path&) const;
+      SharedMemoryRingPtr createSharedMemoryRing(const uint16_t builderId) const;
       void removeDir(const boost::filesystem::path&) const;
       void closeAnyOldRuns() const;
       void populateHltdDirectory(const boost::filesystem::path& runDir) const;
@@ -154,6 +175,8 @@ namespace evb {
       boost::shared_ptr<ResourceManager> resourceManager_;
       boost::shared_ptr<StateMachine> stateMachine_;
       const ConfigurationPtr configuration_;
+      const CompressorPtr compressor_;
+      const MetaDataWriterPtr metaDataWriter_;
 
       const uint32_t buInstance_;
       uint32_t runNumber_;
@@ -163,17 +186,39 @@ namespace evb {
       boost::filesystem::path rawDataDefFile_;
       boost::filesystem::path eolsDefFile_;
       boost::filesystem::path eorDefFile_;
+      JsonTemplate rawDataJson_;
+      JsonTemplate eolsJson_;
+      JsonTemplate eorJson_;
 
       typedef std::map<uint16_t,StreamHandlerPtr > StreamHandlers;
       StreamHandlers streamHandlers_;
 
+      // rings created and pre-faulted when configuring, used for the first run
+      typedef std::map<uint16_t,SharedMemoryRingPtr> SharedMemoryRings;
+      SharedMemoryRings preparedSharedMemoryRings_;
+
       toolbox::task::WorkLoop* lumiAccountingWorkLoop_;
       toolbox::task::WorkLoop* fileMoverWorkLoop_;
       toolbox::task::ActionSignature* lumiAccountingAction_;
       toolbox::task::ActionSignature* fileMoverAction_;
       volatile bool doProcessing_;
-      volatile bool lumiAccountingActive_;
-      volatile bool fileMoverActive_;
+      ActivityFlag lumiAccountingActive_;
+      ActivityFlag fileMoverActive_;
+
+      // index files moved next to raw files which have not been consumed yet
+      struct IndexFile
+      {
+        std::string rawFile;
+        std::string movedRawFile;
+        std::string movedIndexFile;
+      };
+      typedef std::list<IndexFile> IndexFiles;
+      IndexFiles indexFiles_;
+      time_t lastIndexFileCheck_;
+
+      typedef std::vector<StreamHandler::StreamMonitoring> StreamMonitorings;
+      StreamMonitorings lastStreamMonitorings_;
+      uint64_t lastStreamMonitoringTime_;
 
       struct DiskWriterMonitoring
       {
@@ -183,12 +228,18 @@ namespace evb {
         uint32_t lastLumiSection;
         uint32_t lastEventNumberWritten;
         uint32_t currentLumiSection;
+        std::vector<double> writeBandwidth;
+        std::vector<double> writeSize;
+        std::vector<double> stagingBufferUsage;
+        StreamMonitorings streamMonitorings;
       } diskWriterMonitoring_;
       mutable boost::mutex diskWriterMonitoringMutex_;
 
       xdata::UnsignedInteger32 nbFilesWritten_;
       xdata::UnsignedInteger32 nbLumiSections_;
       xdata::UnsignedInteger32 currentLumiSection_;
+      xdata::Vector<xdata::Double> writeBandwidthPerStream_;
+      xdata::Vector<xdata::Double> stagingBufferUsagePerStream_;
 
     };
 
@@ -3,7 +3,6 @@
 
 #include <boost/shared_ptr.hpp>
 
-#include <limits>
 #include <map>
 #include <stdint.h>
 #include <vector>
@@ -11,6 +10,7 @@
 #include "evb/bu/EventInfo.h"
 #include "evb/bu/FedInfo.h"
 #include "evb/DataLocations.h"
+#include "evb/Dumper.h"
 #include "evb/EvBid.h"
 #include "evb/I2OMessages.h"
 #include "i2o/i2oDdmLib.h"
@@ -35,7 +35,7 @@ namespace evb {
       Event
       (
         const EvBid&,
-        const msg::RUtids&,
+        const msg::RUtidsView&,
         const uint16_t buResourceId,
         const bool checkCRC,
         const bool calculateCRC32
@@ -61,14 +61,31 @@ namespace evb {
       { return ruSizes_.empty(); }
 
       /**
-       * Check the complete event for integrity of the data
+       * Check the complete event for integrity of the data.
+       * A corrupted event is dumped using the given dumper.
        */
-      void checkEvent() const;
+      void checkEvent(Dumper&) const;
+
+      enum CheckStatus { UNCHECKED, CHECKED, CORRUPTED, CRC_ERROR };
+
+      /**
+       * Set the outcome of checking the event on a checker thread
+       */
+      void setCheckStatus(const CheckStatus status)
+      { __sync_synchronize(); checkStatus_ = status; }
+
+      /**
+       * Return the outcome of checking the event on a checker thread
+       */
+      CheckStatus getCheckStatus() const
+      { const CheckStatus status = checkStatus_; __sync_synchronize(); return status; }
 
       /**
-       * Write the event as binary dump to a text file
+       * Queue a binary dump of the event to the dumper.
+       * The dump is dropped if the dumper does not accept it.
        */
-      void dumpEventToFile(const std::string& reasonForDump, const uint32_t badChunk=std::numeric_limits<uint32_t>::max()) const;
+      void dumpEventToFile(Dumper&, const std::string& reasonForDump,
+                           const uint32_t badChunk=Dump::noBadChunk, const bool force=false) const;
 
       EvBid getEvBid() const { return evbId_; }
       uint16_t buResourceId() const { return buResourceId_; }
@@ -94,6 +111,7 @@ namespace evb {
       RUsizes ruSizes_;
 
       msg::FedIds missingFedIds_;
+      volatile CheckStatus checkStatus_;
 
     }; // Event
 
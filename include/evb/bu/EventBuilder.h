@@ -4,8 +4,10 @@
 #include <boost/dynamic_bitset.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
 
+#include <deque>
 #include <map>
 #include <stdint.h>
 #include <vector>
@@ -23,10 +25,12 @@
 #include "toolbox/mem/Reference.h"
 #include "toolbox/task/Action.h"
 #include "toolbox/task/WaitingWorkLoop.h"
+#include "xcept/Exception.h"
 #include "xdaq/Application.h"
 #include "xdata/Boolean.h"
 #include "xdata/Double.h"
 #include "xdata/UnsignedInteger32.h"
+#include "xdata/Vector.h"
 
 
 namespace evb {
@@ -62,6 +66,13 @@ namespace evb {
        */
       void addSuperFragment(const uint16_t buResourceId, FragmentChainPtr&);
 
+      /**
+       * Return the builder with the fewest super fragments queued.
+       * The given builder is kept unless another one has less work
+       * or balancing the builders is disabled.
+       */
+      uint16_t getLeastLoadedBuilder(const uint16_t builderId) const;
+
       /**
        * Configure
        */
@@ -138,19 +149,30 @@ namespace evb {
         uint32_t lowestLumiSection;
         uint32_t completeEvents;
         uint32_t partialEvents;
+        uint64_t busyTime;       // time in ns spent building and writing events
+        uint64_t lastBusyTime;
+        double utilization;      // fraction of the time busy since the last monitoring update
 
         EventMapMonitor() :
-          lowestLumiSection(0),completeEvents(0),partialEvents(0) {};
+          lowestLumiSection(0),completeEvents(0),partialEvents(0),
+          busyTime(0),lastBusyTime(0),utilization(0) {};
 
         void reset()
-        { lowestLumiSection = 0; completeEvents = 0; partialEvents = 0; }
+        {
+          lowestLumiSection = 0; completeEvents = 0; partialEvents = 0;
+          busyTime = 0; lastBusyTime = 0; utilization = 0;
+        }
       };
 
       void createProcessingWorkLoops();
       bool process(toolbox::task::WorkLoop*);
       void buildEvent(FragmentChainPtr&, PartialEvents&, CompleteEvents&) const;
-      PartialEvents::iterator getEventPos(PartialEvents&, const EvBid&, const msg::RUtids&, const uint16_t& buResourceId) const;
-      uint32_t handleCompleteEvents(CompleteEvents&, StreamHandlerPtr&) const;
+      PartialEvents::iterator getEventPos(PartialEvents&, const EvBid&, const msg::RUtidsView&, const uint16_t& buResourceId) const;
+      uint32_t handleCompleteEvents(CompleteEvents&, StreamHandlerPtr&, const uint16_t builderId) const;
+      bool check(toolbox::task::WorkLoop*);
+      void checkEvent(const EventPtr&);
+      void handleCorruptedEvent(xcept::Exception&);
+      void handleCRCerror(xcept::Exception&);
       bool isEmpty() const;
 
       BU* bu_;
@@ -169,9 +191,22 @@ namespace evb {
       typedef std::vector<toolbox::task::WorkLoop*> WorkLoops;
       WorkLoops builderWorkLoops_;
       toolbox::task::ActionSignature* builderAction_;
+      WorkLoops checkerWorkLoops_;
+      toolbox::task::ActionSignature* checkerAction_;
+
+      // complete events waiting to be checked by the checker threads
+      typedef std::deque<EventPtr> EventsToCheck;
+      mutable EventsToCheck eventsToCheck_;
+      mutable boost::mutex eventsToCheckMutex_;
+      mutable boost::condition_variable eventsToCheckCondition_;
+      boost::condition_variable eventCheckedCondition_;
+      uint32_t eventsBeingChecked_;
+      uint32_t checkersActive_;
+      volatile uint64_t eventsChecked_;
 
       typedef std::map<uint16_t,EventMapMonitor> EventMapMonitors;
       EventMapMonitors eventMapMonitors_;
+      uint64_t lastMonitoringTime_;
 
       uint64_t corruptedEvents_;
       uint64_t eventsWithCRCerrors_;
@@ -181,6 +216,7 @@ namespace evb {
       volatile bool doProcessing_;
       boost::dynamic_bitset<> processesActive_;
       mutable boost::mutex processesActiveMutex_;
+      mutable boost::condition_variable processesIdle_;
 
       mutable uint16_t writeNextEventsToFile_;
       mutable boost::mutex writeNextEventsToFileMutex_;
@@ -188,6 +224,7 @@ namespace evb {
       xdata::UnsignedInteger64 nbCorruptedEvents_;
       xdata::UnsignedInteger64 nbEventsWithCRCerrors_;
       xdata::UnsignedInteger64 nbEventsMissingData_;
+      xdata::Vector<xdata::Double> builderUtilization_;
 
     }; // EventBuilder
 
@@ -0,0 +1,109 @@
+#ifndef _evb_bu_EventIndex_h_
+#define _evb_bu_EventIndex_h_
+
+#include <boost/shared_ptr.hpp>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "evb/DataLocations.h"
+#include "evb/bu/EventInfo.h"
+
+
+namespace evb {
+  namespace bu {
+
+    /**
+     * Layout of the index file written alongside each raw-data file:
+     *
+     * EventIndexHeader | EventIndexEntry for each event | FedIndexEntry for each FED
+     *
+     * The FEDs of an event are stored in the order they appear in the raw-data file.
+     */
+
+    const uint32_t eventIndexMagic = 0x58427645;  // "EvBX"
+    const uint32_t eventIndexVersion = 1;
+
+    struct EventIndexHeader
+    {
+      uint32_t magic;
+      uint32_t version;
+      uint32_t runNumber;
+      uint32_t lumiSection;
+      uint32_t nbEvents;
+      uint32_t nbFeds;
+    };
+
+    struct EventIndexEntry
+    {
+      uint64_t offset;               // Offset of the EventInfo in the raw-data file
+      uint32_t eventNumber;
+      uint32_t eventSize;            // Size of the FED data following the EventInfo
+      uint32_t firstFed;             // Position of the first FedIndexEntry of this event
+      uint32_t nbFeds;
+    };
+
+    struct FedIndexEntry
+    {
+      uint32_t offset;               // Offset of the FED header relative to the end of the EventInfo
+      uint32_t size;
+      uint16_t fedId;
+      uint16_t reserved;
+    };
+
+
+    /**
+     * \ingroup xdaqApps
+     * \brief Collect the event and FED offsets of a raw-data file
+     */
+
+    class EventIndex
+    {
+    public:
+
+      EventIndex();
+
+      /**
+       * Add the event written at the given file offset.
+       * The FED boundaries are found by walking the FED trailers
+       * backwards through the data locations.
+       */
+      void addEvent(const uint64_t offset, const EventInfoPtr&, const DataLocations&);
+
+      /**
+       * Write the index into the given file
+       */
+      void write(const std::string& fileName) const;
+
+      /**
+       * Forget all events
+       */
+      void clear();
+
+      uint32_t getNbEvents() const { return events_.size(); }
+      const EventIndexEntry& getEvent(const uint32_t pos) const { return events_.at(pos); }
+      const FedIndexEntry& getFed(const uint32_t pos) const { return feds_.at(pos); }
+
+    private:
+
+      EventIndexHeader header_;
+      std::vector<EventIndexEntry> events_;
+      std::vector<FedIndexEntry> feds_;
+      std::vector<uint32_t> chunkOffsets_;
+
+    }; // EventIndex
+
+    typedef boost::shared_ptr<EventIndex> EventIndexPtr;
+
+  } } // namespace evb::bu
+
+#endif // _evb_bu_EventIndex_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
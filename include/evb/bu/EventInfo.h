@@ -16,6 +16,8 @@ namespace evb {
     {
     public:
 
+      static const uint32_t currentVersion = 5;
+
       EventInfo(
         const uint32_t runNumber,
         const uint32_t lumiSection,
@@ -24,6 +26,7 @@ namespace evb {
 
       void addFedSize(const uint32_t size) { eventSize_ += size; }
       void updateCRC32(const iovec&);
+      void combineCRC32(const uint32_t crc32c, const uint32_t size);
 
       uint32_t version() const { return version_; }
       uint32_t eventNumber() const { return eventNumber_; }
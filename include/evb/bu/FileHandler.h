@@ -5,8 +5,14 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <vector>
 
+#include "evb/DataLocations.h"
+#include "evb/bu/CompressedFrame.h"
+#include "evb/bu/Compression.h"
 #include "evb/bu/Event.h"
+#include "evb/bu/EventIndex.h"
+#include "evb/bu/StagingBuffer.h"
 
 
 namespace evb {
@@ -21,26 +27,107 @@ namespace evb {
     {
     public:
 
-      FileHandler(const std::string& rawFileName);
+      /**
+       * Open the raw file. If a staging buffer is given, the event data
+       * is copied into it and written in aligned chunks with O_DIRECT.
+       * If writeEventIndex is set, the event and FED offsets are written
+       * into an index file next to the raw file when it is closed.
+       */
+      FileHandler
+      (
+        const std::string& rawFileName,
+        const uint32_t eventsPerWrite,
+        const uint32_t bytesPerWrite,
+        const bool writeEventIndex,
+        StagingBufferPtr stagingBuffer = StagingBufferPtr()
+      );
 
       ~FileHandler();
 
       /**
-       * Write the event to disk
+       * Queue the event for writing to disk. The queued events
+       * are written with a single writev call once eventsPerWrite
+       * events or bytesPerWrite bytes are queued.
        */
       void writeEvent(const EventPtr&);
 
+      /**
+       * Write the compressed frame to disk. The frame index
+       * is appended to the file when it is closed.
+       */
+      void writeFrame(const CompressedFramePtr&);
+
+      /**
+       * Write all queued events to disk. When using a staging
+       * buffer, only the aligned part of the staged data is written.
+       */
+      void flush();
+
+      /**
+       * Write all queued events to disk if the oldest
+       * event has been queued before the given time stamp
+       */
+      void flushIfQueuedBefore(const uint64_t& timeStamp);
+
       /**
        * Close the file and do the bookkeeping.
        */
       uint64_t closeAndGetFileSize();
 
+      /**
+       * Return the number of write calls issued so far
+       */
+      uint64_t getNbWriteCalls() const
+      { return nbWriteCalls_; }
+
+      /**
+       * Return the number of bytes written to disk so far
+       */
+      uint64_t getBytesWritten() const
+      { return fileSize_; }
+
+      /**
+       * Return true if the file is written with O_DIRECT
+       */
+      bool isDirectIO() const
+      { return directIO_; }
+
+      /**
+       * Return the name of the index file or an empty string
+       * if no index is written
+       */
+      std::string getIndexFileName() const
+      { return eventIndex_.get() ? rawFileName_ + ".idx" : ""; }
+
     private:
 
+      void writeQueuedEvents();
+      void writeFrameIndex();
+      void stageData(const void* data, size_t size);
+      void writeStagedData(const size_t size);
+
       const std::string rawFileName_;
+      const uint32_t eventsPerWrite_;
+      const uint32_t bytesPerWrite_;
+      const StagingBufferPtr stagingBuffer_;
       int fileDescriptor_;
+      bool directIO_;
 
       uint64_t fileSize_;
+      uint64_t fileOffset_;
+      uint64_t nbWriteCalls_;
+
+      typedef std::vector<EventPtr> Events;
+      Events queuedEvents_;
+      typedef std::vector<CompressedFramePtr> Frames;
+      Frames queuedFrames_;
+      DataLocations queuedLocations_;
+      uint64_t queuedBytes_;
+      uint64_t firstQueuedTime_;
+
+      EventIndexPtr eventIndex_;
+      std::vector<compression::IndexEntry> frameIndex_;
+      compression::FileTrailer fileTrailer_;
 
     }; // FileHandler
 
@@ -16,12 +16,15 @@ namespace evb {
       const time_t creationTime;
       const uint32_t lumiSection;
       const std::string fileName;
+      std::string indexFileName;
       uint32_t nbEventsWritten;
       uint32_t lastEventNumberWritten;
       uint64_t fileSize;
+      uint64_t uncompressedSize;
+      uint64_t compressionTime;
 
       FileStatistics(const uint32_t ls, const std::string& fileName)
-        : creationTime(time(0)),lumiSection(ls),fileName(fileName),nbEventsWritten(0),lastEventNumberWritten(0),fileSize(0) {};
+        : creationTime(time(0)),lumiSection(ls),fileName(fileName),nbEventsWritten(0),lastEventNumberWritten(0),fileSize(0),uncompressedSize(0),compressionTime(0) {};
     };
     typedef boost::shared_ptr<FileStatistics> FileStatisticsPtr;
 
@@ -37,9 +40,12 @@ namespace evb {
         s << "creationTime=" << asctime(gmtime(&fileStatistics->creationTime)) << " GMT ";
         s << "lumiSection=" << fileStatistics->lumiSection << " ";
         s << "fileName=" << fileStatistics->fileName << " ";
+        if ( ! fileStatistics->indexFileName.empty() )
+          s << "indexFileName=" << fileStatistics->indexFileName << " ";
         s << "nbEventsWritten=" << fileStatistics->nbEventsWritten << " ";
         s << "lastEventNumberWritten=" << fileStatistics->lastEventNumberWritten << " ";
-        s << "fileSize=" << fileStatistics->fileSize << " Bytes";
+        s << "fileSize=" << fileStatistics->fileSize << " Bytes ";
+        s << "uncompressedSize=" << fileStatistics->uncompressedSize << " Bytes";
       }
 
       return s;
@@ -0,0 +1,209 @@
+#ifndef _evb_bu_MetaDataWriter_h_
+#define _evb_bu_MetaDataWriter_h_
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <deque>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cgicc/HTMLClasses.h"
+#include "evb/ActivityFlag.h"
+#include "evb/InfoSpaceItems.h"
+#include "evb/bu/Configuration.h"
+#include "toolbox/lang/Class.h"
+#include "toolbox/task/Action.h"
+#include "toolbox/task/WaitingWorkLoop.h"
+#include "xdata/Double.h"
+#include "xdata/UnsignedInteger32.h"
+
+
+namespace evb {
+
+  class BU;
+
+  namespace bu {
+
+    class StateMachine;
+
+    /**
+     * \ingroup xdaqApps
+     * \brief The values of the data array of a JSON file
+     */
+    class JsonValues
+    {
+    public:
+
+      JsonValues& add(const uint64_t);
+      JsonValues& add(const std::string&);
+
+      const std::string& str() const { return values_; }
+
+    private:
+
+      std::string values_;
+
+    };
+
+
+    /**
+     * \ingroup xdaqApps
+     * \brief The constant parts of a JSON file referring to a definition file
+     */
+    class JsonTemplate
+    {
+    public:
+
+      JsonTemplate() {};
+
+      JsonTemplate(const std::string& definitionFile, const uint32_t buInstance);
+
+      /**
+       * Return the JSON document with the given data values.
+       * Any additional fields are inserted after the data array.
+       */
+      std::string format(const JsonValues&, const std::string& fields = "") const;
+
+      /**
+       * Return a JSON field with the given string value
+       */
+      static std::string field(const std::string& name, const std::string& value);
+
+    private:
+
+      std::string tail_;
+
+    };
+
+
+    /**
+     * \ingroup xdaqApps
+     * \brief Move raw-data files and write JSON files on a dedicated thread.
+     * The requests are handled in the order they are queued, which guarantees
+     * that the files of a lumi section appear before its EoLS file.
+     */
+    class MetaDataWriter : public toolbox::lang::Class
+    {
+    public:
+
+      MetaDataWriter(BU*);
+
+      ~MetaDataWriter();
+
+      typedef std::vector< std::pair<std::string,std::string> > FileMoves;
+
+      /**
+       * Queue the moves of the given files followed by the creation of the JSON file.
+       * An empty destination removes the file.
+       * Wait if the queue is full.
+       */
+      void write(const std::string& jsonFile, const std::string& body, const FileMoves& = FileMoves());
+
+      /**
+       * Wait until all queued requests have been handled
+       */
+      void drain() const;
+
+      /**
+       * Start processing messages
+       */
+      void startProcessing();
+
+      /**
+       * Stop processing messages. Any requests not yet handled are discarded
+       */
+      void stopProcessing();
+
+      /**
+       * Register the state machine
+       */
+      void registerStateMachine(boost::shared_ptr<StateMachine> stateMachine)
+      { stateMachine_ = stateMachine; }
+
+      /**
+       * Append the info space items to be published in the
+       * monitoring info space to the InfoSpaceItems
+       */
+      void appendMonitoringItems(InfoSpaceItems&);
+
+      /**
+       * Update all values of the items put into the monitoring
+       * info space. The caller has to make sure that the info
+       * space where the items reside is locked and properly unlocked
+       * after the call.
+       */
+      void updateMonitoringItems();
+
+      /**
+       * Return monitoring information as cgicc snipped
+       */
+      cgicc::div getHtmlSnipped() const;
+
+    private:
+
+      struct Request
+      {
+        std::string jsonFile;
+        std::string body;
+        FileMoves fileMoves;
+        uint64_t queuedTime;
+      };
+      typedef std::vector<Request> Requests;
+
+      void resetMonitoringCounters();
+      void startWorkLoop();
+      bool process(toolbox::task::WorkLoop*);
+      void handleRequests(const Requests&);
+      void moveFiles(const FileMoves&) const;
+      void writeTemporaryFile(const Request&) const;
+      void syncFileSystems(const Requests&) const;
+
+      BU* bu_;
+      boost::shared_ptr<StateMachine> stateMachine_;
+      const ConfigurationPtr configuration_;
+
+      std::deque<Request> requests_;
+      mutable boost::mutex requestsMutex_;
+      boost::condition_variable requestQueued_;
+      mutable boost::condition_variable requestsHandled_;
+      bool writing_;
+
+      toolbox::task::WorkLoop* workLoop_;
+      toolbox::task::ActionSignature* action_;
+      volatile bool doProcessing_;
+      ActivityFlag active_;
+
+      struct MetaDataMonitoring
+      {
+        uint64_t nbFiles;
+        uint64_t nbBatches;
+        uint64_t nbFilesSinceUpdate;
+        uint64_t latencySinceUpdate;
+        uint64_t totalLatency;
+        uint64_t maxLatency;
+        uint32_t maxQueueDepth;
+      } metaDataMonitoring_;
+      mutable boost::mutex metaDataMonitoringMutex_;
+
+      xdata::UnsignedInteger32 metaDataQueueDepth_;
+      xdata::Double metaDataLatency_;
+
+    }; // MetaDataWriter
+
+    typedef boost::shared_ptr<MetaDataWriter> MetaDataWriterPtr;
+
+  } } // namespace evb::bu
+
+#endif // _evb_bu_MetaDataWriter_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
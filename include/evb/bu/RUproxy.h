@@ -8,6 +8,7 @@
 #include <stdint.h>
 
 #include "cgicc/HTMLClasses.h"
+#include "evb/ActivityFlag.h"
 #include "evb/ApplicationDescriptorAndTid.h"
 #include "evb/EvBid.h"
 #include "evb/I2OMessages.h"
@@ -144,7 +145,7 @@ namespace evb {
       const ConfigurationPtr configuration_;
 
       bool doProcessing_;
-      bool requestFragmentsActive_;
+      ActivityFlag requestFragmentsActive_;
 
       toolbox::task::WorkLoop* requestFragmentsWL_;
       toolbox::task::ActionSignature* requestFragmentsAction_;
@@ -16,10 +16,13 @@
 #include "evb/EvBid.h"
 #include "evb/I2OMessages.h"
 #include "evb/InfoSpaceItems.h"
+#include "evb/LumiSectionCounters.h"
 #include "evb/OneToOneQueue.h"
 #include "evb/PerformanceMonitor.h"
+#include "evb/SteadyStateMonitor.h"
 #include "evb/bu/DiskUsage.h"
 #include "evb/bu/Event.h"
+#include "evb/bu/ResourceSummary.h"
 #include "toolbox/lang/Class.h"
 #include "toolbox/task/Action.h"
 #include "toolbox/task/WaitingWorkLoop.h"
@@ -58,15 +61,27 @@ namespace evb {
       uint16_t underConstruction(const msg::I2O_DATA_BLOCK_MESSAGE_FRAME*);
 
       /**
-       * Mark the resouces used by the event as complete
+       * Return the builder identifier to which the super fragments of the resource are given.
+       * As long as none of its super fragments has been handed to a builder, the resource
+       * is moved to the proposed builder. Afterwards, the resource stays with its builder.
        */
-      void eventCompleted(const EventPtr&);
+      uint16_t assignBuilder(const uint16_t buResourceId, const uint16_t proposedBuilderId);
+
+      /**
+       * Mark the resouces used by the event built by the given builder as complete
+       */
+      void eventCompleted(const EventPtr&, const uint16_t builderId);
 
       /**
        * Discard the event
        */
       void discardEvent(const EventPtr&);
 
+      /**
+       * Account for a raw-data file of the given size being deleted
+       */
+      void rawDataDeleted(const uint64_t bytes);
+
       /**
        * Get the next resource id for which to request trigger data.
        * Return false if no free resource id is available.
@@ -185,7 +200,10 @@ namespace evb {
 
       void resetMonitoringCounters();
       void incrementEventsInLumiSection(const uint32_t lumiSection);
-      void eventCompletedForLumiSection(const uint32_t lumiSection);
+      void eventCompletedForLumiSection(const uint32_t lumiSection, const uint16_t builderId);
+      void resetLumiSectionCounters();
+      void updateLumiSectionAccounts();
+      bool closeLumiSection(const LumiSectionAccountPtr&);
       void configureResources();
       void configureResourceSummary();
       void configureDiskUsageMonitors();
@@ -195,6 +213,7 @@ namespace evb {
       void handleResourceSummaryFailure(const std::string& msg);
       void startResourceMonitorWorkLoop();
       bool resourceMonitor(toolbox::task::WorkLoop*);
+      void waitForResourceSummaryUpdate();
       void updateResources(const float availableResources, std::string& statusMsg, std::string& statusKeys);
       uint16_t getPriority();
       void changeStatesBasedOnResources();
@@ -207,6 +226,7 @@ namespace evb {
       struct ResourceInfo
       {
         int16_t builderId;
+        bool building;
         bool blocked;
         EvBidList evbIdList;
       };
@@ -228,7 +248,7 @@ namespace evb {
       uint32_t fusCloud_;
       uint32_t fusQuarantined_;
       uint32_t fusStale_;
-      uint32_t allFUsStaleDetected_;
+      time_t allFUsStaleSince_;
       uint32_t initiallyQueuedLS_;
       uint32_t queuedLS_;
       int32_t queuedLSonFUs_;
@@ -237,19 +257,28 @@ namespace evb {
       bool pauseRequested_;
       mutable boost::mutex lsLatencyMutex_;
 
-      boost::filesystem::path resourceSummary_;
+      ResourceSummaryPtr resourceSummary_;
       mutable boost::mutex resourceSummaryMutex_;
       bool resourceSummaryFailureAlreadyNotified_;
       bool resourceLimitiationAlreadyNotified_;
 
       typedef std::vector<DiskUsagePtr> DiskUsageMonitors;
       DiskUsageMonitors diskUsageMonitors_;
+      DiskUsagePtr rawDataDiskUsage_;
       mutable boost::mutex diskUsageMonitorsMutex_;
 
+      // the events are counted by the thread receiving the data blocks and completed
+      // events by each builder in its own counter. Only the lumi-accounting thread
+      // aggregates the counters into the lumi-section accounts and closes lumi sections.
+      LumiSectionCounters eventsInLumiSection_;
+      LumiSectionCounters eventsCompletedInLumiSection_;
+      std::vector<time_t> lumiSectionStartTimes_;
+      volatile uint32_t nextLumiSection_;
+
       typedef std::map<uint32_t,LumiSectionAccountPtr> LumiSectionAccounts;
       LumiSectionAccounts lumiSectionAccounts_;
       mutable boost::mutex lumiSectionAccountsMutex_;
-      uint32_t oldestIncompleteLumiSection_;
+      volatile uint32_t oldestIncompleteLumiSection_;
       volatile bool doProcessing_;
       toolbox::task::WorkLoop* resourceMonitorWL_;
 
@@ -261,6 +290,7 @@ namespace evb {
         uint32_t eventSizeStdDev;
         int32_t outstandingRequests;
         PerformanceMonitor perf;
+        SteadyStateMonitor steadyState;
       } eventMonitoring_;
       mutable boost::mutex eventMonitoringMutex_;
 
@@ -271,6 +301,7 @@ namespace evb {
       xdata::UnsignedInteger32 nbEventsInBU_;
       xdata::UnsignedInteger64 nbEventsBuilt_;
       xdata::UnsignedInteger32 eventRate_;
+      xdata::Integer32 timeToSteadyState_;
       xdata::UnsignedInteger64 throughput_;
       xdata::UnsignedInteger32 eventSize_;
       xdata::UnsignedInteger32 eventSizeStdDev_;
@@ -287,8 +318,10 @@ namespace evb {
       xdata::Double fuOutputBandwidthInMB_;
       xdata::Integer32 queuedLumiSections_;
       xdata::Integer32 queuedLumiSectionsOnFUs_;
+      xdata::Double resourceSummaryLatency_;
       xdata::Double ramDiskSizeInGB_;
       xdata::Double ramDiskUsed_;
+      xdata::Double ramDiskTimeToFull_;
       xdata::String statusMsg_;
       xdata::String statusKeywords_;
 
@@ -0,0 +1,119 @@
+#ifndef _evb_bu_ResourceSummary_h_
+#define _evb_bu_ResourceSummary_h_
+
+#include <boost/filesystem/convenience.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <stdint.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+
+namespace evb {
+  namespace bu {
+
+    /**
+     * \ingroup xdaqApps
+     * \brief Watch and parse the resource summary file written by the hltd
+     */
+
+    class ResourceSummary
+    {
+    public:
+
+      struct Values
+      {
+        int32_t activeResources;
+        int32_t cloud;
+        int32_t quarantined;
+        int32_t staleResources;
+        int32_t activeRunNumQueuedLS;
+        int32_t activeFURun;
+        int32_t activeRunCMSSWMaxLS;
+        double activeRunLSBWMB;
+        bool stopRequests;
+      };
+
+      ResourceSummary(const boost::filesystem::path&);
+
+      ~ResourceSummary();
+
+      /**
+       * Wait up to the given time in ms for the file to be written.
+       * Returns true if the file was written.
+       */
+      bool waitForUpdate(const uint32_t timeoutMs);
+
+      /**
+       * Return true if the file has changed since it was last read,
+       * or if it could not be parsed. Raises an exception if the
+       * file cannot be accessed.
+       */
+      bool modified();
+
+      /**
+       * Read and parse the file.
+       * Raises an exception if the file cannot be parsed.
+       */
+      void read();
+
+      /**
+       * Return the values of the last successful read
+       */
+      const Values& getValues() const
+      { return values_; }
+
+      /**
+       * Return the time of the last modification of the file
+       */
+      time_t getLastWriteTime() const
+      { return lastWriteTime_.tv_sec; }
+
+      /**
+       * Return the time in ms between the last write of the file
+       * and the moment its content was available to the BU
+       */
+      double getLatency() const
+      { return latency_; }
+
+      /**
+       * Return the path to the file being watched
+       */
+      const boost::filesystem::path& path() const
+      { return path_; }
+
+      /**
+       * Parse the keys needed by the BU from the given JSON document
+       */
+      static void parse(const char* json, const size_t size, Values&);
+
+    private:
+
+      void drainEvents();
+
+      const boost::filesystem::path path_;
+      const std::string fileName_;
+      int inotifyFD_;
+      bool written_;
+      bool valid_;
+      struct timespec lastWriteTime_;
+      struct timespec lastReadWriteTime_;
+      double latency_;
+      std::vector<char> buffer_;
+      Values values_;
+    };
+
+    typedef boost::shared_ptr<ResourceSummary> ResourceSummaryPtr;
+
+  } } // namespace evb::bu
+
+#endif // _evb_bu_ResourceSummary_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,198 @@
+#ifndef _evb_bu_SharedMemoryRing_h_
+#define _evb_bu_SharedMemoryRing_h_
+
+#include <boost/shared_ptr.hpp>
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+#include "evb/DataLocations.h"
+#include "evb/bu/EventInfo.h"
+
+
+namespace evb {
+  namespace bu {
+    namespace sharedmemory { // namespace evb::bu::sharedmemory
+
+      /**
+       * Layout of a shared-memory ring:
+       *
+       * RingHeader (one page) | SlotHeader | EventInfo | event data | SlotHeader | ...
+       *
+       * A single producer publishes events into the slots in sequence.
+       * Any number of consumers claim the published slots by advancing
+       * the read index, process the event in place, and acknowledge it
+       * which frees the slot for the producer.
+       */
+
+      const uint32_t ringMagic = 0x52427645;   // "EvBR"
+      const uint32_t ringVersion = 1;
+      const size_t headerSize = 4096;
+      const size_t cacheLineSize = 64;
+
+      enum SlotState
+      {
+        FREE      = 0,
+        PUBLISHED = 1,
+        CLAIMED   = 2
+      };
+
+      struct RingHeader
+      {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t nbSlots;
+        uint32_t slotSize;               // Maximum size of EventInfo plus event data
+        uint32_t runNumber;
+        volatile uint32_t closed;        // Set by the producer at the end of the run
+        char pad0[cacheLineSize - 6*sizeof(uint32_t)];
+        volatile uint64_t writeIndex;    // Number of events published
+        char pad1[cacheLineSize - sizeof(uint64_t)];
+        volatile uint64_t readIndex;     // Number of events claimed by the consumers
+      };
+
+      struct SlotHeader
+      {
+        volatile uint64_t sequence;
+        volatile uint32_t state;
+        uint32_t size;                   // Size of EventInfo plus event data
+        char pad[cacheLineSize - 2*sizeof(uint64_t)];
+      };
+
+      /**
+       * Return the size of a slot including its header
+       */
+      inline size_t slotStride(const uint32_t slotSize)
+      { return sizeof(SlotHeader) + ((slotSize + cacheLineSize - 1) / cacheLineSize) * cacheLineSize; }
+
+    } // namespace evb::bu::sharedmemory
+
+
+    /**
+     * \ingroup xdaqApps
+     * \brief Publish complete events into a POSIX shared-memory ring
+     */
+
+    class SharedMemoryRing
+    {
+    public:
+
+      /**
+       * Create and pre-fault the shared-memory segment with the given name.
+       * An existing segment with the same name is replaced. Consumers
+       * cannot attach to the ring until it has been opened.
+       */
+      SharedMemoryRing
+      (
+        const std::string& name,
+        const uint32_t nbSlots,
+        const uint32_t slotSize
+      );
+
+      /**
+       * Unmap and unlink the segment. Consumers still
+       * attached keep their mapping until they detach.
+       */
+      ~SharedMemoryRing();
+
+      /**
+       * Make the ring available to the consumers for the given run
+       */
+      void open(const uint32_t runNumber);
+
+      /**
+       * Copy the EventInfo and the event data into the next slot.
+       * Wait until the consumers have freed the slot.
+       * Return false if the ring has been aborted while waiting.
+       */
+      bool publish(const EventInfo&, const DataLocations&);
+
+      /**
+       * Flag the end of the run to the consumers
+       */
+      void close();
+
+      /**
+       * Stop waiting for free slots
+       */
+      void abort();
+
+      /**
+       * Return the number of slots not yet acknowledged by the consumers
+       */
+      uint32_t getOccupancy() const;
+
+      const std::string& getName() const { return name_; }
+      uint64_t getNbEventsPublished() const { return header_->writeIndex; }
+
+    private:
+
+      const std::string name_;
+      size_t ringSize_;
+      unsigned char* ring_;
+      sharedmemory::RingHeader* header_;
+      size_t slotStride_;
+      volatile bool aborted_;
+
+    }; // SharedMemoryRing
+
+    typedef boost::shared_ptr<SharedMemoryRing> SharedMemoryRingPtr;
+
+
+    /**
+     * \ingroup xdaqApps
+     * \brief Consume events from a shared-memory ring created by the BU
+     */
+
+    class SharedMemoryReader
+    {
+    public:
+
+      SharedMemoryReader(const std::string& name);
+
+      ~SharedMemoryReader();
+
+      /**
+       * Claim the next published event. Return false if no event
+       * is available. The event data stays valid until it is acknowledged.
+       */
+      bool claim(uint64_t& sequence, const EventInfo*&, const unsigned char*& data);
+
+      /**
+       * Acknowledge the event with the given sequence number
+       * and hand its slot back to the producer
+       */
+      void acknowledge(const uint64_t sequence);
+
+      /**
+       * Return true if the producer closed the ring and
+       * all published events have been claimed
+       */
+      bool isDone() const;
+
+      uint32_t getRunNumber() const { return header_->runNumber; }
+
+    private:
+
+      sharedmemory::SlotHeader* getSlot(const uint64_t sequence) const;
+
+      const std::string name_;
+      size_t ringSize_;
+      unsigned char* ring_;
+      sharedmemory::RingHeader* header_;
+      size_t slotStride_;
+
+    }; // SharedMemoryReader
+
+  } } // namespace evb::bu
+
+#endif // _evb_bu_SharedMemoryRing_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,80 @@
+#ifndef _evb_bu_StagingBuffer_h_
+#define _evb_bu_StagingBuffer_h_
+
+#include <boost/shared_ptr.hpp>
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+namespace evb {
+  namespace bu {
+
+    /**
+     * \ingroup xdaqApps
+     * \brief An aligned buffer used to stage event data for direct I/O
+     */
+
+    class StagingBuffer
+    {
+    public:
+
+      static const size_t alignment = 4096;
+
+      /**
+       * Allocate a buffer of at least the given capacity.
+       * Huge pages are used if available.
+       */
+      StagingBuffer(const size_t capacity);
+
+      ~StagingBuffer();
+
+      /**
+       * Copy the data into the buffer.
+       * Return the number of bytes copied, which is less
+       * than the requested size if the buffer is full.
+       */
+      size_t append(const void* data, const size_t size);
+
+      /**
+       * Remove the given number of bytes from the front of the buffer
+       * and move any remaining bytes to the beginning
+       */
+      void consume(const size_t size);
+
+      /**
+       * Remove all data from the buffer
+       */
+      void clear()
+      { used_ = 0; }
+
+      const unsigned char* data() const { return buffer_; }
+      size_t capacity() const { return capacity_; }
+      size_t used() const { return used_; }
+      size_t alignedSize() const { return used_ & ~(alignment-1); }
+      bool full() const { return used_ == capacity_; }
+      bool empty() const { return used_ == 0; }
+      bool hugePages() const { return hugePages_; }
+
+    private:
+
+      size_t capacity_;
+      size_t used_;
+      unsigned char* buffer_;
+      bool hugePages_;
+
+    }; // StagingBuffer
+
+    typedef boost::shared_ptr<StagingBuffer> StagingBufferPtr;
+
+  } } // namespace evb::bu
+
+#endif // _evb_bu_StagingBuffer_h_
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -4,15 +4,20 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 
+#include <deque>
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
 
 #include "evb/OneToOneQueue.h"
+#include "evb/bu/CompressedFrame.h"
+#include "evb/bu/Compressor.h"
 #include "evb/bu/Configuration.h"
 #include "evb/bu/Event.h"
 #include "evb/bu/FileHandler.h"
 #include "evb/bu/FileStatistics.h"
+#include "evb/bu/SharedMemoryRing.h"
+#include "evb/bu/StagingBuffer.h"
 
 
 namespace evb {
@@ -24,6 +29,7 @@ namespace evb {
     /**
      * \ingroup xdaqApps
      * \brief Handle a stream of events to be written to disk
+     * or published into a shared-memory ring
      */
 
     class StreamHandler
@@ -33,7 +39,9 @@ namespace evb {
       StreamHandler
       (
         BU*,
-        const std::string& streamFileName
+        const std::string& streamFileName,
+        CompressorPtr compressor = CompressorPtr(),
+        SharedMemoryRingPtr sharedMemoryRing = SharedMemoryRingPtr()
       );
 
       ~StreamHandler();
@@ -44,10 +52,23 @@ namespace evb {
       void writeEvent(const EventPtr);
 
       /**
-       * Close the file
+       * Write any events queued for write combining or
+       * compression before the given time stamp
+       */
+      void flushEventsQueuedBefore(const uint64_t& timeStamp);
+
+      /**
+       * Close the file. When publishing into a shared-memory ring,
+       * the statistics of the current lumi section are handed
+       * to the accounting and the ring is closed.
        */
       void closeFile();
 
+      /**
+       * Stop waiting for the consumers of the shared-memory ring
+       */
+      void abort();
+
       /**
        * Close the file if it was opened before the given time.
        * Return true if a file was closed
@@ -60,9 +81,29 @@ namespace evb {
        */
       bool getFileStatistics(FileStatisticsPtr&);
 
+      /**
+       * Return the write statistics of this stream since its creation
+       */
+      struct StreamMonitoring
+      {
+        uint64_t nbWriteCalls;
+        uint64_t bytesWritten;
+        size_t stagingBufferSize;
+        bool directIO;
+        bool hugePages;
+      };
+      void getStreamMonitoring(StreamMonitoring&);
+
     private:
 
+      bool isOpen() const
+      { return ( fileHandler_.get() || publishing_ ); }
+
+      void openFile(const uint32_t lumiSection);
       void do_closeFile();
+      void addEventToFrame(const EventPtr&);
+      void submitCurrentFrame();
+      void writeCompressedFrames(const bool waitUntilDone);
 
       const std::string streamFileName_;
       const ConfigurationPtr configuration_;
@@ -70,6 +111,16 @@ namespace evb {
       uint32_t currentLumiSection_;
 
       FileHandlerPtr fileHandler_;
+      const CompressorPtr compressor_;
+      CompressedFramePtr currentFrame_;
+      typedef std::deque<CompressedFramePtr> CompressedFrames;
+      CompressedFrames pendingFrames_;
+      StagingBufferPtr stagingBuffer_;
+      const SharedMemoryRingPtr sharedMemoryRing_;
+      bool publishing_;
+      uint64_t nbWriteCallsClosedFiles_;
+      uint64_t bytesWrittenClosedFiles_;
+      bool directIO_;
       boost::mutex fileHandlerMutex_;
 
       FileStatisticsPtr currentFileStatistics_;
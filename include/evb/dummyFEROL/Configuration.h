@@ -34,6 +34,12 @@ namespace evb {
         xdata::UnsignedInteger32 fragmentFIFOCapacity;
         xdata::UnsignedInteger32 fakeLumiSectionDuration;
         xdata::UnsignedInteger32 maxTriggerRate;
+        xdata::String triggerPattern;
+        xdata::String triggerRules;
+        xdata::UnsignedInteger32 triggerDeadTime;
+        xdata::Boolean useFrameTemplates;
+        xdata::UnsignedInteger32 framesPerSend;
+        xdata::UnsignedInteger32 maxThroughput;
 
         Configuration()
           : sourceHost("localhost"),
@@ -51,7 +57,13 @@ namespace evb {
             frameSize(0x40000),
             fragmentFIFOCapacity(32),
             fakeLumiSectionDuration(23),
-            maxTriggerRate(0)
+            maxTriggerRate(0),
+            triggerPattern("constant"),
+            triggerRules(""),
+            triggerDeadTime(0),
+            useFrameTemplates(false),
+            framesPerSend(1),
+            maxThroughput(0)
         {};
 
         void addToInfoSpace
@@ -76,6 +88,12 @@ namespace evb {
           params.add("fragmentFIFOCapacity", &fragmentFIFOCapacity);
           params.add("fakeLumiSectionDuration", &fakeLumiSectionDuration);
           params.add("maxTriggerRate", &maxTriggerRate, InfoSpaceItems::change);
+          params.add("triggerPattern", &triggerPattern);
+          params.add("triggerRules", &triggerRules);
+          params.add("triggerDeadTime", &triggerDeadTime);
+          params.add("useFrameTemplates", &useFrameTemplates);
+          params.add("framesPerSend", &framesPerSend);
+          params.add("maxThroughput", &maxThroughput);
         }
       };
 
@@ -7,6 +7,7 @@
 
 #include "boost/scoped_ptr.hpp"
 
+#include "evb/CRCCalculator.h"
 #include "evb/EvBid.h"
 #include "evb/EvBidFactory.h"
 #include "evb/FragmentTracker.h"
@@ -59,6 +60,10 @@ namespace evb {
          * If usePlayback is set to true, the data is read from the playbackDataFile,
          * otherwise, dummy data is generated according to the fedPayloadSize.
          * The frameSize specifies the size of the data frames.
+         * The fragments follow the triggerPattern limited to maxTriggerRate,
+         * the triggerRules and the triggerDeadTime (see TriggerPacer).
+         * If nbFrameTemplates is non-zero, the given number of frames is generated
+         * once and only the event-dependent header fields are patched for each frame.
          */
         void configure
         (
@@ -73,7 +78,11 @@ namespace evb {
           const uint32_t maxFedSize,
           const size_t fragmentPoolSize,
           const uint32_t fakeLumiSectionDuration,
-          const uint32_t maxTriggerRate
+          const uint32_t maxTriggerRate,
+          const std::string& triggerPattern,
+          const std::string& triggerRules,
+          const uint32_t triggerDeadTime,
+          const uint32_t nbFrameTemplates = 0
         );
 
         /**
@@ -119,12 +128,21 @@ namespace evb {
                       uint32_t& nbFedCRCerrors,
                       uint32_t& nbSlinkCRCerrors);
         toolbox::mem::Reference* clone(toolbox::mem::Reference*) const;
+        void createFrameTemplates(const uint32_t nbFrameTemplates);
+        void releaseFrameTemplates();
+        bool fillFromTemplate(toolbox::mem::Reference*&,
+                              const uint32_t stopAtEventNumber,
+                              uint32_t& lastEventNumber,
+                              uint32_t& skipNbEvents,
+                              uint32_t& duplicateNbEvents);
+        uint32_t patchFragment(unsigned char* fragment);
 
         EvBid evbId_;
         uint32_t frameSize_;
         uint32_t fedSize_;
         uint64_t fedId_;
         uint16_t fedCRC_;
+        bool computeCRC_;
         bool usePlayback_;
         toolbox::mem::Pool* fragmentPool_;
         uint32_t fragmentPoolSize_;
@@ -134,6 +152,17 @@ namespace evb {
         typedef std::vector<toolbox::mem::Reference*> PlaybackData;
         PlaybackData playbackData_;
         PlaybackData::const_reverse_iterator playbackDataPos_;
+
+        // frames generated once, holding complete fragments starting at the given offsets
+        struct FrameTemplate
+        {
+          toolbox::mem::Reference* bufRef;
+          std::vector<uint32_t> fragmentOffsets;
+        };
+        typedef std::vector<FrameTemplate> FrameTemplates;
+        FrameTemplates frameTemplates_;
+        uint32_t nextFrameTemplate_;
+        CRCCalculator crcCalculator_;
       };
 
     } } } //namespace evb::test::dummyFEROL
@@ -9,6 +9,7 @@
 #include <stdint.h>
 
 #include "cgicc/HTMLClasses.h"
+#include "evb/ActivityFlag.h"
 #include "evb/ApplicationDescriptorAndTid.h"
 #include "evb/EvBid.h"
 #include "evb/I2OMessages.h"
@@ -125,7 +126,7 @@ namespace evb {
       toolbox::task::ActionSignature* processRequestsAction_;
       volatile bool doProcessing_;
       volatile bool draining_;
-      volatile bool processingActive_;
+      ActivityFlag processingActive_;
 
       I2O_TID tid_;
       uint32_t ruCount_;
@@ -11,6 +11,7 @@
 #include <stdint.h>
 
 #include "cgicc/HTMLClasses.h"
+#include "evb/ActivityFlag.h"
 #include "evb/Constants.h"
 #include "evb/OneToOneQueue.h"
 #include "evb/PerformanceMonitor.h"
@@ -120,7 +121,7 @@ namespace evb {
       toolbox::task::WorkLoop* posterWL_;
       toolbox::task::ActionSignature* posterAction_;
       volatile bool doProcessing_;
-      volatile bool active_;
+      ActivityFlag active_;
 
       xdata::Vector<xdata::UnsignedInteger32> buTids_;
       xdata::Vector<xdata::UnsignedInteger64> throughputPerBU_;
@@ -257,7 +258,9 @@ void evb::readoutunit::BUposter<ReadoutUnit>::drain() const
     {
       haveFrames |= ( ! it->second->frameFIFO->empty() );
     }
-  } while ( haveFrames && ::usleep(1000) );
+
+    if ( haveFrames ) active_.waitForChange(1000);
+  } while ( haveFrames );
 }
 
 
@@ -265,7 +268,7 @@ template<class ReadoutUnit>
 void evb::readoutunit::BUposter<ReadoutUnit>::stopProcessing()
 {
   doProcessing_ = false;
-  while (active_) ::usleep(1000);
+  active_.waitUntilIdle();
 
   {
     boost::unique_lock<boost::shared_mutex> ul(buConnectionsMutex_);
@@ -4,10 +4,13 @@
 #include <boost/dynamic_bitset.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
 
 #include <set>
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include <vector>
 
 #include "cgicc/HTMLClasses.h"
@@ -17,8 +20,10 @@
 #include "evb/Exception.h"
 #include "evb/I2OMessages.h"
 #include "evb/InfoSpaceItems.h"
+#include "evb/OneToManyQueue.h"
 #include "evb/OneToOneQueue.h"
 #include "evb/PerformanceMonitor.h"
+#include "evb/SteadyStateMonitor.h"
 #include "evb/readoutunit/BUposter.h"
 #include "evb/readoutunit/Configuration.h"
 #include "evb/readoutunit/FragmentRequest.h"
@@ -42,6 +47,7 @@
 #include "xdaq/Application.h"
 #include "xdata/Boolean.h"
 #include "xdata/Double.h"
+#include "xdata/Integer32.h"
 #include "xdata/UnsignedInteger32.h"
 #include "xdata/UnsignedInteger64.h"
 #include "xdata/Vector.h"
@@ -137,10 +143,12 @@ namespace evb {
       void updateRequestCounters(const FragmentRequestPtr&);
       bool process(toolbox::task::WorkLoop*);
       bool processRequest(FragmentRequestPtr&,SuperFragments&);
+      void startAssembling() {};
+      bool assembleRequests(toolbox::task::WorkLoop*);
       void handleRequest(const msg::EventRequest*, FragmentRequestPtr&);
       void sendData(const FragmentRequestPtr&, const SuperFragments&);
       toolbox::mem::Reference* getNextBlock(const uint32_t blockNb) const;
-      void fillSuperFragmentHeader
+      msg::SuperFragment* fillSuperFragmentHeader
       (
         unsigned char*& payload,
         uint32_t& remainingPayloadSize,
@@ -148,6 +156,7 @@ namespace evb {
         const SuperFragmentPtr& superFragment,
         const uint32_t currentFragmentSize
       ) const;
+      void setCRC32c(msg::SuperFragment*, const uint32_t crc32c) const;
       bool isEmpty();
       void doLumiSectionTransition() {};
       std::string getHelpTextForBuRequests() const;
@@ -164,12 +173,26 @@ namespace evb {
       volatile bool doProcessing_;
       boost::dynamic_bitset<> processesActive_;
       boost::mutex processesActiveMutex_;
+      boost::condition_variable processesIdle_;
       uint32_t nbActiveProcesses_;
       mutable boost::mutex processingRequestMutex_;
 
       //used on the RU
       typedef OneToOneQueue<FragmentRequestPtr> FragmentRequestFIFO;
       FragmentRequestFIFO fragmentRequestFIFO_;
+      const FragmentRequestPoolPtr fragmentRequestPool_;
+      // A single assembler extracts the super fragments in the order
+      // of the requests. The responders pack and send them concurrently.
+      struct AssembledRequest
+      {
+        FragmentRequestPtr fragmentRequest;
+        SuperFragments superFragments;
+      };
+      typedef OneToManyQueue<AssembledRequest> AssembledRequestFIFO;
+      AssembledRequestFIFO assembledRequestFIFO_;
+      toolbox::task::WorkLoop* assemblingWL_;
+      toolbox::task::ActionSignature* assemblingAction_;
+      volatile bool assemblerActive_;
 
       //used on the EVM
       typedef boost::shared_ptr<FragmentRequestFIFO> FragmentRequestFIFOPtr;
@@ -206,6 +229,7 @@ namespace evb {
         uint32_t i2oRate;
         double packingFactor;
         PerformanceMonitor perf;
+        SteadyStateMonitor steadyState;
       } dataMonitoring_;
       mutable boost::mutex dataMonitoringMutex_;
 
@@ -213,6 +237,7 @@ namespace evb {
       xdata::UnsignedInteger32 requestRate_;
       xdata::UnsignedInteger32 fragmentRate_;
       xdata::UnsignedInteger64 nbEventsBuilt_;
+      xdata::Integer32 timeToSteadyState_;
 
     };
 
@@ -232,6 +257,10 @@ msgPool_(readoutUnit->getMsgPool()),
 doProcessing_(false),
 nbActiveProcesses_(0),
 fragmentRequestFIFO_(readoutUnit,"fragmentRequestFIFO"),
+fragmentRequestPool_(new FragmentRequestPool),
+assembledRequestFIFO_(readoutUnit,"assembledRequestFIFO"),
+assemblingWL_(0),
+assemblerActive_(false),
 lastLumiTransition_(0)
 {
   resetMonitoringCounters();
@@ -248,6 +277,8 @@ evb::readoutunit::BUproxy<ReadoutUnit>::~BUproxy()
     if ( (*it)->isActive() )
       (*it)->cancel();
   }
+  if ( assemblingWL_ && assemblingWL_->isActive() )
+    assemblingWL_->cancel();
 }
 
 
@@ -267,6 +298,8 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::startProcessing()
 
   doProcessing_ = true;
 
+  startAssembling();
+
   for (uint32_t i=0; i < readoutUnit_->getConfiguration()->numberOfResponders; ++i)
   {
     workLoops_.at(i)->submit(action_);
@@ -277,7 +310,11 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::startProcessing()
 template<class ReadoutUnit>
 void evb::readoutunit::BUproxy<ReadoutUnit>::drain()
 {
-  while ( ! isEmpty() ) ::usleep(1000);
+  while ( ! isEmpty() )
+  {
+    boost::mutex::scoped_lock sl(processesActiveMutex_);
+    processesIdle_.timed_wait(sl, boost::posix_time::milliseconds(1));
+  }
   buPoster_.drain();
 }
 
@@ -286,7 +323,11 @@ template<class ReadoutUnit>
 void evb::readoutunit::BUproxy<ReadoutUnit>::stopProcessing()
 {
   doProcessing_ = false;
-  while ( processesActive_.any() ) ::usleep(1000);
+  {
+    boost::mutex::scoped_lock sl(processesActiveMutex_);
+    while ( processesActive_.any() || assemblerActive_ ) processesIdle_.wait(sl);
+  }
+  assembledRequestFIFO_.clear();
   buPoster_.stopProcessing();
 }
 
@@ -312,7 +353,7 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::readoutMsgCallback(toolbox::mem::Re
     {
       nbRequests += eventRequest->nbRequests;
       ++nbRequestMsg;
-      FragmentRequestPtr fragmentRequest( new FragmentRequest );
+      FragmentRequestPtr fragmentRequest = fragmentRequestPool_->get();
       fragmentRequest->buTid = eventRequest->buTid;
       fragmentRequest->buResourceId = eventRequest->buResourceId;
       fragmentRequest->timeStampNS = eventRequest->timeStampNS;
@@ -378,6 +419,7 @@ bool evb::readoutunit::BUproxy<ReadoutUnit>::process(toolbox::task::WorkLoop* wl
     {
       boost::mutex::scoped_lock sl(processesActiveMutex_);
       processesActive_.reset(responderId);
+      processesIdle_.notify_all();
     }
     readoutUnit_->getStateMachine()->processFSMEvent( Fail(e) );
   }
@@ -386,6 +428,7 @@ bool evb::readoutunit::BUproxy<ReadoutUnit>::process(toolbox::task::WorkLoop* wl
     {
       boost::mutex::scoped_lock sl(processesActiveMutex_);
       processesActive_.reset(responderId);
+      processesIdle_.notify_all();
     }
     XCEPT_DECLARE(exception::SuperFragment,
                   sentinelException, e.what());
@@ -396,6 +439,7 @@ bool evb::readoutunit::BUproxy<ReadoutUnit>::process(toolbox::task::WorkLoop* wl
     {
       boost::mutex::scoped_lock sl(processesActiveMutex_);
       processesActive_.reset(responderId);
+      processesIdle_.notify_all();
     }
     XCEPT_DECLARE(exception::SuperFragment,
                   sentinelException, "unkown exception");
@@ -405,6 +449,7 @@ bool evb::readoutunit::BUproxy<ReadoutUnit>::process(toolbox::task::WorkLoop* wl
   {
     boost::mutex::scoped_lock sl(processesActiveMutex_);
     processesActive_.reset(responderId);
+    processesIdle_.notify_all();
   }
 
   ::usleep(10);
@@ -437,27 +482,37 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::sendData
   unsigned char* payload = (unsigned char*)head->getDataLocation() + blockHeaderSize;
   uint32_t remainingPayloadSize = readoutUnit_->getConfiguration()->blockSize - blockHeaderSize;
 
+  // The CRC32c of each part of a super fragment is calculated while copying
+  // the data. The BU combines these instead of reading the data again.
+  uint32_t crc32c = 0;
+  uint32_t* partCRC32c = readoutUnit_->getConfiguration()->calculateCRC32c ? &crc32c : 0;
+
   for (uint32_t i=0; i < nbSuperFragments; ++i)
   {
     const SuperFragmentPtr superFragment = superFragments[i];
     uint32_t remainingSuperFragmentSize = superFragment->getSize();
 
-    fillSuperFragmentHeader(payload,remainingPayloadSize,i+1,superFragment,remainingSuperFragmentSize);
+    msg::SuperFragment* superFragmentMsg =
+      fillSuperFragmentHeader(payload,remainingPayloadSize,i+1,superFragment,remainingSuperFragmentSize);
+    crc32c = 0;
 
     const SuperFragment::FedFragments& fedFragments = superFragment->getFedFragments();
     for ( SuperFragment::FedFragments::const_iterator it = fedFragments.begin(), itEnd = fedFragments.end();
           it != itEnd; ++it)
     {
       uint32_t copiedSize = 0;
-      while ( ! (*it)->fillData(payload,remainingPayloadSize,copiedSize) )
+      while ( ! (*it)->fillData(payload,remainingPayloadSize,copiedSize,partCRC32c) )
       {
         // not all data fit into the remainingPayloadSize
         // get a new block
         remainingSuperFragmentSize -= copiedSize;
+        if ( partCRC32c ) setCRC32c(superFragmentMsg,crc32c);
         toolbox::mem::Reference* nextBlock = getNextBlock(++blockNb);
         payload = (unsigned char*)nextBlock->getDataLocation() + sizeof(msg::I2O_DATA_BLOCK_MESSAGE_FRAME);
         remainingPayloadSize = readoutUnit_->getConfiguration()->blockSize - sizeof(msg::I2O_DATA_BLOCK_MESSAGE_FRAME);
-        fillSuperFragmentHeader(payload,remainingPayloadSize,i+1,superFragment,remainingSuperFragmentSize);
+        superFragmentMsg =
+          fillSuperFragmentHeader(payload,remainingPayloadSize,i+1,superFragment,remainingSuperFragmentSize);
+        crc32c = 0;
         tail->setNextReference(nextBlock);
         tail = nextBlock;
       }
@@ -467,7 +522,17 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::sendData
 
       const fedt_t* trailer = (fedt_t*)(payload - sizeof(fedt_t));
       assert ( FED_TCTRLID_EXTRACT(trailer->eventsize) == FED_SLINK_END_MARKER );
+
+      try
+      {
+        (*it)->checkCopiedCRC();
+      }
+      catch(exception::CRCerror& e)
+      {
+        input_->handleCRCerror(*it,e);
+      }
     }
+    if ( partCRC32c ) setCRC32c(superFragmentMsg,crc32c);
   }
   tail->setDataSize( readoutUnit_->getConfiguration()->blockSize - remainingPayloadSize );
 
@@ -497,6 +562,7 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::sendData
     pvtMsg->OrganizationID         = XDAQ_ORGANIZATION_ID;
     pvtMsg->XFunctionCode          = I2O_BU_CACHE;
     dataBlockMsg->buResourceId     = fragmentRequest->buResourceId;
+    dataBlockMsg->version          = msg::dataBlockVersion;
     dataBlockMsg->timeStampNS      = fragmentRequest->timeStampNS;
     dataBlockMsg->nbBlocks         = blockNb;
     dataBlockMsg->nbSuperFragments = nbSuperFragments;
@@ -547,6 +613,7 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::sendData
     dataMonitoring_.perf.sumOfSizes += payloadSize;
     dataMonitoring_.perf.sumOfSquares += payloadSize*payloadSize;
     dataMonitoring_.perf.logicalCount += nbSuperFragments;
+    dataMonitoring_.steadyState.eventsDone(nbSuperFragments);
   }
 
   if ( lumiTransition )
@@ -586,7 +653,7 @@ toolbox::mem::Reference* evb::readoutunit::BUproxy<ReadoutUnit>::getNextBlock
 
 
 template<class ReadoutUnit>
-void evb::readoutunit::BUproxy<ReadoutUnit>::fillSuperFragmentHeader
+evb::msg::SuperFragment* evb::readoutunit::BUproxy<ReadoutUnit>::fillSuperFragmentHeader
 (
   unsigned char*& payload,
   uint32_t& remainingPayloadSize,
@@ -597,16 +664,16 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::fillSuperFragmentHeader
 {
   const SuperFragment::MissingFedIds& missingFedIds = superFragment->getMissingFedIds();
   const uint16_t nbDroppedFeds = missingFedIds.size();
-  const uint32_t headerSize = sizeof(msg::SuperFragment)
-    + ((nbDroppedFeds-1 + 3) / 4) * sizeof(uint64_t);
-  // Keep 64-bit alignment if nbDroppedFeds > 1.
+  const uint32_t headerSize =
+    ((offsetof(msg::SuperFragment,fedIds) + nbDroppedFeds*sizeof(uint16_t) + 7) / 8) * sizeof(uint64_t);
+  // Keep 64-bit alignment of the payload.
   // ceil(x/y) can be expressed as (x+y-1)/y for positive integers
   assert( headerSize % 8 == 0 );
 
   if ( remainingPayloadSize < headerSize )
   {
     remainingPayloadSize = 0;
-    return;
+    return 0;
   }
 
   msg::SuperFragment* superFragmentMsg = (msg::SuperFragment*)payload;
@@ -618,9 +685,28 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::fillSuperFragmentHeader
   superFragmentMsg->superFragmentNb = superFragmentNb;
   superFragmentMsg->totalSize = superFragment->getSize();
   superFragmentMsg->partSize = currentFragmentSize > remainingPayloadSize ? remainingPayloadSize : currentFragmentSize;
+  superFragmentMsg->crc32c = 0;
+  superFragmentMsg->hasCRC32c = 0;
   superFragmentMsg->nbDroppedFeds = nbDroppedFeds;
 
   memcpy(&superFragmentMsg->fedIds[0],&missingFedIds[0],nbDroppedFeds*sizeof(uint16_t));
+
+  return superFragmentMsg;
+}
+
+
+template<class ReadoutUnit>
+void evb::readoutunit::BUproxy<ReadoutUnit>::setCRC32c
+(
+  msg::SuperFragment* superFragmentMsg,
+  const uint32_t crc32c
+) const
+{
+  // there is no header if the block was full
+  if ( ! superFragmentMsg ) return;
+
+  superFragmentMsg->crc32c = crc32c;
+  superFragmentMsg->hasCRC32c = 1;
 }
 
 
@@ -632,7 +718,20 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::configure()
 
      fragmentRequestFIFO_.clear();
      fragmentRequestFIFO_.resize(readoutUnit_->getConfiguration()->fragmentRequestFIFOCapacity);
-     fragmentRequestFIFOs_.clear();
+     assembledRequestFIFO_.clear();
+     assembledRequestFIFO_.resize(readoutUnit_->getConfiguration()->assembledRequestFIFOCapacity);
+
+     // keep the FIFOs of known BUs to avoid reallocating them when reconfiguring
+     for (typename FragmentRequestFIFOs::iterator it = fragmentRequestFIFOs_.begin(), itEnd = fragmentRequestFIFOs_.end();
+          it != itEnd; ++it)
+     {
+       for (typename PrioritizedFragmentRequestFIFOs::iterator fifo = it->second.begin(), fifoEnd = it->second.end();
+            fifo != fifoEnd; ++fifo)
+       {
+         (*fifo)->clear();
+         (*fifo)->resize(readoutUnit_->getConfiguration()->fragmentRequestFIFOCapacity);
+       }
+     }
      nextBU_ = fragmentRequestFIFOs_.begin();
   }
   {
@@ -640,15 +739,22 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::configure()
     requestMonitoring_.activeRequests = 0;
   }
 
+  // the pool depends on the configuration, e.g. when using hugepages
+  msgPool_ = readoutUnit_->getMsgPool();
+
   if ( readoutUnit_->getConfiguration()->numberOfPreallocatedBlocks.value_ > 0 )
   {
+    // touch the blocks such that the pool hands out memory which does not page fault
+    const uint32_t blockSize = readoutUnit_->getConfiguration()->blockSize;
     toolbox::mem::Reference* head =
-      toolbox::mem::getMemoryPoolFactory()->getFrame(msgPool_,readoutUnit_->getConfiguration()->blockSize);
+      toolbox::mem::getMemoryPoolFactory()->getFrame(msgPool_,blockSize);
+    memset(head->getDataLocation(),0,blockSize);
     toolbox::mem::Reference* tail = head;
     for (uint32_t i = 1; i < readoutUnit_->getConfiguration()->numberOfPreallocatedBlocks; ++i)
     {
       toolbox::mem::Reference* bufRef =
-        toolbox::mem::getMemoryPoolFactory()->getFrame(msgPool_,readoutUnit_->getConfiguration()->blockSize);
+        toolbox::mem::getMemoryPoolFactory()->getFrame(msgPool_,blockSize);
+      memset(bufRef->getDataLocation(),0,blockSize);
       tail->setNextReference(bufRef);
       tail = bufRef;
     }
@@ -707,11 +813,13 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::appendMonitoringItems(InfoSpaceItem
   requestRate_ = 0;
   fragmentRate_ = 0;
   nbEventsBuilt_ = 0;
+  timeToSteadyState_ = -1;
 
   items.add("activeRequests", &activeRequests_);
   items.add("requestRate", &requestRate_);
   items.add("fragmentRate", &fragmentRate_);
   items.add("nbEventsBuilt", &nbEventsBuilt_);
+  items.add("timeToSteadyState", &timeToSteadyState_);
 
   buPoster_.appendMonitoringItems(items);
 }
@@ -744,6 +852,7 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::updateMonitoringItems()
     dataMonitoring_.packingFactor = dataMonitoring_.perf.packingFactor();
     fragmentRate_ = dataMonitoring_.i2oRate;
     nbEventsBuilt_ = dataMonitoring_.nbEventsBuilt;
+    timeToSteadyState_ = dataMonitoring_.steadyState.getTimeToSteadyState();
     dataMonitoring_.perf.reset();
   }
   {
@@ -770,6 +879,7 @@ void evb::readoutunit::BUproxy<ReadoutUnit>::resetMonitoringCounters()
     dataMonitoring_.fragmentCount = 0;
     dataMonitoring_.nbEventsBuilt = 0;
     dataMonitoring_.perf.reset();
+    dataMonitoring_.steadyState.start();
   }
 }
 
@@ -841,12 +951,16 @@ cgicc::div evb::readoutunit::BUproxy<ReadoutUnit>::getHtmlSnipped() const
     table.add(tr()
               .add(td("fragment rate (Hz)"))
               .add(td(boost::lexical_cast<std::string>(dataMonitoring_.fragmentRate))));
+    table.add(tr()
+              .add(td("time to steady state (ms)"))
+              .add(td(timeToSteadyState_.value_ < 0 ? "n/a" : boost::lexical_cast<std::string>(timeToSteadyState_))));
     table.add(tr()
               .add(td("I2O rate (Hz)"))
               .add(td(boost::lexical_cast<std::string>(dataMonitoring_.i2oRate))));
     table.add(tr()
               .add(td("Fragments/I2O"))
               .add(td(doubleToString(dataMonitoring_.packingFactor,1))));
+    addMemoryPoolRows(table, msgPool_, "msg pool");
     div.add(table);
   }
 
@@ -879,6 +993,7 @@ cgicc::div evb::readoutunit::BUproxy<ReadoutUnit>::getHtmlSnipped() const
     if ( fragmentRequestFIFOs_.empty() )
     {
       div.add(fragmentRequestFIFO_.getHtmlSnipped());
+      div.add(assembledRequestFIFO_.getHtmlSnipped());
     }
     else
     {
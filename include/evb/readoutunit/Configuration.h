@@ -12,8 +12,10 @@
 #include "xdata/Bag.h"
 #include "xdata/Boolean.h"
 #include "xdata/Double.h"
+#include "xdata/Integer32.h"
 #include "xdata/String.h"
 #include "xdata/UnsignedInteger32.h"
+#include "xdata/UnsignedInteger64.h"
 #include "xdata/Vector.h"
 
 
@@ -70,6 +72,9 @@ namespace evb {
       typedef xdata::Vector< xdata::Bag<FerolSource> > FerolSources;
 
       xdata::String sendPoolName;                            // The pool name used for evb messages
+      xdata::UnsignedInteger32 hugePageSize;                 // Size in kB of the hugepages backing the message and metaData pools (2048 or 1048576). 0 uses the heap
+      xdata::UnsignedInteger64 msgPoolSize;                  // Size in Bytes of the message pool when backed by hugepages
+      xdata::Integer32 numaNode;                             // NUMA node for the hugepage-backed pools. -1 uses the default memory policy
       xdata::String inputSource;                             // Input mode selection: Socket or Local
       xdata::UnsignedInteger32 numberOfResponders;           // Number of threads handling responses to BUs
       xdata::UnsignedInteger32 blockSize;                    // I2O block size used for sending events to BUs
@@ -78,7 +83,9 @@ namespace evb {
       xdata::UnsignedInteger32 grantFIFOCapacity;            // Capacity of the FIFO used to grant buffers per pipe
       xdata::UnsignedInteger32 fragmentFIFOCapacity;         // Capacity of the FIFO used to store FED data fragments
       xdata::UnsignedInteger32 fragmentRequestFIFOCapacity;  // Capacity of the FIFO to store incoming fragment requests
+      xdata::UnsignedInteger32 assembledRequestFIFOCapacity; // Capacity of the FIFO holding the requests with their super fragments for the responders (rounded up to a power of 2)
       xdata::UnsignedInteger32 checkCRC;                     // Check the CRC of the FED fragments for every Nth event
+      xdata::Boolean calculateCRC32c;                        // If set to true, the CRC32c of the super fragments is calculated when copying them for the BU
       xdata::UnsignedInteger32 writeNextFragmentsToFile;     // Write the next N fragments to text files
       xdata::Boolean dropAtSocket;                           // If set to true, data is discarded after reading from the socket
       xdata::Boolean dropInputData;                          // If set to true, the input data is dropped
@@ -87,6 +94,9 @@ namespace evb {
       xdata::String playbackDataFile;                        // Path to the file used for data playback (not implemented)
       xdata::UnsignedInteger32 dummyFedSizeMin;              // Minimum size of the FED data when using the log-normal distrubution
       xdata::UnsignedInteger32 dummyFedSizeMax;              // Maximum size of the FED data when using the log-normal distrubution
+      xdata::String triggerPattern;                          // Pattern of locally generated triggers: constant, poisson, or bunchTrain
+      xdata::String triggerRules;                            // Trigger rules for local triggers as comma-separated list of 'N/W': at most N triggers in W bunch crossings
+      xdata::UnsignedInteger32 triggerDeadTime;              // Dead time in ns after each locally generated trigger
       xdata::String dipNodes;                                // Comma-separated list of DIP nodes
       xdata::String maskedDipTopics;                         // DIP topics which will not be considered
       xdata::UnsignedInteger32 fragmentPoolSize;             // Size of the toolbox::mem::Pool in Bytes used for dummy events
@@ -97,6 +107,8 @@ namespace evb {
       xdata::Boolean tolerateCorruptedEvents;                // Tolerate corrupted FED data (excluding CRC errors)
       xdata::Boolean tolerateOutOfSequenceEvents;            // Tolerate events out of sequence
       xdata::UnsignedInteger32 maxDumpsPerFED;               // Maximum number of fragment dumps per FED and run
+      xdata::UnsignedInteger32 maxDumpsPerSecond;            // Maximum rate of fragment dumps from all FEDs. Additional dumps are dropped
+      xdata::UnsignedInteger32 dumpFIFOCapacity;             // Maximum number of fragment dumps waiting to be written
       xdata::UnsignedInteger32 ferolConnectTimeOut;          // Timeout in seconds when waiting for FEROL connections
       xdata::UnsignedInteger32 maxTimeWithIncompleteEvents;  // Build incomplete events for at most this time in seconds
       xdata::UnsignedInteger32 maxPostRetries;               // Max. attempts to post an I2O message
@@ -104,6 +116,9 @@ namespace evb {
 
       Configuration()
         : sendPoolName("sudapl"),
+          hugePageSize(0),
+          msgPoolSize(1073741824),
+          numaNode(-1),
           inputSource("Socket"),
           numberOfResponders(6),
           blockSize(65536),
@@ -112,7 +127,9 @@ namespace evb {
           grantFIFOCapacity(4096),
           fragmentFIFOCapacity(512),
           fragmentRequestFIFOCapacity(2048),
+          assembledRequestFIFOCapacity(64),
           checkCRC(1),
+          calculateCRC32c(true),
           writeNextFragmentsToFile(0),
           dropAtSocket(false),
           dropInputData(false),
@@ -121,6 +138,9 @@ namespace evb {
           playbackDataFile(""),
           dummyFedSizeMin(16), // minimum is 16 Bytes
           dummyFedSizeMax(0), // no limitation
+          triggerPattern("constant"),
+          triggerRules(""),
+          triggerDeadTime(0),
           dipNodes("cmsdimns1.cern.ch,cmsdimns2.cern.ch"),
           maskedDipTopics(""),
           fragmentPoolSize(200000000),
@@ -129,6 +149,8 @@ namespace evb {
           tolerateCorruptedEvents(false),
           tolerateOutOfSequenceEvents(false),
           maxDumpsPerFED(10),
+          maxDumpsPerSecond(10),
+          dumpFIFOCapacity(16),
           ferolConnectTimeOut(5),
           maxTimeWithIncompleteEvents(60),
           maxPostRetries(10)
@@ -141,6 +163,9 @@ namespace evb {
       )
       {
         params.add("sendPoolName", &sendPoolName);
+        params.add("hugePageSize", &hugePageSize);
+        params.add("msgPoolSize", &msgPoolSize);
+        params.add("numaNode", &numaNode);
         params.add("inputSource", &inputSource);
         params.add("numberOfResponders", &numberOfResponders);
         params.add("blockSize", &blockSize);
@@ -149,7 +174,9 @@ namespace evb {
         params.add("grantFIFOCapacity", &grantFIFOCapacity);
         params.add("fragmentFIFOCapacity", &fragmentFIFOCapacity);
         params.add("fragmentRequestFIFOCapacity", &fragmentRequestFIFOCapacity);
+        params.add("assembledRequestFIFOCapacity", &assembledRequestFIFOCapacity);
         params.add("checkCRC", &checkCRC);
+        params.add("calculateCRC32c", &calculateCRC32c);
         params.add("writeNextFragmentsToFile", &writeNextFragmentsToFile, InfoSpaceItems::change);
         params.add("dropAtSocket", &dropAtSocket);
         params.add("dropInputData", &dropInputData);
@@ -158,6 +185,9 @@ namespace evb {
         params.add("playbackDataFile", &playbackDataFile);
         params.add("dummyFedSizeMin", &dummyFedSizeMin);
         params.add("dummyFedSizeMax", &dummyFedSizeMax);
+        params.add("triggerPattern", &triggerPattern);
+        params.add("triggerRules", &triggerRules);
+        params.add("triggerDeadTime", &triggerDeadTime);
         params.add("dipNodes", &dipNodes);
         params.add("maskedDipTopics", &maskedDipTopics);
         params.add("fragmentPoolSize", &fragmentPoolSize);
@@ -168,6 +198,8 @@ namespace evb {
         params.add("tolerateCorruptedEvents", &tolerateCorruptedEvents);
         params.add("tolerateOutOfSequenceEvents", &tolerateOutOfSequenceEvents);
         params.add("maxDumpsPerFED", &maxDumpsPerFED);
+        params.add("maxDumpsPerSecond", &maxDumpsPerSecond);
+        params.add("dumpFIFOCapacity", &dumpFIFOCapacity);
         params.add("ferolConnectTimeOut", &ferolConnectTimeOut);
         params.add("maxTimeWithIncompleteEvents", &maxTimeWithIncompleteEvents);
         params.add("maxPostRetries", &maxPostRetries);
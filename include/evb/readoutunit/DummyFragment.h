@@ -36,7 +36,7 @@ namespace evb {
       );
       ~DummyFragment();
 
-      virtual bool fillData(unsigned char* payload, const uint32_t remainingPayloadSize, uint32_t& copiedSize);
+      virtual bool fillData(unsigned char* payload, const uint32_t remainingPayloadSize, uint32_t& copiedSize, uint32_t* crc32c);
 
     private:
 
@@ -10,6 +10,7 @@
 
 #include "evb/CRCCalculator.h"
 #include "evb/DataLocations.h"
+#include "evb/Dumper.h"
 #include "evb/EvBid.h"
 #include "evb/EvBidFactory.h"
 #include "evb/readoutunit/SocketBuffer.h"
@@ -38,6 +39,7 @@ namespace evb {
         const std::string& subSystem,
         const EvBidFactoryPtr&,
         const uint32_t checkCRC,
+        const bool deferCRCcheck,
         uint32_t* fedErrorCount,
         uint32_t* crcErrors
       );
@@ -65,9 +67,21 @@ namespace evb {
       bool isComplete() const { return isComplete_; }
       toolbox::mem::Reference* getBufRef() const { return bufRef_; }
       uint32_t getFedSize() const { return fedSize_; }
-      void dump(std::ostream&, const std::string& reasonForDump);
+      void dump(Dump&, const std::string& reasonForDump);
 
-      virtual bool fillData(unsigned char* payload, const uint32_t remainingPayloadSize, uint32_t& copiedSize);
+      /**
+       * Copy the fragment data into the payload. If crc32c is not null,
+       * it is updated with the copied data. Return true once the whole
+       * fragment has been copied.
+       */
+      virtual bool fillData(unsigned char* payload, const uint32_t remainingPayloadSize, uint32_t& copiedSize, uint32_t* crc32c);
+
+      /**
+       * Compare the FED CRC calculated while copying the data with the
+       * one found in the FED trailer. A CRCerror is raised for every
+       * Fibonacci-th mismatch.
+       */
+      void checkCopiedCRC();
 
 
     protected:
@@ -98,14 +112,20 @@ namespace evb {
     private:
 
       bool parse(toolbox::mem::Reference*, uint32_t& usedSize);
+      bool parseCompleteFragment(const unsigned char* pos, const uint32_t bufferSize, uint32_t& usedSize);
+      void finishFragment(fedt_t*);
       void checkFerolHeader(const ferolh_t*);
       void checkFedHeader(const fedh_t*);
       void checkFedTrailer(fedt_t*);
       void checkCRC(fedt_t*);
+      void compareCRC(const uint32_t conscheck, const uint16_t crc);
+      void copyData(unsigned char* dest, const unsigned char* src, uint32_t size, uint32_t* crc32c);
+      void updateCRC(const unsigned char* data, uint32_t size);
       void checkTrailerBits(const uint32_t conscheck);
       void reportErrors() const;
 
       const uint32_t checkCRC_;
+      const bool deferCRCcheck_;
       uint32_t* fedErrorCount_;
       uint32_t* crcErrors_;
       const bool isMasterFed_;
@@ -124,6 +144,13 @@ namespace evb {
 
       bool isLastFerolHeader_;
       uint32_t payloadLength_;
+
+      bool crcPending_;
+      uint16_t crc_;
+      uint32_t crcSize_;
+      fedt_t fedTrailer_;
+      unsigned char crcCarry_[8];
+      uint32_t crcCarrySize_;
     };
 
     typedef boost::shared_ptr<FedFragment> FedFragmentPtr;
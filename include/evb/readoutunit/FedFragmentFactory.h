@@ -6,6 +6,7 @@
 #include <stdint.h>
 
 #include "evb/CRCCalculator.h"
+#include "evb/Dumper.h"
 #include "evb/EvBid.h"
 #include "evb/EvBidFactory.h"
 #include "evb/readoutunit/DummyFragment.h"
@@ -39,7 +40,8 @@ namespace evb {
       bool append(FedFragmentPtr&, SocketBufferPtr&, uint32_t& usedSize);
 
       void reset(const uint32_t runNumber);
-      void writeFragmentToFile(const FedFragmentPtr&,const std::string& reasonFordump) const;
+      void writeFragmentToFile(const FedFragmentPtr&,const std::string& reasonFordump,const bool force=false) const;
+      void handleCRCerror(const FedFragmentPtr&,exception::CRCerror&);
 
       uint32_t getCorruptedEvents() const { return fedErrors_.corruptedEvents; }
       uint32_t getEventsOutOfSequence() const { return fedErrors_.eventsOutOfSequence; }
@@ -168,6 +170,8 @@ evb::readoutunit::FedFragmentPtr evb::readoutunit::FedFragmentFactory<ReadoutUni
                     readoutUnit_->getSubSystem(),
                     evbIdFactory_,
                     readoutUnit_->getConfiguration()->checkCRC,
+                    // the CRC is checked while copying the data for the BUs unless the data is dropped
+                    ! readoutUnit_->getConfiguration()->dropInputData,
                     &(fedErrors_.fedErrors),
                     &(fedErrors_.crcErrors)
     )
@@ -218,12 +222,7 @@ bool evb::readoutunit::FedFragmentFactory<ReadoutUnit>::errorHandler(const FedFr
   }
   catch(exception::CRCerror& e)
   {
-    LOG4CPLUS_ERROR(readoutUnit_->getApplicationLogger(),
-                    xcept::stdformat_exception_history(e));
-    readoutUnit_->notifyQualified("error",e);
-
-    if ( ++fedErrors_.nbDumps <= readoutUnit_->getConfiguration()->maxDumpsPerFED )
-      writeFragmentToFile(fedFragment,e.message());
+    handleCRCerror(fedFragment,e);
   }
   catch(exception::DataCorruption& e)
   {
@@ -239,7 +238,7 @@ bool evb::readoutunit::FedFragmentFactory<ReadoutUnit>::errorHandler(const FedFr
     }
     else
     {
-      writeFragmentToFile(fedFragment,e.message());
+      writeFragmentToFile(fedFragment,e.message(),true);
       throw e;
     }
   }
@@ -257,7 +256,7 @@ bool evb::readoutunit::FedFragmentFactory<ReadoutUnit>::errorHandler(const FedFr
     }
     else
     {
-      writeFragmentToFile(fedFragment,e.message());
+      writeFragmentToFile(fedFragment,e.message(),true);
       readoutUnit_->getStateMachine()->processFSMEvent( EventOutOfSequence(e) );
     }
   }
@@ -269,7 +268,7 @@ bool evb::readoutunit::FedFragmentFactory<ReadoutUnit>::errorHandler(const FedFr
     XCEPT_DECLARE_NESTED(exception::TCDS, sentinelException,
                          msg.str(),e);
     msg << ": " << e.message();
-    writeFragmentToFile(fedFragment,msg.str());
+    writeFragmentToFile(fedFragment,msg.str(),true);
 
     throw sentinelException;
   }
@@ -278,22 +277,37 @@ bool evb::readoutunit::FedFragmentFactory<ReadoutUnit>::errorHandler(const FedFr
 }
 
 
+template<class ReadoutUnit>
+void evb::readoutunit::FedFragmentFactory<ReadoutUnit>::handleCRCerror
+(
+  const FedFragmentPtr& fedFragment,
+  exception::CRCerror& e
+)
+{
+  LOG4CPLUS_ERROR(readoutUnit_->getApplicationLogger(),
+                  xcept::stdformat_exception_history(e));
+  readoutUnit_->notifyQualified("error",e);
+
+  // the CRC of fragments sent to the BUs is checked by the responder threads
+  if ( __sync_add_and_fetch(&fedErrors_.nbDumps,1) <= readoutUnit_->getConfiguration()->maxDumpsPerFED )
+    writeFragmentToFile(fedFragment,e.message());
+}
+
+
 template<class ReadoutUnit>
 void evb::readoutunit::FedFragmentFactory<ReadoutUnit>::writeFragmentToFile
 (
   const FedFragmentPtr& fragment,
-  const std::string& reasonForDump
+  const std::string& reasonForDump,
+  const bool force
 ) const
 {
-  std::ostringstream fileName;
-  fileName << "/tmp/dump_run" << std::setfill('0') << std::setw(6) << runNumber_
-    << "_event" << std::setw(8) << fragment->getEventNumber()
-    << "_fed" << std::setw(4) << fragment->getFedId()
-    << ".txt";
-  std::ofstream dumpFile;
-  dumpFile.open(fileName.str().c_str());
-  fragment->dump(dumpFile,reasonForDump);
-  dumpFile.close();
+  const DumperPtr dumper = readoutUnit_->getDumper();
+  if ( ! dumper->accept(force) ) return;
+
+  const DumpPtr dump( new Dump(runNumber_,fragment->getEventNumber(),fragment->getFedId()) );
+  fragment->dump(*dump,reasonForDump);
+  dumper->write(dump);
 }
 
 
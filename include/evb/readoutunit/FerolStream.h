@@ -81,17 +81,18 @@ namespace evb {
       void useAsMaster()
       { isMasterStream_ = true; }
 
-      /**
-       * Set the trigger rate for generating events
-       */
-      virtual void setMaxTriggerRate(const uint32_t maxTriggerRate) {};
-
       /**
        * Write the next count FED fragments to a text file
        */
       void writeNextFragmentsToFile(const uint16_t count)
       { writeNextFragments_ = count; }
 
+      /**
+       * Report the CRC error found while sending the FED fragment to the BU
+       */
+      void handleCRCerror(const FedFragmentPtr& fedFragment, exception::CRCerror& e)
+      { fedFragmentFactory_.handleCRCerror(fedFragment,e); }
+
       /**
        * Set the event number at which the generator shall stop
        */
@@ -252,7 +253,7 @@ void evb::readoutunit::FerolStream<ReadoutUnit,Configuration>::maybeDumpFragment
 {
   if ( writeNextFragments_ > 0 )
   {
-    fedFragmentFactory_.writeFragmentToFile(fragment,"Requested by user");
+    fedFragmentFactory_.writeFragmentToFile(fragment,"Requested by user",true);
     --writeNextFragments_;
   }
 }
@@ -356,7 +357,7 @@ void evb::readoutunit::FerolStream<ReadoutUnit,Configuration>::appendFedFragment
   }
   catch(exception::MismatchDetected& e)
   {
-    fedFragmentFactory_.writeFragmentToFile(fedFragment,e.message());
+    fedFragmentFactory_.writeFragmentToFile(fedFragment,e.message(),true);
     syncLoss_ = true;
 
     if ( readoutUnit_->getConfiguration()->tolerateOutOfSequenceEvents
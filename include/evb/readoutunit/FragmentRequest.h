@@ -4,6 +4,10 @@
 #include <stdint.h>
 #include <vector>
 
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
 #include "evb/EvBid.h"
 #include "i2o/i2oDdmLib.h"
 
@@ -25,6 +29,34 @@ namespace evb {
 
     typedef boost::shared_ptr<FragmentRequest> FragmentRequestPtr;
 
+
+    /**
+     * Hands out fragment requests which return to the pool when the last
+     * FragmentRequestPtr goes away. The id vectors keep their memory, so
+     * they are not re-allocated for each request.
+     */
+    class FragmentRequestPool : public boost::enable_shared_from_this<FragmentRequestPool>
+    {
+    public:
+
+      ~FragmentRequestPool();
+
+      /**
+       * Return an unused fragment request with empty id vectors
+       */
+      FragmentRequestPtr get();
+
+    private:
+
+      void recycle(FragmentRequest*);
+
+      typedef std::vector<FragmentRequest*> FragmentRequests;
+      FragmentRequests unusedRequests_;
+      boost::mutex mutex_;
+    };
+
+    typedef boost::shared_ptr<FragmentRequestPool> FragmentRequestPoolPtr;
+
     inline std::ostream& operator<<
     (
       std::ostream& str,
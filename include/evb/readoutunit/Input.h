@@ -18,6 +18,7 @@
 #include <string.h>
 
 #include "cgicc/HTMLClasses.h"
+#include "evb/ActivityFlag.h"
 #include "evb/Constants.h"
 #include "evb/DataLocations.h"
 #include "evb/DumpUtility.h"
@@ -25,6 +26,7 @@
 #include "evb/EvBidFactory.h"
 #include "evb/Exception.h"
 #include "evb/InfoSpaceItems.h"
+#include "evb/LumiSectionCounters.h"
 #include "evb/OneToOneQueue.h"
 #include "evb/PerformanceMonitor.h"
 #include "evb/readoutunit/FerolStream.h"
@@ -32,6 +34,7 @@
 #include "evb/readoutunit/MetaDataStream.h"
 #include "evb/readoutunit/InputMonitor.h"
 #include "evb/readoutunit/StateMachine.h"
+#include "evb/TriggerPacer.h"
 #include "interface/shared/ferol_header.h"
 #include "interface/shared/i2ogevb2g.h"
 #include "log4cplus/loggingmacros.h"
@@ -134,6 +137,11 @@ namespace evb {
        */
       void writeNextFragmentsToFile(const uint16_t count, const uint16_t fedId=FED_COUNT+1);
 
+      /**
+       * Report the CRC error found while sending the FED fragment to the BU
+       */
+      void handleCRCerror(const FedFragmentPtr&, exception::CRCerror&);
+
       /**
        * Stop generating local events at the given event number
        */
@@ -193,21 +201,21 @@ namespace evb {
 
       ReadoutUnit* readoutUnit_;
       MetaDataRetrieverPtr metaDataRetriever_;
+      const TriggerPacerPtr triggerPacer_;
 
       FerolStreams ferolStreams_;
       mutable boost::shared_mutex ferolStreamsMutex_;
       typename FerolStreams::iterator masterStream_;
 
-      typedef std::map<uint32_t,uint32_t> LumiCounterMap;
-      LumiCounterMap lumiCounterMap_;
-      LumiCounterMap::iterator currentLumiCounter_;
-      boost::mutex lumiCounterMutex_;
+      // only the thread handing out super fragments opens and counts lumi sections
+      LumiSectionCounters lumiCounters_;
+      uint32_t currentLumiSection_;
 
       uint32_t runNumber_;
 
       toolbox::task::WorkLoop* dummySuperFragmentWL_;
       toolbox::task::ActionSignature* dummySuperFragmentAction_;
-      volatile bool buildDummySuperFragmentActive_;
+      ActivityFlag buildDummySuperFragmentActive_;
 
       InputMonitor superFragmentMonitor_;
       mutable boost::mutex superFragmentMonitorMutex_;
@@ -244,6 +252,8 @@ evb::readoutunit::Input<ReadoutUnit,Configuration>::Input
   ReadoutUnit* readoutUnit
 ) :
 readoutUnit_(readoutUnit),
+triggerPacer_(new TriggerPacer()),
+currentLumiSection_(0),
 runNumber_(0),
 buildDummySuperFragmentActive_(false),
 incompleteEvents_(0)
@@ -371,39 +381,27 @@ void evb::readoutunit::Input<ReadoutUnit,Configuration>::updateSuperFragmentCoun
       ++incompleteEvents_;
   }
 
+  const uint32_t lumiSection = superFragment->getEvBid().lumiSection();
+  if ( lumiSection > currentLumiSection_ )
   {
-    boost::mutex::scoped_lock sl(lumiCounterMutex_);
-
-    const uint32_t lumiSection = superFragment->getEvBid().lumiSection();
-    for(uint32_t ls = currentLumiCounter_->first+1; ls <= lumiSection; ++ls)
-    {
-      const std::pair<LumiCounterMap::iterator,bool> result =
-        lumiCounterMap_.insert(LumiCounterMap::value_type(ls,0));
-      if ( ! result.second )
-      {
-        std::ostringstream msg;
-        msg << "Received an event from lumi section " << ls;
-        msg << " for which an entry in lumiCounterMap already exists.";
-        XCEPT_RAISE(exception::EventOrder,msg.str());
-      }
-      currentLumiCounter_ = result.first;
-    }
+    // open any skipped lumi sections, but at most one window of them
+    const uint32_t window = lumiCounters_.getWindow();
+    uint32_t ls = currentLumiSection_ + 1;
+    if ( lumiSection - ls >= window )
+      ls = lumiSection - window + 1;
+    for ( ; ls <= lumiSection; ++ls)
+      lumiCounters_.open(ls);
+    currentLumiSection_ = lumiSection;
   }
-  ++(currentLumiCounter_->second);
+  lumiCounters_.increment(currentLumiSection_);
 }
 
 
 template<class ReadoutUnit,class Configuration>
 uint32_t evb::readoutunit::Input<ReadoutUnit,Configuration>::getEventCountForLumiSection(const uint32_t lumiSection)
 {
-  boost::mutex::scoped_lock sl(lumiCounterMutex_);
-
-  const LumiCounterMap::const_iterator pos = lumiCounterMap_.find(lumiSection);
-
-  if ( pos == lumiCounterMap_.end() )
-    return 0;
-  else
-    return pos->second;
+  // lumi sections which dropped out of the ring are reported with 0 events
+  return lumiCounters_.getCount(lumiSection);
 }
 
 
@@ -412,15 +410,12 @@ void evb::readoutunit::Input<ReadoutUnit,Configuration>::startProcessing(const u
 {
   runNumber_ = runNumber;
 
-  {
-    boost::mutex::scoped_lock sl(lumiCounterMutex_);
-
-    lumiCounterMap_.clear();
-    currentLumiCounter_ =
-      lumiCounterMap_.insert(LumiCounterMap::value_type(0,0)).first;
-  }
+  lumiCounters_.clear();
+  lumiCounters_.open(0);
+  currentLumiSection_ = 0;
 
   resetMonitoringCounters();
+  triggerPacer_->start();
 
   {
     boost::shared_lock<boost::shared_mutex> sl(ferolStreamsMutex_);
@@ -481,7 +476,8 @@ void evb::readoutunit::Input<ReadoutUnit,Configuration>::stopProcessing()
       it->second->stopProcessing();
     }
   }
-  while ( buildDummySuperFragmentActive_ ) ::usleep(1000);
+  triggerPacer_->stop();
+  buildDummySuperFragmentActive_.waitUntilIdle();
 }
 
 
@@ -503,15 +499,7 @@ void evb::readoutunit::Input<ReadoutUnit,Configuration>::stopLocalInputAtEvent(c
 template<class ReadoutUnit,class Configuration>
 void evb::readoutunit::Input<ReadoutUnit,Configuration>::setMaxTriggerRate(const uint32_t rate)
 {
-  {
-    boost::shared_lock<boost::shared_mutex> sl(ferolStreamsMutex_);
-
-    for (typename FerolStreams::iterator it = ferolStreams_.begin(), itEnd = ferolStreams_.end();
-          it != itEnd; ++it)
-    {
-      it->second->setMaxTriggerRate(rate);
-    }
-  }
+  triggerPacer_->setRate(rate);
 }
 
 
@@ -682,6 +670,9 @@ void evb::readoutunit::Input<ReadoutUnit,Configuration>::configure()
     XCEPT_RAISE(exception::Configuration, "The block size must be a multiple of 64-bits");
   }
 
+  readoutUnit_->getDumper()->configure(configuration->dumpFIFOCapacity,configuration->maxDumpsPerSecond);
+  triggerPacer_->configure(configuration->triggerPattern.value_,configuration->triggerRules.value_,configuration->triggerDeadTime.value_);
+
   // This may take a while. Thus, do not call subscribeToDip while holding ferolStreamsMutex_
   if ( std::find(configuration->fedSourceIds.begin(),configuration->fedSourceIds.end(),xdata::UnsignedInteger32(SOFT_FED_ID)) != configuration->fedSourceIds.end()
        || configuration->createSoftFed1022 )
@@ -722,7 +713,7 @@ void evb::readoutunit::Input<ReadoutUnit,Configuration>::configure()
 
         if ( fedId != SOFT_FED_ID )
         {
-          FerolStreamPtr ferolStream( new LocalStream<ReadoutUnit,Configuration>(readoutUnit_,it->bag) );
+          FerolStreamPtr ferolStream( new LocalStream<ReadoutUnit,Configuration>(readoutUnit_,it->bag,triggerPacer_) );
           ferolStreams_.insert( typename FerolStreams::value_type(fedId,ferolStream) );
         }
       }
@@ -798,6 +789,21 @@ void evb::readoutunit::Input<ReadoutUnit,Configuration>::writeNextFragmentsToFil
 }
 
 
+template<class ReadoutUnit,class Configuration>
+void evb::readoutunit::Input<ReadoutUnit,Configuration>::handleCRCerror
+(
+  const FedFragmentPtr& fedFragment,
+  exception::CRCerror& e
+)
+{
+  boost::shared_lock<boost::shared_mutex> sl(ferolStreamsMutex_);
+
+  const typename FerolStreams::iterator pos = ferolStreams_.find(fedFragment->getFedId());
+  if ( pos != ferolStreams_.end() )
+    pos->second->handleCRCerror(fedFragment,e);
+}
+
+
 template<class ReadoutUnit,class Configuration>
 cgicc::div evb::readoutunit::Input<ReadoutUnit,Configuration>::getHtmlSnipped() const
 {
@@ -828,6 +834,10 @@ cgicc::div evb::readoutunit::Input<ReadoutUnit,Configuration>::getHtmlSnipped()
     table.add(tr()
               .add(td("# events with missing FEDs"))
               .add(td(boost::lexical_cast<std::string>(incompleteEvents_))));
+    table.add(tr().set("title","Number of fragment dumps written to /tmp and dropped because of the rate limit")
+              .add(td("# fragment dumps written/dropped"))
+              .add(td(boost::lexical_cast<std::string>(readoutUnit_->getDumper()->getNbDumpsWritten())
+                      + "/" + boost::lexical_cast<std::string>(readoutUnit_->getDumper()->getNbDumpsDropped()))));
     table.add(tr()
               .add(td("throughput (MB/s)"))
               .add(td(doubleToString(superFragmentMonitor_.throughput / 1e6,2))));
@@ -6,6 +6,7 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include "evb/ActivityFlag.h"
 #include "evb/Constants.h"
 #include "evb/FragmentSize.h"
 #include "evb/readoutunit/Configuration.h"
@@ -13,6 +14,7 @@
 #include "evb/readoutunit/FerolStream.h"
 #include "evb/readoutunit/ReadoutUnit.h"
 #include "evb/readoutunit/StateMachine.h"
+#include "evb/TriggerPacer.h"
 #include "toolbox/lang/Class.h"
 #include "toolbox/task/Action.h"
 #include "toolbox/task/WaitingWorkLoop.h"
@@ -34,7 +36,7 @@ namespace evb {
     {
     public:
 
-      LocalStream(ReadoutUnit*, const typename Configuration::FerolSource&);
+      LocalStream(ReadoutUnit*, const typename Configuration::FerolSource&, const TriggerPacerPtr&);
 
       ~LocalStream();
 
@@ -53,12 +55,6 @@ namespace evb {
        */
       virtual void stopProcessing();
 
-      /**
-       * Set the trigger rate for generating events
-       */
-      virtual void setMaxTriggerRate(const uint32_t maxTriggerRate)
-      { maxTriggerRate_ = maxTriggerRate; }
-
 
     private:
 
@@ -70,10 +66,10 @@ namespace evb {
       toolbox::task::WorkLoop* generatingWorkLoop_;
       toolbox::task::ActionSignature* generatingAction_;
       boost::scoped_ptr<FragmentSize> fragmentSize_;
+      const TriggerPacerPtr triggerPacer_;
 
-      volatile bool generatingActive_;
-      uint32_t maxTriggerRate_;
-      uint64_t lastTime_;
+      ActivityFlag generatingActive_;
+      uint64_t triggerNumber_;
       uint32_t availableTriggers_;
 
     };
@@ -89,13 +85,14 @@ template<class ReadoutUnit,class Configuration>
 evb::readoutunit::LocalStream<ReadoutUnit,Configuration>::LocalStream
 (
   ReadoutUnit* readoutUnit,
-  const typename Configuration::FerolSource& ferolSource
+  const typename Configuration::FerolSource& ferolSource,
+  const TriggerPacerPtr& triggerPacer
 ) :
   FerolStream<ReadoutUnit,Configuration>(readoutUnit,ferolSource.fedId),
   configuration_(readoutUnit->getConfiguration()),
+  triggerPacer_(triggerPacer),
   generatingActive_(false),
-  maxTriggerRate_(0),
-  lastTime_(0),
+  triggerNumber_(0),
   availableTriggers_(0)
 {
   if ( configuration_->dummyFedSizeMin.value_ < sizeof(fedh_t) + sizeof(fedt_t) )
@@ -191,25 +188,11 @@ bool evb::readoutunit::LocalStream<ReadoutUnit,Configuration>::generating(toolbo
 template<class ReadoutUnit,class Configuration>
 void evb::readoutunit::LocalStream<ReadoutUnit,Configuration>::waitForNextTrigger()
 {
-  if ( maxTriggerRate_ == 0 ) return;
-
-  if ( availableTriggers_ > 0 )
-  {
-    --availableTriggers_;
-    return;
-  }
+  if ( availableTriggers_ == 0 )
+    availableTriggers_ = triggerPacer_->waitForTrigger(triggerNumber_);
 
-  uint64_t now = 0;
-  while ( availableTriggers_ == 0 )
-  {
-    now = getTimeStamp();
-    if ( lastTime_ == 0 )
-      availableTriggers_ = 1;
-    else
-      availableTriggers_ = static_cast<uint32_t>(now>lastTime_ ? (now-lastTime_)/1e9*maxTriggerRate_ : 0);
-  }
-  lastTime_ = now;
   --availableTriggers_;
+  ++triggerNumber_;
 }
 
 
@@ -219,7 +202,7 @@ void evb::readoutunit::LocalStream<ReadoutUnit,Configuration>::startProcessing(c
   FerolStream<ReadoutUnit,Configuration>::startProcessing(runNumber);
 
   this->eventNumberToStop_ = (1 << 25); //larger than maximum event number
-  lastTime_ = getTimeStamp();
+  triggerNumber_ = 0;
   availableTriggers_ = 0;
 
   generatingWorkLoop_->submit(generatingAction_);
@@ -229,7 +212,7 @@ void evb::readoutunit::LocalStream<ReadoutUnit,Configuration>::startProcessing(c
 template<class ReadoutUnit,class Configuration>
 void evb::readoutunit::LocalStream<ReadoutUnit,Configuration>::drain()
 {
-  while ( generatingActive_ ) ::usleep(1000);
+  generatingActive_.waitUntilIdle();
 }
 
 
@@ -10,6 +10,7 @@
 #include "cgicc/HTMLClasses.h"
 #include "evb/CRCCalculator.h"
 #include "evb/EvBid.h"
+#include "evb/HugePageAllocator.h"
 #include "evb/readoutunit/FedFragment.h"
 #include "evb/readoutunit/FerolStream.h"
 #include "evb/readoutunit/MetaData.h"
@@ -144,7 +145,13 @@ void evb::readoutunit::MetaDataStream<ReadoutUnit,Configuration>::createMetaData
 
   try
   {
-    toolbox::mem::HeapAllocator* a = new toolbox::mem::HeapAllocator();
+    // the few metaData fragments fit into a single hugepage
+    const size_t hugePageSize = this->readoutUnit_->getConfiguration()->hugePageSize.value_ * 1024ULL;
+    toolbox::mem::Allocator* a;
+    if ( hugePageSize > 0 )
+      a = new HugePageAllocator(hugePageSize,hugePageSize,this->readoutUnit_->getConfiguration()->numaNode.value_);
+    else
+      a = new toolbox::mem::HeapAllocator();
     fragmentPool_ = toolbox::mem::getMemoryPoolFactory()->createPool(urn,a);
   }
   catch(toolbox::mem::exception::Exception& e)
@@ -9,6 +9,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 
+#include "evb/ActivityFlag.h"
 #include "evb/readoutunit/SocketBuffer.h"
 #include "evb/readoutunit/SocketStream.h"
 #include "pt/blit/InputPipe.h"
@@ -57,7 +58,7 @@ namespace evb {
 
       toolbox::task::WorkLoop* pipeWorkLoop_;
       volatile bool processPipe_;
-      volatile bool pipeActive_;
+      ActivityFlag pipeActive_;
       int outstandingBuffers_;
 
       SocketBuffer::ReleaseFunction releaseFunction_;
@@ -106,7 +107,7 @@ template<class ReadoutUnit,class Configuration>
 evb::readoutunit::PipeHandler<ReadoutUnit,Configuration>::~PipeHandler()
 {
   processPipe_ = false;
-  while (pipeActive_) ::usleep(1000);
+  pipeActive_.waitUntilIdle();
   if ( pipeWorkLoop_ && pipeWorkLoop_->isActive() )
     pipeWorkLoop_->cancel();
   socketStreams_.clear();
@@ -121,7 +122,8 @@ evb::readoutunit::PipeHandler<ReadoutUnit,Configuration>::~PipeHandler()
 template<class ReadoutUnit,class Configuration>
 bool evb::readoutunit::PipeHandler<ReadoutUnit,Configuration>::idle() const
 {
-  while ( pipeActive_ || !grantFIFO_.empty() ) ::usleep(1000);
+  while ( pipeActive_ || !grantFIFO_.empty() )
+    pipeActive_.waitForChange(1000);
   return ( outstandingBuffers_ == 0 );
 }
 
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "evb/ActivityFlag.h"
 #include "evb/OneToOneQueue.h"
 #include "evb/readoutunit/Configuration.h"
 #include "evb/readoutunit/FerolStream.h"
@@ -75,7 +76,7 @@ namespace evb {
       toolbox::task::WorkLoop* parseSocketBuffersWL_;
       toolbox::task::ActionSignature* parseSocketBuffersAction_;
 
-      volatile bool parseSocketBuffersActive_;
+      ActivityFlag parseSocketBuffersActive_;
 
       FedFragmentPtr currentFragment_;
 
@@ -221,7 +222,8 @@ void evb::readoutunit::SocketStream<ReadoutUnit,Configuration>::startProcessing(
 template<class ReadoutUnit,class Configuration>
 void evb::readoutunit::SocketStream<ReadoutUnit,Configuration>::drain()
 {
-  while ( parseSocketBuffersActive_ || !socketBufferFIFO_.empty() ) ::usleep(1000);
+  while ( parseSocketBuffersActive_ || !socketBufferFIFO_.empty() )
+    parseSocketBuffersActive_.waitForChange(1000);
   FerolStream<ReadoutUnit,Configuration>::drain();
 }
 
@@ -230,7 +232,7 @@ template<class ReadoutUnit,class Configuration>
 void evb::readoutunit::SocketStream<ReadoutUnit,Configuration>::stopProcessing()
 {
   FerolStream<ReadoutUnit,Configuration>::stopProcessing();
-  while (parseSocketBuffersActive_) ::usleep(1000);
+  parseSocketBuffersActive_.waitUntilIdle();
   socketBufferFIFO_.clear();
   currentFragment_.reset();
   this->fragmentFIFO_.clear();
@@ -15,6 +15,7 @@
 
 #include "evb/EvBStateMachine.h"
 #include "evb/Exception.h"
+#include "evb/TimeStamp.h"
 #include "evb/readoutunit/StateMachine.h"
 #include "xcept/Exception.h"
 #include "xcept/tools.h"
@@ -446,9 +447,16 @@ void evb::readoutunit::Configuring<Owner>::activity()
   std::string msg = "Failed to configure the components";
   try
   {
+    MonotonicClock::calibrate();
+    const uint64_t startTime = getMonotonicTimeStamp();
+    uint64_t stepTime = startTime;
     if (doConfiguring_) owner->getInput()->configure();
+    stepTime = stateMachine.recordTransitionTime("Configure","Input",stepTime);
     if (doConfiguring_) owner->getBUproxy()->configure();
+    stepTime = stateMachine.recordTransitionTime("Configure","BUproxy",stepTime);
     if (doConfiguring_) doConfigure(owner);
+    stateMachine.recordTransitionTime("Configure","RUproxy",stepTime);
+    stateMachine.recordTransitionTime("Configure","total",startTime);
 
     if (doConfiguring_) stateMachine.processFSMEvent( ConfigureDone() );
   }
@@ -491,10 +499,17 @@ void evb::readoutunit::Running<Owner>::entryAction()
   const uint32_t runNumber = stateMachine.getRunNumber();
   stateMachine.resetMissingFeds();
 
+  const uint64_t startTime = getMonotonicTimeStamp();
+  uint64_t stepTime = startTime;
   owner->getFerolConnectionManager()->startProcessing();
+  stepTime = stateMachine.recordTransitionTime("Enable","FerolConnectionManager",stepTime);
   owner->getInput()->startProcessing(runNumber);
+  stepTime = stateMachine.recordTransitionTime("Enable","Input",stepTime);
   owner->getBUproxy()->startProcessing();
+  stepTime = stateMachine.recordTransitionTime("Enable","BUproxy",stepTime);
   doStartProcessing(owner,runNumber);
+  stateMachine.recordTransitionTime("Enable","RUproxy",stepTime);
+  stateMachine.recordTransitionTime("Enable","total",startTime);
 }
 
 
@@ -504,9 +519,15 @@ void evb::readoutunit::Running<Owner>::exitAction()
   typename my_state::outermost_context_type& stateMachine = this->outermost_context();
   const Owner* owner = stateMachine.getOwner();
 
+  const uint64_t startTime = getMonotonicTimeStamp();
+  uint64_t stepTime = startTime;
   owner->getInput()->stopProcessing();
+  stepTime = stateMachine.recordTransitionTime("Stop","Input",stepTime);
   owner->getBUproxy()->stopProcessing();
+  stepTime = stateMachine.recordTransitionTime("Stop","BUproxy",stepTime);
   doStopProcessing(owner);
+  stateMachine.recordTransitionTime("Stop","RUproxy",stepTime);
+  stateMachine.recordTransitionTime("Stop","total",startTime);
 }
 
 
@@ -537,10 +558,17 @@ void evb::readoutunit::Draining<Owner>::activity()
   std::string msg = "Failed to drain the components";
   try
   {
+    const uint64_t startTime = getMonotonicTimeStamp();
+    uint64_t stepTime = startTime;
     if (doDraining_) owner->getInput()->drain();
+    stepTime = stateMachine.recordTransitionTime("Drain","Input",stepTime);
     if (doDraining_) owner->getFerolConnectionManager()->drain();
+    stepTime = stateMachine.recordTransitionTime("Drain","FerolConnectionManager",stepTime);
     if (doDraining_) owner->getBUproxy()->drain();
+    stepTime = stateMachine.recordTransitionTime("Drain","BUproxy",stepTime);
     if (doDraining_) doDraining(owner);
+    stateMachine.recordTransitionTime("Drain","RUproxy",stepTime);
+    stateMachine.recordTransitionTime("Drain","total",startTime);
 
     if (doDraining_) stateMachine.processFSMEvent( DrainingDone() );
   }
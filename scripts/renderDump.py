@@ -0,0 +1,99 @@
+#!/usr/bin/python
+
+import getopt
+import os
+import struct
+import sys
+
+
+NO_FED_ID = 0xffffffff
+HEADER_FORMAT = "=8s8I"
+
+
+def usage():
+    print("""
+renderDump.py [--outputDir <dir>] dumpFile [dumpFile ...]
+          -h --help:       print this message and exit
+          -o --outputDir:  write the text dumps as .txt files into the given directory (default prints to stdout)
+
+Renders the binary dumps of events and FED fragments written by the EvB
+applications into the same text format as the former synchronous dumps.
+    """)
+
+
+def dumpBlockData(data):
+    lines = []
+    words = struct.unpack("=%dI" % (len(data)//4), data[:len(data)//4*4])
+    nbWords = len(words)
+    for ic in range(0,nbWords,4):
+        d = [words[i] if i < nbWords else 0 for i in range(ic,ic+4)]
+        if ic + 2 >= nbWords:
+            lines.append("%08x : %08x %08x %12s         |    human readable swapped : %08x %08x %12s      : %08x"
+                         % (ic*4, d[0], d[1], "", d[1], d[0], "", ic*4))
+        else:
+            lines.append("%08x : %08x %08x %08x %08x    |    human readable swapped : %08x %08x %08x %08x : %08x"
+                         % (ic*4, d[0], d[1], d[2], d[3], d[1], d[0], d[3], d[2], ic*4))
+    return lines
+
+
+def renderDump(fileName):
+    with open(fileName,"rb") as dumpFile:
+        content = dumpFile.read()
+
+    (magic,version,headerSize,runNumber,eventNumber,fedId,badChunk,nbChunks,descriptionSize) = \
+        struct.unpack_from(HEADER_FORMAT,content)
+    if magic != b"EvBdump\0":
+        raise ValueError(fileName+" is not a binary EvB dump")
+    if version != 1:
+        raise ValueError(fileName+" has unknown dump format version "+str(version))
+
+    pos = headerSize
+    description = content[pos:pos+descriptionSize].decode("ascii","replace")
+    pos += descriptionSize
+    chunkSizes = struct.unpack_from("=%dI" % nbChunks,content,pos)
+    pos += 4*nbChunks
+
+    lines = [description[:-1] if description.endswith("\n") else description]
+    if fedId == NO_FED_ID:
+        for chunk,size in enumerate(chunkSizes):
+            if chunk == badChunk:
+                lines.append("Bad chunk %2d: " % chunk + "*"*112)
+            else:
+                lines.append("Chunk %2d : " % chunk + "-"*115)
+            lines.extend( dumpBlockData(content[pos:pos+size]) )
+            pos += size
+    else:
+        lines.extend( dumpBlockData(content[pos:pos+sum(chunkSizes)]) )
+        lines.append("================ END OF DUMP ===================")
+    return "\n".join(lines)+"\n"
+
+
+def main(argv):
+    outputDir = None
+    try:
+        opts,args = getopt.getopt(argv,"ho:",["help","outputDir="])
+    except getopt.GetoptError:
+        usage()
+        sys.exit(2)
+    for opt, arg in opts:
+        if opt in ("-h", "--help"):
+            usage()
+            sys.exit()
+        elif opt in ("-o", "--outputDir"):
+            outputDir = arg
+    if not args:
+        usage()
+        sys.exit(2)
+
+    for fileName in args:
+        text = renderDump(fileName)
+        if outputDir is None:
+            sys.stdout.write(text)
+        else:
+            baseName = os.path.splitext(os.path.basename(fileName))[0]
+            with open(os.path.join(outputDir,baseName+".txt"),"w") as textFile:
+                textFile.write(text)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
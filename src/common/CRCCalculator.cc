@@ -223,6 +223,12 @@ uint32_t evb::CRCCalculator::crc32c(uint32_t crc, const unsigned char *buf, size
 }
 
 
+uint32_t evb::CRCCalculator::crc32cCombine(uint32_t crc1, uint32_t crc2, size_t len2) const
+{
+  return crc32c_combine(crc1, crc2, len2);
+}
+
+
 /// emacs configuration
 /// Local Variables: -
 /// mode: c++ -
@@ -10,6 +10,7 @@
 #include "evb/dummyFEROL/StateMachine.h"
 #include "evb/Exception.h"
 #include "evb/version.h"
+#include "evb/TimeStamp.h"
 #include "toolbox/task/WorkLoopFactory.h"
 #include "xcept/tools.h"
 
@@ -18,9 +19,12 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <netdb.h>
+#include <limits.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <pthread.h>
 #include <sys/socket.h>
+#include <time.h>
 
 #include <boost/lexical_cast.hpp>
 
@@ -30,7 +34,8 @@ evb::test::DummyFEROL::DummyFEROL(xdaq::ApplicationStub* app) :
   sockfd_(0),
   doProcessing_(false),
   active_(false),
-  lastResync_(0)
+  lastResync_(0),
+  nextSendTime_(0)
 {
   stateMachine_.reset( new dummyFEROL::StateMachine(this) );
 
@@ -167,6 +172,9 @@ cgicc::div evb::test::DummyFEROL::getHtmlSnipped() const
     table.add(tr()
               .add(td("throughput (MB/s)"))
               .add(td(doubleToString(throughput_.value_ / 1e6,2))));
+    table.add(tr()
+              .add(td("throughput (Gb/s)"))
+              .add(td(doubleToString(throughput_.value_ * 8 / 1e9,2))));
     table.add(tr()
               .add(td("rate (fragments/s)"))
               .add(td(boost::lexical_cast<std::string>(fragmentRate_))));
@@ -200,6 +208,15 @@ void evb::test::DummyFEROL::resetMonitoringCounters()
 
 void evb::test::DummyFEROL::configure()
 {
+  if ( configuration_->framesPerSend == 0U || configuration_->framesPerSend > IOV_MAX ||
+       ( configuration_->framesPerSend > 1U && ! configuration_->useFrameTemplates ) )
+  {
+    std::ostringstream msg;
+    msg << "The number of frames per send must be 1, or between 1 and " << IOV_MAX;
+    msg << " when using frame templates, but is " << configuration_->framesPerSend;
+    XCEPT_RAISE(exception::Configuration, msg.str());
+  }
+
   fragmentGenerator_.configure(
     configuration_->fedId,
     configuration_->usePlayback,
@@ -212,8 +229,14 @@ void evb::test::DummyFEROL::configure()
     configuration_->maxFedSize,
     configuration_->frameSize*configuration_->fragmentFIFOCapacity,
     configuration_->fakeLumiSectionDuration,
-    configuration_->maxTriggerRate
+    configuration_->maxTriggerRate,
+    configuration_->triggerPattern,
+    configuration_->triggerRules,
+    configuration_->triggerDeadTime,
+    configuration_->useFrameTemplates ? configuration_->framesPerSend.value_ : 0
   );
+  frames_.reserve(configuration_->framesPerSend);
+  iovecs_.resize(configuration_->framesPerSend);
 
   openConnection();
 }
@@ -319,6 +342,7 @@ void evb::test::DummyFEROL::startProcessing()
   stopAtEvent_ = 0;
   doProcessing_ = true;
   fragmentGenerator_.reset();
+  nextSendTime_ = 0;
   workLoop_->submit(action_);
 }
 
@@ -398,18 +422,31 @@ bool evb::test::DummyFEROL::generating(toolbox::task::WorkLoop *wl)
                                       nbFedCRCerrors_.value_,nbSlinkCRCerrors_.value_) )
       {
         updateCounters(bufRef);
-        sendData(bufRef);
-        ::usleep(1000);
+        frames_.push_back(bufRef);
+        if ( frames_.size() < configuration_->framesPerSend ) continue;
+      }
+
+      if ( ! frames_.empty() )
+      {
+        sendFrames();
+
+        // without any pacing, keep the historic frame rate of less than 1 kHz
+        if ( configuration_->maxThroughput == 0U && ! configuration_->useFrameTemplates )
+          ::usleep(1000);
       }
     }
+    if ( ! frames_.empty() )
+      sendFrames();
   }
   catch(xcept::Exception &e)
   {
+    releaseFrames();
     active_ = false;
     stateMachine_->processFSMEvent( Fail(e) );
   }
   catch(std::exception& e)
   {
+    releaseFrames();
     active_ = false;
     XCEPT_DECLARE(exception::DummyData,
                   sentinelException, e.what());
@@ -417,6 +454,7 @@ bool evb::test::DummyFEROL::generating(toolbox::task::WorkLoop *wl)
   }
   catch(...)
   {
+    releaseFrames();
     active_ = false;
     XCEPT_DECLARE(exception::DummyData,
                   sentinelException, "unkown exception");
@@ -442,22 +480,35 @@ inline void evb::test::DummyFEROL::updateCounters(toolbox::mem::Reference* bufRe
 }
 
 
-inline void evb::test::DummyFEROL::sendData(toolbox::mem::Reference* bufRef)
+void evb::test::DummyFEROL::sendFrames()
 {
-  char* buf = (char*)bufRef->getDataLocation();
-  ssize_t len = bufRef->getDataSize();
+  uint64_t bytes = 0;
+  for ( uint32_t i = 0; i < frames_.size(); ++i )
+  {
+    iovecs_[i].iov_base = frames_[i]->getDataLocation();
+    iovecs_[i].iov_len = frames_[i]->getDataSize();
+    bytes += iovecs_[i].iov_len;
+  }
+
+  struct iovec* iov = &iovecs_[0];
+  int iovcnt = frames_.size();
 
-  while ( len > 0 && doProcessing_ )
+  while ( iovcnt > 0 && doProcessing_ )
   {
-    const ssize_t written = write(sockfd_,buf,len);
+    ssize_t written = writev(sockfd_,iov,iovcnt);
     if ( written < 0 )
     {
-      if ( errno == EWOULDBLOCK )
+      if ( errno == EWOULDBLOCK || errno == EAGAIN )
       {
-        ::usleep(100);
+        struct pollfd pfd;
+        pfd.fd = sockfd_;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        ::poll(&pfd,1,100);
       }
-      else
+      else if ( errno != EINTR )
       {
+        releaseFrames();
         std::ostringstream msg;
         msg << "Failed to send data to " << configuration_->destinationHost.value_ << ":" << configuration_->destinationPort;
         msg << " : " << strerror(errno);
@@ -466,11 +517,56 @@ inline void evb::test::DummyFEROL::sendData(toolbox::mem::Reference* bufRef)
     }
     else
     {
-      len -= written;
-      buf += written;
+      while ( iovcnt > 0 && static_cast<size_t>(written) >= iov->iov_len )
+      {
+        written -= iov->iov_len;
+        ++iov;
+        --iovcnt;
+      }
+      if ( iovcnt > 0 )
+      {
+        iov->iov_base = (char*)iov->iov_base + written;
+        iov->iov_len -= written;
+      }
     }
   }
-  bufRef->release();
+  releaseFrames();
+
+  if ( configuration_->maxThroughput > 0U )
+    waitForBandwidth(bytes);
+}
+
+
+void evb::test::DummyFEROL::releaseFrames()
+{
+  for ( Frames::const_iterator it = frames_.begin(), itEnd = frames_.end();
+        it != itEnd; ++it )
+  {
+    (*it)->release();
+  }
+  frames_.clear();
+}
+
+
+void evb::test::DummyFEROL::waitForBandwidth(const uint64_t bytes)
+{
+  // Token bucket allowing bursts of up to 1 ms worth of data
+  const uint64_t burst = 1000000;
+  const uint64_t now = getMonotonicTimeStamp();
+
+  if ( nextSendTime_ + burst < now )
+    nextSendTime_ = now - burst;
+
+  // MB/s equals Bytes/us, thus the transmission time in ns is 1000*bytes/throughput
+  nextSendTime_ += bytes * 1000 / configuration_->maxThroughput;
+
+  if ( nextSendTime_ > now )
+  {
+    struct timespec delay;
+    delay.tv_sec = (nextSendTime_ - now) / 1000000000;
+    delay.tv_nsec = (nextSendTime_ - now) % 1000000000;
+    ::nanosleep(&delay,0);
+  }
 }
 
 
@@ -0,0 +1,254 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <iomanip>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <boost/bind.hpp>
+
+#include "evb/Dumper.h"
+#include "evb/TimeStamp.h"
+
+
+namespace {
+
+  const char dumpMagic[8] = { 'E','v','B','d','u','m','p','\0' };
+  const uint32_t dumpVersion = 1;
+
+  struct DumpHeader
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t runNumber;
+    uint32_t eventNumber;
+    uint32_t fedId;
+    uint32_t badChunk;
+    uint32_t nbChunks;
+    uint32_t descriptionSize;
+  };
+
+  bool writeAll(const int fileDescriptor, struct iovec* iov, int iovcnt)
+  {
+    while ( iovcnt > 0 )
+    {
+      ssize_t written = ::writev(fileDescriptor, iov, iovcnt);
+      if ( written < 0 )
+      {
+        if ( errno == EINTR ) continue;
+        return false;
+      }
+      while ( iovcnt > 0 && static_cast<size_t>(written) >= iov->iov_len )
+      {
+        written -= iov->iov_len;
+        ++iov;
+        --iovcnt;
+      }
+      if ( iovcnt > 0 )
+      {
+        iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+        iov->iov_len -= written;
+      }
+    }
+    return true;
+  }
+
+}
+
+
+const uint32_t evb::Dump::noFedId;
+const uint32_t evb::Dump::noBadChunk;
+
+
+evb::Dump::Dump(const uint32_t runNumber, const uint32_t eventNumber, const uint32_t fedId) :
+  runNumber(runNumber),
+  eventNumber(eventNumber),
+  fedId(fedId),
+  badChunk(noBadChunk)
+{}
+
+
+void evb::Dump::addChunk(const void* location, const uint32_t size)
+{
+  const size_t offset = data.size();
+  data.resize(offset + size);
+  if ( size > 0 )
+    memcpy(&data[offset], location, size);
+  chunkSizes.push_back(size);
+}
+
+
+evb::Dumper::Dumper(const std::string& dumpDir) :
+  dumpDir_(dumpDir),
+  fifoCapacity_(16),
+  maxDumpsPerSecond_(10),
+  writing_(false),
+  stop_(false),
+  tokens_(10),
+  timeOfLastToken_(now()),
+  nbDumpsWritten_(0),
+  nbDumpsDropped_(0)
+{
+  dumperThread_ = boost::thread( boost::bind( &Dumper::writeDumps, this ) );
+}
+
+
+evb::Dumper::~Dumper()
+{
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    stop_ = true;
+    dumpQueued_.notify_one();
+  }
+  try
+  {
+    dumperThread_.join();
+  }
+  catch ( const boost::thread_interrupted& ) {}
+}
+
+
+void evb::Dumper::configure(const uint32_t fifoCapacity, const uint32_t maxDumpsPerSecond)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  fifoCapacity_ = fifoCapacity;
+  maxDumpsPerSecond_ = maxDumpsPerSecond;
+  tokens_ = maxDumpsPerSecond;
+  timeOfLastToken_ = now();
+}
+
+
+bool evb::Dumper::accept(const bool force)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+
+  const uint64_t currentTime = now();
+  tokens_ += (currentTime - timeOfLastToken_) / 1e6 * maxDumpsPerSecond_;
+  if ( tokens_ > maxDumpsPerSecond_ ) tokens_ = maxDumpsPerSecond_;
+  timeOfLastToken_ = currentTime;
+
+  if ( dumps_.size() >= fifoCapacity_ || ( ! force && tokens_ < 1 ) )
+  {
+    __sync_fetch_and_add(&nbDumpsDropped_,1);
+    return false;
+  }
+
+  if ( tokens_ >= 1 ) tokens_ -= 1;
+  return true;
+}
+
+
+void evb::Dumper::write(const DumpPtr& dump)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  dumps_.push_back(dump);
+  dumpQueued_.notify_one();
+}
+
+
+void evb::Dumper::drain()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  while ( ! dumps_.empty() || writing_ )
+    dumpsWritten_.wait(lock);
+}
+
+
+uint64_t evb::Dumper::now() const
+{
+  return getMonotonicTimeStamp() / 1000;
+}
+
+
+void evb::Dumper::writeDumps()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+
+  for (;;)
+  {
+    while ( dumps_.empty() && ! stop_ )
+      dumpQueued_.wait(lock);
+
+    // write any queued dumps before stopping, as they might explain a failure
+    if ( dumps_.empty() ) return;
+
+    const DumpPtr dump = dumps_.front();
+    dumps_.pop_front();
+    writing_ = true;
+
+    lock.unlock();
+    if ( writeFile(*dump) )
+      __sync_fetch_and_add(&nbDumpsWritten_,1);
+    else
+      __sync_fetch_and_add(&nbDumpsDropped_,1);
+    lock.lock();
+
+    writing_ = false;
+    dumpsWritten_.notify_all();
+  }
+}
+
+
+std::string evb::Dumper::getFileName(const Dump& dump) const
+{
+  std::ostringstream fileName;
+  fileName << dumpDir_ << "/dump_run" << std::setfill('0') << std::setw(6) << dump.runNumber
+    << "_event" << std::setw(8) << dump.eventNumber;
+  if ( dump.fedId != Dump::noFedId )
+    fileName << "_fed" << std::setw(4) << dump.fedId;
+  fileName << ".dump";
+  return fileName.str();
+}
+
+
+bool evb::Dumper::writeFile(const Dump& dump) const
+{
+  DumpHeader header;
+  memcpy(header.magic, dumpMagic, sizeof(header.magic));
+  header.version = dumpVersion;
+  header.headerSize = sizeof(DumpHeader);
+  header.runNumber = dump.runNumber;
+  header.eventNumber = dump.eventNumber;
+  header.fedId = dump.fedId;
+  header.badChunk = dump.badChunk;
+  header.nbChunks = dump.chunkSizes.size();
+  header.descriptionSize = dump.description.size();
+
+  struct iovec iov[4];
+  iov[0].iov_base = &header;
+  iov[0].iov_len = sizeof(header);
+  iov[1].iov_base = const_cast<char*>(dump.description.data());
+  iov[1].iov_len = dump.description.size();
+  iov[2].iov_base = const_cast<uint32_t*>(dump.chunkSizes.empty() ? 0 : &dump.chunkSizes[0]);
+  iov[2].iov_len = dump.chunkSizes.size() * sizeof(uint32_t);
+  iov[3].iov_base = const_cast<unsigned char*>(dump.data.empty() ? 0 : &dump.data[0]);
+  iov[3].iov_len = dump.data.size();
+
+  // write to a temporary file such that only complete dumps appear under the final name
+  const std::string fileName = getFileName(dump);
+  const std::string tmpFileName = fileName + ".tmp";
+
+  const int fileDescriptor = ::open(tmpFileName.c_str(), O_WRONLY|O_CREAT|O_TRUNC, S_IRUSR|S_IWUSR|S_IRGRP|S_IROTH);
+  if ( fileDescriptor == -1 ) return false;
+
+  const bool written = writeAll(fileDescriptor, iov, 4);
+
+  if ( ::close(fileDescriptor) != 0 || ! written ||
+       ::rename(tmpFileName.c_str(), fileName.c_str()) != 0 )
+  {
+    ::unlink(tmpFileName.c_str());
+    return false;
+  }
+  return true;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
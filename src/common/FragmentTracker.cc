@@ -22,11 +22,10 @@ evb::FragmentTracker::FragmentTracker
   fedSize_(fedSize),
   minFedSize_(minFedSize),
   maxFedSize_(maxFedSize),
-  maxTriggerRate_(0),
   computeCRC_(computeCRC),
   fedCRC_(0xffff),
   typeOfNextComponent_(FED_HEADER),
-  lastTime_(0),
+  triggerNumber_(0),
   availableTriggers_(0)
 {
   if (minFedSize < sizeof(fedh_t) + sizeof(fedt_t))
@@ -64,32 +63,19 @@ uint32_t evb::FragmentTracker::startFragment(const EvBid& evbId)
 
 void evb::FragmentTracker::startRun()
 {
-  lastTime_ = getTimeStamp();
+  triggerPacer_.start();
+  triggerNumber_ = 0;
   availableTriggers_ = 0;
 }
 
 
 void evb::FragmentTracker::waitForNextTrigger()
 {
-  if ( maxTriggerRate_ == 0 ) return;
+  if ( availableTriggers_ == 0 )
+    availableTriggers_ = triggerPacer_.waitForTrigger(triggerNumber_);
 
-  if ( availableTriggers_ > 0 )
-  {
-    --availableTriggers_;
-    return;
-  }
-
-  uint64_t now = 0;
-  while ( availableTriggers_ == 0 )
-  {
-    now = getTimeStamp();
-    if ( lastTime_ == 0 )
-      availableTriggers_ = 1;
-    else
-      availableTriggers_ = static_cast<uint32_t>(now>lastTime_ ? (now-lastTime_)/1e9*maxTriggerRate_ : 0);
-  }
-  lastTime_ = now;
   --availableTriggers_;
+  ++triggerNumber_;
 }
 
 
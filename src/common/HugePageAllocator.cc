@@ -0,0 +1,231 @@
+#include <errno.h>
+#include <sstream>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
+
+#include "evb/Constants.h"
+#include "evb/HugePageAllocator.h"
+#include "toolbox/mem/CommittedHeapBuffer.h"
+#include "toolbox/mem/MemoryPoolFactory.h"
+#include "toolbox/mem/exception/MemoryPoolNotFound.h"
+#include "toolbox/net/URN.h"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#ifndef MPOL_BIND
+#define MPOL_BIND 2
+#endif
+
+#ifndef MPOL_MF_STRICT
+#define MPOL_MF_STRICT (1<<0)
+#endif
+
+
+namespace {
+
+  uint64_t getMinorPageFaults()
+  {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+  }
+
+}
+
+
+evb::HugePageAllocator::HugePageAllocator
+(
+  const size_t committedSize,
+  const size_t hugePageSize,
+  const int32_t numaNode
+)
+throw (toolbox::mem::exception::FailedCreation) :
+  hugePageSize_(hugePageSize),
+  numaNode_(numaNode),
+  committedSize_(0),
+  memory_(MAP_FAILED),
+  prefaultPageFaults_(0)
+{
+  if ( hugePageSize_ == 0 || (hugePageSize_ & (hugePageSize_-1)) != 0 )
+  {
+    std::ostringstream msg;
+    msg << "The hugepage size " << hugePageSize_ << " Bytes is not a power of 2";
+    XCEPT_RAISE(toolbox::mem::exception::FailedCreation, msg.str());
+  }
+  committedSize_ = ((committedSize + hugePageSize_ - 1) / hugePageSize_) * hugePageSize_;
+
+  const int pageShift = __builtin_ctzl(hugePageSize_);
+  memory_ = ::mmap(0, committedSize_, PROT_READ|PROT_WRITE,
+                   MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB|(pageShift << MAP_HUGE_SHIFT), -1, 0);
+  if ( memory_ == MAP_FAILED )
+  {
+    std::ostringstream msg;
+    msg << "Failed to map " << committedSize_ << " Bytes of hugepages of " << hugePageSize_/1024 << " kB: ";
+    msg << strerror(errno) << ". Check the number of hugepages reserved in ";
+    msg << "/sys/kernel/mm/hugepages/hugepages-" << hugePageSize_/1024 << "kB/nr_hugepages";
+    XCEPT_RAISE(toolbox::mem::exception::FailedCreation, msg.str());
+  }
+
+  if ( numaNode_ >= 0 )
+  {
+    // bind the memory before it is faulted in
+    const unsigned long bitsPerLong = 8*sizeof(unsigned long);
+    std::vector<unsigned long> nodeMask(numaNode_/bitsPerLong + 1, 0);
+    nodeMask[numaNode_/bitsPerLong] = 1UL << (numaNode_ % bitsPerLong);
+    if ( ::syscall(SYS_mbind, memory_, committedSize_, MPOL_BIND,
+                   &nodeMask[0], nodeMask.size()*bitsPerLong + 1, MPOL_MF_STRICT) != 0 )
+    {
+      std::ostringstream msg;
+      msg << "Failed to bind the hugepages to NUMA node " << numaNode_ << ": " << strerror(errno);
+      ::munmap(memory_, committedSize_);
+      XCEPT_RAISE(toolbox::mem::exception::FailedCreation, msg.str());
+    }
+  }
+
+  // pre-fault all pages to avoid page faults while taking data
+  const uint64_t pageFaults = getMinorPageFaults();
+  for (size_t offset = 0; offset < committedSize_; offset += hugePageSize_)
+    static_cast<volatile char*>(memory_)[offset] = 0;
+  prefaultPageFaults_ = getMinorPageFaults() - pageFaults;
+
+  memPartition_.addToPool(memory_, committedSize_);
+}
+
+
+evb::HugePageAllocator::~HugePageAllocator()
+{
+  if ( memory_ != MAP_FAILED )
+    ::munmap(memory_, committedSize_);
+}
+
+
+toolbox::mem::Buffer* evb::HugePageAllocator::alloc(size_t size, toolbox::mem::Pool* pool)
+throw (toolbox::mem::exception::FailedAllocation)
+{
+  void* buffer = 0;
+  try
+  {
+    buffer = memPartition_.alloc(size);
+  }
+  catch(toolbox::mem::exception::Exception& e)
+  {
+    std::ostringstream msg;
+    msg << "Failed to allocate " << size << " Bytes from the hugepage memory";
+    XCEPT_RETHROW(toolbox::mem::exception::FailedAllocation, msg.str(), e);
+  }
+  return new toolbox::mem::CommittedHeapBuffer(pool, size, buffer);
+}
+
+
+void evb::HugePageAllocator::free(toolbox::mem::Buffer* buffer)
+throw (toolbox::mem::exception::FailedDispose)
+{
+  try
+  {
+    memPartition_.free(buffer->getAddress());
+  }
+  catch(toolbox::mem::exception::Exception& e)
+  {
+    XCEPT_RETHROW(toolbox::mem::exception::FailedDispose, "Failed to free the buffer from the hugepage memory", e);
+  }
+  delete buffer;
+}
+
+
+size_t evb::HugePageAllocator::getUsed()
+{
+  return memPartition_.getUsed();
+}
+
+
+toolbox::mem::Pool* evb::getHugePagePool
+(
+  const std::string& poolName,
+  const size_t hugePageSize,
+  const size_t poolSize,
+  const int32_t numaNode
+)
+{
+  toolbox::net::URN urn("toolbox-mem-pool", poolName);
+
+  try
+  {
+    toolbox::mem::Pool* pool = toolbox::mem::getMemoryPoolFactory()->findPool(urn);
+    HugePageAllocator* allocator = dynamic_cast<HugePageAllocator*>(pool->getAllocator());
+    if ( allocator &&
+         allocator->getHugePageSize() == hugePageSize &&
+         allocator->getNumaNode() == numaNode &&
+         allocator->getCommittedSize() >= poolSize )
+      return pool;
+
+    toolbox::mem::getMemoryPoolFactory()->destroyPool(urn);
+  }
+  catch(toolbox::mem::exception::MemoryPoolNotFound)
+  {
+    // create a new pool
+  }
+
+  HugePageAllocator* allocator = new HugePageAllocator(poolSize, hugePageSize, numaNode);
+  toolbox::mem::Pool* pool = toolbox::mem::getMemoryPoolFactory()->createPool(urn, allocator);
+  pool->setHighThreshold((unsigned long) (allocator->getCommittedSize() * 0.9));
+
+  return pool;
+}
+
+
+void evb::addMemoryPoolRows(cgicc::table& table, toolbox::mem::Pool* pool, const std::string& poolName)
+{
+  using namespace cgicc;
+
+  if ( ! pool ) return;
+
+  toolbox::mem::Allocator* allocator = dynamic_cast<toolbox::mem::Allocator*>(pool->getAllocator());
+  const HugePageAllocator* hugePageAllocator = dynamic_cast<HugePageAllocator*>(allocator);
+
+  std::ostringstream usage;
+  usage << doubleToString(allocator->getUsed()/1e6,1);
+  if ( allocator->isCommittedSizeSupported() )
+    usage << " / " << doubleToString(allocator->getCommittedSize()/1e6,1);
+  table.add(tr()
+            .add(td(poolName+" usage (MB)"))
+            .add(td(usage.str())));
+
+  std::ostringstream pages;
+  if ( hugePageAllocator )
+  {
+    pages << hugePageAllocator->getHugePageSize()/1024 << " kB";
+    if ( hugePageAllocator->getNumaNode() >= 0 )
+      pages << " on node " << hugePageAllocator->getNumaNode();
+    pages << ", " << hugePageAllocator->getPrefaultPageFaults() << " faults when pre-faulting";
+  }
+  else
+  {
+    pages << allocator->type();
+  }
+  table.add(tr()
+            .add(td(poolName+" pages"))
+            .add(td(pages.str())));
+
+  struct rusage rusage;
+  getrusage(RUSAGE_SELF, &rusage);
+  table.add(tr()
+            .add(td("page faults (minor/major)"))
+            .add(td(boost::lexical_cast<std::string>(rusage.ru_minflt)+"/"+
+                    boost::lexical_cast<std::string>(rusage.ru_majflt))));
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -1,34 +1,36 @@
-#include "evb/I2OMessages.h"
+#include <sstream>
 
+#include "evb/Exception.h"
+#include "evb/I2OMessages.h"
 
-void evb::msg::EventRequest::getEvBids(evb::msg::EvBids& ids) const
-{
-  ids.clear();
-  ids.reserve(nbRequests);
 
-  unsigned char* payload = (unsigned char*)&evbIds[0];
+namespace {
 
-  for (uint32_t i=0; i < nbRequests; ++i)
+  void checkSize(const std::string& what, const size_t neededSize, const size_t availableSize)
   {
-    ids.push_back( *(EvBid*)payload );
-    payload += sizeof(EvBid);
+    if ( neededSize > availableSize )
+    {
+      std::ostringstream msg;
+      msg << "The ids in the " << what << " need " << neededSize;
+      msg << " Bytes, but only " << availableSize << " Bytes are available";
+      XCEPT_RAISE(evb::exception::I2O, msg.str());
+    }
   }
+
 }
 
 
-void evb::msg::EventRequest::getRUtids(evb::msg::RUtids& tids) const
+evb::msg::EvBidsView evb::msg::EventRequest::getEvBids() const
 {
-  tids.clear();
-  tids.reserve(nbRUtids);
+  checkSize("event request", sizeof(EventRequest) + nbRequests*sizeof(EvBid) + nbRUtids*sizeof(I2O_TID), msgSize);
+  return EvBidsView((const EvBid*)&evbIds[0], nbRequests);
+}
 
-  unsigned char* payload = (unsigned char*)&evbIds[0] +
-    nbRequests * sizeof(EvBid);
 
-  for (uint32_t i=0; i < nbRUtids; ++i)
-  {
-    tids.push_back( *(I2O_TID*)payload );
-    payload += sizeof(I2O_TID);
-  }
+evb::msg::RUtidsView evb::msg::EventRequest::getRUtids() const
+{
+  checkSize("event request", sizeof(EventRequest) + nbRequests*sizeof(EvBid) + nbRUtids*sizeof(I2O_TID), msgSize);
+  return RUtidsView((const I2O_TID*)((const unsigned char*)&evbIds[0] + nbRequests*sizeof(EvBid)), nbRUtids);
 }
 
 
@@ -44,34 +46,19 @@ void evb::msg::SuperFragment::appendFedIds(evb::msg::FedIds& feds) const
 }
 
 
-void evb::msg::I2O_DATA_BLOCK_MESSAGE_FRAME::getEvBids(evb::msg::EvBids& ids) const
+evb::msg::EvBidsView evb::msg::I2O_DATA_BLOCK_MESSAGE_FRAME::getEvBids() const
 {
-  ids.clear();
-  ids.reserve(nbSuperFragments);
-
-  unsigned char* payload = (unsigned char*)&evbIds[0];
-
-  for (uint32_t i=0; i < nbSuperFragments; ++i)
-  {
-    ids.push_back( *(EvBid*)payload );
-    payload += sizeof(EvBid);
-  }
+  checkSize("I2O_DATA_BLOCK_MESSAGE_FRAME header",
+            sizeof(I2O_DATA_BLOCK_MESSAGE_FRAME) + nbSuperFragments*sizeof(EvBid) + nbRUtids*sizeof(I2O_TID), headerSize);
+  return EvBidsView((const EvBid*)&evbIds[0], nbSuperFragments);
 }
 
 
-void evb::msg::I2O_DATA_BLOCK_MESSAGE_FRAME::getRUtids(evb::msg::RUtids& tids) const
+evb::msg::RUtidsView evb::msg::I2O_DATA_BLOCK_MESSAGE_FRAME::getRUtids() const
 {
-  tids.clear();
-  tids.reserve(nbRUtids);
-
-  unsigned char* payload = (unsigned char*)&evbIds[0] +
-    nbSuperFragments * sizeof(EvBid);
-
-  for (uint32_t i=0; i < nbRUtids; ++i)
-  {
-    tids.push_back( *(I2O_TID*)payload );
-    payload += sizeof(I2O_TID);
-  }
+  checkSize("I2O_DATA_BLOCK_MESSAGE_FRAME header",
+            sizeof(I2O_DATA_BLOCK_MESSAGE_FRAME) + nbSuperFragments*sizeof(EvBid) + nbRUtids*sizeof(I2O_TID), headerSize);
+  return RUtidsView((const I2O_TID*)((const unsigned char*)&evbIds[0] + nbSuperFragments*sizeof(EvBid)), nbRUtids);
 }
 
 
@@ -126,14 +113,12 @@ std::ostream& evb::msg::operator<<
     str << "  nbDiscards=" << eventRequest->nbDiscards << std::endl;
     str << "  nbRUtids=" << eventRequest->nbRUtids << std::endl;
 
-    evb::msg::EvBids evbIds;
-    eventRequest->getEvBids(evbIds);
+    const evb::msg::EvBidsView evbIds = eventRequest->getEvBids();
     str << "  evbIds:" << std::endl;
     for (uint32_t i=0; i < eventRequest->nbRequests; ++i)
       str << "     [" << i << "]: " << evbIds[i] << std::endl;
 
-    evb::msg::RUtids ruTids;
-    eventRequest->getRUtids(ruTids);
+    const evb::msg::RUtidsView ruTids = eventRequest->getRUtids();
     str << "  ruTids:" << std::endl;
     for (uint32_t i=0; i < eventRequest->nbRUtids; ++i)
       str << "     [" << i << "]: " << ruTids[i] << std::endl;
@@ -156,6 +141,8 @@ std::ostream& evb::msg::operator<<
   str << "superFragmentNb=" << superFragment.superFragmentNb << std::endl;
   str << "totalSize=" << superFragment.totalSize << std::endl;
   str << "partSize=" << superFragment.partSize << std::endl;
+  if ( superFragment.hasCRC32c )
+    str << "crc32c=0x" << std::hex << superFragment.crc32c << std::dec << std::endl;
   str << "nbDroppedFeds=" << superFragment.nbDroppedFeds << std::endl;
 
   if ( superFragment.nbDroppedFeds > 0 )
@@ -185,20 +172,19 @@ std::ostream& evb::msg::operator<<
   str << "buResourceId=" << dataBlockMsg.buResourceId << std::endl;
   str << "nbBlocks=" << dataBlockMsg.nbBlocks << std::endl;
   str << "blockNb=" << dataBlockMsg.blockNb << std::endl;
+  str << "version=" << dataBlockMsg.version << std::endl;
   str << "timeStampNS=" << dataBlockMsg.timeStampNS << std::endl;
   str << "nbSuperFragments=" << dataBlockMsg.nbSuperFragments << std::endl;
   str << "nbRUtids=" << dataBlockMsg.nbRUtids << std::endl;
 
   if ( dataBlockMsg.blockNb == 1 )
   {
-    evb::msg::EvBids evbIds;
-    dataBlockMsg.getEvBids(evbIds);
+    const evb::msg::EvBidsView evbIds = dataBlockMsg.getEvBids();
     str << "evbIds:" << std::endl;
     for (uint32_t i=0; i < dataBlockMsg.nbSuperFragments; ++i)
       str << "   [" << i << "]: " << evbIds[i] << std::endl;
 
-    evb::msg::RUtids ruTids;
-    dataBlockMsg.getRUtids(ruTids);
+    const evb::msg::RUtidsView ruTids = dataBlockMsg.getRUtids();
     str << "ruTids:" << std::endl;
     for (uint32_t i=0; i < dataBlockMsg.nbRUtids; ++i)
       str << "   [" << i << "]: " << ruTids[i] << std::endl;
@@ -1,9 +1,42 @@
 #include "evb/Exception.h"
 #include "evb/InfoSpaceItems.h"
+#include "xdata/AbstractVector.h"
+#include "xdata/Boolean.h"
+#include "xdata/Double.h"
 
+#include <math.h>
 #include <sstream>
 
 
+namespace {
+
+  bool isNumeric(xdata::Serializable* item)
+  {
+    const std::string type = item->type();
+    return ( type.compare(0,8,"unsigned") == 0 ||
+             type.compare(0,3,"int") == 0 ||
+             type == "double" || type == "float" || type == "bool" );
+  }
+
+
+  void writeSample(std::ostream& out, xdata::Serializable* item)
+  {
+    const xdata::Boolean* boolean = dynamic_cast<xdata::Boolean*>(item);
+    const xdata::Double* number = dynamic_cast<xdata::Double*>(item);
+    if ( boolean )
+      out << ( boolean->value_ ? 1 : 0 );
+    else if ( number && isnan(number->value_) )
+      out << "NaN";
+    else if ( number && isinf(number->value_) )
+      out << ( number->value_ > 0 ? "+Inf" : "-Inf" );
+    else
+      out << item->toString();
+    out << "\n";
+  }
+
+}
+
+
 void evb::InfoSpaceItems::add
 (
   const std::string& name,
@@ -69,6 +102,40 @@ void evb::InfoSpaceItems::putIntoInfoSpace(xdata::InfoSpace* s, xdata::ActionLis
 }
 
 
+void evb::InfoSpaceItems::writePrometheusMetrics
+(
+  std::ostream& out,
+  const std::string& prefix,
+  const std::string& labels
+) const
+{
+  for (Items::const_iterator it = items_.begin(), itEnd = items_.end(); it != itEnd; ++it)
+  {
+    xdata::Serializable* item = it->second.first;
+    const std::string name = prefix + it->first;
+
+    if ( item->type() == "vector" )
+    {
+      xdata::AbstractVector* vector = dynamic_cast<xdata::AbstractVector*>(item);
+      if ( ! vector || vector->elements() == 0 || ! isNumeric(vector->elementAt(0)) ) continue;
+
+      out << "# TYPE " << name << " gauge\n";
+      for (size_t i = 0; i < vector->elements(); ++i)
+      {
+        out << name << "{" << labels << ",index=\"" << i << "\"} ";
+        writeSample(out, vector->elementAt(i));
+      }
+    }
+    else if ( isNumeric(item) )
+    {
+      out << "# TYPE " << name << " gauge\n";
+      out << name << "{" << labels << "} ";
+      writeSample(out, item);
+    }
+  }
+}
+
+
 /// emacs configuration
 /// Local Variables: -
 /// mode: c++ -
@@ -0,0 +1,136 @@
+#include <algorithm>
+
+#include "evb/LumiSectionCounters.h"
+
+
+const uint32_t evb::LumiSectionCounters::noLumiSection;
+
+
+evb::LumiSectionCounters::LumiSectionCounters(const uint32_t window, const uint16_t nbThreads)
+{
+  resize(window,nbThreads);
+}
+
+
+void evb::LumiSectionCounters::resize(const uint32_t window, const uint16_t nbThreads)
+{
+  window_ = std::max(1U,window);
+  nbThreads_ = std::max(static_cast<uint16_t>(1),nbThreads);
+  slots_.clear();
+  slots_.resize(window_);
+  counters_.clear();
+  counters_.resize(window_*nbThreads_);
+  incrementing_.clear();
+  incrementing_.resize(nbThreads_);
+  clear();
+}
+
+
+void evb::LumiSectionCounters::clear()
+{
+  for (Slots::iterator it = slots_.begin(), itEnd = slots_.end(); it != itEnd; ++it)
+    it->lumiSection = noLumiSection;
+  for (Counters::iterator it = counters_.begin(), itEnd = counters_.end(); it != itEnd; ++it)
+    it->count = 0;
+  for (Slots::iterator it = incrementing_.begin(), itEnd = incrementing_.end(); it != itEnd; ++it)
+    it->lumiSection = noLumiSection;
+  oldestOpen_ = 0;
+  closing_ = noLumiSection;
+}
+
+
+void evb::LumiSectionCounters::open(const uint32_t lumiSection)
+{
+  const uint32_t slot = lumiSection % window_;
+
+  // invalidate the slot first such that readers do not see the reset counters
+  slots_[slot].lumiSection = noLumiSection;
+  __sync_synchronize();
+  for (uint16_t thread = 0; thread < nbThreads_; ++thread)
+    counters_[thread*window_ + slot].count = 0;
+  __sync_synchronize();
+  slots_[slot].lumiSection = lumiSection;
+}
+
+
+bool evb::LumiSectionCounters::incrementIfNotClosed(const uint32_t lumiSection, const uint16_t thread)
+{
+  // Announce the event before looking at the lumi section: either the closing
+  // thread sees the announcement and does not close the lumi section, or this
+  // thread sees that it is being closed and waits for the outcome.
+  incrementing_[thread].lumiSection = lumiSection;
+  __sync_synchronize();
+  if ( closing_ == lumiSection )
+  {
+    boost::mutex::scoped_lock sl(closingMutex_);
+    while ( closing_ == lumiSection )
+      closingDone_.wait(sl);
+  }
+
+  const bool isClosed = ( lumiSection < oldestOpen_ );
+  if ( ! isClosed )
+    increment(lumiSection,thread);
+  __sync_synchronize();
+  incrementing_[thread].lumiSection = noLumiSection;
+
+  return ! isClosed;
+}
+
+
+bool evb::LumiSectionCounters::closeIfCountIs(const uint32_t lumiSection, const uint32_t nbEvents)
+{
+  bool closed = false;
+
+  closing_ = lumiSection;
+  __sync_synchronize();
+  if ( ! isIncrementing(lumiSection) && getCount(lumiSection) == nbEvents )
+  {
+    oldestOpen_ = lumiSection + 1;
+    closed = true;
+  }
+  __sync_synchronize();
+
+  {
+    boost::mutex::scoped_lock sl(closingMutex_);
+    closing_ = noLumiSection;
+  }
+  closingDone_.notify_all();
+
+  return closed;
+}
+
+
+bool evb::LumiSectionCounters::isIncrementing(const uint32_t lumiSection) const
+{
+  for (Slots::const_iterator it = incrementing_.begin(), itEnd = incrementing_.end(); it != itEnd; ++it)
+  {
+    if ( it->lumiSection == lumiSection ) return true;
+  }
+  return false;
+}
+
+
+uint32_t evb::LumiSectionCounters::getCount(const uint32_t lumiSection) const
+{
+  if ( ! isOpen(lumiSection) ) return 0;
+
+  const uint32_t slot = lumiSection % window_;
+  uint32_t count = 0;
+  __sync_synchronize();
+  for (uint16_t thread = 0; thread < nbThreads_; ++thread)
+    count += counters_[thread*window_ + slot].count;
+  __sync_synchronize();
+
+  // the slot might have been re-opened for a newer lumi section meanwhile
+  if ( ! isOpen(lumiSection) ) return 0;
+
+  return count;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -26,40 +26,137 @@ namespace evb {
     template<>
     void BUproxy<RU>::handleRequest(const msg::EventRequest* eventRequest, FragmentRequestPtr& fragmentRequest)
     {
-      eventRequest->getEvBids(fragmentRequest->evbIds);
-      eventRequest->getRUtids(fragmentRequest->ruTids);
+      // the request message is released before the request is processed, thus copy the ids.
+      // The pooled request keeps the memory of its vectors.
+      const msg::EvBidsView evbIds = eventRequest->getEvBids();
+      fragmentRequest->evbIds.assign(evbIds.begin(),evbIds.end());
+      const msg::RUtidsView ruTids = eventRequest->getRUtids();
+      fragmentRequest->ruTids.assign(ruTids.begin(),ruTids.end());
 
       fragmentRequestFIFO_.enqWait(fragmentRequest);
     }
 
 
     template<>
-    bool BUproxy<RU>::processRequest(FragmentRequestPtr& fragmentRequest, SuperFragments& superFragments)
+    void BUproxy<RU>::startAssembling()
     {
-      boost::mutex::scoped_lock sl(processingRequestMutex_);
-
-      if ( doProcessing_ && fragmentRequestFIFO_.deq(fragmentRequest) )
+      if ( ! assemblingWL_ )
       {
         try
         {
+          assemblingWL_ = toolbox::task::getWorkLoopFactory()->
+            getWorkLoop( readoutUnit_->getIdentifier("requestAssembler"), "waiting" );
+
+          assemblingAction_ =
+            toolbox::task::bind(this, &evb::readoutunit::BUproxy<RU>::assembleRequests,
+                                readoutUnit_->getIdentifier("assembleRequests") );
+
+          if ( ! assemblingWL_->isActive() )
+            assemblingWL_->activate();
+        }
+        catch(xcept::Exception& e)
+        {
+          std::string msg = "Failed to start workloop 'requestAssembler'";
+          XCEPT_RETHROW(exception::WorkLoop, msg, e);
+        }
+      }
+      assemblingWL_->submit(assemblingAction_);
+    }
+
+
+    template<>
+    bool BUproxy<RU>::assembleRequests(toolbox::task::WorkLoop*)
+    {
+      if ( ! doProcessing_ ) return false;
+
+      {
+        boost::mutex::scoped_lock sl(processesActiveMutex_);
+        assemblerActive_ = true;
+      }
+
+      try
+      {
+        // The super fragments must be extracted from the FEROL streams in the order
+        // of the requests. Thus, only this workloop dequeues the requests.
+        AssembledRequest assembledRequest;
+        while ( doProcessing_ && fragmentRequestFIFO_.deq(assembledRequest.fragmentRequest) )
+        {
+          const FragmentRequestPtr& fragmentRequest = assembledRequest.fragmentRequest;
           for (uint32_t i=0; i < fragmentRequest->nbRequests; ++i)
           {
             const EvBid& evbId = fragmentRequest->evbIds.at(i);
             SuperFragmentPtr superFragment;
             input_->getSuperFragmentWithEvBid(evbId, superFragment);
-            superFragments.push_back(superFragment);
+            assembledRequest.superFragments.push_back(superFragment);
           }
           {
             boost::mutex::scoped_lock sl(requestMonitoringMutex_);
             --requestMonitoring_.activeRequests;
           }
 
-          return true;
+          assembledRequestFIFO_.enqWait(assembledRequest,doProcessing_);
+          assembledRequest.fragmentRequest.reset();
+          assembledRequest.superFragments.clear();
+        }
+      }
+      catch(exception::HaltRequested)
+      {
+        // nothing to do
+      }
+      catch(xcept::Exception& e)
+      {
+        {
+          boost::mutex::scoped_lock sl(processesActiveMutex_);
+          assemblerActive_ = false;
+          processesIdle_.notify_all();
         }
-        catch(exception::HaltRequested)
+        readoutUnit_->getStateMachine()->processFSMEvent( Fail(e) );
+      }
+      catch(std::exception& e)
+      {
         {
-          return false;
+          boost::mutex::scoped_lock sl(processesActiveMutex_);
+          assemblerActive_ = false;
+          processesIdle_.notify_all();
         }
+        XCEPT_DECLARE(exception::SuperFragment,
+                      sentinelException, e.what());
+        readoutUnit_->getStateMachine()->processFSMEvent( Fail(sentinelException) );
+      }
+      catch(...)
+      {
+        {
+          boost::mutex::scoped_lock sl(processesActiveMutex_);
+          assemblerActive_ = false;
+          processesIdle_.notify_all();
+        }
+        XCEPT_DECLARE(exception::SuperFragment,
+                      sentinelException, "unkown exception");
+        readoutUnit_->getStateMachine()->processFSMEvent( Fail(sentinelException) );
+      }
+
+      {
+        boost::mutex::scoped_lock sl(processesActiveMutex_);
+        assemblerActive_ = false;
+        processesIdle_.notify_all();
+      }
+
+      ::usleep(10);
+
+      return doProcessing_;
+    }
+
+
+    template<>
+    bool BUproxy<RU>::processRequest(FragmentRequestPtr& fragmentRequest, SuperFragments& superFragments)
+    {
+      // Any number of responders can take the assembled requests concurrently
+      AssembledRequest assembledRequest;
+      if ( doProcessing_ && assembledRequestFIFO_.deq(assembledRequest) )
+      {
+        fragmentRequest = assembledRequest.fragmentRequest;
+        superFragments.swap(assembledRequest.superFragments);
+        return true;
       }
 
       return false;
@@ -70,7 +167,8 @@ namespace evb {
     bool BUproxy<RU>::isEmpty()
     {
       boost::mutex::scoped_lock sl(processesActiveMutex_);
-      return ( fragmentRequestFIFO_.empty() && processesActive_.none() );
+      return ( fragmentRequestFIFO_.empty() && !assemblerActive_ &&
+               assembledRequestFIFO_.empty() && processesActive_.none() );
     }
 
 
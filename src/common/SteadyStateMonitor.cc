@@ -0,0 +1,82 @@
+#include <algorithm>
+
+#include "evb/SteadyStateMonitor.h"
+#include "evb/TimeStamp.h"
+
+
+const uint32_t evb::SteadyStateMonitor::binWidthMS;
+const uint32_t evb::SteadyStateMonitor::minEventsPerWindow;
+
+
+evb::SteadyStateMonitor::SteadyStateMonitor(const uint32_t observationTimeMS) :
+  nbBins_( std::max(2U,observationTimeMS/binWidthMS) ),
+  counts_(nbBins_,0),
+  startTime_(0),
+  observing_(false),
+  timeToSteadyState_(-1)
+{}
+
+
+void evb::SteadyStateMonitor::start()
+{
+  std::fill(counts_.begin(),counts_.end(),0);
+  timeToSteadyState_ = -1;
+  startTime_ = getMonotonicTimeStamp();
+  observing_ = true;
+}
+
+
+void evb::SteadyStateMonitor::countEvents(const uint32_t count)
+{
+  const uint64_t bin = (getMonotonicTimeStamp() - startTime_) / (binWidthMS*1000000ULL);
+  if ( bin < nbBins_ )
+    counts_[bin] += count;
+  else
+    analyse();
+}
+
+
+int32_t evb::SteadyStateMonitor::getTimeToSteadyState()
+{
+  if ( observing_ && getMonotonicTimeStamp() - startTime_ >= nbBins_*binWidthMS*1000000ULL )
+    analyse();
+
+  return timeToSteadyState_;
+}
+
+
+void evb::SteadyStateMonitor::analyse()
+{
+  observing_ = false;
+
+  uint64_t steadyStateEvents = 0;
+  for (uint32_t bin = nbBins_/2; bin < nbBins_; ++bin)
+    steadyStateEvents += counts_[bin];
+  if ( steadyStateEvents == 0 ) return;
+
+  // use windows which contain enough events to be insensitive to fluctuations
+  const uint32_t steadyStateBins = nbBins_ - nbBins_/2;
+  const uint32_t windowSize = std::min(steadyStateBins,
+    std::max(1U,static_cast<uint32_t>(minEventsPerWindow*steadyStateBins/steadyStateEvents)));
+  const double threshold = 0.9 * steadyStateEvents * windowSize / steadyStateBins;
+
+  uint64_t eventsInWindow = 0;
+  for (uint32_t bin = 0; bin < nbBins_; ++bin)
+  {
+    eventsInWindow += counts_[bin];
+    if ( bin >= windowSize ) eventsInWindow -= counts_[bin-windowSize];
+    if ( bin+1 >= windowSize && eventsInWindow >= threshold )
+    {
+      timeToSteadyState_ = (bin+1-windowSize) * binWidthMS;
+      return;
+    }
+  }
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
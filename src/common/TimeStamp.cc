@@ -0,0 +1,116 @@
+#include <pthread.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include "evb/TimeStamp.h"
+
+
+bool evb::MonotonicClock::useTSC_ = false;
+uint64_t evb::MonotonicClock::tscAtCalibration_ = 0;
+uint64_t evb::MonotonicClock::timeAtCalibration_ = 0;
+uint64_t evb::MonotonicClock::nsPerTick_ = 0;
+const uint32_t evb::MonotonicClock::nsPerTickShift;
+
+
+namespace {
+  pthread_once_t calibrationOnce = PTHREAD_ONCE_INIT;
+}
+
+
+void evb::MonotonicClock::calibrate()
+{
+  pthread_once(&calibrationOnce, &MonotonicClock::doCalibrate);
+}
+
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace {
+
+  bool hasInvariantTSC()
+  {
+    unsigned int eax, ebx, ecx, edx;
+    if ( ! __get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007 )
+      return false;
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return ( edx & (1 << 8) );
+  }
+
+  // Read the raw clock and the TSC just before and after it. Retry a few times
+  // to avoid samples where the thread was interrupted between the readings.
+  void sampleClocks(uint64_t& time, uint64_t& tsc)
+  {
+    uint64_t minTicks = ~0ULL;
+    for (int i = 0; i < 10; ++i)
+    {
+      const uint64_t before = __rdtsc();
+      const uint64_t rawTime = evb::MonotonicClock::getRawTime();
+      const uint64_t after = __rdtsc();
+      if ( after - before < minTicks )
+      {
+        minTicks = after - before;
+        time = rawTime;
+        tsc = before + (after - before) / 2;
+      }
+    }
+  }
+
+}
+
+
+void evb::MonotonicClock::doCalibrate()
+{
+  if ( ! hasInvariantTSC() ) return;
+
+  uint64_t startTime = 0, startTSC = 0;
+  sampleClocks(startTime, startTSC);
+
+  struct timespec delay;
+  delay.tv_sec = 0;
+  delay.tv_nsec = 20000000;
+  ::nanosleep(&delay, 0);
+
+  uint64_t stopTime = 0, stopTSC = 0;
+  sampleClocks(stopTime, stopTSC);
+
+  if ( stopTSC <= startTSC || stopTime <= startTime ) return;
+
+  tscAtCalibration_ = stopTSC;
+  timeAtCalibration_ = stopTime;
+  nsPerTick_ = ((stopTime - startTime) << nsPerTickShift) / (stopTSC - startTSC);
+
+  // publish the calibration constants before switching to the TSC
+  __sync_synchronize();
+  useTSC_ = true;
+}
+
+
+double evb::MonotonicClock::getTSCfrequency()
+{
+  if ( ! useTSC_ ) return 0;
+  return static_cast<double>(1ULL << nsPerTickShift) / nsPerTick_;
+}
+
+#else // no time-stamp counter
+
+void evb::MonotonicClock::doCalibrate()
+{}
+
+
+double evb::MonotonicClock::getTSCfrequency()
+{
+  return 0;
+}
+
+#endif
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <math.h>
+#include <sstream>
+#include <stdio.h>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "evb/Constants.h"
+#include "evb/Exception.h"
+#include "evb/TimeStamp.h"
+#include "evb/TriggerPacer.h"
+
+
+namespace {
+
+  const double bunchCrossingNS = 24.95;
+
+}
+
+
+const uint32_t evb::TriggerPacer::scheduleSize;
+const uint32_t evb::TriggerPacer::maxTriggersPerCall;
+const uint32_t evb::TriggerPacer::bunchCrossingsPerOrbit;
+
+
+evb::TriggerPacer::TriggerPacer() :
+  pattern_(CONSTANT),
+  rate_(0),
+  deadTime_(0),
+  schedule_(scheduleSize,0),
+  firstRetained_(0),
+  nextTrigger_(0),
+  highestRequested_(0),
+  baseTime_(0),
+  offset_(0),
+  filledBunchCount_(0),
+  stopped_(false),
+  nbVetoedTriggers_(0),
+  rng_( static_cast<uint32_t>(getTimeStamp()) )
+{
+  // LHC-like filling scheme: groups of 3 trains of 48 bunches separated by 7 empty
+  // bunch crossings, a gap of 38 bunch crossings after each group, and an abort gap
+  // of at least 119 bunch crossings at the end of the orbit
+  const uint32_t trainLength = 48;
+  const uint32_t trainsPerGroup = 3;
+  const uint32_t trainGap = 7;
+  const uint32_t groupGap = 38;
+  const uint32_t abortGap = 119;
+  const uint32_t groupLength = trainsPerGroup*trainLength + (trainsPerGroup-1)*trainGap;
+
+  uint32_t bx = 1;
+  while ( bx + groupLength + abortGap <= bunchCrossingsPerOrbit )
+  {
+    for (uint32_t train = 0; train < trainsPerGroup; ++train)
+    {
+      for (uint32_t bunch = 0; bunch < trainLength; ++bunch)
+        filledBunches_.push_back(bx++);
+      if ( train < trainsPerGroup-1 ) bx += trainGap;
+    }
+    bx += groupGap;
+  }
+}
+
+
+void evb::TriggerPacer::configure(const std::string& pattern, const std::string& rules, const uint32_t deadTime)
+{
+  Pattern newPattern;
+  if ( pattern == "constant" )
+    newPattern = CONSTANT;
+  else if ( pattern == "poisson" )
+    newPattern = POISSON;
+  else if ( pattern == "bunchTrain" )
+    newPattern = BUNCH_TRAIN;
+  else
+  {
+    XCEPT_RAISE(exception::Configuration, "Unknown trigger pattern '"+pattern+"'. Use 'constant', 'poisson' or 'bunchTrain'");
+  }
+
+  Rules newRules;
+  std::istringstream ruleList(rules);
+  std::string rule;
+  while ( std::getline(ruleList,rule,',') )
+  {
+    uint32_t nbTriggers = 0;
+    uint32_t window = 0;
+    char trailing;
+    if ( sscanf(rule.c_str()," %u / %u %c",&nbTriggers,&window,&trailing) != 2 ||
+         nbTriggers == 0 || nbTriggers >= scheduleSize/2 || window == 0 )
+    {
+      std::ostringstream msg;
+      msg << "Invalid trigger rule '" << rule << "'. ";
+      msg << "Expected 'N/W' allowing at most 0 < N < " << scheduleSize/2;
+      msg << " triggers in any window of W > 0 bunch crossings";
+      XCEPT_RAISE(exception::Configuration, msg.str());
+    }
+    newRules.push_back( Rules::value_type(nbTriggers,static_cast<uint64_t>(window*bunchCrossingNS)) );
+  }
+
+  boost::mutex::scoped_lock sl(mutex_);
+  pattern_ = newPattern;
+  rules_.swap(newRules);
+  deadTime_ = deadTime;
+}
+
+
+void evb::TriggerPacer::setRate(const uint32_t rate)
+{
+  boost::mutex::scoped_lock sl(mutex_);
+
+  rate_ = rate;
+  rebase( getMonotonicTimeStamp() );
+  scheduleChanged_.notify_all();
+}
+
+
+void evb::TriggerPacer::start()
+{
+  boost::mutex::scoped_lock sl(mutex_);
+
+  stopped_ = false;
+  firstRetained_ = 0;
+  nextTrigger_ = 0;
+  highestRequested_ = 0;
+  nbVetoedTriggers_ = 0;
+  rebase( getMonotonicTimeStamp() );
+  scheduleChanged_.notify_all();
+}
+
+
+void evb::TriggerPacer::stop()
+{
+  boost::mutex::scoped_lock sl(mutex_);
+
+  stopped_ = true;
+  scheduleChanged_.notify_all();
+}
+
+
+uint32_t evb::TriggerPacer::waitForTrigger(const uint64_t triggerNumber)
+{
+  boost::mutex::scoped_lock sl(mutex_);
+
+  uint64_t now = 0;
+  for (;;)
+  {
+    if ( stopped_ ) return 1;
+
+    if ( rate_ == 0 )
+    {
+      highestRequested_ = std::max(highestRequested_,triggerNumber+maxTriggersPerCall);
+      return maxTriggersPerCall;
+    }
+
+    now = getMonotonicTimeStamp();
+    const uint64_t triggerTime = getTriggerTime(triggerNumber);
+    if ( triggerTime <= now ) break;
+
+    // sleep until the trigger is due unless the schedule changes
+    scheduleChanged_.timed_wait(sl, boost::posix_time::microseconds((triggerTime-now+999)/1000));
+  }
+
+  uint32_t nbTriggers = 1;
+  while ( nbTriggers < maxTriggersPerCall && getTriggerTime(triggerNumber+nbTriggers) <= now )
+    ++nbTriggers;
+
+  highestRequested_ = std::max(highestRequested_,triggerNumber+nbTriggers);
+
+  return nbTriggers;
+}
+
+
+uint64_t evb::TriggerPacer::getNbVetoedTriggers() const
+{
+  boost::mutex::scoped_lock sl(mutex_);
+  return nbVetoedTriggers_;
+}
+
+
+void evb::TriggerPacer::rebase(const uint64_t now)
+{
+  // discard the triggers scheduled in the future. They will be rescheduled from now on
+  while ( nextTrigger_ > firstRetained_ && schedule_[(nextTrigger_-1) & (scheduleSize-1)] > now )
+    --nextTrigger_;
+
+  // continue after any trigger handed out while the rate was not limited
+  if ( highestRequested_ > nextTrigger_ )
+  {
+    firstRetained_ = highestRequested_;
+    nextTrigger_ = highestRequested_;
+  }
+
+  baseTime_ = now;
+  offset_ = 0;
+  filledBunchCount_ = 0;
+}
+
+
+uint64_t evb::TriggerPacer::getTriggerTime(const uint64_t triggerNumber)
+{
+  const uint64_t oldestRetained = std::max(firstRetained_,
+                                           nextTrigger_ > scheduleSize ? nextTrigger_-scheduleSize : 0);
+
+  // triggers no longer retained are in the past
+  if ( triggerNumber < oldestRetained ) return 0;
+
+  while ( triggerNumber >= nextTrigger_ )
+    scheduleNextTrigger();
+
+  return schedule_[triggerNumber & (scheduleSize-1)];
+}
+
+
+void evb::TriggerPacer::scheduleNextTrigger()
+{
+  uint64_t candidate = getNextCandidate();
+  while ( isVetoed(candidate) )
+  {
+    ++nbVetoedTriggers_;
+    candidate = getNextCandidate();
+  }
+  schedule_[nextTrigger_ & (scheduleSize-1)] = candidate;
+  ++nextTrigger_;
+}
+
+
+uint64_t evb::TriggerPacer::getNextCandidate()
+{
+  switch (pattern_)
+  {
+    case CONSTANT:
+      offset_ += 1e9/rate_;
+      break;
+
+    case POISSON:
+      offset_ -= log(1-getUniform()) * 1e9/rate_;
+      break;
+
+    case BUNCH_TRAIN:
+    {
+      // skip a geometrically distributed number of filled bunches
+      const double orbitTime = bunchCrossingsPerOrbit * bunchCrossingNS / 1e9;
+      const double probability = rate_ * orbitTime / filledBunches_.size();
+      if ( probability < 1 )
+        filledBunchCount_ += static_cast<uint64_t>( log(1-getUniform()) / log(1-probability) );
+      const uint64_t orbit = filledBunchCount_ / filledBunches_.size();
+      const uint16_t bunchCrossing = filledBunches_[filledBunchCount_ % filledBunches_.size()];
+      offset_ = (orbit*bunchCrossingsPerOrbit + bunchCrossing) * bunchCrossingNS;
+      ++filledBunchCount_;
+      break;
+    }
+  }
+  return baseTime_ + static_cast<uint64_t>(offset_);
+}
+
+
+bool evb::TriggerPacer::isVetoed(const uint64_t candidate) const
+{
+  if ( nextTrigger_ == firstRetained_ ) return false;
+
+  const uint64_t lastTrigger = schedule_[(nextTrigger_-1) & (scheduleSize-1)];
+  if ( candidate < lastTrigger + deadTime_ ) return true;
+
+  for (Rules::const_iterator it = rules_.begin(), itEnd = rules_.end(); it != itEnd; ++it)
+  {
+    if ( nextTrigger_ >= firstRetained_ + it->first &&
+         schedule_[(nextTrigger_ - it->first) & (scheduleSize-1)] + it->second > candidate )
+      return true;
+  }
+  return false;
+}
+
+
+double evb::TriggerPacer::getUniform()
+{
+  return rng_() / 4294967296.0;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,105 @@
+#include <limits>
+#include <sstream>
+#include <string.h>
+
+#include "evb/bu/CompressedFrame.h"
+#include "evb/Constants.h"
+#include "evb/Exception.h"
+#include "evb/TimeStamp.h"
+
+
+evb::bu::CompressedFrame::CompressedFrame() :
+  creationTime_(getMonotonicTimeStamp()),
+  nbEvents_(0),
+  firstEventNumber_(0),
+  uncompressedSize_(0),
+  compressionTime_(0),
+  done_(false)
+{}
+
+
+void evb::bu::CompressedFrame::addEvent(const EventPtr& event)
+{
+  if ( events_.empty() )
+    firstEventNumber_ = event->getEventInfo()->eventNumber();
+
+  events_.push_back(event);
+  ++nbEvents_;
+  uncompressedSize_ += sizeof(EventInfo) + event->getEventInfo()->eventSize();
+}
+
+
+void evb::bu::CompressedFrame::compress
+(
+  compression::Codec& codec,
+  std::vector<unsigned char>& scratch
+)
+{
+  const uint64_t startTime = getMonotonicTimeStamp();
+
+  if ( uncompressedSize_ > std::numeric_limits<uint32_t>::max() )
+  {
+    std::ostringstream msg;
+    msg << "Cannot compress " << nbEvents_ << " events starting with event " << firstEventNumber_;
+    msg << " into one frame: the frame size of " << uncompressedSize_ << " Bytes exceeds 4 GB";
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+
+  scratch.resize(uncompressedSize_);
+  unsigned char* pos = &scratch[0];
+
+  for ( Events::const_iterator it = events_.begin(), itEnd = events_.end();
+        it != itEnd; ++it )
+  {
+    const EventInfoPtr& eventInfo = (*it)->getEventInfo();
+    memcpy(pos, eventInfo.get(), sizeof(EventInfo));
+    pos += sizeof(EventInfo);
+
+    const DataLocations& locs = (*it)->getDataLocations();
+    for ( DataLocations::const_iterator loc = locs.begin(), locEnd = locs.end();
+          loc != locEnd; ++loc )
+    {
+      memcpy(pos, loc->iov_base, loc->iov_len);
+      pos += loc->iov_len;
+    }
+  }
+
+  if ( pos != &scratch[0] + uncompressedSize_ )
+  {
+    std::ostringstream msg;
+    msg << "Failed to gather " << nbEvents_ << " events starting with event " << firstEventNumber_;
+    msg << ": the data locations do not match the event sizes";
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+
+  // the data has been copied, release the I2O buffers
+  events_.clear();
+
+  buffer_.resize( sizeof(compression::FrameHeader) + codec.compressBound(uncompressedSize_) );
+  const size_t compressedSize = codec.compress(&scratch[0], uncompressedSize_,
+                                               &buffer_[sizeof(compression::FrameHeader)],
+                                               buffer_.size() - sizeof(compression::FrameHeader));
+  buffer_.resize( sizeof(compression::FrameHeader) + compressedSize );
+
+  compression::FrameHeader* header = reinterpret_cast<compression::FrameHeader*>(&buffer_[0]);
+  header->magic = compression::frameMagic;
+  header->algorithm = codec.getAlgorithm();
+  header->nbEvents = nbEvents_;
+  header->firstEventNumber = firstEventNumber_;
+  header->uncompressedSize = uncompressedSize_;
+  header->compressedSize = compressedSize;
+
+  compressionTime_ = getMonotonicTimeStamp() - startTime;
+
+  // make sure the frame is complete before it is flagged as done
+  __sync_synchronize();
+  done_ = true;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <errno.h>
+#include <lz4.h>
+#include <sstream>
+#include <string.h>
+#include <zstd.h>
+
+#include "evb/bu/Compression.h"
+#include "evb/Exception.h"
+
+
+evb::bu::compression::Algorithm evb::bu::compression::getAlgorithm(const std::string& name)
+{
+  if ( name == "none" ) return NONE;
+  if ( name == "lz4" ) return LZ4;
+  if ( name == "zstd" ) return ZSTD;
+
+  std::ostringstream msg;
+  msg << "Unknown compression algorithm '" << name << "'. Valid choices are none, lz4, and zstd";
+  XCEPT_RAISE(exception::Configuration, msg.str());
+}
+
+
+std::string evb::bu::compression::getName(const Algorithm algorithm)
+{
+  switch (algorithm)
+  {
+    case NONE: return "none";
+    case LZ4: return "lz4";
+    case ZSTD: return "zstd";
+  }
+  return "unknown";
+}
+
+
+evb::bu::compression::Codec::Codec
+(
+  const Algorithm algorithm,
+  const int32_t level
+) :
+  algorithm_(algorithm),
+  level_(level),
+  compressionContext_(0),
+  decompressionContext_(0)
+{
+  if ( algorithm_ == ZSTD )
+  {
+    compressionContext_ = ZSTD_createCCtx();
+    decompressionContext_ = ZSTD_createDCtx();
+    if ( ! compressionContext_ || ! decompressionContext_ )
+    {
+      XCEPT_RAISE(exception::OutOfMemory, "Failed to create the Zstd contexts");
+    }
+  }
+}
+
+
+evb::bu::compression::Codec::~Codec()
+{
+  if ( compressionContext_ )
+    ZSTD_freeCCtx( static_cast<ZSTD_CCtx*>(compressionContext_) );
+  if ( decompressionContext_ )
+    ZSTD_freeDCtx( static_cast<ZSTD_DCtx*>(decompressionContext_) );
+}
+
+
+size_t evb::bu::compression::Codec::compressBound(const size_t size) const
+{
+  switch (algorithm_)
+  {
+    case LZ4: return LZ4_compressBound(size);
+    case ZSTD: return ZSTD_compressBound(size);
+    default: return size;
+  }
+}
+
+
+size_t evb::bu::compression::Codec::compress
+(
+  const void* src,
+  const size_t srcSize,
+  void* dst,
+  const size_t dstCapacity
+)
+{
+  switch (algorithm_)
+  {
+    case LZ4:
+    {
+      // for LZ4, the level is used as acceleration factor
+      const int compressedSize = LZ4_compress_fast(static_cast<const char*>(src), static_cast<char*>(dst),
+                                                   srcSize, dstCapacity, level_ > 1 ? level_ : 1);
+      if ( compressedSize <= 0 )
+      {
+        std::ostringstream msg;
+        msg << "Failed to LZ4 compress " << srcSize << " Bytes into a buffer of " << dstCapacity << " Bytes";
+        XCEPT_RAISE(exception::DiskWriting, msg.str());
+      }
+      return compressedSize;
+    }
+    case ZSTD:
+    {
+      const size_t compressedSize = ZSTD_compressCCtx(static_cast<ZSTD_CCtx*>(compressionContext_),
+                                                      dst, dstCapacity, src, srcSize, level_);
+      if ( ZSTD_isError(compressedSize) )
+      {
+        std::ostringstream msg;
+        msg << "Failed to Zstd compress " << srcSize << " Bytes: " << ZSTD_getErrorName(compressedSize);
+        XCEPT_RAISE(exception::DiskWriting, msg.str());
+      }
+      return compressedSize;
+    }
+    default:
+    {
+      if ( srcSize > dstCapacity )
+      {
+        std::ostringstream msg;
+        msg << "Cannot copy " << srcSize << " Bytes into a buffer of " << dstCapacity << " Bytes";
+        XCEPT_RAISE(exception::DiskWriting, msg.str());
+      }
+      memcpy(dst, src, srcSize);
+      return srcSize;
+    }
+  }
+}
+
+
+void evb::bu::compression::Codec::decompress
+(
+  const void* src,
+  const size_t srcSize,
+  void* dst,
+  const size_t dstSize
+)
+{
+  size_t uncompressedSize = 0;
+
+  switch (algorithm_)
+  {
+    case LZ4:
+    {
+      const int size = LZ4_decompress_safe(static_cast<const char*>(src), static_cast<char*>(dst),
+                                           srcSize, dstSize);
+      if ( size < 0 )
+      {
+        std::ostringstream msg;
+        msg << "Failed to LZ4 decompress " << srcSize << " Bytes: corrupted data";
+        XCEPT_RAISE(exception::DataCorruption, msg.str());
+      }
+      uncompressedSize = size;
+      break;
+    }
+    case ZSTD:
+    {
+      uncompressedSize = ZSTD_decompressDCtx(static_cast<ZSTD_DCtx*>(decompressionContext_),
+                                             dst, dstSize, src, srcSize);
+      if ( ZSTD_isError(uncompressedSize) )
+      {
+        std::ostringstream msg;
+        msg << "Failed to Zstd decompress " << srcSize << " Bytes: " << ZSTD_getErrorName(uncompressedSize);
+        XCEPT_RAISE(exception::DataCorruption, msg.str());
+      }
+      break;
+    }
+    default:
+    {
+      uncompressedSize = std::min(srcSize,dstSize);
+      memcpy(dst, src, uncompressedSize);
+    }
+  }
+
+  if ( uncompressedSize != dstSize )
+  {
+    std::ostringstream msg;
+    msg << "Decompressed " << uncompressedSize << " Bytes while expecting " << dstSize << " Bytes";
+    XCEPT_RAISE(exception::DataCorruption, msg.str());
+  }
+}
+
+
+evb::bu::compression::FileReader::FileReader(const std::string& fileName) :
+  fileName_(fileName),
+  file_(fopen(fileName.c_str(),"rb"))
+{
+  if ( ! file_ )
+  {
+    std::ostringstream msg;
+    msg << "Failed to open " << fileName_ << ": " << strerror(errno);
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+
+  // the destructor is not called if the constructor throws
+  try
+  {
+    readIndex();
+  }
+  catch(...)
+  {
+    fclose(file_);
+    throw;
+  }
+}
+
+
+evb::bu::compression::FileReader::~FileReader()
+{
+  fclose(file_);
+}
+
+
+void evb::bu::compression::FileReader::readIndex()
+{
+  if ( fseeko(file_, 0, SEEK_END) != 0 )
+  {
+    std::ostringstream msg;
+    msg << "Failed to seek to the end of " << fileName_ << ": " << strerror(errno);
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+  const uint64_t fileSize = ftello(file_);
+
+  FileTrailer trailer;
+  if ( fileSize < sizeof(FileTrailer) )
+  {
+    XCEPT_RAISE(exception::DataCorruption, "The file " + fileName_ + " is too small to hold a frame index");
+  }
+  read(&trailer, sizeof(FileTrailer), fileSize - sizeof(FileTrailer));
+
+  if ( trailer.magic != trailerMagic ||
+       trailer.indexOffset + trailer.nbFrames*sizeof(IndexEntry) + sizeof(FileTrailer) != fileSize )
+  {
+    XCEPT_RAISE(exception::DataCorruption, "The file " + fileName_ + " does not end with a valid frame index");
+  }
+
+  index_.resize(trailer.nbFrames);
+  if ( trailer.nbFrames > 0 )
+    read(&index_[0], trailer.nbFrames*sizeof(IndexEntry), trailer.indexOffset);
+}
+
+
+evb::bu::compression::FrameHeader evb::bu::compression::FileReader::readFrame
+(
+  const uint32_t frame,
+  std::vector<unsigned char>& buffer
+)
+{
+  const IndexEntry& indexEntry = index_.at(frame);
+
+  FrameHeader header;
+  read(&header, sizeof(FrameHeader), indexEntry.offset);
+
+  if ( header.magic != frameMagic ||
+       header.compressedSize != indexEntry.compressedSize ||
+       header.uncompressedSize != indexEntry.uncompressedSize ||
+       header.firstEventNumber != indexEntry.firstEventNumber ||
+       header.nbEvents != indexEntry.nbEvents )
+  {
+    std::ostringstream msg;
+    msg << "The header of frame " << frame << " in " << fileName_;
+    msg << " does not match the frame index";
+    XCEPT_RAISE(exception::DataCorruption, msg.str());
+  }
+
+  compressedData_.resize(header.compressedSize);
+  if ( header.compressedSize > 0 )
+    read(&compressedData_[0], header.compressedSize, indexEntry.offset + sizeof(FrameHeader));
+
+  buffer.resize(header.uncompressedSize);
+  if ( header.uncompressedSize > 0 )
+  {
+    Codec codec(static_cast<Algorithm>(header.algorithm), 0);
+    codec.decompress(&compressedData_[0], header.compressedSize, &buffer[0], header.uncompressedSize);
+  }
+
+  return header;
+}
+
+
+void evb::bu::compression::FileReader::read(void* buffer, const size_t size, const uint64_t offset)
+{
+  if ( fseeko(file_, offset, SEEK_SET) != 0 || fread(buffer, 1, size, file_) != size )
+  {
+    std::ostringstream msg;
+    msg << "Failed to read " << size << " Bytes at offset " << offset << " from " << fileName_;
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
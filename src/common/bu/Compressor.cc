@@ -0,0 +1,353 @@
+#include <sstream>
+#include <string>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "evb/BU.h"
+#include "evb/Constants.h"
+#include "evb/bu/Compressor.h"
+#include "evb/bu/StateMachine.h"
+#include "evb/Exception.h"
+#include "toolbox/task/WorkLoopFactory.h"
+#include "xcept/tools.h"
+
+
+evb::bu::Compressor::Compressor(BU* bu) :
+  bu_(bu),
+  configuration_(bu->getConfiguration()),
+  algorithm_(compression::NONE),
+  nextFIFO_(0),
+  doProcessing_(false)
+{
+  workerAction_ =
+    toolbox::task::bind(this, &evb::bu::Compressor::process,
+                        bu_->getIdentifier("compressor") );
+
+  resetMonitoringCounters();
+}
+
+
+evb::bu::Compressor::~Compressor()
+{
+  for ( WorkLoops::iterator it = workerWorkLoops_.begin(), itEnd = workerWorkLoops_.end();
+        it != itEnd; ++it)
+  {
+    if ( (*it)->isActive() )
+      (*it)->cancel();
+  }
+}
+
+
+void evb::bu::Compressor::configure()
+{
+  frameFIFOs_.clear();
+  nextFIFO_ = 0;
+
+  algorithm_ = compression::getAlgorithm(configuration_->compressionAlgorithm.value_);
+
+  if ( ! isEnabled() ) return;
+
+  if ( configuration_->eventsPerCompressedFrame == 0U || configuration_->numberOfCompressionWorkers == 0U )
+  {
+    XCEPT_RAISE(exception::Configuration,
+                "Both eventsPerCompressedFrame and numberOfCompressionWorkers must be larger than 0 when compressing the output");
+  }
+
+  {
+    boost::mutex::scoped_lock sl(processesActiveMutex_);
+
+    processesActive_.clear();
+    processesActive_.resize(configuration_->numberOfCompressionWorkers.value_);
+  }
+
+  for (uint16_t i=0; i < configuration_->numberOfCompressionWorkers; ++i)
+  {
+    std::ostringstream fifoName;
+    fifoName << "compressionFIFO_" << i;
+    FrameFIFOPtr frameFIFO( new FrameFIFO(bu_,fifoName.str()) );
+    frameFIFO->resize(configuration_->compressionFIFOCapacity);
+    frameFIFOs_.push_back(frameFIFO);
+  }
+
+  createProcessingWorkLoops();
+}
+
+
+void evb::bu::Compressor::createProcessingWorkLoops()
+{
+  const std::string identifier = bu_->getIdentifier();
+
+  try
+  {
+    // Leave any previous created workloops alone. Only add new ones if needed.
+    for (uint16_t i=workerWorkLoops_.size(); i < configuration_->numberOfCompressionWorkers; ++i)
+    {
+      std::ostringstream workLoopName;
+      workLoopName << identifier << "/Compressor_" << i;
+      toolbox::task::WorkLoop* wl = toolbox::task::getWorkLoopFactory()->getWorkLoop( workLoopName.str(), "waiting" );
+
+      if ( ! wl->isActive() ) wl->activate();
+      workerWorkLoops_.push_back(wl);
+    }
+  }
+  catch(xcept::Exception& e)
+  {
+    XCEPT_RETHROW(exception::WorkLoop, "Failed to start workloops", e);
+  }
+}
+
+
+void evb::bu::Compressor::startProcessing()
+{
+  resetMonitoringCounters();
+
+  if ( ! isEnabled() ) return;
+
+  doProcessing_ = true;
+  for (uint32_t i=0; i < configuration_->numberOfCompressionWorkers; ++i)
+  {
+    workerWorkLoops_.at(i)->submit(workerAction_);
+  }
+}
+
+
+void evb::bu::Compressor::stopProcessing()
+{
+  doProcessing_ = false;
+
+  {
+    boost::mutex::scoped_lock sl(frameQueuedMutex_);
+    frameQueued_.notify_all();
+  }
+  {
+    boost::mutex::scoped_lock sl(frameDoneMutex_);
+    frameDone_.notify_all();
+  }
+
+  {
+    boost::mutex::scoped_lock sl(processesActiveMutex_);
+    while ( processesActive_.any() ) processesIdle_.wait(sl);
+  }
+
+  for (FrameFIFOs::const_iterator it = frameFIFOs_.begin(), itEnd = frameFIFOs_.end();
+       it != itEnd; ++it)
+  {
+    (*it)->clear();
+  }
+}
+
+
+void evb::bu::Compressor::compress(const CompressedFramePtr& frame)
+{
+  boost::mutex::scoped_lock sl(frameFIFOsMutex_);
+
+  frameFIFOs_[nextFIFO_]->enqWait(frame,doProcessing_);
+  nextFIFO_ = (nextFIFO_ + 1) % frameFIFOs_.size();
+
+  boost::mutex::scoped_lock qsl(frameQueuedMutex_);
+  frameQueued_.notify_all();
+}
+
+
+void evb::bu::Compressor::waitUntilDone(const CompressedFramePtr& frame) const
+{
+  boost::mutex::scoped_lock sl(frameDoneMutex_);
+
+  while ( ! frame->isDone() )
+  {
+    if ( ! doProcessing_ )
+    {
+      std::ostringstream msg;
+      msg << "The compression of the frame starting with event " << frame->firstEventNumber();
+      msg << " was not done before the compression workers were stopped";
+      XCEPT_RAISE(exception::DiskWriting, msg.str());
+    }
+    frameDone_.timed_wait(sl, boost::posix_time::milliseconds(100));
+  }
+}
+
+
+bool evb::bu::Compressor::process(toolbox::task::WorkLoop* wl)
+{
+  if ( ! doProcessing_ ) return false;
+
+  const std::string wlName =  wl->getName();
+  const size_t startPos = wlName.find_last_of("_") + 1;
+  const size_t endPos = wlName.find("/",startPos);
+  const uint16_t workerId = boost::lexical_cast<uint16_t>( wlName.substr(startPos,endPos-startPos) );
+
+  {
+    boost::mutex::scoped_lock sl(processesActiveMutex_);
+    processesActive_.set(workerId);
+  }
+
+  try
+  {
+    const FrameFIFOPtr frameFIFO = frameFIFOs_.at(workerId);
+    compression::Codec codec(algorithm_, configuration_->compressionLevel);
+    std::vector<unsigned char> scratch;
+    CompressedFramePtr frame;
+
+    while ( doProcessing_ )
+    {
+      if ( frameFIFO->deq(frame) )
+      {
+        frame->compress(codec,scratch);
+
+        {
+          boost::mutex::scoped_lock sl(frameDoneMutex_);
+          frameDone_.notify_all();
+        }
+
+        boost::mutex::scoped_lock sl(compressionMonitoringMutex_);
+        ++compressionMonitoring_.nbFrames;
+        compressionMonitoring_.nbEvents += frame->nbEvents();
+        compressionMonitoring_.uncompressedBytes += frame->uncompressedSize();
+        compressionMonitoring_.compressedBytes += frame->size();
+        compressionMonitoring_.compressionTime += frame->compressionTime();
+      }
+      else
+      {
+        boost::mutex::scoped_lock sl(frameQueuedMutex_);
+        while ( frameFIFO->empty() && doProcessing_ )
+          frameQueued_.timed_wait(sl, boost::posix_time::milliseconds(100));
+      }
+    }
+  }
+  catch(xcept::Exception& e)
+  {
+    {
+      boost::mutex::scoped_lock sl(processesActiveMutex_);
+      processesActive_.reset(workerId);
+      processesIdle_.notify_all();
+    }
+    stateMachine_->processFSMEvent( Fail(e) );
+  }
+  catch(std::exception& e)
+  {
+    {
+      boost::mutex::scoped_lock sl(processesActiveMutex_);
+      processesActive_.reset(workerId);
+      processesIdle_.notify_all();
+    }
+    XCEPT_DECLARE(exception::DiskWriting,
+                  sentinelException, e.what());
+    stateMachine_->processFSMEvent( Fail(sentinelException) );
+  }
+  catch(...)
+  {
+    {
+      boost::mutex::scoped_lock sl(processesActiveMutex_);
+      processesActive_.reset(workerId);
+      processesIdle_.notify_all();
+    }
+    XCEPT_DECLARE(exception::DiskWriting,
+                  sentinelException, "unkown exception");
+    stateMachine_->processFSMEvent( Fail(sentinelException) );
+  }
+
+  {
+    boost::mutex::scoped_lock sl(processesActiveMutex_);
+    processesActive_.reset(workerId);
+    processesIdle_.notify_all();
+  }
+
+  return false;
+}
+
+
+void evb::bu::Compressor::appendMonitoringItems(InfoSpaceItems& items)
+{
+  compressionRatio_ = 0;
+  compressionThroughput_ = 0;
+
+  items.add("compressionRatio", &compressionRatio_);
+  items.add("compressionThroughput", &compressionThroughput_);
+}
+
+
+void evb::bu::Compressor::updateMonitoringItems()
+{
+  boost::mutex::scoped_lock sl(compressionMonitoringMutex_);
+
+  compressionRatio_ = compressionMonitoring_.compressedBytes > 0 ?
+    static_cast<double>(compressionMonitoring_.uncompressedBytes) / compressionMonitoring_.compressedBytes : 0;
+  compressionThroughput_ = compressionMonitoring_.compressionTime > 0 ?
+    compressionMonitoring_.uncompressedBytes * 1e3 / compressionMonitoring_.compressionTime : 0;
+}
+
+
+void evb::bu::Compressor::resetMonitoringCounters()
+{
+  boost::mutex::scoped_lock sl(compressionMonitoringMutex_);
+
+  compressionMonitoring_.nbFrames = 0;
+  compressionMonitoring_.nbEvents = 0;
+  compressionMonitoring_.uncompressedBytes = 0;
+  compressionMonitoring_.compressedBytes = 0;
+  compressionMonitoring_.compressionTime = 0;
+}
+
+
+cgicc::div evb::bu::Compressor::getHtmlSnipped() const
+{
+  using namespace cgicc;
+
+  cgicc::div div;
+
+  {
+    cgicc::table table;
+    table.set("title","Compression of the raw data since the beginning of the run. The throughput is the average throughput of a single worker thread.");
+
+    boost::mutex::scoped_lock sl(compressionMonitoringMutex_);
+
+    table.add(tr()
+              .add(td("compression"))
+              .add(td(compression::getName(algorithm_))));
+    table.add(tr()
+              .add(td("# frames compressed"))
+              .add(td(boost::lexical_cast<std::string>(compressionMonitoring_.nbFrames))));
+    table.add(tr()
+              .add(td("# events compressed"))
+              .add(td(boost::lexical_cast<std::string>(compressionMonitoring_.nbEvents))));
+    table.add(tr()
+              .add(td("compression ratio"))
+              .add(td(doubleToString(compressionMonitoring_.compressedBytes > 0 ?
+                                     static_cast<double>(compressionMonitoring_.uncompressedBytes) / compressionMonitoring_.compressedBytes : 0, 2))));
+    table.add(tr()
+              .add(td("throughput per worker (MB/s)"))
+              .add(td(doubleToString(compressionMonitoring_.compressionTime > 0 ?
+                                     compressionMonitoring_.uncompressedBytes * 1e3 / compressionMonitoring_.compressionTime : 0, 1))));
+    div.add(table);
+  }
+
+  if ( ! frameFIFOs_.empty() )
+  {
+    cgicc::div fifos;
+    fifos.set("title","FIFOs holding frames of events to be compressed by the corresponding worker threads.");
+
+    FrameFIFOs::const_iterator it = frameFIFOs_.begin();
+    while ( it != frameFIFOs_.end() )
+    {
+      try
+      {
+        fifos.add((*it)->getHtmlSnipped());
+        ++it;
+      }
+      catch(...) {}
+    }
+
+    div.add(fifos);
+  }
+
+  return div;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -4,7 +4,9 @@
 #include <boost/filesystem.hpp>
 
 #include "evb/bu/DiskUsage.h"
+#include "evb/Constants.h"
 #include "evb/Exception.h"
+#include "evb/TimeStamp.h"
 #include "xcept/tools.h"
 
 
@@ -12,13 +14,23 @@ evb::bu::DiskUsage::DiskUsage
 (
   const boost::filesystem::path& path,
   const float lowWaterMark,
-  const float highWaterMark
+  const float highWaterMark,
+  const uint32_t predictionHorizon
 ) :
   path_(path),
   lowWaterMark_(lowWaterMark),
   highWaterMark_(highWaterMark),
+  predictionHorizon_(predictionHorizon),
   state_(IDLE),
-  valid_(false)
+  valid_(false),
+  bytesWritten_(0),
+  bytesDeleted_(0),
+  diskSizeBytes_(0),
+  usedBytesAtStatFs_(0),
+  accountedBytesAtStatFs_(0),
+  usedBytesAtLastRate_(0),
+  timeOfLastRate_(0),
+  usageRate_(0)
 {
   if ( lowWaterMark >= highWaterMark )
   {
@@ -66,10 +78,16 @@ void evb::bu::DiskUsage::update()
 
 float evb::bu::DiskUsage::overThreshold()
 {
-  const float diskUsage = relDiskUsage();
+  boost::mutex::scoped_lock lock(mutex_);
 
   if ( ! valid_ ) return 1; //error condition
 
+  float diskUsage = estimateDiskUsage();
+
+  // extrapolate the usage to the end of the prediction horizon
+  if ( predictionHorizon_ > 0 && usageRate_ > 0 && diskSizeBytes_ > 0 )
+    diskUsage += usageRate_ * predictionHorizon_ / diskSizeBytes_;
+
   return (diskUsage < lowWaterMark_) ? 0 :
     (diskUsage - lowWaterMark_) / (highWaterMark_ - lowWaterMark_);
 }
@@ -77,13 +95,46 @@ float evb::bu::DiskUsage::overThreshold()
 
 float evb::bu::DiskUsage::diskSizeGB()
 {
+  boost::mutex::scoped_lock lock(mutex_);
   return ( valid_ ? diskSizeGB_ : -1 );
 }
 
 
 float evb::bu::DiskUsage::relDiskUsage()
 {
-  return ( valid_ ? relDiskUsage_ : -1 );
+  boost::mutex::scoped_lock lock(mutex_);
+  return ( valid_ ? estimateDiskUsage() : -1 );
+}
+
+
+float evb::bu::DiskUsage::timeToFull()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+
+  if ( ! valid_ || usageRate_ <= 0 || diskSizeBytes_ == 0 ) return -1;
+
+  const double remainingBytes = (highWaterMark_ - estimateDiskUsage()) * diskSizeBytes_;
+  return ( remainingBytes > 0 ? remainingBytes / usageRate_ : 0 );
+}
+
+
+float evb::bu::DiskUsage::estimateDiskUsage()
+{
+  if ( diskSizeBytes_ == 0 ) return relDiskUsage_;
+
+  const int64_t usedBytes = estimateUsedBytes();
+
+  if ( usedBytes <= 0 ) return 0;
+  if ( static_cast<uint64_t>(usedBytes) >= diskSizeBytes_ ) return 1;
+  return static_cast<float>(usedBytes) / diskSizeBytes_;
+}
+
+
+int64_t evb::bu::DiskUsage::estimateUsedBytes()
+{
+  // add the bytes written and deleted by the BU since the last statfs
+  const int64_t accountedBytes = bytesWritten_ - bytesDeleted_;
+  return usedBytesAtStatFs_ + (accountedBytes - accountedBytesAtStatFs_);
 }
 
 
@@ -101,23 +152,45 @@ void evb::bu::DiskUsage::doStatFs()
       state_ = UPDATING;
     }
 
+    const int64_t accountedBytes = bytesWritten_ - bytesDeleted_;
     struct statfs64 statfs;
     const int retVal = statfs64(path_.string().c_str(), &statfs);
-
-    if ( retVal == 0 )
-    {
-      diskSizeGB_ = static_cast<float>(statfs.f_blocks * statfs.f_bsize) / 1000 / 1000 / 1000;
-      if ( statfs.f_blocks > statfs.f_bfree )
-        relDiskUsage_ = 1 - static_cast<float>(statfs.f_bfree)/statfs.f_blocks;
-      else
-        relDiskUsage_ = 1;
-      valid_ = true;
-    }
+    const uint64_t timeOfStatFs = getMonotonicTimeStamp();
 
     if (path_ == "/aSlowDiskForUnitTests") ::sleep(5);
 
     {
       boost::mutex::scoped_lock lock(mutex_);
+
+      if ( retVal == 0 )
+      {
+        diskSizeBytes_ = statfs.f_blocks * statfs.f_bsize;
+        diskSizeGB_ = static_cast<float>(diskSizeBytes_) / 1000 / 1000 / 1000;
+        if ( statfs.f_blocks > statfs.f_bfree )
+        {
+          relDiskUsage_ = 1 - static_cast<float>(statfs.f_bfree)/statfs.f_blocks;
+          usedBytesAtStatFs_ = (statfs.f_blocks - statfs.f_bfree) * statfs.f_bsize;
+        }
+        else
+        {
+          relDiskUsage_ = 1;
+          usedBytesAtStatFs_ = diskSizeBytes_;
+        }
+        accountedBytesAtStatFs_ = accountedBytes;
+        valid_ = true;
+
+        // The net rate at which the disk fills is taken from successive statfs calls.
+        // Thus, it includes the files deleted by the HLT and not only the data written by the BU.
+        if ( timeOfLastRate_ > 0 && timeOfStatFs > timeOfLastRate_ )
+        {
+          const double deltaT = (timeOfStatFs - timeOfLastRate_) / 1e9;
+          const double rate = (static_cast<int64_t>(usedBytesAtStatFs_) - usedBytesAtLastRate_) / deltaT;
+          usageRate_ += deltaT / (deltaT + 2) * (rate - usageRate_);
+        }
+        timeOfLastRate_ = timeOfStatFs;
+        usedBytesAtLastRate_ = usedBytesAtStatFs_;
+      }
+
       if (state_ == STOP) break;
       state_ = IDLE;
     }
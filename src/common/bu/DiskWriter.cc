@@ -13,7 +13,9 @@
 #include "evb/bu/DiskWriter.h"
 #include "evb/bu/ResourceManager.h"
 #include "evb/bu/RUproxy.h"
+#include "evb/Constants.h"
 #include "evb/Exception.h"
+#include "evb/TimeStamp.h"
 #include "toolbox/task/WorkLoopFactory.h"
 #include "xdata/String.h"
 #include "xdata/Vector.h"
@@ -27,10 +29,13 @@ evb::bu::DiskWriter::DiskWriter
   bu_(bu),
   resourceManager_(resourceManager),
   configuration_(bu->getConfiguration()),
+  compressor_( new Compressor(bu) ),
+  metaDataWriter_( new MetaDataWriter(bu) ),
   buInstance_(bu->getApplicationDescriptor()->getInstance()),
   doProcessing_(false),
   lumiAccountingActive_(false),
-  fileMoverActive_(false)
+  fileMoverActive_(false),
+  lastIndexFileCheck_(0)
 {
   resetMonitoringCounters();
   startLumiAccounting();
@@ -61,6 +66,10 @@ void evb::bu::DiskWriter::startProcessing(const uint32_t runNumber)
 
   resetMonitoringCounters();
   runNumber_ = runNumber;
+  indexFiles_.clear();
+  lastIndexFileCheck_ = 0;
+
+  compressor_->startProcessing();
 
   doProcessing_ = true;
   lumiAccountingWorkLoop_->submit(lumiAccountingAction_);
@@ -81,9 +90,22 @@ void evb::bu::DiskWriter::startProcessing(const uint32_t runNumber)
   {
     std::ostringstream fileName;
     fileName << streamFileName.string() << std::hex << i;
-    StreamHandlerPtr streamHandler( new StreamHandler(bu_,fileName.str()) );
+    SharedMemoryRingPtr sharedMemoryRing;
+    if ( configuration_->useSharedMemory && ! configuration_->dropEventData )
+    {
+      const SharedMemoryRings::iterator pos = preparedSharedMemoryRings_.find(i);
+      if ( pos != preparedSharedMemoryRings_.end() )
+        sharedMemoryRing = pos->second;
+      else
+        sharedMemoryRing = createSharedMemoryRing(i);
+      sharedMemoryRing->open(runNumber_);
+    }
+    StreamHandlerPtr streamHandler( new StreamHandler(bu_,fileName.str(),
+                                                      compressor_->isEnabled() ? compressor_ : CompressorPtr(),
+                                                      sharedMemoryRing) );
     streamHandlers_.insert( StreamHandlers::value_type(i,streamHandler) );
   }
+  preparedSharedMemoryRings_.clear();
 
   if ( ! configuration_->dropEventData )
   {
@@ -99,6 +121,11 @@ void evb::bu::DiskWriter::startProcessing(const uint32_t runNumber)
     defineEoLS(jsdDir);
     defineEoR(jsdDir);
 
+    rawDataJson_ = JsonTemplate(rawDataDefFile_.string(), buInstance_);
+    eolsJson_ = JsonTemplate(eolsDefFile_.string(), buInstance_);
+    eorJson_ = JsonTemplate(eorDefFile_.string(), buInstance_);
+
+    metaDataWriter_->startProcessing();
     fileMoverWorkLoop_->submit(fileMoverAction_);
   }
 }
@@ -108,16 +135,28 @@ void evb::bu::DiskWriter::drain()
 {}
 
 
+void evb::bu::DiskWriter::abortStreams()
+{
+  for (StreamHandlers::const_iterator it = streamHandlers_.begin(), itEnd = streamHandlers_.end();
+       it != itEnd; ++it)
+  {
+    it->second->abort();
+  }
+}
+
+
 void evb::bu::DiskWriter::stopProcessing()
 {
   doProcessing_ = false;
-  while ( lumiAccountingActive_ || fileMoverActive_ ) ::usleep(1000);
+  lumiAccountingActive_.waitUntilIdle();
+  fileMoverActive_.waitUntilIdle();
 
   for (StreamHandlers::const_iterator it = streamHandlers_.begin(), itEnd = streamHandlers_.end();
        it != itEnd; ++it)
   {
     it->second->closeFile();
   }
+  compressor_->stopProcessing();
 
   moveFiles();
   doLumiSectionAccounting(false);
@@ -141,6 +180,10 @@ void evb::bu::DiskWriter::stopProcessing()
   if ( !configuration_->dropEventData )
   {
     writeEoR();
+    metaDataWriter_->drain();
+    metaDataWriter_->stopProcessing();
+    lastIndexFileCheck_ = 0;
+    removeOrphanedIndexFiles();
     removeDir(runRawDataDir_);
 
     if ( configuration_->deleteRawDataFiles )
@@ -298,6 +341,8 @@ bool evb::bu::DiskWriter::fileMover(toolbox::task::WorkLoop* wl)
   try
   {
     moveFiles();
+    removeOrphanedIndexFiles();
+    updateStreamMonitoring();
   }
   catch(xcept::Exception& e)
   {
@@ -336,6 +381,7 @@ void evb::bu::DiskWriter::moveFiles()
   {
     workDone = false;
     const time_t oldLumiSectionTime = time(0) - configuration_->lumiSectionTimeout;
+    const uint64_t oldQueuedEventTime = getMonotonicTimeStamp() - configuration_->writeCombiningTimeout*1000000ULL;
 
     for (StreamHandlers::const_iterator it = streamHandlers_.begin(), itEnd = streamHandlers_.end();
          it != itEnd; ++it)
@@ -346,15 +392,78 @@ void evb::bu::DiskWriter::moveFiles()
         handleRawDataFile(fileStatistics);
       }
       workDone |= it->second->closeFileIfOpenedBefore(oldLumiSectionTime);
+      it->second->flushEventsQueuedBefore(oldQueuedEventTime);
     }
   } while ( workDone );
 }
 
 
+void evb::bu::DiskWriter::updateStreamMonitoring()
+{
+  const uint64_t now = getMonotonicTimeStamp();
+  const double deltaT = (now - lastStreamMonitoringTime_) / 1e9;
+  if ( deltaT < 1 ) return;
+
+  StreamMonitorings streamMonitorings(streamHandlers_.size());
+  std::vector<double> writeBandwidth(streamHandlers_.size(),0);
+  std::vector<double> writeSize(streamHandlers_.size(),0);
+  std::vector<double> stagingBufferUsage(streamHandlers_.size(),0);
+  lastStreamMonitorings_.resize(streamHandlers_.size());
+
+  for (StreamHandlers::const_iterator it = streamHandlers_.begin(), itEnd = streamHandlers_.end();
+       it != itEnd; ++it)
+  {
+    StreamHandler::StreamMonitoring& current = streamMonitorings[it->first];
+    const StreamHandler::StreamMonitoring& last = lastStreamMonitorings_[it->first];
+    it->second->getStreamMonitoring(current);
+
+    const uint64_t deltaBytes = current.bytesWritten - last.bytesWritten;
+    const uint64_t deltaWrites = current.nbWriteCalls - last.nbWriteCalls;
+    writeBandwidth[it->first] = deltaBytes / deltaT;
+    if ( deltaWrites > 0 )
+    {
+      writeSize[it->first] = static_cast<double>(deltaBytes) / deltaWrites;
+      if ( current.stagingBufferSize > 0 )
+        stagingBufferUsage[it->first] = writeSize[it->first] / current.stagingBufferSize;
+    }
+  }
+
+  lastStreamMonitorings_ = streamMonitorings;
+  lastStreamMonitoringTime_ = now;
+
+  boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
+
+  diskWriterMonitoring_.writeBandwidth.swap(writeBandwidth);
+  diskWriterMonitoring_.writeSize.swap(writeSize);
+  diskWriterMonitoring_.stagingBufferUsage.swap(stagingBufferUsage);
+  diskWriterMonitoring_.streamMonitorings.swap(streamMonitorings);
+}
+
+
 void evb::bu::DiskWriter::handleRawDataFile(const FileStatisticsPtr& fileStatistics)
 {
   const LumiStatistics::iterator lumiStatistics = getLumiStatistics(fileStatistics->lumiSection);
 
+  if ( fileStatistics->fileName.empty() )
+  {
+    // the events have been published into a shared-memory ring: only account them
+    {
+      boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
+
+      diskWriterMonitoring_.nbEventsWritten += fileStatistics->nbEventsWritten;
+      diskWriterMonitoring_.lastEventNumberWritten = fileStatistics->lastEventNumberWritten;
+      if ( diskWriterMonitoring_.currentLumiSection < fileStatistics->lumiSection )
+        diskWriterMonitoring_.currentLumiSection = fileStatistics->lumiSection;
+      if ( diskWriterMonitoring_.lastLumiSection < fileStatistics->lumiSection )
+        diskWriterMonitoring_.lastLumiSection = fileStatistics->lumiSection;
+    }
+
+    lumiStatistics->second->nbEventsWritten += fileStatistics->nbEventsWritten;
+    lumiStatistics->second->nbBytesWritten += fileStatistics->fileSize;
+    lumiStatistics->second->nbUncompressedBytes += fileStatistics->uncompressedSize;
+    return;
+  }
+
   std::ostringstream fileNameStream;
   fileNameStream << std::setfill('0') <<
     "run"<< std::setw(6) << runNumber_ <<
@@ -362,32 +471,47 @@ void evb::bu::DiskWriter::handleRawDataFile(const FileStatisticsPtr& fileStatist
     "_index" << std::setw(6) << lumiStatistics->second->index++ <<
     ".raw";
   const boost::filesystem::path destination( runRawDataDir_.parent_path() / fileNameStream.str() );
+  boost::filesystem::path indexDestination;
+  if ( ! fileStatistics->indexFileName.empty() )
+  {
+    indexDestination = destination;
+    indexDestination.replace_extension("idx");
+  }
+
+  // an empty destination removes the file
+  MetaDataWriter::FileMoves fileMoves;
+  std::string fields;
   if ( configuration_->deleteRawDataFiles )
-    boost::filesystem::remove(fileStatistics->fileName);
+  {
+    resourceManager_->rawDataDeleted(fileStatistics->fileSize);
+    fileMoves.push_back( std::make_pair(fileStatistics->fileName,std::string()) );
+    if ( ! indexDestination.empty() )
+      fileMoves.push_back( std::make_pair(fileStatistics->indexFileName,std::string()) );
+  }
   else
-    boost::filesystem::rename(fileStatistics->fileName, destination);
-
-  boost::filesystem::path jsonFile( runMetaDataDir_ / fileNameStream.str() );
-  jsonFile.replace_extension("jsn");
-  if ( boost::filesystem::exists(jsonFile) )
   {
-    std::ostringstream msg;
-    msg << "The JSON file " << jsonFile.string() << " already exists";
-    XCEPT_RAISE(exception::DiskWriting, msg.str());
+    // move the index first such that it is available once the raw file shows up
+    if ( ! indexDestination.empty() )
+    {
+      fileMoves.push_back( std::make_pair(fileStatistics->indexFileName,indexDestination.string()) );
+      fields = JsonTemplate::field("index",indexDestination.string());
+
+      IndexFile indexFile;
+      indexFile.rawFile = fileStatistics->fileName;
+      indexFile.movedRawFile = destination.string();
+      indexFile.movedIndexFile = indexDestination.string();
+      indexFiles_.push_back(indexFile);
+    }
+    fileMoves.push_back( std::make_pair(fileStatistics->fileName,destination.string()) );
   }
 
-  const std::string path = jsonFile.string() + ".tmp";
-  std::ofstream json(path.c_str());
-  json << "{"                                                                     << std::endl;
-  json << "   \"data\" : [ \""
-    << fileStatistics->nbEventsWritten  << "\", \""
-    << fileStatistics->fileSize << "\" ],"                                        << std::endl;
-  json << "   \"definition\" : \"" << rawDataDefFile_.string() << "\","           << std::endl;
-  json << "   \"source\" : \"BU-"  << buInstance_  << "\""                        << std::endl;
-  json << "}"                                                                     << std::endl;
-  json.close();
+  boost::filesystem::path jsonFile( runMetaDataDir_ / fileNameStream.str() );
+  jsonFile.replace_extension("jsn");
 
-  boost::filesystem::rename(path,jsonFile);
+  JsonValues values;
+  values.add(fileStatistics->nbEventsWritten)
+    .add(fileStatistics->fileSize);
+  metaDataWriter_->write(jsonFile.string(), rawDataJson_.format(values,fields), fileMoves);
 
   {
     boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
@@ -404,6 +528,33 @@ void evb::bu::DiskWriter::handleRawDataFile(const FileStatisticsPtr& fileStatist
   ++(lumiStatistics->second->fileCount);
   lumiStatistics->second->nbEventsWritten += fileStatistics->nbEventsWritten;
   lumiStatistics->second->nbBytesWritten += fileStatistics->fileSize;
+  lumiStatistics->second->nbUncompressedBytes += fileStatistics->uncompressedSize;
+  lumiStatistics->second->compressionTime += fileStatistics->compressionTime;
+}
+
+
+void evb::bu::DiskWriter::removeOrphanedIndexFiles()
+{
+  // the consumers delete the raw files, but do not know about the index files
+  const time_t now = time(0);
+  if ( now == lastIndexFileCheck_ ) return;
+  lastIndexFileCheck_ = now;
+
+  IndexFiles::iterator it = indexFiles_.begin();
+  while ( it != indexFiles_.end() )
+  {
+    // check the source first: once it is gone, the raw file has been moved and
+    // is only missing from the destination if it has been consumed
+    if ( boost::filesystem::exists(it->rawFile) || boost::filesystem::exists(it->movedRawFile) )
+    {
+      ++it;
+    }
+    else
+    {
+      boost::filesystem::remove(it->movedIndexFile);
+      indexFiles_.erase(it++);
+    }
+  }
 }
 
 
@@ -431,16 +582,32 @@ void evb::bu::DiskWriter::appendMonitoringItems(InfoSpaceItems& items)
   items.add("nbFilesWritten", &nbFilesWritten_);
   items.add("nbLumiSections", &nbLumiSections_);
   items.add("currentLumiSection", &currentLumiSection_);
+  items.add("writeBandwidthPerStream", &writeBandwidthPerStream_);
+  items.add("stagingBufferUsagePerStream", &stagingBufferUsagePerStream_);
+
+  compressor_->appendMonitoringItems(items);
+  metaDataWriter_->appendMonitoringItems(items);
 }
 
 
 void evb::bu::DiskWriter::updateMonitoringItems()
 {
+  compressor_->updateMonitoringItems();
+  metaDataWriter_->updateMonitoringItems();
+
   boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
 
   nbFilesWritten_ = diskWriterMonitoring_.nbFiles;
   nbLumiSections_ = diskWriterMonitoring_.nbLumiSections;
   currentLumiSection_ = diskWriterMonitoring_.currentLumiSection;
+
+  writeBandwidthPerStream_.clear();
+  stagingBufferUsagePerStream_.clear();
+  for ( uint16_t i = 0; i < diskWriterMonitoring_.writeBandwidth.size(); ++i )
+  {
+    writeBandwidthPerStream_.push_back(diskWriterMonitoring_.writeBandwidth[i]);
+    stagingBufferUsagePerStream_.push_back(diskWriterMonitoring_.stagingBufferUsage[i]);
+  }
 }
 
 
@@ -454,6 +621,13 @@ void evb::bu::DiskWriter::resetMonitoringCounters()
   diskWriterMonitoring_.lastEventNumberWritten = 0;
   diskWriterMonitoring_.currentLumiSection = 0;
   diskWriterMonitoring_.lastLumiSection = 0;
+  diskWriterMonitoring_.writeBandwidth.clear();
+  diskWriterMonitoring_.writeSize.clear();
+  diskWriterMonitoring_.stagingBufferUsage.clear();
+  diskWriterMonitoring_.streamMonitorings.clear();
+
+  lastStreamMonitorings_.clear();
+  lastStreamMonitoringTime_ = getMonotonicTimeStamp();
 }
 
 
@@ -467,16 +641,38 @@ uint32_t evb::bu::DiskWriter::getNbLumiSections() const
 void evb::bu::DiskWriter::configure()
 {
   streamHandlers_.clear();
+  preparedSharedMemoryRings_.clear();
   lumiStatistics_.clear();
 
+  compressor_->configure();
+
   if ( ! configuration_->dropEventData )
   {
     createDir(configuration_->rawDataDir.value_);
     createDir(configuration_->metaDataDir.value_);
+
+    // mapping and pre-faulting the rings takes a while, thus do it now instead of when enabling.
+    // The rings for any later run are only created when enabling, as the consumers might still
+    // be attached to the rings of the previous run.
+    if ( configuration_->useSharedMemory )
+    {
+      for (uint16_t i=0; i < configuration_->numberOfBuilders; ++i)
+        preparedSharedMemoryRings_.insert( SharedMemoryRings::value_type(i,createSharedMemoryRing(i)) );
+    }
   }
 }
 
 
+evb::bu::SharedMemoryRingPtr evb::bu::DiskWriter::createSharedMemoryRing(const uint16_t builderId) const
+{
+  std::ostringstream ringName;
+  ringName << "/evb_bu" << buInstance_ << "_stream" << std::hex << builderId;
+  return SharedMemoryRingPtr( new SharedMemoryRing(ringName.str(),
+                                                   configuration_->sharedMemorySlots,
+                                                   configuration_->sharedMemorySlotSize) );
+}
+
+
 void evb::bu::DiskWriter::createDir(const boost::filesystem::path& path) const
 {
   if ( ! boost::filesystem::exists(path) &&
@@ -542,6 +738,46 @@ cgicc::div evb::bu::DiskWriter::getHtmlSnipped() const
     div.add(table);
   }
 
+  if ( compressor_->isEnabled() )
+  {
+    div.add(compressor_->getHtmlSnipped());
+  }
+
+  div.add(metaDataWriter_->getHtmlSnipped());
+
+  {
+    table table;
+    table.set("title","Write statistics for each output stream. The staging buffer usage is the average fraction of the staging buffer written with one call. It is only used if 'useDirectIO' is true.");
+
+    table.add(tr()
+              .add(th("stream"))
+              .add(th("bandwidth (MB/s)"))
+              .add(th("write size (kB)"))
+              .add(th("direct I/O"))
+              .add(th("staging buffer (MB)"))
+              .add(th("staging usage (%)")));
+
+    boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
+
+    for ( uint16_t i = 0; i < diskWriterMonitoring_.streamMonitorings.size(); ++i )
+    {
+      const StreamHandler::StreamMonitoring& streamMonitoring = diskWriterMonitoring_.streamMonitorings[i];
+      std::ostringstream stagingBuffer;
+      stagingBuffer << std::fixed << std::setprecision(1) << streamMonitoring.stagingBufferSize / 1e6;
+      if ( streamMonitoring.hugePages )
+        stagingBuffer << " (huge pages)";
+
+      table.add(tr()
+                .add(td(boost::lexical_cast<std::string>(i)))
+                .add(td(doubleToString(diskWriterMonitoring_.writeBandwidth[i] / 1e6,1)))
+                .add(td(doubleToString(diskWriterMonitoring_.writeSize[i] / 1e3,1)))
+                .add(td(streamMonitoring.directIO ? "yes" : "no"))
+                .add(td(stagingBuffer.str()))
+                .add(td(doubleToString(diskWriterMonitoring_.stagingBufferUsage[i] * 100,1))));
+    }
+    div.add(table);
+  }
+
   return div;
 }
 
@@ -700,28 +936,24 @@ void evb::bu::DiskWriter::writeEoLS(const LumiInfoPtr& lumiInfo) const
     "_EoLS.jsn";
   const boost::filesystem::path jsonFile = runMetaDataDir_ / fileNameStream.str();
 
-  if ( boost::filesystem::exists(jsonFile) )
-  {
-    std::ostringstream msg;
-    msg << "The JSON file " << jsonFile.string() << " already exists";
-    XCEPT_RAISE(exception::DiskWriting, msg.str());
-  }
-
-  const std::string path = jsonFile.string() + ".tmp";
-  std::ofstream json(path.c_str());
-  json << "{"                                                              << std::endl;
-  json << "   \"data\" : [ \""
-    << lumiInfo->nbEventsWritten << "\", \""
-    << lumiInfo->fileCount << "\", \""
-    << lumiInfo->totalEvents << "\", \""
-    << lumiInfo->nbIncompleteEvents << "\", \""
-    << lumiInfo->nbBytesWritten << "\" ],"                                 << std::endl;
-  json << "   \"definition\" : \"" << eolsDefFile_.string() << "\","       << std::endl;
-  json << "   \"source\" : \"BU-"  << buInstance_ << "\""                  << std::endl;
-  json << "}"                                                              << std::endl;
-  json.close();
-
-  boost::filesystem::rename(path,jsonFile);
+  const double compressionRatio = lumiInfo->nbBytesWritten > 0 ?
+    static_cast<double>(lumiInfo->nbUncompressedBytes) / lumiInfo->nbBytesWritten : 0;
+  const double compressionThroughput = lumiInfo->compressionTime > 0 ?
+    lumiInfo->nbUncompressedBytes * 1e3 / lumiInfo->compressionTime : 0;
+
+  JsonValues values;
+  values.add(lumiInfo->nbEventsWritten)
+    .add(lumiInfo->fileCount)
+    .add(lumiInfo->totalEvents)
+    .add(lumiInfo->nbIncompleteEvents)
+    .add(lumiInfo->nbBytesWritten)
+    .add(EventInfo::currentVersion)
+    .add(lumiInfo->nbUncompressedBytes)
+    .add(doubleToString(compressionRatio,3))
+    .add(doubleToString(compressionThroughput,1));
+
+  // queued after the raw-data files of this lumi section
+  metaDataWriter_->write(jsonFile.string(), eolsJson_.format(values));
 }
 
 
@@ -733,28 +965,16 @@ void evb::bu::DiskWriter::writeEoR() const
     "_ls0000_EoR.jsn";
   const boost::filesystem::path jsonFile = runMetaDataDir_ / fileNameStream.str();
 
-  if ( boost::filesystem::exists(jsonFile) )
+  JsonValues values;
   {
-    std::ostringstream msg;
-    msg << "The JSON file " << jsonFile.string() << " already exists";
-    XCEPT_RAISE(exception::DiskWriting, msg.str());
+    boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
+    values.add(diskWriterMonitoring_.nbEventsWritten)
+      .add(diskWriterMonitoring_.nbFiles)
+      .add(diskWriterMonitoring_.nbLumiSections)
+      .add(diskWriterMonitoring_.lastLumiSection);
   }
 
-  boost::mutex::scoped_lock sl(diskWriterMonitoringMutex_);
-  const std::string path = jsonFile.string() + ".tmp";
-  std::ofstream json(path.c_str());
-  json << "{"                                                                           << std::endl;
-  json << "   \"data\" : [ \""
-    << diskWriterMonitoring_.nbEventsWritten << "\", \""
-    << diskWriterMonitoring_.nbFiles         << "\", \""
-    << diskWriterMonitoring_.nbLumiSections  << "\", \""
-    << diskWriterMonitoring_.lastLumiSection << "\" ],"                                 << std::endl;
-  json << "   \"definition\" : \"" << eorDefFile_.string() << "\","                     << std::endl;
-  json << "   \"source\" : \"BU-"  << buInstance_   << "\""                             << std::endl;
-  json << "}"                                                                           << std::endl;
-  json.close();
-
-  boost::filesystem::rename(path,jsonFile);
+  metaDataWriter_->write(jsonFile.string(), eorJson_.format(values));
 }
 
 
@@ -815,6 +1035,26 @@ void evb::bu::DiskWriter::defineEoLS(const boost::filesystem::path& jsdDir)
   json << "         \"name\" : \"NBytes\","                   << std::endl;
   json << "         \"operation\" : \"sum\","                 << std::endl;
   json << "         \"type\" : \"integer\""                   << std::endl;
+  json << "      },"                                          << std::endl;
+  json << "      {"                                           << std::endl;
+  json << "         \"name\" : \"EventInfoVersion\","         << std::endl;
+  json << "         \"operation\" : \"max\","                 << std::endl;
+  json << "         \"type\" : \"integer\""                   << std::endl;
+  json << "      },"                                          << std::endl;
+  json << "      {"                                           << std::endl;
+  json << "         \"name\" : \"NUncompressedBytes\","       << std::endl;
+  json << "         \"operation\" : \"sum\","                 << std::endl;
+  json << "         \"type\" : \"integer\""                   << std::endl;
+  json << "      },"                                          << std::endl;
+  json << "      {"                                           << std::endl;
+  json << "         \"name\" : \"CompressionRatio\","         << std::endl;
+  json << "         \"operation\" : \"avg\","                 << std::endl;
+  json << "         \"type\" : \"double\""                    << std::endl;
+  json << "      },"                                          << std::endl;
+  json << "      {"                                           << std::endl;
+  json << "         \"name\" : \"CompressionThroughput\","    << std::endl;
+  json << "         \"operation\" : \"avg\","                 << std::endl;
+  json << "         \"type\" : \"double\""                    << std::endl;
   json << "      }"                                           << std::endl;
   json << "   ]"                                              << std::endl;
   json << "}"                                                 << std::endl;
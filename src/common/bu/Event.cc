@@ -1,11 +1,8 @@
-#include <fstream>
-#include <iomanip>
 #include <limits>
 #include <stdlib.h>
 #include <sstream>
 
 #include "evb/bu/Event.h"
-#include "evb/DumpUtility.h"
 #include "evb/Exception.h"
 #include "xcept/tools.h"
 
@@ -13,7 +10,7 @@
 evb::bu::Event::Event
 (
   const EvBid& evbId,
-  const msg::RUtids& ruTids,
+  const msg::RUtidsView& ruTids,
   const uint16_t buResourceId,
   const bool checkCRC,
   const bool calculateCRC32
@@ -21,10 +18,11 @@ evb::bu::Event::Event
   evbId_(evbId),
   checkCRC_(checkCRC),
   calculateCRC32_(calculateCRC32),
-  buResourceId_(buResourceId)
+  buResourceId_(buResourceId),
+  checkStatus_(UNCHECKED)
 {
   eventInfo_ = EventInfoPtr( new EventInfo(evbId.runNumber(), evbId.lumiSection(), evbId.eventNumber()) );
-  for ( msg::RUtids::const_iterator it = ruTids.begin(), itEnd = ruTids.end();
+  for ( msg::RUtidsView::const_iterator it = ruTids.begin(), itEnd = ruTids.end();
         it != itEnd; ++it)
   {
     ruSizes_.insert( RUsizes::value_type(*it,std::numeric_limits<uint32_t>::max()) );
@@ -93,7 +91,13 @@ bool evb::bu::Event::appendSuperFragment
     dataLocations_.push_back(dataLocation);
 
     if (calculateCRC32_)
-      eventInfo_->updateCRC32(dataLocation);
+    {
+      // use the CRC32c calculated by the RU while copying the data if available
+      if (superFragmentMsg->hasCRC32c)
+        eventInfo_->combineCRC32(superFragmentMsg->crc32c, superFragmentMsg->partSize);
+      else
+        eventInfo_->updateCRC32(dataLocation);
+    }
   }
 
   // erase at the very end. Otherwise the event might be considered complete
@@ -109,7 +113,7 @@ bool evb::bu::Event::appendSuperFragment
 }
 
 
-void evb::bu::Event::checkEvent() const
+void evb::bu::Event::checkEvent(Dumper& dumper) const
 {
   if ( ! isComplete() )
   {
@@ -174,7 +178,7 @@ void evb::bu::Event::checkEvent() const
     std::ostringstream msg;
     msg << "Found bad data in chunk " << chunk << " of event with EvB id " << evbId_ << ": " << std::endl;
 
-    dumpEventToFile(e.message(),chunk);
+    dumpEventToFile(dumper,e.message(),chunk);
 
     XCEPT_RETHROW(exception::DataCorruption, msg.str(), e);
   }
@@ -194,31 +198,26 @@ void evb::bu::Event::checkEvent() const
 }
 
 
-void evb::bu::Event::dumpEventToFile(const std::string& reasonForDump, const uint32_t badChunk) const
+void evb::bu::Event::dumpEventToFile
+(
+  Dumper& dumper,
+  const std::string& reasonForDump,
+  const uint32_t badChunk,
+  const bool force
+) const
 {
-  std::ostringstream fileName;
-  fileName << "/tmp/dump_run" << std::setfill('0') << std::setw(6) << eventInfo_->runNumber()
-    << "_event" << std::setw(8) << eventInfo_->eventNumber()
-    << ".txt";
-  std::ofstream dumpFile;
-  dumpFile.open(fileName.str().c_str());
-  dumpFile << "Reason for dump: " << reasonForDump << std::endl;
+  if ( ! dumper.accept(force) ) return;
+
+  const DumpPtr dump( new Dump(eventInfo_->runNumber(),eventInfo_->eventNumber()) );
+  dump->description = "Reason for dump: " + reasonForDump + "\n";
+  dump->badChunk = badChunk;
 
   for ( uint32_t i = 0; i < dataLocations_.size(); ++i )
   {
-    if ( i == badChunk )
-    {
-      dumpFile << toolbox::toString("Bad chunk %2d: ", i);
-      dumpFile << std::string(112,'*') << std::endl;
-    }
-    else
-    {
-      dumpFile << toolbox::toString("Chunk %2d : ",i);
-      dumpFile << std::string(115,'-') << std::endl;
-    }
-    DumpUtility::dumpBlockData(dumpFile,(unsigned char*)dataLocations_[i].iov_base,dataLocations_[i].iov_len);
+    dump->addChunk(dataLocations_[i].iov_base,dataLocations_[i].iov_len);
   }
-  dumpFile.close();
+
+  dumper.write(dump);
 }
 
 
@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <sstream>
 #include <string>
 
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/lexical_cast.hpp>
 
 #include "evb/BU.h"
@@ -10,6 +12,7 @@
 #include "evb/bu/ResourceManager.h"
 #include "evb/bu/StateMachine.h"
 #include "evb/Exception.h"
+#include "evb/TimeStamp.h"
 #include "toolbox/task/WorkLoopFactory.h"
 #include "xcept/tools.h"
 
@@ -24,6 +27,10 @@ evb::bu::EventBuilder::EventBuilder
   diskWriter_(diskWriter),
   resourceManager_(resourceManager),
   configuration_(bu->getConfiguration()),
+  eventsBeingChecked_(0),
+  checkersActive_(0),
+  eventsChecked_(0),
+  lastMonitoringTime_(0),
   corruptedEvents_(0),
   eventsWithCRCerrors_(0),
   eventsMissingData_(0),
@@ -33,6 +40,9 @@ evb::bu::EventBuilder::EventBuilder
   builderAction_ =
     toolbox::task::bind(this, &evb::bu::EventBuilder::process,
                         bu_->getIdentifier("eventBuilder") );
+  checkerAction_ =
+    toolbox::task::bind(this, &evb::bu::EventBuilder::check,
+                        bu_->getIdentifier("eventChecker") );
 }
 
 
@@ -44,6 +54,12 @@ evb::bu::EventBuilder::~EventBuilder()
     if ( (*it)->isActive() )
       (*it)->cancel();
   }
+  for ( WorkLoops::iterator it = checkerWorkLoops_.begin(), itEnd = checkerWorkLoops_.end();
+        it != itEnd; ++it)
+  {
+    if ( (*it)->isActive() )
+      (*it)->cancel();
+  }
 }
 
 
@@ -59,11 +75,33 @@ void evb::bu::EventBuilder::addSuperFragment
 }
 
 
+uint16_t evb::bu::EventBuilder::getLeastLoadedBuilder(const uint16_t builderId) const
+{
+  const SuperFragmentFIFOs::const_iterator pos = superFragmentFIFOs_.find(builderId);
+  if ( ! configuration_->balanceBuilders || pos == superFragmentFIFOs_.end() )
+    return builderId;
+
+  uint16_t leastLoadedBuilder = builderId;
+  uint32_t fewestElements = pos->second->elements();
+  for (SuperFragmentFIFOs::const_iterator it = superFragmentFIFOs_.begin(), itEnd = superFragmentFIFOs_.end();
+       it != itEnd && fewestElements > 0; ++it)
+  {
+    const uint32_t elements = it->second->elements();
+    if ( elements < fewestElements )
+    {
+      leastLoadedBuilder = it->first;
+      fewestElements = elements;
+    }
+  }
+  return leastLoadedBuilder;
+}
+
+
 void evb::bu::EventBuilder::configure()
 {
-  superFragmentFIFOs_.clear();
   eventMapMonitors_.clear();
   writeNextEventsToFile_ = 0;
+  bu_->getDumper()->configure(configuration_->dumpFIFOCapacity,configuration_->maxDumpsPerSecond);
 
   {
     boost::mutex::scoped_lock sl(processesActiveMutex_);
@@ -72,13 +110,22 @@ void evb::bu::EventBuilder::configure()
     processesActive_.resize(configuration_->numberOfBuilders.value_);
   }
 
+  // keep the FIFOs of builders which still exist to avoid reallocating them
+  superFragmentFIFOs_.erase( superFragmentFIFOs_.lower_bound(configuration_->numberOfBuilders.value_),
+                             superFragmentFIFOs_.end() );
+
   for (uint16_t i=0; i < configuration_->numberOfBuilders; ++i)
   {
-    std::ostringstream fifoName;
-    fifoName << "superFragmentFIFO_" << i;
-    SuperFragmentFIFOPtr superFragmentFIFO( new SuperFragmentFIFO(bu_,fifoName.str()) );
-    superFragmentFIFO->resize(configuration_->superFragmentFIFOCapacity);
-    superFragmentFIFOs_.insert( SuperFragmentFIFOs::value_type(i,superFragmentFIFO) );
+    SuperFragmentFIFOs::iterator pos = superFragmentFIFOs_.find(i);
+    if ( pos == superFragmentFIFOs_.end() )
+    {
+      std::ostringstream fifoName;
+      fifoName << "superFragmentFIFO_" << i;
+      SuperFragmentFIFOPtr superFragmentFIFO( new SuperFragmentFIFO(bu_,fifoName.str()) );
+      pos = superFragmentFIFOs_.insert( SuperFragmentFIFOs::value_type(i,superFragmentFIFO) ).first;
+    }
+    pos->second->clear();
+    pos->second->resize(configuration_->superFragmentFIFOCapacity);
 
     eventMapMonitors_.insert( EventMapMonitors::value_type(i,EventMapMonitor()) );
   }
@@ -103,6 +150,16 @@ void evb::bu::EventBuilder::createProcessingWorkLoops()
       if ( ! wl->isActive() ) wl->activate();
       builderWorkLoops_.push_back(wl);
     }
+
+    for (uint16_t i=checkerWorkLoops_.size(); i < configuration_->numberOfCheckers; ++i)
+    {
+      std::ostringstream workLoopName;
+      workLoopName << identifier << "/Checker_" << i;
+      toolbox::task::WorkLoop* wl = toolbox::task::getWorkLoopFactory()->getWorkLoop( workLoopName.str(), "waiting" );
+
+      if ( ! wl->isActive() ) wl->activate();
+      checkerWorkLoops_.push_back(wl);
+    }
   }
   catch(xcept::Exception& e)
   {
@@ -126,7 +183,16 @@ void evb::bu::EventBuilder::startProcessing(const uint32_t runNumber)
     eventsWithCRCerrors_ = 0;
     eventsMissingData_ = 0;
   }
+  {
+    boost::mutex::scoped_lock sl(eventsToCheckMutex_);
+    eventsToCheck_.clear();
+    eventsBeingChecked_ = 0;
+  }
   doProcessing_ = true;
+  for (uint32_t i=0; i < configuration_->numberOfCheckers; ++i)
+  {
+    checkerWorkLoops_.at(i)->submit(checkerAction_);
+  }
   for (uint32_t i=0; i < configuration_->numberOfBuilders; ++i)
   {
     builderWorkLoops_.at(i)->submit(builderAction_);
@@ -142,27 +208,168 @@ bool evb::bu::EventBuilder::isEmpty() const
     if ( !it->second->empty() ) return false;
   }
 
+  {
+    boost::mutex::scoped_lock sl(eventsToCheckMutex_);
+    if ( !eventsToCheck_.empty() || eventsBeingChecked_ > 0 ) return false;
+  }
+
   return processesActive_.none();
 }
 
 
 void evb::bu::EventBuilder::drain() const
 {
-  while ( !isEmpty() ) ::usleep(1000);
+  boost::mutex::scoped_lock sl(processesActiveMutex_);
+  while ( !isEmpty() )
+    processesIdle_.timed_wait(sl, boost::posix_time::milliseconds(1));
 }
 
 
 void evb::bu::EventBuilder::stopProcessing()
 {
   doProcessing_ = false;
+  diskWriter_->abortStreams();
 
-  while ( processesActive_.any() ) ::usleep(1000);
+  {
+    boost::mutex::scoped_lock sl(eventsToCheckMutex_);
+    eventsToCheckCondition_.notify_all();
+    eventCheckedCondition_.notify_all();
+  }
+
+  {
+    boost::mutex::scoped_lock sl(processesActiveMutex_);
+    while ( processesActive_.any() ) processesIdle_.wait(sl);
+  }
+  {
+    boost::mutex::scoped_lock sl(eventsToCheckMutex_);
+    while ( checkersActive_ > 0 ) eventsToCheckCondition_.wait(sl);
+  }
 
   for (SuperFragmentFIFOs::const_iterator it = superFragmentFIFOs_.begin(), itEnd = superFragmentFIFOs_.end();
        it != itEnd; ++it)
   {
     it->second->clear();
   }
+
+  boost::mutex::scoped_lock sl(eventsToCheckMutex_);
+  eventsToCheck_.clear();
+}
+
+
+void evb::bu::EventBuilder::handleCorruptedEvent(xcept::Exception& e)
+{
+  {
+    boost::mutex::scoped_lock sl(errorCountMutex_);
+    ++corruptedEvents_;
+  }
+
+  LOG4CPLUS_ERROR(bu_->getApplicationLogger(),
+                  xcept::stdformat_exception_history(e));
+  bu_->notifyQualified("error",e);
+}
+
+
+void evb::bu::EventBuilder::handleCRCerror(xcept::Exception& e)
+{
+  bool reportError;
+  {
+    boost::mutex::scoped_lock sl(errorCountMutex_);
+    reportError = evb::isFibonacci( ++eventsWithCRCerrors_ );
+  }
+
+  if ( reportError )
+  {
+    std::ostringstream msg;
+    msg << "received " << eventsWithCRCerrors_ << " events with CRC error";
+
+    XCEPT_DECLARE_NESTED(exception::CRCerror,sentinelError,msg.str(),e);
+    bu_->notifyQualified("error",sentinelError);
+
+    msg << ": " << xcept::stdformat_exception_history(e);
+    LOG4CPLUS_ERROR(bu_->getApplicationLogger(),msg.str());
+  }
+}
+
+
+bool evb::bu::EventBuilder::check(toolbox::task::WorkLoop*)
+{
+  {
+    boost::mutex::scoped_lock sl(eventsToCheckMutex_);
+    ++checkersActive_;
+  }
+
+  try
+  {
+    EventPtr event;
+
+    while ( doProcessing_ )
+    {
+      {
+        boost::mutex::scoped_lock sl(eventsToCheckMutex_);
+
+        while ( eventsToCheck_.empty() && doProcessing_ )
+          eventsToCheckCondition_.timed_wait(sl, boost::posix_time::milliseconds(10));
+
+        if ( ! doProcessing_ ) break;
+
+        event = eventsToCheck_.front();
+        eventsToCheck_.pop_front();
+        ++eventsBeingChecked_;
+      }
+
+      checkEvent(event);
+      event.reset();
+
+      boost::mutex::scoped_lock sl(eventsToCheckMutex_);
+      --eventsBeingChecked_;
+      ++eventsChecked_;
+      eventCheckedCondition_.notify_all();
+    }
+  }
+  catch(xcept::Exception& e)
+  {
+    stateMachine_->processFSMEvent( Fail(e) );
+  }
+  catch(std::exception& e)
+  {
+    XCEPT_DECLARE(exception::SuperFragment,
+                  sentinelException, e.what());
+    stateMachine_->processFSMEvent( Fail(sentinelException) );
+  }
+  catch(...)
+  {
+    XCEPT_DECLARE(exception::SuperFragment,
+                  sentinelException, "unkown exception");
+    stateMachine_->processFSMEvent( Fail(sentinelException) );
+  }
+
+  {
+    boost::mutex::scoped_lock sl(eventsToCheckMutex_);
+    --checkersActive_;
+    eventsToCheckCondition_.notify_all();
+  }
+
+  return false;
+}
+
+
+void evb::bu::EventBuilder::checkEvent(const EventPtr& event)
+{
+  try
+  {
+    event->checkEvent(*bu_->getDumper());
+    event->setCheckStatus(Event::CHECKED);
+  }
+  catch(exception::DataCorruption& e)
+  {
+    event->setCheckStatus(Event::CORRUPTED);
+    handleCorruptedEvent(e);
+  }
+  catch(exception::CRCerror& e)
+  {
+    event->setCheckStatus(Event::CRC_ERROR);
+    handleCRCerror(e);
+  }
 }
 
 
@@ -193,7 +400,9 @@ bool evb::bu::EventBuilder::process(toolbox::task::WorkLoop* wl)
   {
     while ( doProcessing_ )
     {
+      const uint64_t startTime = getMonotonicTimeStamp();
       bool workDone = false;
+      uint64_t eventsCheckedBefore = 0;
 
       if ( superFragmentFIFO->deq(superFragments) )
       {
@@ -203,11 +412,14 @@ bool evb::bu::EventBuilder::process(toolbox::task::WorkLoop* wl)
 
       if ( ! completeEvents.empty() )
       {
-        workDone = true;
+        // with checker threads, the builder has to wait for the events to be checked
+        const size_t nbCompleteEvents = completeEvents.size();
+        eventsCheckedBefore = eventsChecked_;
+        __sync_synchronize();
         try
         {
           eventMapMonitor.lowestLumiSection = completeEvents.begin()->first;
-          const uint32_t eventsMissingData = handleCompleteEvents(completeEvents,streamHandler);
+          const uint32_t eventsMissingData = handleCompleteEvents(completeEvents,streamHandler,builderId);
           if ( eventsMissingData > 0 )
           {
             boost::mutex::scoped_lock sl(errorCountMutex_);
@@ -216,46 +428,40 @@ bool evb::bu::EventBuilder::process(toolbox::task::WorkLoop* wl)
         }
         catch(exception::DataCorruption& e)
         {
-          {
-            boost::mutex::scoped_lock sl(errorCountMutex_);
-            ++corruptedEvents_;
-          }
-
-          LOG4CPLUS_ERROR(bu_->getApplicationLogger(),
-                          xcept::stdformat_exception_history(e));
-          bu_->notifyQualified("error",e);
+          handleCorruptedEvent(e);
         }
         catch(exception::CRCerror& e)
         {
-          bool reportError;
-          {
-            boost::mutex::scoped_lock sl(errorCountMutex_);
-            reportError = evb::isFibonacci( ++eventsWithCRCerrors_ );
-          }
-
-          if ( reportError )
-          {
-            std::ostringstream msg;
-            msg << "received " << eventsWithCRCerrors_ << " events with CRC error";
-
-            XCEPT_DECLARE_NESTED(exception::CRCerror,sentinelError,msg.str(),e);
-            bu_->notifyQualified("error",sentinelError);
-
-            msg << ": " << xcept::stdformat_exception_history(e);
-            LOG4CPLUS_ERROR(bu_->getApplicationLogger(),msg.str());
-          }
+          handleCRCerror(e);
         }
+        if ( configuration_->numberOfCheckers == 0U || completeEvents.size() < nbCompleteEvents )
+          workDone = true;
       }
 
       eventMapMonitor.partialEvents = partialEvents.size();
       eventMapMonitor.completeEvents = completeEvents.size();
 
-      if ( ! workDone )
+      if ( workDone )
+      {
+        eventMapMonitor.busyTime += getMonotonicTimeStamp() - startTime;
+      }
+      else
       {
         boost::mutex::scoped_lock sl(processesActiveMutex_);
         processesActive_.reset(builderId);
+        processesIdle_.notify_all();
         sl.unlock();
-        ::usleep(1000);
+        if ( configuration_->numberOfCheckers > 0U && ! completeEvents.empty() )
+        {
+          // wake up once a checker is done, but keep looking for new super fragments
+          boost::mutex::scoped_lock csl(eventsToCheckMutex_);
+          if ( eventsChecked_ == eventsCheckedBefore )
+            eventCheckedCondition_.timed_wait(csl, boost::posix_time::milliseconds(1));
+        }
+        else
+        {
+          ::usleep(1000);
+        }
         sl.lock();
         processesActive_.set(builderId);
       }
@@ -266,6 +472,7 @@ bool evb::bu::EventBuilder::process(toolbox::task::WorkLoop* wl)
     {
       boost::mutex::scoped_lock sl(processesActiveMutex_);
       processesActive_.reset(builderId);
+      processesIdle_.notify_all();
     }
     stateMachine_->processFSMEvent( Fail(e) );
   }
@@ -274,6 +481,7 @@ bool evb::bu::EventBuilder::process(toolbox::task::WorkLoop* wl)
     {
       boost::mutex::scoped_lock sl(processesActiveMutex_);
       processesActive_.reset(builderId);
+      processesIdle_.notify_all();
     }
     XCEPT_DECLARE(exception::SuperFragment,
                   sentinelException, e.what());
@@ -284,6 +492,7 @@ bool evb::bu::EventBuilder::process(toolbox::task::WorkLoop* wl)
     {
       boost::mutex::scoped_lock sl(processesActiveMutex_);
       processesActive_.reset(builderId);
+      processesIdle_.notify_all();
     }
     XCEPT_DECLARE(exception::SuperFragment,
                   sentinelException, "unkown exception");
@@ -293,6 +502,7 @@ bool evb::bu::EventBuilder::process(toolbox::task::WorkLoop* wl)
   {
     boost::mutex::scoped_lock sl(processesActiveMutex_);
     processesActive_.reset(builderId);
+    processesIdle_.notify_all();
   }
 
   return false;
@@ -314,10 +524,9 @@ void evb::bu::EventBuilder::buildEvent
   const I2O_TID ruTid = stdMsg->InitiatorAddress;
   const uint16_t nbSuperFragments = firstDataBlockMsg->nbSuperFragments;
   uint16_t superFragmentCount = 0;
-  msg::EvBids evbIds;
-  firstDataBlockMsg->getEvBids(evbIds);
-  msg::RUtids ruTids;
-  firstDataBlockMsg->getRUtids(ruTids);
+  // the views stay valid while the super-fragment chain holds the first block
+  const msg::EvBidsView evbIds = firstDataBlockMsg->getEvBids();
+  const msg::RUtidsView ruTids = firstDataBlockMsg->getRUtids();
 
   do
   {
@@ -347,6 +556,12 @@ void evb::bu::EventBuilder::buildEvent
           // the event is complete, too
           const uint32_t lumiSection = eventPos->first.lumiSection();
           completeEvents.insert(CompleteEvents::value_type(lumiSection,eventPos->second));
+          if ( configuration_->numberOfCheckers > 0U )
+          {
+            boost::mutex::scoped_lock sl(eventsToCheckMutex_);
+            eventsToCheck_.push_back(eventPos->second);
+            eventsToCheckCondition_.notify_one();
+          }
           partialEvents.erase(eventPos);
         }
       }
@@ -377,7 +592,7 @@ evb::bu::EventBuilder::PartialEvents::iterator evb::bu::EventBuilder::getEventPo
 (
   PartialEvents& partialEvents,
   const EvBid& evbId,
-  const msg::RUtids& ruTids,
+  const msg::RUtidsView& ruTids,
   const uint16_t& buResourceId
 ) const
 {
@@ -396,7 +611,8 @@ evb::bu::EventBuilder::PartialEvents::iterator evb::bu::EventBuilder::getEventPo
 uint32_t evb::bu::EventBuilder::handleCompleteEvents
 (
   CompleteEvents& completeEvents,
-  StreamHandlerPtr& streamHandler
+  StreamHandlerPtr& streamHandler,
+  const uint16_t builderId
 ) const
 {
   const uint32_t oldestIncompleteLumiSection = resourceManager_->getOldestIncompleteLumiSection();
@@ -410,24 +626,44 @@ uint32_t evb::bu::EventBuilder::handleCompleteEvents
     {
       const EventPtr& event = pos->second;
 
-      try
+      if ( configuration_->numberOfCheckers > 0U )
       {
-        event->checkEvent();
-      }
-      catch(exception::DataCorruption& e)
-      {
-        resourceManager_->eventCompleted(event);
-        resourceManager_->discardEvent(event);
-        completeEvents.erase(pos++);
-        throw; // rethrow the exception such that it can be handled outside of critical section
+        // errors have already been reported by the checker thread
+        const Event::CheckStatus checkStatus = event->getCheckStatus();
+        if ( checkStatus == Event::UNCHECKED )
+        {
+          // keep the order in which the events of the lumi section are written
+          break;
+        }
+        else if ( checkStatus == Event::CORRUPTED )
+        {
+          resourceManager_->eventCompleted(event,builderId);
+          resourceManager_->discardEvent(event);
+          completeEvents.erase(pos++);
+          continue;
+        }
       }
-      catch(exception::CRCerror& e)
+      else
       {
-        resourceManager_->eventCompleted(event);
-        streamHandler->writeEvent(event);
-        resourceManager_->discardEvent(event);
-        completeEvents.erase(pos++);
-        throw; // rethrow the exception such that it can be handled outside of critical section
+        try
+        {
+          event->checkEvent(*bu_->getDumper());
+        }
+        catch(exception::DataCorruption& e)
+        {
+          resourceManager_->eventCompleted(event,builderId);
+          resourceManager_->discardEvent(event);
+          completeEvents.erase(pos++);
+          throw; // rethrow the exception such that it can be handled outside of critical section
+        }
+        catch(exception::CRCerror& e)
+        {
+          resourceManager_->eventCompleted(event,builderId);
+          streamHandler->writeEvent(event);
+          resourceManager_->discardEvent(event);
+          completeEvents.erase(pos++);
+          throw; // rethrow the exception such that it can be handled outside of critical section
+        }
       }
 
       if ( event->isMissingData() )
@@ -438,12 +674,12 @@ uint32_t evb::bu::EventBuilder::handleCompleteEvents
         boost::mutex::scoped_lock sl(writeNextEventsToFileMutex_);
         if ( writeNextEventsToFile_ > 0 ) // recheck once we have the lock
         {
-          event->dumpEventToFile("Requested by user");
+          event->dumpEventToFile(*bu_->getDumper(),"Requested by user",Dump::noBadChunk,true);
           --writeNextEventsToFile_;
         }
       }
 
-      resourceManager_->eventCompleted(event);
+      resourceManager_->eventCompleted(event,builderId);
       streamHandler->writeEvent(event);
       resourceManager_->discardEvent(event);
       completeEvents.erase(pos++);
@@ -467,6 +703,7 @@ void evb::bu::EventBuilder::appendMonitoringItems(InfoSpaceItems& items)
   items.add("nbCorruptedEvents", &nbCorruptedEvents_);
   items.add("nbEventsWithCRCerrors", &nbEventsWithCRCerrors_);
   items.add("nbEventsMissingData", &nbEventsMissingData_);
+  items.add("builderUtilization", &builderUtilization_);
 }
 
 
@@ -477,6 +714,20 @@ void evb::bu::EventBuilder::updateMonitoringItems()
   nbCorruptedEvents_ = corruptedEvents_;
   nbEventsWithCRCerrors_ = eventsWithCRCerrors_;
   nbEventsMissingData_ = eventsMissingData_;
+
+  const uint64_t now = getMonotonicTimeStamp();
+  const uint64_t deltaT = now - lastMonitoringTime_;
+  lastMonitoringTime_ = now;
+
+  builderUtilization_.clear();
+  for ( EventMapMonitors::iterator it = eventMapMonitors_.begin(), itEnd = eventMapMonitors_.end();
+        it != itEnd; ++it )
+  {
+    const uint64_t busyTime = it->second.busyTime;
+    it->second.utilization = deltaT > 0 ? std::min(1., static_cast<double>(busyTime - it->second.lastBusyTime) / deltaT) : 0;
+    it->second.lastBusyTime = busyTime;
+    builderUtilization_.push_back(it->second.utilization);
+  }
 }
 
 
@@ -530,21 +781,26 @@ cgicc::div evb::bu::EventBuilder::getHtmlSnipped() const
     table.add(tr()
               .add(td("# events w/ missing FED data"))
               .add(td(boost::lexical_cast<std::string>(eventsMissingData_))));
+    table.add(tr().set("title","Number of event dumps written to /tmp and dropped because of the rate limit")
+              .add(td("# event dumps written/dropped"))
+              .add(td(boost::lexical_cast<std::string>(bu_->getDumper()->getNbDumpsWritten())
+                      + "/" + boost::lexical_cast<std::string>(bu_->getDumper()->getNbDumpsDropped()))));
 
     div.add(table);
   }
 
   {
     cgicc::table table;
-    table.set("title","List of builder threads. Each thread assembles events independently. Any complete event is held back until all threads have reached the next lumi section.");
+    table.set("title","List of builder threads. Each thread assembles events independently. New resources are given to the thread with the fewest queued super-fragments. Any complete event is held back until all threads have reached the next lumi section.");
 
     boost::mutex::scoped_lock sl(processesActiveMutex_);
 
     table.add(tr()
-              .add(th("Event builders").set("colspan","5")));
+              .add(th("Event builders").set("colspan","6")));
     table.add(tr()
               .add(td("builder"))
               .add(td("active"))
+              .add(td("busy (%)"))
               .add(td("ls"))
               .add(td("#partial"))
               .add(td("#complete")));
@@ -555,6 +811,7 @@ cgicc::div evb::bu::EventBuilder::getHtmlSnipped() const
       table.add(tr()
                 .add(td(boost::lexical_cast<std::string>(it->first)))
                 .add(td(processesActive_[it->first]?"yes":"no"))
+                .add(td(doubleToString(it->second.utilization*100,1)))
                 .add(td(boost::lexical_cast<std::string>(it->second.lowestLumiSection)))
                 .add(td(boost::lexical_cast<std::string>(it->second.partialEvents)))
                 .add(td(boost::lexical_cast<std::string>(it->second.completeEvents))));
@@ -563,6 +820,26 @@ cgicc::div evb::bu::EventBuilder::getHtmlSnipped() const
     div.add(table);
   }
 
+  if ( configuration_->numberOfCheckers > 0U )
+  {
+    cgicc::table table;
+    table.set("title","Complete events are checked for data integrity by a pool of checker threads before they are written.");
+
+    boost::mutex::scoped_lock sl(eventsToCheckMutex_);
+
+    table.add(tr()
+              .add(td("# checker threads"))
+              .add(td(boost::lexical_cast<std::string>(configuration_->numberOfCheckers.value_))));
+    table.add(tr()
+              .add(td("# events waiting to be checked"))
+              .add(td(boost::lexical_cast<std::string>(eventsToCheck_.size()))));
+    table.add(tr()
+              .add(td("# events being checked"))
+              .add(td(boost::lexical_cast<std::string>(eventsBeingChecked_))));
+
+    div.add(table);
+  }
+
   if ( ! superFragmentFIFOs_.empty() )
   {
     cgicc::div fifos;
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <sstream>
+#include <string.h>
+#include <unistd.h>
+
+#include "evb/bu/EventIndex.h"
+#include "evb/Exception.h"
+#include "interface/shared/fed_header.h"
+#include "interface/shared/fed_trailer.h"
+
+
+evb::bu::EventIndex::EventIndex()
+{
+  clear();
+}
+
+
+void evb::bu::EventIndex::addEvent
+(
+  const uint64_t offset,
+  const EventInfoPtr& eventInfo,
+  const DataLocations& locs
+)
+{
+  if ( events_.empty() )
+  {
+    header_.runNumber = eventInfo->runNumber();
+    header_.lumiSection = eventInfo->lumiSection();
+  }
+
+  EventIndexEntry eventEntry;
+  eventEntry.offset = offset;
+  eventEntry.eventNumber = eventInfo->eventNumber();
+  eventEntry.eventSize = eventInfo->eventSize();
+  eventEntry.firstFed = feds_.size();
+
+  // offsets of the data chunks relative to the start of the event data
+  chunkOffsets_.clear();
+  uint32_t eventSize = 0;
+  for ( DataLocations::const_iterator it = locs.begin(), itEnd = locs.end();
+        it != itEnd; ++it )
+  {
+    chunkOffsets_.push_back(eventSize);
+    eventSize += it->iov_len;
+  }
+
+  // the events have been checked by the builder, thus the FED trailers
+  // can be followed backwards without looking at the payload
+  uint32_t fedEnd = eventSize;
+  uint32_t chunk = locs.size() - 1;
+
+  while ( fedEnd > 0 )
+  {
+    while ( chunkOffsets_[chunk] >= fedEnd ) --chunk;
+
+    const uint32_t trailerEnd = fedEnd - chunkOffsets_[chunk];
+    if ( trailerEnd < sizeof(fedt_t) )
+    {
+      std::ostringstream msg;
+      msg << "Cannot index event " << eventEntry.eventNumber;
+      msg << ": the FED trailer ending at offset " << fedEnd << " spans two data chunks";
+      XCEPT_RAISE(exception::DataCorruption, msg.str());
+    }
+    const fedt_t* trailer = reinterpret_cast<const fedt_t*>(
+      static_cast<const unsigned char*>(locs[chunk].iov_base) + trailerEnd - sizeof(fedt_t) );
+
+    const uint32_t fedSize = FED_EVSZ_EXTRACT(trailer->eventsize)<<3;
+    if ( fedSize < sizeof(fedh_t) + sizeof(fedt_t) || fedSize > fedEnd )
+    {
+      std::ostringstream msg;
+      msg << "Cannot index event " << eventEntry.eventNumber;
+      msg << ": invalid FED size of " << fedSize << " Bytes in the trailer ending at offset " << fedEnd;
+      XCEPT_RAISE(exception::DataCorruption, msg.str());
+    }
+
+    const uint32_t fedStart = fedEnd - fedSize;
+    while ( chunkOffsets_[chunk] > fedStart ) --chunk;
+
+    const fedh_t* fedHeader = reinterpret_cast<const fedh_t*>(
+      static_cast<const unsigned char*>(locs[chunk].iov_base) + fedStart - chunkOffsets_[chunk] );
+
+    FedIndexEntry fedEntry;
+    fedEntry.offset = fedStart;
+    fedEntry.size = fedSize;
+    fedEntry.fedId = FED_SOID_EXTRACT(fedHeader->sourceid);
+    fedEntry.reserved = 0;
+    feds_.push_back(fedEntry);
+
+    fedEnd = fedStart;
+  }
+
+  std::reverse(feds_.begin() + eventEntry.firstFed, feds_.end());
+  eventEntry.nbFeds = feds_.size() - eventEntry.firstFed;
+  events_.push_back(eventEntry);
+}
+
+
+void evb::bu::EventIndex::write(const std::string& fileName) const
+{
+  EventIndexHeader header = header_;
+  header.nbEvents = events_.size();
+  header.nbFeds = feds_.size();
+
+  iovec locs[3];
+  locs[0].iov_base = &header;
+  locs[0].iov_len = sizeof(EventIndexHeader);
+  locs[1].iov_base = const_cast<EventIndexEntry*>(events_.empty() ? 0 : &events_[0]);
+  locs[1].iov_len = events_.size() * sizeof(EventIndexEntry);
+  locs[2].iov_base = const_cast<FedIndexEntry*>(feds_.empty() ? 0 : &feds_[0]);
+  locs[2].iov_len = feds_.size() * sizeof(FedIndexEntry);
+  const ssize_t indexSize = locs[0].iov_len + locs[1].iov_len + locs[2].iov_len;
+
+  const int fileDescriptor = open(fileName.c_str(), O_RDWR|O_CREAT|O_TRUNC,
+                                  S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH);
+  if ( fileDescriptor == -1 )
+  {
+    std::ostringstream msg;
+    msg << "Failed to open index file " << fileName << ": " << strerror(errno);
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+
+  // the index is small compared to the raw data: a short write is treated as an error
+  const ssize_t bytesWritten = writev(fileDescriptor, locs, 3);
+  const int writeErrno = errno;
+  ::close(fileDescriptor);
+
+  if ( bytesWritten != indexSize )
+  {
+    // do not leave a truncated index behind
+    ::unlink(fileName.c_str());
+
+    std::ostringstream msg;
+    msg << "Failed to write " << indexSize << " Bytes into index file " << fileName;
+    if ( bytesWritten < 0 )
+      msg << ": " << strerror(writeErrno);
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+}
+
+
+void evb::bu::EventIndex::clear()
+{
+  header_.magic = eventIndexMagic;
+  header_.version = eventIndexVersion;
+  header_.runNumber = 0;
+  header_.lumiSection = 0;
+  header_.nbEvents = 0;
+  header_.nbFeds = 0;
+  events_.clear();
+  feds_.clear();
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -13,7 +13,7 @@ evb::bu::EventInfo::EventInfo
   const uint32_t lumi,
   const uint32_t event
 ) :
-  version_(5),
+  version_(currentVersion),
   runNumber_(run),
   lumiSection_(lumi),
   eventNumber_(event),
@@ -28,6 +28,12 @@ void evb::bu::EventInfo::updateCRC32(const iovec& loc)
 }
 
 
+void evb::bu::EventInfo::combineCRC32(const uint32_t crc32c, const uint32_t size)
+{
+  crc32c_ = crcCalculator_.crc32cCombine(crc32c_, crc32c, size);
+}
+
+
 namespace evb{
   namespace bu {
 
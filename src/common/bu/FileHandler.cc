@@ -1,23 +1,48 @@
 #include <boost/filesystem/convenience.hpp>
 
+#include <algorithm>
+#include <errno.h>
 #include <fcntl.h>
 #include <fstream>
+#include <limits.h>
 #include <sstream>
 #include <iomanip>
 
+#include "evb/Constants.h"
 #include "evb/Exception.h"
 #include "evb/DataLocations.h"
 #include "evb/bu/EventInfo.h"
 #include "evb/bu/FedInfo.h"
 #include "evb/bu/FileHandler.h"
+#include "evb/TimeStamp.h"
 #include "xcept/tools.h"
 
 
-evb::bu::FileHandler::FileHandler(const std::string& rawFileName) :
+evb::bu::FileHandler::FileHandler
+(
+  const std::string& rawFileName,
+  const uint32_t eventsPerWrite,
+  const uint32_t bytesPerWrite,
+  const bool writeEventIndex,
+  StagingBufferPtr stagingBuffer
+) :
   rawFileName_(rawFileName),
+  eventsPerWrite_(eventsPerWrite),
+  bytesPerWrite_(bytesPerWrite),
+  stagingBuffer_(stagingBuffer),
   fileDescriptor_(0),
-  fileSize_(0)
+  directIO_(false),
+  fileSize_(0),
+  fileOffset_(0),
+  nbWriteCalls_(0),
+  queuedBytes_(0),
+  firstQueuedTime_(0)
 {
+  queuedLocations_.reserve(IOV_MAX);
+
+  if ( writeEventIndex )
+    eventIndex_.reset( new EventIndex() );
+
   if ( boost::filesystem::exists(rawFileName_) )
   {
     std::ostringstream msg;
@@ -25,7 +50,29 @@ evb::bu::FileHandler::FileHandler(const std::string& rawFileName) :
     XCEPT_RAISE(exception::DiskWriting, msg.str());
   }
 
-  fileDescriptor_ = open(rawFileName_.c_str(), O_RDWR|O_CREAT|O_TRUNC, S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH);
+  const mode_t mode = S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH;
+
+  if ( stagingBuffer_.get() )
+  {
+    stagingBuffer_->clear();
+
+    fileDescriptor_ = open(rawFileName_.c_str(), O_RDWR|O_CREAT|O_TRUNC|O_DIRECT, mode);
+    if ( fileDescriptor_ != -1 )
+      directIO_ = true;
+    else if ( errno != EINVAL )
+    {
+      std::ostringstream msg;
+      msg << "Failed to open output file " << rawFileName_
+        << " for direct I/O: " << strerror(errno);
+      XCEPT_RAISE(exception::DiskWriting, msg.str());
+    }
+    // else the file system does not support O_DIRECT:
+    // keep using the staging buffer for large aligned writes
+  }
+
+  if ( ! directIO_ )
+    fileDescriptor_ = open(rawFileName_.c_str(), O_RDWR|O_CREAT|O_TRUNC, mode);
+
   if ( fileDescriptor_ == -1 )
   {
     std::ostringstream msg;
@@ -45,20 +92,270 @@ evb::bu::FileHandler::~FileHandler()
 void evb::bu::FileHandler::writeEvent(const EventPtr& event)
 {
   const EventInfoPtr& eventInfo = event->getEventInfo();
-  size_t bytesWritten = write(fileDescriptor_,eventInfo.get(),sizeof(EventInfo));
-
   const DataLocations& locs = event->getDataLocations();
-  bytesWritten += writev(fileDescriptor_,&locs[0],locs.size());
 
-  if ( bytesWritten != sizeof(EventInfo) + eventInfo->eventSize() )
+  uint64_t eventSize = 0;
+  for ( DataLocations::const_iterator it = locs.begin(), itEnd = locs.end();
+        it != itEnd; ++it )
+  {
+    eventSize += it->iov_len;
+  }
+
+  if ( eventSize != eventInfo->eventSize() )
   {
     std::ostringstream msg;
     msg << "Failed to completely write event " << event->getEvBid();
     msg << " into " << rawFileName_;
+    msg << ": the data locations hold " << eventSize << " Bytes";
+    msg << " while the event size is " << eventInfo->eventSize() << " Bytes";
     XCEPT_RAISE(exception::DiskWriting, msg.str());
   }
 
-  fileSize_ += bytesWritten;
+  if ( eventIndex_.get() )
+    eventIndex_->addEvent(fileOffset_, eventInfo, locs);
+
+  if ( stagingBuffer_.get() )
+  {
+    if ( stagingBuffer_->empty() )
+      firstQueuedTime_ = getMonotonicTimeStamp();
+
+    stageData(eventInfo.get(), sizeof(EventInfo));
+    for ( DataLocations::const_iterator it = locs.begin(), itEnd = locs.end();
+          it != itEnd; ++it )
+    {
+      stageData(it->iov_base, it->iov_len);
+    }
+    fileOffset_ += sizeof(EventInfo) + eventSize;
+    return;
+  }
+
+  // keep a single writev call per flush if possible
+  if ( ! queuedLocations_.empty() && queuedLocations_.size() + locs.size() + 1 > IOV_MAX )
+    writeQueuedEvents();
+
+  iovec eventInfoLocation;
+  eventInfoLocation.iov_base = eventInfo.get();
+  eventInfoLocation.iov_len = sizeof(EventInfo);
+  queuedLocations_.push_back(eventInfoLocation);
+  queuedLocations_.insert(queuedLocations_.end(),locs.begin(),locs.end());
+
+  // the event holds the I2O buffers until its data has been written
+  if ( queuedEvents_.empty() )
+    firstQueuedTime_ = getMonotonicTimeStamp();
+  queuedEvents_.push_back(event);
+  queuedBytes_ += sizeof(EventInfo) + eventSize;
+  fileOffset_ += sizeof(EventInfo) + eventSize;
+
+  if ( queuedEvents_.size() >= eventsPerWrite_ || queuedBytes_ >= bytesPerWrite_ )
+    writeQueuedEvents();
+}
+
+
+void evb::bu::FileHandler::writeFrame(const CompressedFramePtr& frame)
+{
+  compression::IndexEntry indexEntry;
+  indexEntry.offset = fileOffset_;
+  indexEntry.firstEventNumber = frame->firstEventNumber();
+  indexEntry.nbEvents = frame->nbEvents();
+  indexEntry.uncompressedSize = frame->uncompressedSize();
+  indexEntry.compressedSize = frame->size() - sizeof(compression::FrameHeader);
+  frameIndex_.push_back(indexEntry);
+
+  if ( stagingBuffer_.get() )
+  {
+    if ( stagingBuffer_->empty() )
+      firstQueuedTime_ = getMonotonicTimeStamp();
+
+    stageData(frame->data(), frame->size());
+  }
+  else
+  {
+    if ( queuedLocations_.size() >= IOV_MAX )
+      writeQueuedEvents();
+
+    iovec frameLocation;
+    frameLocation.iov_base = const_cast<unsigned char*>(frame->data());
+    frameLocation.iov_len = frame->size();
+    queuedLocations_.push_back(frameLocation);
+
+    if ( queuedFrames_.empty() )
+      firstQueuedTime_ = getMonotonicTimeStamp();
+    queuedFrames_.push_back(frame);
+    queuedBytes_ += frame->size();
+
+    if ( queuedFrames_.size() >= eventsPerWrite_ || queuedBytes_ >= bytesPerWrite_ )
+      writeQueuedEvents();
+  }
+
+  fileOffset_ += frame->size();
+}
+
+
+void evb::bu::FileHandler::writeFrameIndex()
+{
+  fileTrailer_.indexOffset = fileOffset_;
+  fileTrailer_.nbFrames = frameIndex_.size();
+  fileTrailer_.magic = compression::trailerMagic;
+
+  const size_t indexSize = frameIndex_.size() * sizeof(compression::IndexEntry);
+
+  if ( stagingBuffer_.get() )
+  {
+    stageData(&frameIndex_[0], indexSize);
+    stageData(&fileTrailer_, sizeof(compression::FileTrailer));
+  }
+  else
+  {
+    if ( queuedLocations_.size() + 2 > IOV_MAX )
+      writeQueuedEvents();
+
+    iovec location;
+    location.iov_base = &frameIndex_[0];
+    location.iov_len = indexSize;
+    queuedLocations_.push_back(location);
+    location.iov_base = &fileTrailer_;
+    location.iov_len = sizeof(compression::FileTrailer);
+    queuedLocations_.push_back(location);
+    queuedBytes_ += indexSize + sizeof(compression::FileTrailer);
+  }
+
+  fileOffset_ += indexSize + sizeof(compression::FileTrailer);
+}
+
+
+void evb::bu::FileHandler::flushIfQueuedBefore(const uint64_t& timeStamp)
+{
+  if ( firstQueuedTime_ > 0 && firstQueuedTime_ < timeStamp )
+    flush();
+}
+
+
+void evb::bu::FileHandler::flush()
+{
+  if ( stagingBuffer_.get() )
+  {
+    if ( stagingBuffer_->alignedSize() > 0 )
+      writeStagedData( stagingBuffer_->alignedSize() );
+
+    // the unaligned tail is only written when closing the file
+    firstQueuedTime_ = stagingBuffer_->empty() ? 0 : getMonotonicTimeStamp();
+  }
+  else
+  {
+    writeQueuedEvents();
+  }
+}
+
+
+void evb::bu::FileHandler::stageData(const void* data, size_t size)
+{
+  const unsigned char* pos = static_cast<const unsigned char*>(data);
+
+  while ( size > 0 )
+  {
+    const size_t bytesCopied = stagingBuffer_->append(pos, size);
+    pos += bytesCopied;
+    size -= bytesCopied;
+
+    if ( stagingBuffer_->full() )
+      writeStagedData( stagingBuffer_->capacity() );
+  }
+}
+
+
+void evb::bu::FileHandler::writeStagedData(const size_t size)
+{
+  const unsigned char* pos = stagingBuffer_->data();
+  size_t remainingBytes = size;
+
+  while ( remainingBytes > 0 )
+  {
+    const ssize_t bytesWritten = write(fileDescriptor_, pos, remainingBytes);
+    ++nbWriteCalls_;
+
+    if ( bytesWritten <= 0 )
+    {
+      if ( bytesWritten < 0 && errno == EINTR ) continue;
+
+      std::ostringstream msg;
+      msg << "Failed to write " << remainingBytes << " Bytes from the staging buffer";
+      msg << " into " << rawFileName_;
+      if ( bytesWritten < 0 )
+        msg << ": " << strerror(errno);
+
+      stagingBuffer_->clear();
+
+      XCEPT_RAISE(exception::DiskWriting, msg.str());
+    }
+
+    fileSize_ += bytesWritten;
+    remainingBytes -= bytesWritten;
+    pos += bytesWritten;
+  }
+
+  stagingBuffer_->consume(size);
+}
+
+
+void evb::bu::FileHandler::writeQueuedEvents()
+{
+  firstQueuedTime_ = 0;
+
+  if ( queuedLocations_.empty() ) return;
+
+  iovec* iov = &queuedLocations_[0];
+  size_t iovcnt = queuedLocations_.size();
+  uint64_t remainingBytes = queuedBytes_;
+
+  while ( remainingBytes > 0 )
+  {
+    const ssize_t bytesWritten = writev(fileDescriptor_, iov, std::min(iovcnt,static_cast<size_t>(IOV_MAX)));
+    ++nbWriteCalls_;
+
+    if ( bytesWritten <= 0 )
+    {
+      if ( bytesWritten < 0 && errno == EINTR ) continue;
+
+      std::ostringstream msg;
+      msg << "Failed to completely write " << remainingBytes << " Bytes";
+      if ( ! queuedEvents_.empty() )
+        msg << " of " << queuedEvents_.size() << " events ending with event " << queuedEvents_.back()->getEvBid();
+      if ( ! queuedFrames_.empty() )
+        msg << " of " << queuedFrames_.size() << " compressed frames";
+      msg << " into " << rawFileName_;
+      if ( bytesWritten < 0 )
+        msg << ": " << strerror(errno);
+
+      queuedEvents_.clear();
+      queuedFrames_.clear();
+      queuedLocations_.clear();
+      queuedBytes_ = 0;
+
+      XCEPT_RAISE(exception::DiskWriting, msg.str());
+    }
+
+    fileSize_ += bytesWritten;
+    remainingBytes -= bytesWritten;
+
+    // skip over the data already written
+    size_t bytesToSkip = bytesWritten;
+    while ( iovcnt > 0 && bytesToSkip >= iov->iov_len )
+    {
+      bytesToSkip -= iov->iov_len;
+      ++iov;
+      --iovcnt;
+    }
+    if ( bytesToSkip > 0 )
+    {
+      iov->iov_base = static_cast<unsigned char*>(iov->iov_base) + bytesToSkip;
+      iov->iov_len -= bytesToSkip;
+    }
+  }
+
+  queuedEvents_.clear();
+  queuedFrames_.clear();
+  queuedLocations_.clear();
+  queuedBytes_ = 0;
 }
 
 
@@ -70,6 +367,23 @@ uint64_t evb::bu::FileHandler::closeAndGetFileSize()
   {
     if ( fileDescriptor_ )
     {
+      if ( ! frameIndex_.empty() )
+        writeFrameIndex();
+
+      flush();
+
+      if ( stagingBuffer_.get() && ! stagingBuffer_->empty() )
+      {
+        // O_DIRECT requires aligned writes. Write the tail through the page cache.
+        if ( directIO_ && fcntl(fileDescriptor_, F_SETFL, fcntl(fileDescriptor_, F_GETFL) & ~O_DIRECT) < 0 )
+        {
+          std::ostringstream msg;
+          msg << error << ": cannot clear O_DIRECT: " << strerror(errno);
+          XCEPT_RAISE(exception::DiskWriting, msg.str());
+        }
+        writeStagedData( stagingBuffer_->used() );
+      }
+
       if ( ::close(fileDescriptor_) < 0 )
       {
         std::ostringstream msg;
@@ -77,6 +391,9 @@ uint64_t evb::bu::FileHandler::closeAndGetFileSize()
         XCEPT_RAISE(exception::DiskWriting, msg.str());
       }
       fileDescriptor_ = 0;
+
+      if ( eventIndex_.get() )
+        eventIndex_->write( getIndexFileName() );
     }
   }
   catch(std::exception& e)
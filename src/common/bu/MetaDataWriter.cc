@@ -0,0 +1,463 @@
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <set>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/filesystem/convenience.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "evb/BU.h"
+#include "evb/Constants.h"
+#include "evb/bu/MetaDataWriter.h"
+#include "evb/bu/StateMachine.h"
+#include "evb/Exception.h"
+#include "evb/TimeStamp.h"
+#include "toolbox/task/WorkLoopFactory.h"
+#include "xcept/tools.h"
+
+
+evb::bu::JsonValues& evb::bu::JsonValues::add(const uint64_t value)
+{
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+  return add(std::string(buffer));
+}
+
+
+evb::bu::JsonValues& evb::bu::JsonValues::add(const std::string& value)
+{
+  if ( ! values_.empty() )
+    values_ += ", ";
+  values_ += '"';
+  values_ += value;
+  values_ += '"';
+  return *this;
+}
+
+
+evb::bu::JsonTemplate::JsonTemplate
+(
+  const std::string& definitionFile,
+  const uint32_t buInstance
+)
+{
+  std::ostringstream tail;
+  tail << field("definition",definitionFile);
+  tail << "   \"source\" : \"BU-" << buInstance << "\"" << std::endl;
+  tail << "}" << std::endl;
+  tail_ = tail.str();
+}
+
+
+std::string evb::bu::JsonTemplate::format(const JsonValues& values, const std::string& fields) const
+{
+  std::string json;
+  json.reserve(32 + values.str().size() + fields.size() + tail_.size());
+  json += "{\n   \"data\" : [ ";
+  json += values.str();
+  json += " ],\n";
+  json += fields;
+  json += tail_;
+  return json;
+}
+
+
+std::string evb::bu::JsonTemplate::field(const std::string& name, const std::string& value)
+{
+  return "   \"" + name + "\" : \"" + value + "\",\n";
+}
+
+
+evb::bu::MetaDataWriter::MetaDataWriter(BU* bu) :
+  bu_(bu),
+  configuration_(bu->getConfiguration()),
+  writing_(false),
+  doProcessing_(false),
+  active_(false)
+{
+  resetMonitoringCounters();
+  startWorkLoop();
+}
+
+
+evb::bu::MetaDataWriter::~MetaDataWriter()
+{
+  if ( workLoop_ && workLoop_->isActive() )
+    workLoop_->cancel();
+}
+
+
+void evb::bu::MetaDataWriter::startWorkLoop()
+{
+  try
+  {
+    workLoop_ =
+      toolbox::task::getWorkLoopFactory()->getWorkLoop(bu_->getIdentifier("metaDataWriter"), "waiting");
+
+    if ( !workLoop_->isActive() )
+      workLoop_->activate();
+
+    action_ =
+      toolbox::task::bind(this,
+                          &evb::bu::MetaDataWriter::process,
+                          bu_->getIdentifier("metaDataWriterAction"));
+  }
+  catch(xcept::Exception& e)
+  {
+    std::string msg = "Failed to start meta-data writer workloop";
+    XCEPT_RETHROW(exception::WorkLoop, msg, e);
+  }
+}
+
+
+void evb::bu::MetaDataWriter::startProcessing()
+{
+  resetMonitoringCounters();
+
+  {
+    boost::mutex::scoped_lock sl(requestsMutex_);
+    requests_.clear();
+  }
+
+  doProcessing_ = true;
+  active_ = true;
+  workLoop_->submit(action_);
+}
+
+
+void evb::bu::MetaDataWriter::stopProcessing()
+{
+  doProcessing_ = false;
+  requestQueued_.notify_all();
+
+  active_.waitUntilIdle();
+
+  boost::mutex::scoped_lock sl(requestsMutex_);
+  requests_.clear();
+}
+
+
+void evb::bu::MetaDataWriter::write
+(
+  const std::string& jsonFile,
+  const std::string& body,
+  const FileMoves& fileMoves
+)
+{
+  Request request;
+  request.jsonFile = jsonFile;
+  request.body = body;
+  request.fileMoves = fileMoves;
+  request.queuedTime = getMonotonicTimeStamp();
+
+  boost::mutex::scoped_lock sl(requestsMutex_);
+
+  if ( ! active_ )
+  {
+    // no worker running, e.g. when closing old runs during configuration
+    sl.unlock();
+    handleRequests( Requests(1,request) );
+    return;
+  }
+
+  while ( requests_.size() >= configuration_->metaDataFIFOCapacity && active_ )
+    requestsHandled_.timed_wait(sl, boost::posix_time::milliseconds(100));
+
+  requests_.push_back(request);
+  requestQueued_.notify_one();
+
+  boost::mutex::scoped_lock msl(metaDataMonitoringMutex_);
+  if ( requests_.size() > metaDataMonitoring_.maxQueueDepth )
+    metaDataMonitoring_.maxQueueDepth = requests_.size();
+}
+
+
+void evb::bu::MetaDataWriter::drain() const
+{
+  boost::mutex::scoped_lock sl(requestsMutex_);
+
+  while ( (! requests_.empty() || writing_) && active_ )
+    requestsHandled_.timed_wait(sl, boost::posix_time::milliseconds(100));
+}
+
+
+bool evb::bu::MetaDataWriter::process(toolbox::task::WorkLoop*)
+{
+  try
+  {
+    Requests batch;
+
+    while ( doProcessing_ )
+    {
+      {
+        boost::mutex::scoped_lock sl(requestsMutex_);
+
+        writing_ = false;
+        requestsHandled_.notify_all();
+
+        while ( requests_.empty() && doProcessing_ )
+          requestQueued_.timed_wait(sl, boost::posix_time::milliseconds(100));
+
+        if ( ! doProcessing_ ) break;
+
+        const size_t batchSize = std::min(requests_.size(),
+                                          static_cast<size_t>(std::max(configuration_->metaDataBatchSize.value_,1U)));
+        batch.assign(requests_.begin(), requests_.begin() + batchSize);
+        requests_.erase(requests_.begin(), requests_.begin() + batchSize);
+        writing_ = true;
+      }
+
+      handleRequests(batch);
+    }
+  }
+  catch(xcept::Exception& e)
+  {
+    active_ = false;
+    stateMachine_->processFSMEvent( Fail(e) );
+  }
+  catch(std::exception& e)
+  {
+    active_ = false;
+    XCEPT_DECLARE(exception::DiskWriting,
+                  sentinelException, e.what());
+    stateMachine_->processFSMEvent( Fail(sentinelException) );
+  }
+  catch(...)
+  {
+    active_ = false;
+    XCEPT_DECLARE(exception::DiskWriting,
+                  sentinelException, "unkown exception");
+    stateMachine_->processFSMEvent( Fail(sentinelException) );
+  }
+
+  {
+    boost::mutex::scoped_lock sl(requestsMutex_);
+    writing_ = false;
+    active_ = false;
+    requestsHandled_.notify_all();
+  }
+
+  return false;
+}
+
+
+void evb::bu::MetaDataWriter::handleRequests(const Requests& requests)
+{
+  // move the raw data and write all JSON files into temporary files first
+  for ( Requests::const_iterator it = requests.begin(), itEnd = requests.end();
+        it != itEnd; ++it )
+  {
+    moveFiles(it->fileMoves);
+    if ( ! it->jsonFile.empty() )
+      writeTemporaryFile(*it);
+  }
+
+  if ( configuration_->syncMetaData )
+    syncFileSystems(requests);
+
+  // publish the JSON files in the order they have been queued
+  const uint64_t now = getMonotonicTimeStamp();
+  uint64_t latency = 0;
+  uint64_t maxLatency = 0;
+
+  for ( Requests::const_iterator it = requests.begin(), itEnd = requests.end();
+        it != itEnd; ++it )
+  {
+    if ( ! it->jsonFile.empty() )
+    {
+      const std::string tmpFile = it->jsonFile + ".tmp";
+      if ( ::rename(tmpFile.c_str(), it->jsonFile.c_str()) != 0 )
+      {
+        std::ostringstream msg;
+        msg << "Failed to rename " << tmpFile << " to " << it->jsonFile << ": " << strerror(errno);
+        XCEPT_RAISE(exception::DiskWriting, msg.str());
+      }
+    }
+    latency += now - it->queuedTime;
+    maxLatency = std::max(maxLatency, now - it->queuedTime);
+  }
+
+  boost::mutex::scoped_lock sl(metaDataMonitoringMutex_);
+
+  metaDataMonitoring_.nbFiles += requests.size();
+  ++metaDataMonitoring_.nbBatches;
+  metaDataMonitoring_.nbFilesSinceUpdate += requests.size();
+  metaDataMonitoring_.latencySinceUpdate += latency;
+  metaDataMonitoring_.totalLatency += latency;
+  metaDataMonitoring_.maxLatency = std::max(metaDataMonitoring_.maxLatency, maxLatency);
+}
+
+
+void evb::bu::MetaDataWriter::moveFiles(const FileMoves& fileMoves) const
+{
+  for ( FileMoves::const_iterator it = fileMoves.begin(), itEnd = fileMoves.end();
+        it != itEnd; ++it )
+  {
+    if ( it->second.empty() )
+      boost::filesystem::remove(it->first);
+    else if ( ::rename(it->first.c_str(), it->second.c_str()) != 0 )
+    {
+      std::ostringstream msg;
+      msg << "Failed to move " << it->first << " to " << it->second << ": " << strerror(errno);
+      XCEPT_RAISE(exception::DiskWriting, msg.str());
+    }
+  }
+}
+
+
+void evb::bu::MetaDataWriter::writeTemporaryFile(const Request& request) const
+{
+  if ( ::access(request.jsonFile.c_str(), F_OK) == 0 )
+  {
+    std::ostringstream msg;
+    msg << "The JSON file " << request.jsonFile << " already exists";
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+
+  const std::string tmpFile = request.jsonFile + ".tmp";
+  const int fileDescriptor = open(tmpFile.c_str(), O_WRONLY|O_CREAT|O_TRUNC,
+                                  S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH);
+  if ( fileDescriptor == -1 )
+  {
+    std::ostringstream msg;
+    msg << "Failed to open " << tmpFile << ": " << strerror(errno);
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+
+  const ssize_t bytesWritten = ::write(fileDescriptor, request.body.c_str(), request.body.size());
+  const int writeErrno = errno;
+  ::close(fileDescriptor);
+
+  if ( bytesWritten != static_cast<ssize_t>(request.body.size()) )
+  {
+    std::ostringstream msg;
+    msg << "Failed to write " << request.body.size() << " Bytes into " << tmpFile;
+    if ( bytesWritten < 0 )
+      msg << ": " << strerror(writeErrno);
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+}
+
+
+void evb::bu::MetaDataWriter::syncFileSystems(const Requests& requests) const
+{
+  // a single syncfs per directory flushes all files of the batch
+  std::set<std::string> directories;
+  for ( Requests::const_iterator it = requests.begin(), itEnd = requests.end();
+        it != itEnd; ++it )
+  {
+    if ( ! it->jsonFile.empty() )
+      directories.insert( boost::filesystem::path(it->jsonFile).parent_path().string() );
+  }
+
+  for ( std::set<std::string>::const_iterator it = directories.begin(), itEnd = directories.end();
+        it != itEnd; ++it )
+  {
+    const int fileDescriptor = open(it->c_str(), O_RDONLY|O_DIRECTORY);
+    if ( fileDescriptor == -1 || syncfs(fileDescriptor) != 0 )
+    {
+      std::ostringstream msg;
+      msg << "Failed to sync the file system holding " << *it << ": " << strerror(errno);
+      if ( fileDescriptor != -1 ) ::close(fileDescriptor);
+      XCEPT_RAISE(exception::DiskWriting, msg.str());
+    }
+    ::close(fileDescriptor);
+  }
+}
+
+
+void evb::bu::MetaDataWriter::appendMonitoringItems(InfoSpaceItems& items)
+{
+  metaDataQueueDepth_ = 0;
+  metaDataLatency_ = 0;
+
+  items.add("metaDataQueueDepth", &metaDataQueueDepth_);
+  items.add("metaDataLatency", &metaDataLatency_);
+}
+
+
+void evb::bu::MetaDataWriter::updateMonitoringItems()
+{
+  {
+    boost::mutex::scoped_lock sl(requestsMutex_);
+    metaDataQueueDepth_ = requests_.size();
+  }
+
+  boost::mutex::scoped_lock sl(metaDataMonitoringMutex_);
+
+  if ( metaDataMonitoring_.nbFilesSinceUpdate > 0 )
+  {
+    // average latency in ms since the last update
+    metaDataLatency_ = metaDataMonitoring_.latencySinceUpdate / 1e6 / metaDataMonitoring_.nbFilesSinceUpdate;
+    metaDataMonitoring_.nbFilesSinceUpdate = 0;
+    metaDataMonitoring_.latencySinceUpdate = 0;
+  }
+}
+
+
+void evb::bu::MetaDataWriter::resetMonitoringCounters()
+{
+  boost::mutex::scoped_lock sl(metaDataMonitoringMutex_);
+
+  metaDataMonitoring_.nbFiles = 0;
+  metaDataMonitoring_.nbBatches = 0;
+  metaDataMonitoring_.nbFilesSinceUpdate = 0;
+  metaDataMonitoring_.latencySinceUpdate = 0;
+  metaDataMonitoring_.totalLatency = 0;
+  metaDataMonitoring_.maxLatency = 0;
+  metaDataMonitoring_.maxQueueDepth = 0;
+}
+
+
+cgicc::div evb::bu::MetaDataWriter::getHtmlSnipped() const
+{
+  using namespace cgicc;
+
+  uint32_t queueDepth;
+  {
+    boost::mutex::scoped_lock sl(requestsMutex_);
+    queueDepth = requests_.size();
+  }
+
+  cgicc::table table;
+  table.set("title","Meta-data files and raw-data file moves handled by the meta-data writer since the beginning of the run.");
+
+  boost::mutex::scoped_lock sl(metaDataMonitoringMutex_);
+
+  table.add(tr()
+            .add(td("# meta-data requests"))
+            .add(td(boost::lexical_cast<std::string>(metaDataMonitoring_.nbFiles))));
+  table.add(tr()
+            .add(td("avg requests per batch"))
+            .add(td(doubleToString(metaDataMonitoring_.nbBatches > 0 ?
+                                   static_cast<double>(metaDataMonitoring_.nbFiles) / metaDataMonitoring_.nbBatches : 0, 1))));
+  table.add(tr()
+            .add(td("queue depth (max)"))
+            .add(td(boost::lexical_cast<std::string>(queueDepth) + " (" +
+                    boost::lexical_cast<std::string>(metaDataMonitoring_.maxQueueDepth) + ")")));
+  table.add(tr()
+            .add(td("avg latency (ms)"))
+            .add(td(doubleToString(metaDataMonitoring_.nbFiles > 0 ?
+                                   metaDataMonitoring_.totalLatency / 1e6 / metaDataMonitoring_.nbFiles : 0, 1))));
+  table.add(tr()
+            .add(td("max latency (ms)"))
+            .add(td(doubleToString(metaDataMonitoring_.maxLatency / 1e6,1))));
+
+  cgicc::div div;
+  div.add(table);
+  return div;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -76,6 +76,16 @@ void evb::bu::RUproxy::superFragmentCallback(toolbox::mem::Reference* bufRef)
         (msg::I2O_DATA_BLOCK_MESSAGE_FRAME*)stdMsg;
       const uint32_t payload = stdMsg->MessageSize << 2;
 
+      if ( dataBlockMsg->version != msg::dataBlockVersion )
+      {
+        std::ostringstream msg;
+        msg << "Received an I2O_DATA_BLOCK_MESSAGE_FRAME with version " << dataBlockMsg->version;
+        msg << " from RU TID " << stdMsg->InitiatorAddress;
+        msg << ", while this BU expects version " << msg::dataBlockVersion;
+        msg << ". The RUs and BUs must run the same software release.";
+        XCEPT_RAISE(exception::I2O, msg.str());
+      }
+
       Index index;
       index.ruTid = stdMsg->InitiatorAddress;
       index.buResourceId = dataBlockMsg->buResourceId;
@@ -148,7 +158,10 @@ void evb::bu::RUproxy::superFragmentCallback(toolbox::mem::Reference* bufRef)
 
         if ( superFragmentComplete )
         {
-          eventBuilder_->addSuperFragment(builderId,dataBlockPos->second);
+          // the first complete super fragment binds the resource to the least loaded builder
+          const uint16_t assignedBuilderId =
+            resourceManager_->assignBuilder(index.buResourceId,eventBuilder_->getLeastLoadedBuilder(builderId));
+          eventBuilder_->addSuperFragment(assignedBuilderId,dataBlockPos->second);
           dataBlockMap_.erase(dataBlockPos);
         }
       }
@@ -190,14 +203,15 @@ void evb::bu::RUproxy::startProcessing()
 
 void evb::bu::RUproxy::drain()
 {
-  while ( requestFragmentsActive_ || !dataBlockMap_.empty() ) ::usleep(1000);
+  while ( requestFragmentsActive_ || !dataBlockMap_.empty() )
+    requestFragmentsActive_.waitForChange(1000);
 }
 
 
 void evb::bu::RUproxy::stopProcessing()
 {
   doProcessing_ = false;
-  while ( requestFragmentsActive_ ) ::usleep(1000);
+  requestFragmentsActive_.waitUntilIdle();
 }
 
 
@@ -471,6 +485,9 @@ void evb::bu::RUproxy::configure()
 
   roundTripTimeSampling_ = configuration_->roundTripTimeSamples>0U ? 1./configuration_->roundTripTimeSamples : 0;
 
+  // the pool depends on the configuration, e.g. when using hugepages
+  msgPool_ = bu_->getMsgPool();
+
   getApplicationDescriptors();
 }
 
@@ -652,6 +669,7 @@ cgicc::div evb::bu::RUproxy::getHtmlSnipped() const
     table.add(tr()
               .add(td("Fragments/I2O"))
               .add(td(doubleToString(fragmentMonitoring_.packingFactor,1))));
+    addMemoryPoolRows(table, msgPool_, "msg pool");
     div.add(table);
   }
   {
@@ -14,9 +14,6 @@
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/lexical_cast.hpp>
-#include <boost/property_tree/exceptions.hpp>
-#include <boost/property_tree/json_parser.hpp>
-#include <boost/property_tree/ptree.hpp>
 
 
 evb::bu::ResourceManager::ResourceManager
@@ -36,7 +33,7 @@ evb::bu::ResourceManager::ResourceManager
   fusCloud_(0),
   fusQuarantined_(0),
   fusStale_(0),
-  allFUsStaleDetected_(0),
+  allFUsStaleSince_(0),
   initiallyQueuedLS_(0),
   queuedLS_(0),
   queuedLSonFUs_(-1),
@@ -45,6 +42,7 @@ evb::bu::ResourceManager::ResourceManager
   pauseRequested_(false),
   resourceSummaryFailureAlreadyNotified_(false),
   resourceLimitiationAlreadyNotified_(false),
+  nextLumiSection_(0),
   oldestIncompleteLumiSection_(0),
   doProcessing_(false)
 {
@@ -184,61 +182,124 @@ uint16_t evb::bu::ResourceManager::underConstruction(const msg::I2O_DATA_BLOCK_M
 }
 
 
+uint16_t evb::bu::ResourceManager::assignBuilder(const uint16_t buResourceId, const uint16_t proposedBuilderId)
+{
+  const BuilderResources::iterator pos = builderResources_.find(buResourceId);
+
+  if ( pos == builderResources_.end() || pos->second.builderId == -1 )
+    return -1;
+
+  if ( ! pos->second.building )
+  {
+    pos->second.builderId = proposedBuilderId;
+    pos->second.building = true;
+  }
+
+  return pos->second.builderId;
+}
+
+
 uint32_t evb::bu::ResourceManager::getOldestIncompleteLumiSection() const
 {
-  boost::mutex::scoped_lock sl(lsLatencyMutex_);
   return oldestIncompleteLumiSection_;
 }
 
 
 void evb::bu::ResourceManager::incrementEventsInLumiSection(const uint32_t lumiSection)
 {
-  boost::mutex::scoped_lock sl(lumiSectionAccountsMutex_);
-
-  LumiSectionAccounts::const_iterator pos = lumiSectionAccounts_.find(lumiSection);
-
-  if ( pos == lumiSectionAccounts_.end() )
+  if ( lumiSection >= nextLumiSection_ )
   {
-    // backfill any skipped lumi sections
-    // if there are pervious LS, fill anything in between
+    // open any skipped lumi sections
     // if the current lumiSection is 0, this means that we do not create any LS numbers,
     // otherwise start with the first legal LS 1
-    const uint32_t newestLumiSection = !lumiSectionAccounts_.empty() ? lumiSectionAccounts_.rbegin()->first + 1 :
-      (lumiSection == 0 ? 0 : 1);
-    for ( uint32_t ls = newestLumiSection; ls <= lumiSection; ++ls )
+    const uint32_t window = eventsInLumiSection_.getWindow();
+    const uint32_t oldestOpenLumiSection = eventsInLumiSection_.getOldestOpen();
+    if ( lumiSection >= oldestOpenLumiSection + window )
     {
-      LumiSectionAccountPtr lumiAccount( new LumiSectionAccount(ls) );
-      pos = lumiSectionAccounts_.insert(LumiSectionAccounts::value_type(ls,lumiAccount)).first;
+      std::ostringstream msg;
+      msg << "Received an event from lumi section " << lumiSection;
+      msg << " while the lumi section " << oldestOpenLumiSection << " is still open.";
+      msg << " Only " << window << " lumi sections can be open at the same time.";
+      XCEPT_RAISE(exception::EventOrder, msg.str());
     }
+    const time_t now = time(0);
+    uint32_t ls = nextLumiSection_;
+    if ( ls == 0 && lumiSection > 0 ) ls = 1;
+    for ( ; ls <= lumiSection; ++ls )
+    {
+      lumiSectionStartTimes_[ls % window] = now;
+      eventsInLumiSection_.open(ls);
+      eventsCompletedInLumiSection_.open(ls);
+    }
+    __sync_synchronize();
+    nextLumiSection_ = lumiSection + 1;
   }
 
-  if ( pos == lumiSectionAccounts_.end() )
+  // the lumi section might be closed concurrently by the lumi-accounting thread
+  if ( ! eventsInLumiSection_.incrementIfNotClosed(lumiSection) )
   {
     std::ostringstream msg;
     msg << "Received an event from an earlier lumi section " << lumiSection;
     msg << " that has already been closed.";
     XCEPT_RAISE(exception::EventOrder, msg.str());
   }
+}
 
-  ++(pos->second->nbEvents);
-  ++(pos->second->nbIncompleteEvents);
+
+void evb::bu::ResourceManager::eventCompletedForLumiSection(const uint32_t lumiSection, const uint16_t builderId)
+{
+  if ( ! eventsCompletedInLumiSection_.isOpen(lumiSection) )
+  {
+    std::ostringstream msg;
+    msg << "Completed an event from an unknown lumi section " << lumiSection;
+    XCEPT_RAISE(exception::EventOrder, msg.str());
+  }
+
+  eventsCompletedInLumiSection_.increment(lumiSection,builderId);
 }
 
 
-void evb::bu::ResourceManager::eventCompletedForLumiSection(const uint32_t lumiSection)
+void evb::bu::ResourceManager::resetLumiSectionCounters()
 {
   boost::mutex::scoped_lock sl(lumiSectionAccountsMutex_);
 
-  LumiSectionAccounts::iterator pos = lumiSectionAccounts_.find(lumiSection);
+  lumiSectionAccounts_.clear();
+  eventsInLumiSection_.clear();
+  eventsCompletedInLumiSection_.clear();
+  nextLumiSection_ = 0;
+}
+
 
-  if ( pos == lumiSectionAccounts_.end() )
+void evb::bu::ResourceManager::updateLumiSectionAccounts()
+{
+  // add accounts for newly opened lumi sections
+  const uint32_t nextLumiSection = nextLumiSection_;
+  uint32_t ls = lumiSectionAccounts_.empty() ? eventsInLumiSection_.getOldestOpen() : lumiSectionAccounts_.rbegin()->first + 1;
+  for ( ; ls < nextLumiSection; ++ls )
   {
-    std::ostringstream msg;
-    msg << "Completed an event from an unknown lumi section " << lumiSection;
-    XCEPT_RAISE(exception::EventOrder, msg.str());
+    if ( eventsInLumiSection_.isOpen(ls) )
+    {
+      LumiSectionAccountPtr lumiAccount( new LumiSectionAccount(ls) );
+      lumiAccount->startTime = lumiSectionStartTimes_[ls % lumiSectionStartTimes_.size()];
+      lumiSectionAccounts_.insert(lumiSectionAccounts_.end(),LumiSectionAccounts::value_type(ls,lumiAccount));
+    }
   }
 
-  --(pos->second->nbIncompleteEvents);
+  for ( LumiSectionAccounts::const_iterator it = lumiSectionAccounts_.begin(), itEnd = lumiSectionAccounts_.end();
+        it != itEnd; ++it)
+  {
+    // read the completed events first, as they can never exceed the events counted afterwards
+    const uint32_t nbCompletedEvents = eventsCompletedInLumiSection_.getCount(it->first);
+    it->second->nbEvents = eventsInLumiSection_.getCount(it->first);
+    it->second->nbIncompleteEvents = it->second->nbEvents - nbCompletedEvents;
+  }
+}
+
+
+bool evb::bu::ResourceManager::closeLumiSection(const LumiSectionAccountPtr& lumiSectionAccount)
+{
+  // an event might have been counted since the account was updated
+  return eventsInLumiSection_.closeIfCountIs(lumiSectionAccount->lumiSection,lumiSectionAccount->nbEvents);
 }
 
 
@@ -250,6 +311,8 @@ bool evb::bu::ResourceManager::getNextLumiSectionAccount
 {
   boost::mutex::scoped_lock sl(lumiSectionAccountsMutex_);
 
+  updateLumiSectionAccounts();
+
   const LumiSectionAccounts::iterator oldestLumiSection = lumiSectionAccounts_.begin();
   bool foundCompleteLS = false;
 
@@ -259,6 +322,7 @@ bool evb::bu::ResourceManager::getNextLumiSectionAccount
   {
     lumiSectionAccount = oldestLumiSection->second;
     lumiSectionAccounts_.erase(oldestLumiSection);
+    eventsInLumiSection_.close(lumiSectionAccount->lumiSection);
     return true;
   }
 
@@ -282,18 +346,20 @@ bool evb::bu::ResourceManager::getNextLumiSectionAccount
 
   if ( oldestLumiSection->second->nbIncompleteEvents == 0 )
   {
-    if ( lumiSectionAccounts_.size() > 1 ) // there are newer lumi sections
+    if ( lumiSectionAccounts_.size() > 1 && // there are newer lumi sections
+         closeLumiSection(oldestLumiSection->second) )
     {
       lumiSectionAccount = oldestLumiSection->second;
       lumiSectionAccounts_.erase(oldestLumiSection);
       foundCompleteLS = true;
     }
-    else // check if the current lumi section timed out
+    else if ( lumiSectionAccounts_.size() == 1 ) // check if the current lumi section timed out
     {
       uint32_t lumiSection = oldestLumiSection->second->lumiSection;
       const time_t now = time(0);
       const uint32_t lumiDuration = now>oldestLumiSection->second->startTime ? now-oldestLumiSection->second->startTime : 0;
-      if ( lumiSection > 0 && lumiSectionTimeout_ > 0 && lumiDuration > lumiSectionTimeout_ )
+      if ( lumiSection > 0 && lumiSectionTimeout_ > 0 && lumiDuration > lumiSectionTimeout_ &&
+           closeLumiSection(oldestLumiSection->second) )
       {
         std::ostringstream msg;
         msg.setf(std::ios::fixed);
@@ -320,9 +386,13 @@ bool evb::bu::ResourceManager::getNextLumiSectionAccount
 }
 
 
-void evb::bu::ResourceManager::eventCompleted(const EventPtr& event)
+void evb::bu::ResourceManager::eventCompleted(const EventPtr& event, const uint16_t builderId)
 {
-  eventCompletedForLumiSection(event->getEventInfo()->lumiSection());
+  eventCompletedForLumiSection(event->getEventInfo()->lumiSection(),builderId);
+
+  // the pointer is only changed when configuring, i.e. when no events are built
+  if ( rawDataDiskUsage_.get() )
+    rawDataDiskUsage_->bytesWritten( sizeof(EventInfo) + event->getEventInfo()->eventSize() );
 
   boost::mutex::scoped_lock sl(eventMonitoringMutex_);
 
@@ -331,6 +401,14 @@ void evb::bu::ResourceManager::eventCompleted(const EventPtr& event)
   eventMonitoring_.perf.sumOfSquares += eventSize*eventSize;
   ++eventMonitoring_.perf.logicalCount;
   ++eventMonitoring_.nbEventsBuilt;
+  eventMonitoring_.steadyState.eventsDone(1);
+}
+
+
+void evb::bu::ResourceManager::rawDataDeleted(const uint64_t bytes)
+{
+  if ( rawDataDiskUsage_.get() )
+    rawDataDiskUsage_->bytesDeleted(bytes);
 }
 
 
@@ -398,6 +476,7 @@ void evb::bu::ResourceManager::getAllAvailableResources(BUresources& resources)
         boost::mutex::scoped_lock sl(eventMonitoringMutex_);
 
         pos->second.builderId = (++builderId_) % configuration_->numberOfBuilders;
+        pos->second.building = false;
         resources.push_back( BUresource(pos->first,currentPriority_,eventsToDiscard_) );
         eventsToDiscard_ = 0;
         ++eventMonitoring_.outstandingRequests;
@@ -410,6 +489,7 @@ void evb::bu::ResourceManager::getAllAvailableResources(BUresources& resources)
 void evb::bu::ResourceManager::startProcessing()
 {
   resetMonitoringCounters();
+  resetLumiSectionCounters();
   doProcessing_ = true;
   runNumber_ = bu_->getStateMachine()->getRunNumber();
 }
@@ -431,17 +511,19 @@ float evb::bu::ResourceManager::getAvailableResources(std::string& statusMsg, st
 {
   boost::mutex::scoped_lock sl(resourceSummaryMutex_);
 
-  if ( resourceSummary_.empty() ) return nbResources_;
+  if ( ! resourceSummary_.get() ) return nbResources_;
+
+  // only re-read the file if the hltd has written it since the last time
+  const bool modified = resourceSummary_->modified();
 
-  const std::time_t lastWriteTime = boost::filesystem::last_write_time(resourceSummary_);
   if ( configuration_->staleResourceTime > 0U &&
-       (std::time(0) - lastWriteTime) > configuration_->staleResourceTime )
+       (std::time(0) - resourceSummary_->getLastWriteTime()) > configuration_->staleResourceTime )
   {
     std::ostringstream msg;
-    msg << resourceSummary_.string() << " has not been updated in the last ";
+    msg << resourceSummary_->path().string() << " has not been updated in the last ";
     msg << configuration_->staleResourceTime << "s";
     handleResourceSummaryFailure(msg.str());
-    statusMsg = "Blocking requests because " + resourceSummary_.string() + " is stale";
+    statusMsg = "Blocking requests because " + resourceSummary_->path().string() + " is stale";
     statusKeys = "RESOURCE_SUMMARY_STALE";
     return 0;
   }
@@ -449,20 +531,23 @@ float evb::bu::ResourceManager::getAvailableResources(std::string& statusMsg, st
   uint32_t lsLatency = 0;
   try
   {
+    if ( modified )
+      resourceSummary_->read();
+
+    const ResourceSummary::Values& values = resourceSummary_->getValues();
+
     boost::mutex::scoped_lock sl(lsLatencyMutex_);
 
-    boost::property_tree::ptree pt;
-    boost::property_tree::read_json(resourceSummary_.string(), pt);
-    fusHLT_ = pt.get<int>("active_resources");
-    fusCloud_ = pt.get<int>("cloud");
-    fusQuarantined_ = pt.get<int>("quarantined");
-    fusStale_ = pt.get<int>("stale_resources");
-    fuOutBwMB_ = pt.get<double>("activeRunLSBWMB");
-    queuedLSonFUs_ = pt.get<int>("activeRunNumQueuedLS");
-    pauseRequested_ = pt.get<bool>("bu_stop_requests_flag");
-
-    const uint32_t activeFURun = pt.get<int>("activeFURun");
-    const uint32_t activeRunCMSSWMaxLS = std::max(0,pt.get<int>("activeRunCMSSWMaxLS"));
+    fusHLT_ = values.activeResources;
+    fusCloud_ = values.cloud;
+    fusQuarantined_ = values.quarantined;
+    fusStale_ = values.staleResources;
+    fuOutBwMB_ = values.activeRunLSBWMB;
+    queuedLSonFUs_ = values.activeRunNumQueuedLS;
+    pauseRequested_ = values.stopRequests;
+
+    const uint32_t activeFURun = values.activeFURun;
+    const uint32_t activeRunCMSSWMaxLS = std::max(0,values.activeRunCMSSWMaxLS);
     if ( activeFURun == runNumber_ && activeRunCMSSWMaxLS > 0 )
     {
       if ( oldestIncompleteLumiSection_ >= activeRunCMSSWMaxLS )
@@ -475,13 +560,13 @@ float evb::bu::ResourceManager::getAvailableResources(std::string& statusMsg, st
         lsLatency = 0;
     }
   }
-  catch(boost::property_tree::ptree_error& e)
+  catch(exception::FFF& e)
   {
     std::ostringstream msg;
-    msg << "Failed to parse " << resourceSummary_.string() << ": ";
-    msg << e.what();
+    msg << "Failed to parse " << resourceSummary_->path().string() << ": ";
+    msg << e.message();
     handleResourceSummaryFailure(msg.str());
-    statusMsg = "Blocking requests because " + resourceSummary_.string() + " cannot be parsed";
+    statusMsg = "Blocking requests because " + resourceSummary_->path().string() + " cannot be parsed";
     statusKeys = "RESOURCE_SUMMARY_FAILURE";
     return 0;
   }
@@ -651,6 +736,7 @@ void evb::bu::ResourceManager::updateDiskUsages()
       {
         ramDiskSizeInGB_ = (*it)->diskSizeGB();
         ramDiskUsed_ = (*it)->relDiskUsage();
+        ramDiskTimeToFull_ = (*it)->timeToFull();
         break;
       }
       ++pathIter;
@@ -743,12 +829,29 @@ bool evb::bu::ResourceManager::resourceMonitor(toolbox::task::WorkLoop*)
     bu_->getStateMachine()->processFSMEvent( Fail(sentinelException) );
   }
 
-  ::sleep(1);
+  waitForResourceSummaryUpdate();
 
   return true;
 }
 
 
+void evb::bu::ResourceManager::waitForResourceSummaryUpdate()
+{
+  ResourceSummaryPtr resourceSummary;
+  {
+    boost::mutex::scoped_lock sl(resourceSummaryMutex_);
+    resourceSummary = resourceSummary_;
+  }
+
+  // react to changes of the FU resources as soon as the hltd writes the summary,
+  // but re-evaluate the disk usage and lumi-section latency at least once per second
+  if ( resourceSummary.get() )
+    resourceSummary->waitForUpdate(1000);
+  else
+    ::sleep(1);
+}
+
+
 void evb::bu::ResourceManager::updateResources(const float availableResources, std::string& statusMsg, std::string& statusKeys)
 {
   uint32_t resourcesToBlock;
@@ -781,6 +884,8 @@ void evb::bu::ResourceManager::updateResources(const float availableResources, s
       msg.precision(0);
       msg << " RAMdisk is " << overThreshold*100 << "% over the safe disk-usage threshold of ";
       msg << configuration_->rawDataLowWaterMark*100 << "%";
+      if ( configuration_->diskUsagePredictionHorizon > 0U )
+        msg << " including the data expected within the next " << configuration_->diskUsagePredictionHorizon << "s";
       statusMsg += msg.str();
       statusKeys += "RAMDISK_USAGE_HIGH";
     }
@@ -846,10 +951,10 @@ void evb::bu::ResourceManager::changeStatesBasedOnResources()
   }
 
 
-  if ( allFUsStale )
-    ++allFUsStaleDetected_;
-  else
-    allFUsStaleDetected_ = 0;
+  if ( ! allFUsStale )
+    allFUsStaleSince_ = 0;
+  else if ( allFUsStaleSince_ == 0 )
+    allFUsStaleSince_ = std::time(0);
 
   uint32_t outstandingRequests;
   {
@@ -865,11 +970,12 @@ void evb::bu::ResourceManager::changeStatesBasedOnResources()
   {
     XCEPT_RAISE(exception::FFF, "All FU cores in the appliance are quarantined, i.e. HLT is failing on all of them.");
   }
-  else if ( allFUsStaleDetected_ >= configuration_->maxTriesFUsStale )
+  else if ( allFUsStaleSince_ > 0 &&
+            static_cast<uint32_t>(std::time(0) - allFUsStaleSince_) >= configuration_->maxTriesFUsStale )
   {
     std::ostringstream msg;
     msg << "All FUs in the appliance are reporting a stale file handle since more than ";
-    msg << allFUsStaleDetected_ << " seconds";
+    msg << (std::time(0) - allFUsStaleSince_) << " seconds";
     XCEPT_RAISE(exception::FFF, msg.str());
   }
   else if ( blockedResources_ == 0U || outstandingRequests > configuration_->numberOfBuilders )
@@ -898,6 +1004,7 @@ void evb::bu::ResourceManager::appendMonitoringItems(InfoSpaceItems& items)
   nbEventsInBU_ = 0;
   nbEventsBuilt_ = 0;
   eventRate_ = 0;
+  timeToSteadyState_ = -1;
   throughput_ = 0;
   eventSize_ = 0;
   eventSizeStdDev_ = 0;
@@ -914,14 +1021,17 @@ void evb::bu::ResourceManager::appendMonitoringItems(InfoSpaceItems& items)
   fuOutputBandwidthInMB_ = 0;
   queuedLumiSections_ = 0;
   queuedLumiSectionsOnFUs_ = -1;
+  resourceSummaryLatency_ = 0;
   ramDiskSizeInGB_ = 0;
   ramDiskUsed_ = 0;
+  ramDiskTimeToFull_ = -1;
   statusMsg_ = "";
   statusKeywords_ = "";
 
   items.add("nbEventsInBU", &nbEventsInBU_);
   items.add("nbEventsBuilt", &nbEventsBuilt_);
   items.add("eventRate", &eventRate_);
+  items.add("timeToSteadyState", &timeToSteadyState_);
   items.add("throughput", &throughput_);
   items.add("eventSize", &eventSize_);
   items.add("eventSizeStdDev", &eventSizeStdDev_);
@@ -938,8 +1048,10 @@ void evb::bu::ResourceManager::appendMonitoringItems(InfoSpaceItems& items)
   items.add("fuOutputBandwidthInMB", &fuOutputBandwidthInMB_);
   items.add("queuedLumiSections", &queuedLumiSections_);
   items.add("queuedLumiSectionsOnFUs", &queuedLumiSectionsOnFUs_);
+  items.add("resourceSummaryLatency", &resourceSummaryLatency_);
   items.add("ramDiskSizeInGB", &ramDiskSizeInGB_);
   items.add("ramDiskUsed", &ramDiskUsed_);
+  items.add("ramDiskTimeToFull", &ramDiskTimeToFull_);
   items.add("statusMsg", &statusMsg_);
   items.add("statusKeywords", &statusKeywords_);
 }
@@ -960,6 +1072,10 @@ void evb::bu::ResourceManager::updateMonitoringItems()
     queuedLumiSections_ = queuedLS_;
     queuedLumiSectionsOnFUs_ = queuedLSonFUs_;
   }
+  {
+    boost::mutex::scoped_lock sl(resourceSummaryMutex_);
+    resourceSummaryLatency_ = resourceSummary_.get() ? resourceSummary_->getLatency() : 0;
+  }
   {
     boost::mutex::scoped_lock sl(eventMonitoringMutex_);
 
@@ -967,6 +1083,7 @@ void evb::bu::ResourceManager::updateMonitoringItems()
     nbEventsInBU_ = eventMonitoring_.nbEventsInBU;
     nbEventsBuilt_ = eventMonitoring_.nbEventsBuilt;
     eventRate_ = eventMonitoring_.perf.logicalRate(deltaT);
+    timeToSteadyState_ = eventMonitoring_.steadyState.getTimeToSteadyState();
     throughput_ = eventMonitoring_.perf.throughput(deltaT);
     if ( eventRate_ > 0U )
     {
@@ -1026,6 +1143,7 @@ void evb::bu::ResourceManager::resetMonitoringCounters()
     eventMonitoring_.eventSize = 0;
     eventMonitoring_.eventSizeStdDev = 0;
     eventMonitoring_.perf.reset();
+    eventMonitoring_.steadyState.start();
   }
 }
 
@@ -1070,7 +1188,9 @@ uint64_t evb::bu::ResourceManager::getNbEventsBuilt() const
 void evb::bu::ResourceManager::configure()
 {
   resourceFIFO_.clear();
-  lumiSectionAccounts_.clear();
+  eventsCompletedInLumiSection_.resize(eventsInLumiSection_.getWindow(),configuration_->numberOfBuilders);
+  lumiSectionStartTimes_.assign(eventsInLumiSection_.getWindow(),0);
+  resetLumiSectionCounters();
 
   eventsToDiscard_ = 0;
   eventMonitoring_.outstandingRequests = 0;
@@ -1101,6 +1221,7 @@ void evb::bu::ResourceManager::configureResources()
   {
     ResourceInfo resourceInfo;
     resourceInfo.builderId = -1;
+    resourceInfo.building = false;
     resourceInfo.blocked = !configuration_->dropEventData;
     std::pair<BuilderResources::iterator,bool> result =
       builderResources_.insert(BuilderResources::value_type(resourceId,resourceInfo));
@@ -1119,7 +1240,7 @@ void evb::bu::ResourceManager::configureResourceSummary()
 {
   boost::mutex::scoped_lock sl(resourceSummaryMutex_);
 
-  resourceSummary_.clear();
+  resourceSummary_.reset();
   resourceSummaryFailureAlreadyNotified_ = false;
   resourceLimitiationAlreadyNotified_ = false;
 
@@ -1127,14 +1248,15 @@ void evb::bu::ResourceManager::configureResourceSummary()
 
   if ( !configuration_->ignoreResourceSummary && !configuration_->deleteRawDataFiles )
   {
-    resourceSummary_ = boost::filesystem::path(configuration_->rawDataDir.value_) / configuration_->resourceSummaryFileName.value_;
-    if ( !boost::filesystem::exists(resourceSummary_) )
+    const boost::filesystem::path resourceSummary =
+      boost::filesystem::path(configuration_->rawDataDir.value_) / configuration_->resourceSummaryFileName.value_;
+    if ( !boost::filesystem::exists(resourceSummary) )
     {
       std::ostringstream msg;
-      msg << "Resource summary file " << resourceSummary_ << " does not exist";
-      resourceSummary_.clear();
+      msg << "Resource summary file " << resourceSummary << " does not exist";
       XCEPT_RAISE(exception::DiskWriting, msg.str());
     }
+    resourceSummary_.reset( new ResourceSummary(resourceSummary) );
   }
 }
 
@@ -1144,13 +1266,16 @@ void evb::bu::ResourceManager::configureDiskUsageMonitors()
   boost::mutex::scoped_lock sl(diskUsageMonitorsMutex_);
 
   diskUsageMonitors_.clear();
+  rawDataDiskUsage_.reset();
 
   if ( configuration_->dropEventData ) return;
 
   DiskUsagePtr rawDiskUsage(
-    new DiskUsage(configuration_->rawDataDir.value_,configuration_->rawDataLowWaterMark,configuration_->rawDataHighWaterMark)
+    new DiskUsage(configuration_->rawDataDir.value_,configuration_->rawDataLowWaterMark,configuration_->rawDataHighWaterMark,
+                  configuration_->diskUsagePredictionHorizon)
   );
   diskUsageMonitors_.push_back(rawDiskUsage);
+  rawDataDiskUsage_ = rawDiskUsage;
 
   if ( configuration_->metaDataDir != configuration_->rawDataDir )
   {
@@ -1193,6 +1318,9 @@ cgicc::div evb::bu::ResourceManager::getHtmlSnipped() const
     table.add(tr()
               .add(td("rate (events/s)"))
               .add(td(boost::lexical_cast<std::string>(eventRate_))));
+    table.add(tr()
+              .add(td("time to steady state (ms)"))
+              .add(td(timeToSteadyState_.value_ < 0 ? "n/a" : boost::lexical_cast<std::string>(timeToSteadyState_))));
     {
       std::ostringstream str;
       str.setf(std::ios::fixed);
@@ -1238,6 +1366,16 @@ cgicc::div evb::bu::ResourceManager::getHtmlSnipped() const
                 .add(td("# blocked resources"))
                 .add(td(boost::lexical_cast<std::string>(blockedResources_)+"/"+boost::lexical_cast<std::string>(nbResources_))));
     }
+    {
+      boost::mutex::scoped_lock sl(resourceSummaryMutex_);
+
+      if ( resourceSummary_.get() )
+      {
+        table.add(tr()
+                  .add(td("resource summary latency (ms)"))
+                  .add(td(doubleToString(resourceSummary_->getLatency(),1))));
+      }
+    }
     {
       boost::mutex::scoped_lock sl(diskUsageMonitorsMutex_);
 
@@ -1253,6 +1391,9 @@ cgicc::div evb::bu::ResourceManager::getHtmlSnipped() const
           str.setf(std::ios::fixed);
           str.precision(1);
           str << (*it)->relDiskUsage()*100 << "% of " << (*it)->diskSizeGB() << " GB";
+          const float timeToFull = (*it)->timeToFull();
+          if ( timeToFull >= 0 )
+            str << " (full in " << timeToFull << "s)";
           table.add(tr()
                     .add(td((*it)->path().string()))
                     .add(td(str.str())));
@@ -0,0 +1,299 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "evb/bu/ResourceSummary.h"
+#include "evb/Exception.h"
+
+
+namespace {
+
+  // The keys needed by the BU. Any other key in the file is ignored.
+  enum Key
+  {
+    ACTIVE_RESOURCES,
+    CLOUD,
+    QUARANTINED,
+    STALE_RESOURCES,
+    ACTIVE_RUN_NUM_QUEUED_LS,
+    ACTIVE_FU_RUN,
+    ACTIVE_RUN_CMSSW_MAX_LS,
+    ACTIVE_RUN_LS_BW_MB,
+    BU_STOP_REQUESTS_FLAG,
+    NB_KEYS
+  };
+
+  const char* keyNames[NB_KEYS] =
+  {
+    "active_resources",
+    "cloud",
+    "quarantined",
+    "stale_resources",
+    "activeRunNumQueuedLS",
+    "activeFURun",
+    "activeRunCMSSWMaxLS",
+    "activeRunLSBWMB",
+    "bu_stop_requests_flag"
+  };
+
+  bool isSpace(const char c)
+  {
+    return ( c == ' ' || c == '\t' || c == '\n' || c == '\r' );
+  }
+
+  double deltaInMs(const struct timespec& start, const struct timespec& end)
+  {
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+  }
+
+}
+
+
+evb::bu::ResourceSummary::ResourceSummary(const boost::filesystem::path& path) :
+  path_(path),
+  fileName_(boost::filesystem::path(path.filename()).string()),
+  inotifyFD_(-1),
+  written_(true),
+  valid_(false),
+  latency_(0)
+{
+  lastWriteTime_.tv_sec = 0;
+  lastWriteTime_.tv_nsec = 0;
+  lastReadWriteTime_ = lastWriteTime_;
+  memset(&values_, 0, sizeof(values_));
+  values_.activeRunNumQueuedLS = -1;
+
+  // The hltd either rewrites the file in place or moves a new file over it.
+  // Watching the directory catches both. If inotify is not available,
+  // e.g. on some network file systems, modified() falls back to the modification time.
+  inotifyFD_ = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+  if ( inotifyFD_ != -1 &&
+       inotify_add_watch(inotifyFD_, path_.parent_path().string().c_str(), IN_CLOSE_WRITE|IN_MOVED_TO) == -1 )
+  {
+    ::close(inotifyFD_);
+    inotifyFD_ = -1;
+  }
+}
+
+
+evb::bu::ResourceSummary::~ResourceSummary()
+{
+  if ( inotifyFD_ != -1 )
+    ::close(inotifyFD_);
+}
+
+
+bool evb::bu::ResourceSummary::waitForUpdate(const uint32_t timeoutMs)
+{
+  if ( written_ ) return true;
+
+  if ( inotifyFD_ == -1 )
+  {
+    ::usleep(timeoutMs*1000);
+    return false;
+  }
+
+  struct pollfd pfd;
+  pfd.fd = inotifyFD_;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+
+  if ( ::poll(&pfd, 1, timeoutMs) > 0 )
+    drainEvents();
+
+  return written_;
+}
+
+
+void evb::bu::ResourceSummary::drainEvents()
+{
+  char buffer[sizeof(struct inotify_event) + NAME_MAX + 1] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+  ssize_t length;
+  while ( (length = ::read(inotifyFD_, buffer, sizeof(buffer))) > 0 )
+  {
+    for ( const char* pos = buffer; pos < buffer + length; )
+    {
+      const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(pos);
+      if ( event->len > 0 && fileName_ == event->name )
+        written_ = true;
+      pos += sizeof(struct inotify_event) + event->len;
+    }
+  }
+}
+
+
+bool evb::bu::ResourceSummary::modified()
+{
+  struct stat fileStat;
+  if ( ::stat(path_.string().c_str(), &fileStat) != 0 )
+  {
+    std::ostringstream msg;
+    msg << "Cannot access the resource summary " << path_.string() << ": " << strerror(errno);
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+  lastWriteTime_ = fileStat.st_mtim;
+
+  if ( lastWriteTime_.tv_sec != lastReadWriteTime_.tv_sec ||
+       lastWriteTime_.tv_nsec != lastReadWriteTime_.tv_nsec )
+    written_ = true;
+
+  return ( written_ || ! valid_ );
+}
+
+
+void evb::bu::ResourceSummary::read()
+{
+  written_ = false;
+  valid_ = false;
+  lastReadWriteTime_ = lastWriteTime_;
+
+  const int fileDescriptor = ::open(path_.string().c_str(), O_RDONLY);
+  if ( fileDescriptor == -1 )
+  {
+    std::ostringstream msg;
+    msg << "Failed to open " << path_.string() << ": " << strerror(errno);
+    XCEPT_RAISE(exception::FFF, msg.str());
+  }
+
+  // the file is small, thus the buffer is only resized for the first read
+  if ( buffer_.size() < 4096 ) buffer_.resize(4096);
+  size_t size = 0;
+  ssize_t bytesRead;
+  while ( (bytesRead = ::read(fileDescriptor, &buffer_[size], buffer_.size() - size)) > 0 )
+  {
+    size += bytesRead;
+    if ( size == buffer_.size() ) buffer_.resize(2*size);
+  }
+  ::close(fileDescriptor);
+
+  if ( bytesRead < 0 )
+  {
+    std::ostringstream msg;
+    msg << "Failed to read " << path_.string() << ": " << strerror(errno);
+    XCEPT_RAISE(exception::FFF, msg.str());
+  }
+
+  Values values;
+  parse(&buffer_[0], size, values);
+  values_ = values;
+  valid_ = true;
+
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  latency_ = deltaInMs(lastWriteTime_, now);
+}
+
+
+void evb::bu::ResourceSummary::parse(const char* json, const size_t size, Values& values)
+{
+  const char* pos = json;
+  const char* const end = json + size;
+  uint32_t foundKeys = 0;
+
+  while ( pos < end )
+  {
+    if ( *pos++ != '"' ) continue;
+
+    // a key or a string value
+    const char* name = pos;
+    while ( pos < end && *pos != '"' )
+    {
+      if ( *pos == '\\' ) ++pos;
+      ++pos;
+    }
+    if ( pos >= end ) break;
+    const size_t nameLength = pos - name;
+    ++pos;
+
+    while ( pos < end && isSpace(*pos) ) ++pos;
+    if ( pos >= end || *pos != ':' ) continue;
+    ++pos;
+    while ( pos < end && isSpace(*pos) ) ++pos;
+
+    uint16_t key = 0;
+    while ( key < NB_KEYS &&
+            ( strlen(keyNames[key]) != nameLength || strncmp(keyNames[key], name, nameLength) != 0 ) ) ++key;
+    if ( key == NB_KEYS ) continue;
+
+    // copy the value, which might be quoted, to terminate it for the conversion
+    char value[32];
+    size_t valueLength = 0;
+    const bool quoted = ( pos < end && *pos == '"' );
+    if ( quoted ) ++pos;
+    while ( pos < end && *pos != ',' && *pos != '}' && *pos != '"' && ! isSpace(*pos) &&
+            valueLength < sizeof(value) - 1 )
+      value[valueLength++] = *pos++;
+    value[valueLength] = '\0';
+    if ( quoted && pos < end && *pos == '"' ) ++pos;
+
+    char* valueEnd = value;
+    bool valid = ( valueLength > 0 );
+    switch ( key )
+    {
+      case ACTIVE_RUN_LS_BW_MB:
+        values.activeRunLSBWMB = strtod(value, &valueEnd);
+        break;
+
+      case BU_STOP_REQUESTS_FLAG:
+        if ( strcmp(value,"true") == 0 || strcmp(value,"1") == 0 )
+          values.stopRequests = true;
+        else if ( strcmp(value,"false") == 0 || strcmp(value,"0") == 0 )
+          values.stopRequests = false;
+        else
+          valid = false;
+        valueEnd = value + valueLength;
+        break;
+
+      default:
+      {
+        const long number = strtol(value, &valueEnd, 10);
+        switch ( key )
+        {
+          case ACTIVE_RESOURCES:         values.activeResources = number; break;
+          case CLOUD:                    values.cloud = number; break;
+          case QUARANTINED:              values.quarantined = number; break;
+          case STALE_RESOURCES:          values.staleResources = number; break;
+          case ACTIVE_RUN_NUM_QUEUED_LS: values.activeRunNumQueuedLS = number; break;
+          case ACTIVE_FU_RUN:            values.activeFURun = number; break;
+          case ACTIVE_RUN_CMSSW_MAX_LS:  values.activeRunCMSSWMaxLS = number; break;
+        }
+      }
+    }
+
+    if ( ! valid || *valueEnd != '\0' )
+    {
+      std::ostringstream msg;
+      msg << "conversion of data to type failed for key " << keyNames[key] << ": '" << value << "'";
+      XCEPT_RAISE(exception::FFF, msg.str());
+    }
+    foundKeys |= (1 << key);
+  }
+
+  if ( foundKeys != (1U << NB_KEYS) - 1 )
+  {
+    std::ostringstream msg;
+    msg << "No such node:";
+    for ( uint16_t key = 0; key < NB_KEYS; ++key )
+    {
+      if ( ! (foundKeys & (1 << key)) )
+        msg << " " << keyNames[key];
+    }
+    XCEPT_RAISE(exception::FFF, msg.str());
+  }
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
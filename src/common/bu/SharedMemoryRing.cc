@@ -0,0 +1,278 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <sstream>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "evb/bu/SharedMemoryRing.h"
+#include "evb/Exception.h"
+
+
+evb::bu::SharedMemoryRing::SharedMemoryRing
+(
+  const std::string& name,
+  const uint32_t nbSlots,
+  const uint32_t slotSize
+) :
+  name_(name),
+  ringSize_(0),
+  ring_(0),
+  header_(0),
+  slotStride_(sharedmemory::slotStride(slotSize)),
+  aborted_(false)
+{
+  if ( nbSlots == 0 || slotSize < sizeof(EventInfo) )
+  {
+    std::ostringstream msg;
+    msg << "Invalid shared-memory ring " << name_ << " with " << nbSlots;
+    msg << " slots of " << slotSize << " Bytes";
+    XCEPT_RAISE(exception::Configuration, msg.str());
+  }
+
+  ringSize_ = sharedmemory::headerSize + nbSlots * slotStride_;
+
+  // remove any left-over ring from a previous run
+  shm_unlink(name_.c_str());
+
+  const int fd = shm_open(name_.c_str(), O_RDWR|O_CREAT|O_EXCL, S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH|S_IWOTH);
+  if ( fd == -1 )
+  {
+    std::ostringstream msg;
+    msg << "Failed to create the shared-memory ring " << name_ << ": " << strerror(errno);
+    XCEPT_RAISE(exception::OutOfMemory, msg.str());
+  }
+
+  if ( ftruncate(fd, ringSize_) != 0 )
+  {
+    std::ostringstream msg;
+    msg << "Failed to resize the shared-memory ring " << name_ << " to " << ringSize_ << " Bytes: " << strerror(errno);
+    ::close(fd);
+    shm_unlink(name_.c_str());
+    XCEPT_RAISE(exception::OutOfMemory, msg.str());
+  }
+
+  void* ring = mmap(0, ringSize_, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, 0);
+  ::close(fd);
+  if ( ring == MAP_FAILED )
+  {
+    std::ostringstream msg;
+    msg << "Failed to map the shared-memory ring " << name_ << ": " << strerror(errno);
+    shm_unlink(name_.c_str());
+    XCEPT_RAISE(exception::OutOfMemory, msg.str());
+  }
+
+  ring_ = static_cast<unsigned char*>(ring);
+  memset(ring_, 0, ringSize_);
+
+  header_ = reinterpret_cast<sharedmemory::RingHeader*>(ring_);
+  header_->version = sharedmemory::ringVersion;
+  header_->nbSlots = nbSlots;
+  header_->slotSize = slotSize;
+}
+
+
+void evb::bu::SharedMemoryRing::open(const uint32_t runNumber)
+{
+  header_->runNumber = runNumber;
+
+  // consumers only accept the ring once the magic is set
+  __sync_synchronize();
+  header_->magic = sharedmemory::ringMagic;
+}
+
+
+evb::bu::SharedMemoryRing::~SharedMemoryRing()
+{
+  close();
+  munmap(ring_, ringSize_);
+  shm_unlink(name_.c_str());
+}
+
+
+bool evb::bu::SharedMemoryRing::publish(const EventInfo& eventInfo, const DataLocations& locs)
+{
+  const uint32_t size = sizeof(EventInfo) + eventInfo.eventSize();
+  if ( size > header_->slotSize )
+  {
+    std::ostringstream msg;
+    msg << "Event " << eventInfo.eventNumber() << " of " << size << " Bytes";
+    msg << " does not fit into the slots of " << header_->slotSize << " Bytes";
+    msg << " of the shared-memory ring " << name_;
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+
+  const uint64_t sequence = header_->writeIndex;
+  sharedmemory::SlotHeader* slot = reinterpret_cast<sharedmemory::SlotHeader*>(
+    ring_ + sharedmemory::headerSize + (sequence % header_->nbSlots) * slotStride_ );
+
+  // wait for the consumers to acknowledge the previous event in this slot
+  while ( slot->state != sharedmemory::FREE )
+  {
+    if ( aborted_ ) return false;
+    ::usleep(100);
+  }
+  __sync_synchronize();
+
+  unsigned char* pos = reinterpret_cast<unsigned char*>(slot + 1);
+  memcpy(pos, &eventInfo, sizeof(EventInfo));
+  pos += sizeof(EventInfo);
+  for ( DataLocations::const_iterator it = locs.begin(), itEnd = locs.end();
+        it != itEnd; ++it )
+  {
+    memcpy(pos, it->iov_base, it->iov_len);
+    pos += it->iov_len;
+  }
+  slot->size = size;
+  slot->sequence = sequence;
+
+  // make the data visible before publishing the slot
+  __sync_synchronize();
+  slot->state = sharedmemory::PUBLISHED;
+  __sync_synchronize();
+  header_->writeIndex = sequence + 1;
+
+  return true;
+}
+
+
+void evb::bu::SharedMemoryRing::close()
+{
+  __sync_synchronize();
+  header_->closed = 1;
+}
+
+
+void evb::bu::SharedMemoryRing::abort()
+{
+  aborted_ = true;
+}
+
+
+uint32_t evb::bu::SharedMemoryRing::getOccupancy() const
+{
+  uint32_t occupancy = 0;
+  for ( uint32_t i = 0; i < header_->nbSlots; ++i )
+  {
+    const sharedmemory::SlotHeader* slot = reinterpret_cast<const sharedmemory::SlotHeader*>(
+      ring_ + sharedmemory::headerSize + i * slotStride_ );
+    if ( slot->state != sharedmemory::FREE ) ++occupancy;
+  }
+  return occupancy;
+}
+
+
+evb::bu::SharedMemoryReader::SharedMemoryReader(const std::string& name) :
+  name_(name),
+  ringSize_(0),
+  ring_(0),
+  header_(0),
+  slotStride_(0)
+{
+  const int fd = shm_open(name_.c_str(), O_RDWR, 0);
+  if ( fd == -1 )
+  {
+    std::ostringstream msg;
+    msg << "Failed to open the shared-memory ring " << name_ << ": " << strerror(errno);
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+
+  struct stat fileStat;
+  if ( fstat(fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < sharedmemory::headerSize )
+  {
+    ::close(fd);
+    XCEPT_RAISE(exception::DataCorruption, "The shared-memory ring " + name_ + " is too small");
+  }
+  ringSize_ = fileStat.st_size;
+
+  void* ring = mmap(0, ringSize_, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if ( ring == MAP_FAILED )
+  {
+    std::ostringstream msg;
+    msg << "Failed to map the shared-memory ring " << name_ << ": " << strerror(errno);
+    XCEPT_RAISE(exception::DiskWriting, msg.str());
+  }
+
+  ring_ = static_cast<unsigned char*>(ring);
+  header_ = reinterpret_cast<sharedmemory::RingHeader*>(ring_);
+  __sync_synchronize();
+
+  if ( header_->magic != sharedmemory::ringMagic || header_->version != sharedmemory::ringVersion )
+  {
+    munmap(ring_, ringSize_);
+    XCEPT_RAISE(exception::DataCorruption, "The shared-memory ring " + name_ + " is not ready or has an unknown format");
+  }
+  slotStride_ = sharedmemory::slotStride(header_->slotSize);
+}
+
+
+evb::bu::SharedMemoryReader::~SharedMemoryReader()
+{
+  munmap(ring_, ringSize_);
+}
+
+
+bool evb::bu::SharedMemoryReader::claim
+(
+  uint64_t& sequence,
+  const EventInfo*& eventInfo,
+  const unsigned char*& data
+)
+{
+  uint64_t readIndex = header_->readIndex;
+
+  do {
+    if ( readIndex >= header_->writeIndex ) return false;
+    sequence = readIndex;
+    readIndex = __sync_val_compare_and_swap(&header_->readIndex, sequence, sequence + 1);
+  } while ( readIndex != sequence );
+
+  sharedmemory::SlotHeader* slot = getSlot(sequence);
+  __sync_synchronize();
+
+  if ( slot->state != sharedmemory::PUBLISHED || slot->sequence != sequence )
+  {
+    std::ostringstream msg;
+    msg << "Slot for event sequence " << sequence << " in the shared-memory ring " << name_;
+    msg << " has not been published";
+    XCEPT_RAISE(exception::EventOrder, msg.str());
+  }
+  slot->state = sharedmemory::CLAIMED;
+
+  eventInfo = reinterpret_cast<const EventInfo*>(slot + 1);
+  data = reinterpret_cast<const unsigned char*>(slot + 1) + sizeof(EventInfo);
+
+  return true;
+}
+
+
+void evb::bu::SharedMemoryReader::acknowledge(const uint64_t sequence)
+{
+  sharedmemory::SlotHeader* slot = getSlot(sequence);
+  __sync_synchronize();
+  slot->state = sharedmemory::FREE;
+}
+
+
+bool evb::bu::SharedMemoryReader::isDone() const
+{
+  __sync_synchronize();
+  return ( header_->closed && header_->readIndex >= header_->writeIndex );
+}
+
+
+evb::bu::sharedmemory::SlotHeader* evb::bu::SharedMemoryReader::getSlot(const uint64_t sequence) const
+{
+  return reinterpret_cast<sharedmemory::SlotHeader*>(
+    ring_ + sharedmemory::headerSize + (sequence % header_->nbSlots) * slotStride_ );
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
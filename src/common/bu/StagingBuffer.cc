@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <errno.h>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "evb/bu/StagingBuffer.h"
+#include "evb/Exception.h"
+
+
+evb::bu::StagingBuffer::StagingBuffer(const size_t capacity) :
+  used_(0),
+  buffer_(0),
+  hugePages_(false)
+{
+  const size_t hugePageSize = 2*1024*1024;
+  capacity_ = ((std::max(capacity,alignment) + hugePageSize - 1) / hugePageSize) * hugePageSize;
+
+  void* buffer = mmap(0, capacity_, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+  if ( buffer != MAP_FAILED )
+  {
+    hugePages_ = true;
+  }
+  else
+  {
+    // no huge pages available, fall back to normal pages
+    const int err = posix_memalign(&buffer, alignment, capacity_);
+    if ( err != 0 )
+    {
+      std::ostringstream msg;
+      msg << "Failed to allocate a staging buffer of " << capacity_ << " Bytes: " << strerror(err);
+      XCEPT_RAISE(exception::OutOfMemory, msg.str());
+    }
+  }
+
+  buffer_ = static_cast<unsigned char*>(buffer);
+
+  // fault in all pages now instead of while writing the first file
+  memset(buffer_, 0, capacity_);
+}
+
+
+evb::bu::StagingBuffer::~StagingBuffer()
+{
+  if ( hugePages_ )
+    munmap(buffer_, capacity_);
+  else
+    free(buffer_);
+}
+
+
+size_t evb::bu::StagingBuffer::append(const void* data, const size_t size)
+{
+  const size_t bytesToCopy = std::min(size, capacity_ - used_);
+  memcpy(buffer_ + used_, data, bytesToCopy);
+  used_ += bytesToCopy;
+  return bytesToCopy;
+}
+
+
+void evb::bu::StagingBuffer::consume(const size_t size)
+{
+  if ( size >= used_ )
+  {
+    used_ = 0;
+  }
+  else
+  {
+    used_ -= size;
+    memmove(buffer_, buffer_ + size, used_);
+  }
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -8,6 +8,7 @@
 #include "evb/bu/States.h"
 #include "evb/Constants.h"
 #include "evb/Exception.h"
+#include "evb/TimeStamp.h"
 
 #include <boost/thread.hpp>
 #include <boost/bind.hpp>
@@ -49,10 +50,18 @@ void evb::bu::Configuring::activity()
   {
     outermost_context_type& stateMachine = outermost_context();
 
+    MonotonicClock::calibrate();
+    const uint64_t startTime = getMonotonicTimeStamp();
+    uint64_t stepTime = startTime;
     if (doConfiguring_) stateMachine.resourceManager()->configure();
+    stepTime = stateMachine.recordTransitionTime("Configure","ResourceManager",stepTime);
     if (doConfiguring_) stateMachine.ruProxy()->configure();
+    stepTime = stateMachine.recordTransitionTime("Configure","RUproxy",stepTime);
     if (doConfiguring_) stateMachine.eventBuilder()->configure();
+    stepTime = stateMachine.recordTransitionTime("Configure","EventBuilder",stepTime);
     if (doConfiguring_) stateMachine.diskWriter()->configure();
+    stateMachine.recordTransitionTime("Configure","DiskWriter",stepTime);
+    stateMachine.recordTransitionTime("Configure","total",startTime);
 
     if (doConfiguring_) stateMachine.processFSMEvent( ConfigureDone() );
   }
@@ -112,10 +121,17 @@ void evb::bu::Running::entryAction()
   outermost_context_type& stateMachine = outermost_context();
   const uint32_t runNumber = stateMachine.getRunNumber();
 
+  const uint64_t startTime = getMonotonicTimeStamp();
+  uint64_t stepTime = startTime;
   stateMachine.diskWriter()->startProcessing(runNumber);
+  stepTime = stateMachine.recordTransitionTime("Enable","DiskWriter",stepTime);
   stateMachine.resourceManager()->startProcessing();
+  stepTime = stateMachine.recordTransitionTime("Enable","ResourceManager",stepTime);
   stateMachine.eventBuilder()->startProcessing(runNumber);
+  stepTime = stateMachine.recordTransitionTime("Enable","EventBuilder",stepTime);
   stateMachine.ruProxy()->startProcessing();
+  stateMachine.recordTransitionTime("Enable","RUproxy",stepTime);
+  stateMachine.recordTransitionTime("Enable","total",startTime);
 }
 
 
@@ -123,10 +139,17 @@ void evb::bu::Running::exitAction()
 {
   outermost_context_type& stateMachine = outermost_context();
 
+  const uint64_t startTime = getMonotonicTimeStamp();
+  uint64_t stepTime = startTime;
   stateMachine.ruProxy()->stopProcessing();
+  stepTime = stateMachine.recordTransitionTime("Stop","RUproxy",stepTime);
   stateMachine.resourceManager()->stopProcessing();
+  stepTime = stateMachine.recordTransitionTime("Stop","ResourceManager",stepTime);
   stateMachine.eventBuilder()->stopProcessing();
+  stepTime = stateMachine.recordTransitionTime("Stop","EventBuilder",stepTime);
   stateMachine.diskWriter()->stopProcessing();
+  stateMachine.recordTransitionTime("Stop","DiskWriter",stepTime);
+  stateMachine.recordTransitionTime("Stop","total",startTime);
 }
 
 
@@ -147,10 +170,17 @@ void evb::bu::Draining::activity()
   std::string msg = "Failed to drain the components";
   try
   {
+    const uint64_t startTime = getMonotonicTimeStamp();
+    uint64_t stepTime = startTime;
     if (doDraining_) stateMachine.ruProxy()->drain();
+    stepTime = stateMachine.recordTransitionTime("Drain","RUproxy",stepTime);
     if (doDraining_) stateMachine.eventBuilder()->drain();
+    stepTime = stateMachine.recordTransitionTime("Drain","EventBuilder",stepTime);
     if (doDraining_) stateMachine.resourceManager()->drain();
+    stepTime = stateMachine.recordTransitionTime("Drain","ResourceManager",stepTime);
     if (doDraining_) stateMachine.diskWriter()->drain();
+    stateMachine.recordTransitionTime("Drain","DiskWriter",stepTime);
+    stateMachine.recordTransitionTime("Drain","total",startTime);
 
     if (doDraining_) stateMachine.processFSMEvent( DrainingDone() );
   }
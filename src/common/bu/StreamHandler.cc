@@ -8,15 +8,28 @@
 evb::bu::StreamHandler::StreamHandler
 (
   BU* bu,
-  const std::string& streamFileName
+  const std::string& streamFileName,
+  CompressorPtr compressor,
+  SharedMemoryRingPtr sharedMemoryRing
 ) :
   streamFileName_(streamFileName),
   configuration_(bu->getConfiguration()),
   index_(0),
+  compressor_(compressor),
+  sharedMemoryRing_(sharedMemoryRing),
+  publishing_(false),
+  nbWriteCallsClosedFiles_(0),
+  bytesWrittenClosedFiles_(0),
+  directIO_(false),
   currentFileStatistics_(new FileStatistics(0,"")),
   fileStatisticsFIFO_(bu,"fileStatisticsFIFO_"+streamFileName.substr(streamFileName.rfind("/")+1))
 {
   fileStatisticsFIFO_.resize(configuration_->fileStatisticsFIFOCapacity);
+
+  if ( configuration_->useDirectIO && ! configuration_->dropEventData && ! sharedMemoryRing_.get() )
+  {
+    stagingBuffer_.reset( new StagingBuffer(configuration_->stagingBufferSize) );
+  }
 }
 
 
@@ -34,7 +47,7 @@ void evb::bu::StreamHandler::writeEvent(const EventPtr event)
 
   const uint32_t lumiSection = event->getEventInfo()->lumiSection();
 
-  if ( fileHandler_.get() && lumiSection > currentFileStatistics_->lumiSection )
+  if ( isOpen() && lumiSection > currentFileStatistics_->lumiSection )
   {
     do_closeFile();
   }
@@ -47,15 +60,20 @@ void evb::bu::StreamHandler::writeEvent(const EventPtr event)
     XCEPT_RAISE(exception::EventOrder, msg.str());
   }
 
-  if ( ! fileHandler_.get() )
+  if ( ! isOpen() )
+    openFile(lumiSection);
+
+  if ( sharedMemoryRing_.get() )
   {
-    std::ostringstream fileName;
-    fileName << streamFileName_ << "_" << std::hex << static_cast<unsigned int>(++index_);
-    fileHandler_.reset( new FileHandler(fileName.str()) );
-    currentFileStatistics_.reset( new FileStatistics(lumiSection,fileName.str()) );
+    const EventInfoPtr& eventInfo = event->getEventInfo();
+    // the data is copied into the ring: the I2O buffers are released with the event
+    if ( ! sharedMemoryRing_->publish(*eventInfo, event->getDataLocations()) ) return;
+    currentFileStatistics_->fileSize += sizeof(EventInfo) + eventInfo->eventSize();
   }
-
-  fileHandler_->writeEvent(event);
+  else if ( compressor_.get() )
+    addEventToFrame(event);
+  else
+    fileHandler_->writeEvent(event);
   currentFileStatistics_->lastEventNumberWritten = event->getEventInfo()->eventNumber();
 
   if ( ++currentFileStatistics_->nbEventsWritten >= configuration_->maxEventsPerFile )
@@ -65,11 +83,34 @@ void evb::bu::StreamHandler::writeEvent(const EventPtr event)
 }
 
 
+void evb::bu::StreamHandler::openFile(const uint32_t lumiSection)
+{
+  if ( sharedMemoryRing_.get() )
+  {
+    // no file is written: the statistics only serve the lumi-section accounting
+    currentFileStatistics_.reset( new FileStatistics(lumiSection,"") );
+    publishing_ = true;
+    return;
+  }
+
+  std::ostringstream fileName;
+  fileName << streamFileName_ << "_" << std::hex << static_cast<unsigned int>(++index_);
+  fileHandler_.reset( new FileHandler(fileName.str(),
+                                      configuration_->eventsPerWrite,
+                                      configuration_->bytesPerWrite,
+                                      configuration_->writeEventIndex && ! compressor_.get(),
+                                      stagingBuffer_) );
+  directIO_ = fileHandler_->isDirectIO();
+  currentFileStatistics_.reset( new FileStatistics(lumiSection,fileName.str()) );
+  currentFileStatistics_->indexFileName = fileHandler_->getIndexFileName();
+}
+
+
 bool evb::bu::StreamHandler::closeFileIfOpenedBefore(const time_t& time)
 {
   boost::mutex::scoped_lock sl(fileHandlerMutex_);
 
-  if ( fileHandler_.get() && currentFileStatistics_->creationTime < time )
+  if ( isOpen() && currentFileStatistics_->creationTime < time )
   {
     do_closeFile();
     return true;
@@ -79,21 +120,69 @@ bool evb::bu::StreamHandler::closeFileIfOpenedBefore(const time_t& time)
 }
 
 
-void evb::bu::StreamHandler::closeFile()
+void evb::bu::StreamHandler::flushEventsQueuedBefore(const uint64_t& timeStamp)
 {
   boost::mutex::scoped_lock sl(fileHandlerMutex_);
 
   if ( fileHandler_.get() )
+  {
+    if ( compressor_.get() )
+    {
+      if ( currentFrame_.get() && currentFrame_->creationTime() < timeStamp )
+        submitCurrentFrame();
+      writeCompressedFrames(false);
+    }
+    fileHandler_->flushIfQueuedBefore(timeStamp);
+  }
+}
+
+
+void evb::bu::StreamHandler::closeFile()
+{
+  boost::mutex::scoped_lock sl(fileHandlerMutex_);
+
+  if ( isOpen() )
   {
     do_closeFile();
   }
+
+  if ( sharedMemoryRing_.get() )
+    sharedMemoryRing_->close();
+}
+
+
+void evb::bu::StreamHandler::abort()
+{
+  if ( sharedMemoryRing_.get() )
+    sharedMemoryRing_->abort();
 }
 
 
 void evb::bu::StreamHandler::do_closeFile()
 {
+  if ( publishing_ )
+  {
+    currentFileStatistics_->uncompressedSize = currentFileStatistics_->fileSize;
+    nbWriteCallsClosedFiles_ += currentFileStatistics_->nbEventsWritten;
+    bytesWrittenClosedFiles_ += currentFileStatistics_->fileSize;
+    fileStatisticsFIFO_.enqWait(currentFileStatistics_);
+    publishing_ = false;
+    return;
+  }
+
+  if ( compressor_.get() )
+  {
+    if ( currentFrame_.get() )
+      submitCurrentFrame();
+    writeCompressedFrames(true);
+  }
+
   currentFileStatistics_->fileSize =
     fileHandler_->closeAndGetFileSize();
+  if ( ! compressor_.get() )
+    currentFileStatistics_->uncompressedSize = currentFileStatistics_->fileSize;
+  nbWriteCallsClosedFiles_ += fileHandler_->getNbWriteCalls();
+  bytesWrittenClosedFiles_ += fileHandler_->getBytesWritten();
 
   fileStatisticsFIFO_.enqWait(currentFileStatistics_);
 
@@ -101,12 +190,86 @@ void evb::bu::StreamHandler::do_closeFile()
 }
 
 
+void evb::bu::StreamHandler::addEventToFrame(const EventPtr& event)
+{
+  if ( ! currentFrame_.get() )
+    currentFrame_.reset( new CompressedFrame() );
+
+  currentFrame_->addEvent(event);
+
+  if ( currentFrame_->nbEvents() >= configuration_->eventsPerCompressedFrame )
+    submitCurrentFrame();
+
+  writeCompressedFrames(false);
+}
+
+
+void evb::bu::StreamHandler::submitCurrentFrame()
+{
+  pendingFrames_.push_back(currentFrame_);
+  compressor_->compress(currentFrame_);
+  currentFrame_.reset();
+}
+
+
+void evb::bu::StreamHandler::writeCompressedFrames(const bool waitUntilDone)
+{
+  // the frames are compressed in parallel, but must be written in order
+  while ( ! pendingFrames_.empty() )
+  {
+    const CompressedFramePtr& frame = pendingFrames_.front();
+
+    if ( ! frame->isDone() )
+    {
+      if ( ! waitUntilDone ) return;
+      compressor_->waitUntilDone(frame);
+    }
+
+    fileHandler_->writeFrame(frame);
+    currentFileStatistics_->uncompressedSize += frame->uncompressedSize();
+    currentFileStatistics_->compressionTime += frame->compressionTime();
+
+    pendingFrames_.pop_front();
+  }
+}
+
+
 bool evb::bu::StreamHandler::getFileStatistics(FileStatisticsPtr& fileStatistics)
 {
   return fileStatisticsFIFO_.deq(fileStatistics);
 }
 
 
+void evb::bu::StreamHandler::getStreamMonitoring(StreamMonitoring& streamMonitoring)
+{
+  boost::mutex::scoped_lock sl(fileHandlerMutex_);
+
+  streamMonitoring.nbWriteCalls = nbWriteCallsClosedFiles_;
+  streamMonitoring.bytesWritten = bytesWrittenClosedFiles_;
+  if ( fileHandler_.get() )
+  {
+    streamMonitoring.nbWriteCalls += fileHandler_->getNbWriteCalls();
+    streamMonitoring.bytesWritten += fileHandler_->getBytesWritten();
+  }
+  else if ( publishing_ )
+  {
+    streamMonitoring.nbWriteCalls += currentFileStatistics_->nbEventsWritten;
+    streamMonitoring.bytesWritten += currentFileStatistics_->fileSize;
+  }
+  streamMonitoring.directIO = directIO_;
+  if ( stagingBuffer_.get() )
+  {
+    streamMonitoring.stagingBufferSize = stagingBuffer_->capacity();
+    streamMonitoring.hugePages = stagingBuffer_->hugePages();
+  }
+  else
+  {
+    streamMonitoring.stagingBufferSize = 0;
+    streamMonitoring.hugePages = false;
+  }
+}
+
+
 /// emacs configuration
 /// Local Variables: -
 /// mode: c++ -
@@ -37,6 +37,9 @@
  * and ifdefs to compile and call hw version only with X86_64
  */
 
+/* Added crc32c_combine to merge the crcs of consecutive buffers
+ */
+
 
 
 #include <stdio.h>
@@ -112,6 +115,63 @@ uint32_t crc32c_sw(uint32_t crci, const unsigned char *buf, size_t len)
     return (uint32_t)crc ^ 0xffffffff;
 }
 
+/* Multiply a and b mod p, where a and b are polynomials in reflected bit
+   order with the x^0 term in the most significant bit. */
+static uint32_t crc32c_multmodp(uint32_t a, uint32_t b)
+{
+    uint32_t m, p;
+
+    m = (uint32_t)1 << 31;
+    p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0)
+                break;
+        }
+        m >>= 1;
+        b = b & 1 ? (b >> 1) ^ POLY : b >> 1;
+    }
+    return p;
+}
+
+/* Table of x^2^n mod p(x) used to apply len zero bytes to a crc. */
+static pthread_once_t crc32c_once_combine = PTHREAD_ONCE_INIT;
+static uint32_t crc32c_x2n_table[32];
+
+static void crc32c_init_combine(void)
+{
+    uint32_t n, p;
+
+    p = (uint32_t)1 << 30;      /* x^1 */
+    crc32c_x2n_table[0] = p;
+    for (n = 1; n < 32; n++)
+        crc32c_x2n_table[n] = p = crc32c_multmodp(p, p);
+}
+
+/* Return x^(n * 2^k) mod p(x). */
+static uint32_t crc32c_x2nmodp(size_t n, unsigned k)
+{
+    uint32_t p;
+
+    p = (uint32_t)1 << 31;      /* x^0 == 1 */
+    while (n) {
+        if (n & 1)
+            p = crc32c_multmodp(crc32c_x2n_table[k & 31], p);
+        n >>= 1;
+        k++;
+    }
+    return p;
+}
+
+/* Return the crc of the concatenation of two buffers, given the crc1 of the
+   first, and the crc2 and length len2 of the second buffer. */
+uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2)
+{
+    pthread_once(&crc32c_once_combine, crc32c_init_combine);
+    return crc32c_multmodp(crc32c_x2nmodp(len2, 3), crc1) ^ crc2;
+}
+
 #if defined(__x86_64__)
 /* Multiply a matrix times a vector over the Galois field of two elements,
    GF(2).  Each element is a bit in an unsigned integer.  mat must have at
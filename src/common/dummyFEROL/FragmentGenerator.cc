@@ -21,7 +21,9 @@
 evb::test::dummyFEROL::FragmentGenerator::FragmentGenerator() :
   frameSize_(0),
   fedSize_(0),
-  usePlayback_(false)
+  computeCRC_(false),
+  usePlayback_(false),
+  nextFrameTemplate_(0)
 {}
 
 
@@ -38,7 +40,11 @@ void evb::test::dummyFEROL::FragmentGenerator::configure
   const uint32_t maxFedSize,
   const size_t fragmentPoolSize,
   const uint32_t fakeLumiSectionDuration,
-  const uint32_t maxTriggerRate
+  const uint32_t maxTriggerRate,
+  const std::string& triggerPattern,
+  const std::string& triggerRules,
+  const uint32_t triggerDeadTime,
+  const uint32_t nbFrameTemplates
 )
 {
   if (fedId > FED_COUNT)
@@ -75,9 +81,28 @@ void evb::test::dummyFEROL::FragmentGenerator::configure
     XCEPT_RAISE(exception::Configuration, msg.str());
   }
 
+  if ( nbFrameTemplates > 0 )
+  {
+    if ( usePlayback || fedSizeStdDev > 0 )
+    {
+      XCEPT_RAISE(exception::Configuration,
+                  "Frame templates can only be used for generated FED fragments of fixed size");
+    }
+    if ( nbFrameTemplates * frameSize_ >= fragmentPoolSize )
+    {
+      std::ostringstream msg;
+      msg << "The " << nbFrameTemplates << " frame templates of " << frameSize_ << " Bytes";
+      msg << " do not leave any space in the fragment pool of " << fragmentPoolSize << " Bytes";
+      XCEPT_RAISE(exception::Configuration, msg.str());
+    }
+  }
+
   usePlayback_ = usePlayback;
+  computeCRC_ = computeCRC;
   evbIdFactory_.setFakeLumiSectionDuration(fakeLumiSectionDuration);
 
+  releaseFrameTemplates();
+
   toolbox::net::URN urn("toolbox-mem-pool", "FragmentPool");
   try
   {
@@ -102,6 +127,10 @@ void evb::test::dummyFEROL::FragmentGenerator::configure
   fragmentTracker_.reset(
     new FragmentTracker(fedId,fedSize,fedSizeStdDev,minFedSize,maxFedSize,computeCRC)
   );
+
+  // create the templates before the trigger rate is limited
+  createFrameTemplates(nbFrameTemplates);
+  fragmentTracker_->configureTriggers(triggerPattern,triggerRules,triggerDeadTime);
   fragmentTracker_->setMaxTriggerRate(maxTriggerRate);
 
   playbackData_.clear();
@@ -240,8 +269,16 @@ bool evb::test::dummyFEROL::FragmentGenerator::getData
       playbackDataPos_ = playbackData_.rbegin();
     return true;
   }
+  else if ( ! frameTemplates_.empty() &&
+            corruptNbEvents == 0 && nbBXerrors == 0 &&
+            nbFedCRCerrors == 0 && nbSlinkCRCerrors == 0 )
+  {
+    return fillFromTemplate(bufRef,stopAtEventNumber,lastEventNumber,
+                            skipNbEvents,duplicateNbEvents);
+  }
   else
   {
+    // frames with injected errors are always generated from scratch
     return fillData(bufRef,stopAtEventNumber,lastEventNumber,skipNbEvents,
                     duplicateNbEvents,corruptNbEvents,nbBXerrors,
                     nbFedCRCerrors,nbSlinkCRCerrors);
@@ -395,6 +432,156 @@ bool evb::test::dummyFEROL::FragmentGenerator::fillData
 }
 
 
+void evb::test::dummyFEROL::FragmentGenerator::createFrameTemplates(const uint32_t nbFrameTemplates)
+{
+  uint32_t lastEventNumber = 0;
+  uint32_t noErrors = 0;
+
+  for ( uint32_t i = 0; i < nbFrameTemplates; ++i )
+  {
+    FrameTemplate frameTemplate;
+    if ( ! fillData(frameTemplate.bufRef,0,lastEventNumber,noErrors,noErrors,noErrors,noErrors,noErrors,noErrors) )
+    {
+      releaseFrameTemplates();
+      XCEPT_RAISE(exception::OutOfMemory, "Failed to allocate the frame templates");
+    }
+
+    // find the start of each FED fragment
+    const unsigned char* frame = (unsigned char*)frameTemplate.bufRef->getDataLocation();
+    const uint32_t frameSize = frameTemplate.bufRef->getDataSize();
+    uint32_t offset = 0;
+    while ( offset < frameSize )
+    {
+      const ferolh_t* ferolHeader = (ferolh_t*)(frame + offset);
+      if ( ferolHeader->is_first_packet() )
+        frameTemplate.fragmentOffsets.push_back(offset);
+      offset += sizeof(ferolh_t) + ferolHeader->data_length();
+    }
+    frameTemplates_.push_back(frameTemplate);
+  }
+  nextFrameTemplate_ = 0;
+}
+
+
+void evb::test::dummyFEROL::FragmentGenerator::releaseFrameTemplates()
+{
+  for ( FrameTemplates::const_iterator it = frameTemplates_.begin(), itEnd = frameTemplates_.end();
+        it != itEnd; ++it )
+  {
+    it->bufRef->release();
+  }
+  frameTemplates_.clear();
+  nextFrameTemplate_ = 0;
+}
+
+
+bool evb::test::dummyFEROL::FragmentGenerator::fillFromTemplate
+(
+  toolbox::mem::Reference*& bufRef,
+  const uint32_t stopAtEventNumber,
+  uint32_t& lastEventNumber,
+  uint32_t& skipNbEvents,
+  uint32_t& duplicateNbEvents
+)
+{
+  for ( uint32_t i = 0; i < skipNbEvents; ++i )
+  {
+    evbId_ = evbIdFactory_.getEvBid();
+  }
+  skipNbEvents = 0;
+
+  // The frame is sent before the next frame is requested. Thus, the template
+  // is not in use anymore when it comes around again.
+  const FrameTemplate& frameTemplate = frameTemplates_[nextFrameTemplate_];
+  unsigned char* frame = (unsigned char*)frameTemplate.bufRef->getDataLocation();
+  uint32_t usedFrameSize = 0;
+
+  for ( std::vector<uint32_t>::const_iterator it = frameTemplate.fragmentOffsets.begin(),
+          itEnd = frameTemplate.fragmentOffsets.end();
+        it != itEnd && (stopAtEventNumber == 0 || lastEventNumber < stopAtEventNumber); ++it )
+  {
+    fragmentTracker_->waitForNextTrigger();
+    usedFrameSize = *it + patchFragment(frame + *it);
+
+    if ( duplicateNbEvents > 0 )
+      --duplicateNbEvents;
+    else
+    {
+      lastEventNumber = evbId_.eventNumber();
+      evbId_ = evbIdFactory_.getEvBid();
+    }
+  }
+
+  if ( usedFrameSize == 0 ) return false;
+
+  bufRef = frameTemplate.bufRef->duplicate();
+  bufRef->setDataSize(usedFrameSize);
+
+  if ( ++nextFrameTemplate_ == frameTemplates_.size() )
+    nextFrameTemplate_ = 0;
+
+  return true;
+}
+
+
+uint32_t evb::test::dummyFEROL::FragmentGenerator::patchFragment(unsigned char* fragment)
+{
+  unsigned char* pos = fragment;
+  uint16_t fedCRC = 0xffff;
+  uint32_t packetNumber = 0;
+  bool isLastPacket = false;
+
+  do
+  {
+    ferolh_t* ferolHeader = (ferolh_t*)pos;
+    const uint32_t length = ferolHeader->data_length();
+    const bool isFirstPacket = ferolHeader->is_first_packet();
+    isLastPacket = ferolHeader->is_last_packet();
+    unsigned char* payload = pos + sizeof(ferolh_t);
+
+    // rewrite the complete FEROL header as the setters do not clear previous values
+    memset(ferolHeader, 0, sizeof(ferolh_t));
+    ferolHeader->set_signature();
+    ferolHeader->set_packet_number(packetNumber);
+    if ( isFirstPacket )
+      ferolHeader->set_first_packet();
+    if ( isLastPacket )
+      ferolHeader->set_last_packet();
+    ferolHeader->set_data_length(length);
+    ferolHeader->set_fed_id(fedId_);
+    ferolHeader->set_event_number( evbId_.eventNumber() );
+
+    if ( isFirstPacket )
+    {
+      fedh_t* fedHeader = (fedh_t*)payload;
+      fedHeader->sourceid = (evbId_.bxId() << FED_BXID_SHIFT) | (fedId_ << FED_SOID_SHIFT);
+      fedHeader->eventid  = (FED_SLINK_START_MARKER << FED_HCTRLID_SHIFT) | evbId_.eventNumber();
+    }
+
+    if ( computeCRC_ )
+    {
+      if ( isLastPacket )
+      {
+        fedt_t* fedTrailer = (fedt_t*)(payload + length - sizeof(fedt_t));
+        fedTrailer->conscheck &= ~(FED_CRCS_MASK | 0xC004);
+      }
+      crcCalculator_.compute(fedCRC,payload,length);
+    }
+
+    pos = payload + length;
+    ++packetNumber;
+  } while ( ! isLastPacket );
+
+  if ( computeCRC_ )
+  {
+    fedt_t* fedTrailer = (fedt_t*)(pos - sizeof(fedt_t));
+    fedTrailer->conscheck |= (fedCRC << FED_CRCS_SHIFT);
+  }
+
+  return pos - fragment;
+}
+
+
 toolbox::mem::Reference* evb::test::dummyFEROL::FragmentGenerator::clone
 (
   toolbox::mem::Reference* bufRef
@@ -2,6 +2,7 @@
 #include "evb/DummyFEROL.h"
 #include "evb/dummyFEROL/StateMachine.h"
 #include "evb/dummyFEROL/States.h"
+#include "evb/TimeStamp.h"
 
 #include <boost/thread.hpp>
 #include <boost/bind.hpp>
@@ -33,6 +34,7 @@ void evb::test::dummyFEROL::Configuring::activity()
   std::string msg = "Failed to configure the components";
   try
   {
+    MonotonicClock::calibrate();
     if (doConfiguring_) stateMachine.dummyFEROL()->configure();
     if (doConfiguring_) stateMachine.processFSMEvent( ConfigureDone() );
   }
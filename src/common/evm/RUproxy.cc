@@ -6,6 +6,7 @@
 #include "evb/evm/RUproxy.h"
 #include "evb/Constants.h"
 #include "evb/EvBid.h"
+#include "evb/TimeStamp.h"
 #include "toolbox/mem/MemoryPoolFactory.h"
 #include "toolbox/task/WorkLoopFactory.h"
 #include "xcept/tools.h"
@@ -83,7 +84,8 @@ void evb::evm::RUproxy::startProcessing()
 void evb::evm::RUproxy::drain()
 {
   draining_ = true;
-  while ( !readoutMsgFIFO_.empty() || processingActive_ ) ::usleep(1000);
+  while ( !readoutMsgFIFO_.empty() || processingActive_ )
+    processingActive_.waitForChange(1000);
 }
 
 
@@ -91,7 +93,7 @@ void evb::evm::RUproxy::stopProcessing()
 {
   doProcessing_ = false;
   draining_ = false;
-  while ( processingActive_ ) ::usleep(1000);
+  processingActive_.waitUntilIdle();
 
   readoutMsgFIFO_.clear();
 }
@@ -142,7 +144,7 @@ bool evb::evm::RUproxy::processRequests(toolbox::task::WorkLoop* wl)
   unsigned char* payload = 0;
   uint32_t requestCount = 0;
   const uint64_t maxAllocateTime = evm_->getConfiguration()->maxAllocateTime * 1000 * ruCount_;
-  uint64_t timeLimit = getTimeStamp() + maxAllocateTime;
+  uint64_t timeLimit = getMonotonicTimeStamp() + maxAllocateTime;
 
   try
   {
@@ -167,7 +169,7 @@ bool evb::evm::RUproxy::processRequests(toolbox::task::WorkLoop* wl)
           rqstBufRef = getRequestMsgBuffer(blockSize);
           msgSize = sizeof(msg::ReadoutMsg);
           payload = ((unsigned char*)rqstBufRef->getDataLocation()) + msgSize;
-          timeLimit = getTimeStamp() + maxAllocateTime;
+          timeLimit = getMonotonicTimeStamp() + maxAllocateTime;
         }
 
         msg::EventRequest* eventRequest = (msg::EventRequest*)payload;
@@ -197,7 +199,7 @@ bool evb::evm::RUproxy::processRequests(toolbox::task::WorkLoop* wl)
         }
       }
       ::usleep(10);
-    } while ( getTimeStamp() < timeLimit && !draining_ );
+    } while ( getMonotonicTimeStamp() < timeLimit && !draining_ );
 
     if ( rqstBufRef )
     {
@@ -333,6 +335,9 @@ void evb::evm::RUproxy::resetMonitoringCounters()
 
 void evb::evm::RUproxy::configure()
 {
+  // the pool depends on the configuration, e.g. when using hugepages
+  msgPool_ = evm_->getMsgPool();
+
   getApplicationDescriptors();
   ruCount_ = participatingRUs_.size();
 
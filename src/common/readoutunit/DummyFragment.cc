@@ -14,7 +14,7 @@ evb::readoutunit::DummyFragment::DummyFragment
   uint32_t* fedErrorCount,
   uint32_t* crcErrors
 )
-  : FedFragment(fedId,isMasterFed,subSystem,evbIdFactory,checkCRC,fedErrorCount,crcErrors),
+  : FedFragment(fedId,isMasterFed,subSystem,evbIdFactory,checkCRC,false,fedErrorCount,crcErrors),
     remainingFedSize_(fedSize),
     computeCRC_(computeCRC),
     fedCRC_(0xffff)
@@ -30,7 +30,7 @@ evb::readoutunit::DummyFragment::~DummyFragment()
 {}
 
 
-bool evb::readoutunit::DummyFragment::fillData(unsigned char* payload, const uint32_t remainingPayloadSize, uint32_t& copiedSize)
+bool evb::readoutunit::DummyFragment::fillData(unsigned char* payload, const uint32_t remainingPayloadSize, uint32_t& copiedSize, uint32_t* crc32c)
 {
   copiedSize = 0;
 
@@ -134,6 +134,10 @@ bool evb::readoutunit::DummyFragment::fillData(unsigned char* payload, const uin
       }
     }
   }
+
+  if ( crc32c )
+    *crc32c = crcCalculator_.crc32c(*crc32c,payload,copiedSize);
+
   return isComplete_;
 }
 
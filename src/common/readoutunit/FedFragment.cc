@@ -1,5 +1,7 @@
+#include <algorithm>
+#include <sstream>
+
 #include "evb/Constants.h"
-#include "evb/DumpUtility.h"
 #include "evb/Exception.h"
 #include "evb/readoutunit/FedFragment.h"
 //#include "interface/shared/i2ogevb2g.h"
@@ -14,6 +16,7 @@ evb::readoutunit::FedFragment::FedFragment
   const std::string& subSystem,
   const EvBidFactoryPtr& evbIdFactory,
   const uint32_t checkCRC,
+  const bool deferCRCcheck,
   uint32_t* fedErrorCount,
   uint32_t* crcErrors
 )
@@ -26,12 +29,14 @@ evb::readoutunit::FedFragment::FedFragment
     tmpBufferSize_(0),
     evbIdFactory_(evbIdFactory),
     checkCRC_(checkCRC),
+    deferCRCcheck_(deferCRCcheck),
     fedErrorCount_(fedErrorCount),crcErrors_(crcErrors),
     isMasterFed_(isMasterFed),
     subSystem_(subSystem),
     isCorrupted_(false),isOutOfSequence_(false),
     hasCRCerror_(false),hasFEDerror_(false),
-    bufRef_(0),copyOffset_(0)
+    bufRef_(0),copyOffset_(0),
+    crcPending_(false)
 {}
 
 
@@ -50,11 +55,13 @@ evb::readoutunit::FedFragment::FedFragment
     evbId_(evbId),
     isComplete_(true),
     checkCRC_(0),
+    deferCRCcheck_(false),
     isMasterFed_(isMasterFed),
     subSystem_(subSystem),
     isCorrupted_(false),isOutOfSequence_(false),
     hasCRCerror_(false),hasFEDerror_(false),
-    bufRef_(bufRef),copyOffset_(0)
+    bufRef_(bufRef),copyOffset_(0),
+    crcPending_(false)
 {
   iovec dataLocation;
   dataLocation.iov_base = (void*)(bufRef->getDataLocation());
@@ -80,7 +87,7 @@ evb::readoutunit::FedFragment::~FedFragment()
 }
 
 
-bool evb::readoutunit::FedFragment::fillData(unsigned char* payload, const uint32_t remainingPayloadSize, uint32_t& copiedSize)
+bool evb::readoutunit::FedFragment::fillData(unsigned char* payload, const uint32_t remainingPayloadSize, uint32_t& copiedSize, uint32_t* crc32c)
 {
   assert( isComplete_ );
 
@@ -94,7 +101,7 @@ bool evb::readoutunit::FedFragment::fillData(unsigned char* payload, const uint3
     if ( chunkSize-copyOffset_ <= remainingPayloadSize-copiedSize )
     {
       // fill the remaining fragment
-      memcpy(payload+copiedSize, chunkBase+copyOffset_, chunkSize-copyOffset_);
+      copyData(payload+copiedSize, chunkBase+copyOffset_, chunkSize-copyOffset_, crc32c);
       copiedSize += chunkSize-copyOffset_;
       ++copyIterator_;
       copyOffset_ = 0;
@@ -102,7 +109,7 @@ bool evb::readoutunit::FedFragment::fillData(unsigned char* payload, const uint3
     else
     {
       // fill the remaining payload
-      memcpy(payload+copiedSize, chunkBase+copyOffset_, remainingPayloadSize-copiedSize);
+      copyData(payload+copiedSize, chunkBase+copyOffset_, remainingPayloadSize-copiedSize, crc32c);
       copyOffset_ += remainingPayloadSize-copiedSize;
       copiedSize = remainingPayloadSize;
       return false;
@@ -112,6 +119,78 @@ bool evb::readoutunit::FedFragment::fillData(unsigned char* payload, const uint3
 }
 
 
+void evb::readoutunit::FedFragment::copyData(unsigned char* dest, const unsigned char* src, uint32_t size, uint32_t* crc32c)
+{
+  if ( !crc32c && !crcPending_ )
+  {
+    memcpy(dest, src, size);
+    return;
+  }
+
+  // Copy in pieces fitting into the L1 cache and calculate
+  // the checksums from the copy instead of re-reading the source
+  const uint32_t pieceSize = 4096;
+  while ( size > 0 )
+  {
+    const uint32_t copySize = size < pieceSize ? size : pieceSize;
+    memcpy(dest, src, copySize);
+
+    if ( crc32c )
+      *crc32c = crcCalculator_.crc32c(*crc32c, dest, copySize);
+    if ( crcPending_ )
+      updateCRC(dest, copySize);
+
+    dest += copySize;
+    src += copySize;
+    size -= copySize;
+  }
+}
+
+
+void evb::readoutunit::FedFragment::updateCRC(const unsigned char* data, uint32_t size)
+{
+  // The FED trailer is added by checkCopiedCRC with the CRC field masked
+  const uint32_t crcSize = fedSize_ - sizeof(fedt_t);
+  if ( crcSize_ + size > crcSize )
+    size = crcSize - crcSize_;
+  crcSize_ += size;
+
+  // The CRC calculator needs multiples of 8 Bytes
+  if ( crcCarrySize_ > 0 )
+  {
+    const uint32_t missingBytes = std::min(8 - crcCarrySize_, size);
+    memcpy(&crcCarry_[crcCarrySize_], data, missingBytes);
+    crcCarrySize_ += missingBytes;
+    data += missingBytes;
+    size -= missingBytes;
+    if ( crcCarrySize_ < 8 ) return;
+    crcCalculator_.compute(crc_, crcCarry_, 8);
+    crcCarrySize_ = 0;
+  }
+  const uint32_t overflow = size % 8;
+  crcCalculator_.compute(crc_, data, size - overflow);
+  memcpy(crcCarry_, data + size - overflow, overflow);
+  crcCarrySize_ = overflow;
+}
+
+
+void evb::readoutunit::FedFragment::checkCopiedCRC()
+{
+  if ( ! crcPending_ ) return;
+  crcPending_ = false;
+
+  // Force C,F,R & CRC field in the last word to zero before adding it to the CRC.
+  fedt_t fedTrailer = fedTrailer_;
+  fedTrailer.conscheck &= ~(FED_CRCS_MASK | 0xC004);
+  crcCalculator_.compute(crc_, (uint8_t*)&fedTrailer, sizeof(fedt_t));
+
+  compareCRC(fedTrailer_.conscheck, crc_);
+
+  if ( ! isOutOfSequence_ )
+    reportErrors();
+}
+
+
 bool evb::readoutunit::FedFragment::append(const EvBid& evbId, toolbox::mem::Reference* bufRef)
 {
   evbId_ = evbId;
@@ -132,9 +211,17 @@ bool evb::readoutunit::FedFragment::parse(toolbox::mem::Reference* bufRef, uint3
 {
   assert( ! isComplete_ );
 
-  uint32_t remainingBufferSize = bufRef->getDataSize() - usedSize;
   const unsigned char* pos = (unsigned char*)bufRef->getDataLocation();
 
+  // Most fragments are fully contained in the socket buffer. Try these first
+  // and use the component-wise parsing below for fragments spanning several
+  // buffers or if the fragment looks suspicious.
+  if ( typeOfNextComponent_ == FEROL_HEADER && tmpBufferSize_ == 0 && fedSize_ == 0 &&
+       parseCompleteFragment(pos, bufRef->getDataSize(), usedSize) )
+    return true;
+
+  uint32_t remainingBufferSize = bufRef->getDataSize() - usedSize;
+
   iovec dataLocation;
   dataLocation.iov_base = (void*)(pos + usedSize);
   dataLocation.iov_len = 0;
@@ -319,26 +406,8 @@ bool evb::readoutunit::FedFragment::parse(toolbox::mem::Reference* bufRef, uint3
           remainingBufferSize -= sizeof(fedt_t);
         }
 
-        isComplete_ = true;
         dataLocations_.push_back(dataLocation);
-        copyIterator_ = dataLocations_.begin();
-
-        checkFedTrailer(fedTrailer);
-
-        try
-        {
-          if ( !evbId_.isValid() )
-            evbId_ = evbIdFactory_->getEvBid(eventNumber_, bxId_, dataLocations_);
-        }
-        catch(exception::EventOutOfSequence& e)
-        {
-          isOutOfSequence_ = true;
-          if ( ! errorMsg_.empty() )
-            errorMsg_ += ". ";
-          errorMsg_ += e.message();
-        }
-
-        reportErrors();
+        finishFragment(fedTrailer);
 
         return true;
       }
@@ -353,6 +422,111 @@ bool evb::readoutunit::FedFragment::parse(toolbox::mem::Reference* bufRef, uint3
 }
 
 
+bool evb::readoutunit::FedFragment::parseCompleteFragment
+(
+  const unsigned char* pos,
+  const uint32_t bufferSize,
+  uint32_t& usedSize
+)
+{
+  // Walk over all FEROL headers of the fragment before touching any state.
+  // Packets which are not in the expected sequence, or a fragment which
+  // does not end in this buffer, are left to the component-wise parsing
+  // which provides the detailed error reporting.
+  const ferolh_t* ferolHeader;
+  uint32_t offset = usedSize;
+  uint32_t fedSize = 0;
+  uint32_t packetNumber = 0;
+  uint32_t eventNumber = 0;
+
+  do
+  {
+    if ( bufferSize - offset < sizeof(ferolh_t) )
+    {
+      dataLocations_.clear();
+      return false;
+    }
+
+    ferolHeader = (const ferolh_t*)(pos + offset);
+    offset += sizeof(ferolh_t);
+
+    const bool isFirstPacket = ferolHeader->is_first_packet();
+    const uint32_t dataLength = ferolHeader->data_length();
+    uint32_t minDataLength = 0;
+    if ( isFirstPacket )
+    {
+      eventNumber = ferolHeader->event_number();
+      minDataLength += sizeof(fedh_t);
+    }
+    if ( ferolHeader->is_last_packet() )
+      minDataLength += sizeof(fedt_t);
+
+    if ( ferolHeader->signature() != FEROL_SIGNATURE ||
+         ferolHeader->fed_id() != fedId_ ||
+         ferolHeader->event_number() != eventNumber ||
+         ferolHeader->packet_number() != packetNumber ||
+         isFirstPacket != (packetNumber == 0) ||
+         dataLength < minDataLength ||
+         bufferSize - offset < dataLength )
+    {
+      dataLocations_.clear();
+      return false;
+    }
+
+    if ( dataLength > 0 )
+    {
+      iovec dataLocation;
+      dataLocation.iov_base = (void*)(pos + offset);
+      dataLocation.iov_len = dataLength;
+      dataLocations_.push_back(dataLocation);
+    }
+
+    offset += dataLength;
+    fedSize += dataLength;
+    ++packetNumber;
+  }
+  while ( ! ferolHeader->is_last_packet() );
+
+  usedSize = offset;
+  eventNumber_ = eventNumber;
+  fedSize_ = fedSize;
+
+  const fedh_t* fedHeader = (const fedh_t*)dataLocations_.front().iov_base;
+  checkFedHeader(fedHeader);
+  if ( bxId_ > FED_BXID_WIDTH )
+    bxId_ = FED_BXID_EXTRACT(fedHeader->sourceid);
+
+  const iovec& lastLocation = dataLocations_.back();
+  finishFragment( (fedt_t*)((unsigned char*)lastLocation.iov_base + lastLocation.iov_len - sizeof(fedt_t)) );
+
+  return true;
+}
+
+
+void evb::readoutunit::FedFragment::finishFragment(fedt_t* fedTrailer)
+{
+  isComplete_ = true;
+  copyIterator_ = dataLocations_.begin();
+
+  checkFedTrailer(fedTrailer);
+
+  try
+  {
+    if ( !evbId_.isValid() )
+      evbId_ = evbIdFactory_->getEvBid(eventNumber_, bxId_, dataLocations_);
+  }
+  catch(exception::EventOutOfSequence& e)
+  {
+    isOutOfSequence_ = true;
+    if ( ! errorMsg_.empty() )
+      errorMsg_ += ". ";
+    errorMsg_ += e.message();
+  }
+
+  reportErrors();
+}
+
+
 void evb::readoutunit::FedFragment::checkFerolHeader(const ferolh_t* ferolHeader)
 {
 
@@ -472,6 +646,19 @@ void evb::readoutunit::FedFragment::checkCRC(fedt_t* fedTrailer)
 {
   if ( checkCRC_ == 0 || eventNumber_ % checkCRC_ != 0 ) return;
 
+  if ( deferCRCcheck_ && ! isCorrupted_ && (fedTrailer->conscheck & 0xC004) == 0 )
+  {
+    // Calculate the CRC while fillData copies the data for the BU.
+    // Fragments with known problems are checked right away to report
+    // all issues at once.
+    crcPending_ = true;
+    crc_ = 0xffff;
+    crcSize_ = 0;
+    crcCarrySize_ = 0;
+    fedTrailer_ = *fedTrailer;
+    return;
+  }
+
   // Force C,F,R & CRC field in the last word to zero before re-computing the CRC.
   // See http://cmsdoc.cern.ch/cms/TRIDAS/horizontal/RUWG/DAQ_IF_guide/DAQ_IF_guide.html#CDF
   DataLocations::const_reverse_iterator rit = dataLocations_.rbegin();
@@ -512,7 +699,13 @@ void evb::readoutunit::FedFragment::checkCRC(fedt_t* fedTrailer)
 
   *conscheck = origConscheck;
 
-  const uint16_t trailerCRC = FED_CRCS_EXTRACT(origConscheck);
+  compareCRC(origConscheck, crc);
+}
+
+
+void evb::readoutunit::FedFragment::compareCRC(const uint32_t conscheck, const uint16_t crc)
+{
+  const uint16_t trailerCRC = FED_CRCS_EXTRACT(conscheck);
   if ( trailerCRC != crc )
   {
     hasCRCerror_ = true;
@@ -576,7 +769,7 @@ void evb::readoutunit::FedFragment::reportErrors() const
     msg << errorMsg_;
     XCEPT_RAISE(exception::EventOutOfSequence, msg.str());
   }
-  else if ( hasCRCerror_ && evb::isFibonacci( ++(*crcErrors_) ) )
+  else if ( hasCRCerror_ && evb::isFibonacci( __sync_add_and_fetch(crcErrors_,1) ) )
   {
     std::ostringstream msg;
     msg << "Received " << *crcErrors_ << " events with wrong CRC checksum from FED " << fedId_ << " (" << subSystem_ << "): ";
@@ -595,19 +788,16 @@ void evb::readoutunit::FedFragment::reportErrors() const
 
 void evb::readoutunit::FedFragment::dump
 (
-  std::ostream& s,
+  Dump& dump,
   const std::string& reasonForDump
 )
 {
-  std::vector<unsigned char> buffer;
   uint32_t copiedSize = 0;
   if ( isComplete_ )
   {
-    buffer.resize( getFedSize() );
     for ( DataLocations::const_iterator it = dataLocations_.begin(), itEnd = dataLocations_.end();
           it != itEnd; ++it)
     {
-      memcpy(&buffer[copiedSize],it->iov_base,it->iov_len);
       copiedSize += it->iov_len;
     }
   }
@@ -616,13 +806,11 @@ void evb::readoutunit::FedFragment::dump
     for ( SocketBuffers::const_iterator it = socketBuffers_.begin(), itEnd = socketBuffers_.end();
           it != itEnd; ++it)
     {
-      toolbox::mem::Reference* bufRef = (*it)->getBufRef();
-      buffer.resize( copiedSize + bufRef->getDataSize() );
-      memcpy(&buffer[copiedSize],bufRef->getDataLocation(),bufRef->getDataSize());
-      copiedSize += bufRef->getDataSize();
+      copiedSize += (*it)->getBufRef()->getDataSize();
     }
   }
 
+  std::ostringstream s;
   s << "==================== DUMP ======================" << std::endl;
   s << "Reason for dump: " << reasonForDump << std::endl;
   s << "FED completely received   : " << (isComplete_?"true":"false") << std::endl;
@@ -633,13 +821,30 @@ void evb::readoutunit::FedFragment::dump
   s << "Trigger no           (dec): " << eventNumber_ << std::endl;
   if ( evbId_.isValid() )
     s << "EvB id                    : " << evbId_ << std::endl;
+  dump.description = s.str();
 
+  // the data is copied as is, the dump is rendered offline
   if ( bufRef_ )
-    DumpUtility::dumpBlockData(s, (unsigned char*)bufRef_->getDataLocation(), bufRef_->getDataSize());
+  {
+    dump.addChunk(bufRef_->getDataLocation(),bufRef_->getDataSize());
+  }
+  else if ( isComplete_ )
+  {
+    for ( DataLocations::const_iterator it = dataLocations_.begin(), itEnd = dataLocations_.end();
+          it != itEnd; ++it)
+    {
+      dump.addChunk(it->iov_base,it->iov_len);
+    }
+  }
   else
-    DumpUtility::dumpBlockData(s, &buffer[0], copiedSize);
-
-  s << "================ END OF DUMP ===================" << std::endl;
+  {
+    for ( SocketBuffers::const_iterator it = socketBuffers_.begin(), itEnd = socketBuffers_.end();
+          it != itEnd; ++it)
+    {
+      toolbox::mem::Reference* bufRef = (*it)->getBufRef();
+      dump.addChunk(bufRef->getDataLocation(),bufRef->getDataSize());
+    }
+  }
 }
 
 
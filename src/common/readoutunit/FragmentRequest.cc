@@ -0,0 +1,51 @@
+#include <boost/bind.hpp>
+
+#include "evb/readoutunit/FragmentRequest.h"
+
+
+evb::readoutunit::FragmentRequestPool::~FragmentRequestPool()
+{
+  for (FragmentRequests::const_iterator it = unusedRequests_.begin(), itEnd = unusedRequests_.end();
+       it != itEnd; ++it)
+  {
+    delete *it;
+  }
+}
+
+
+evb::readoutunit::FragmentRequestPtr evb::readoutunit::FragmentRequestPool::get()
+{
+  FragmentRequest* fragmentRequest = 0;
+  {
+    boost::mutex::scoped_lock sl(mutex_);
+    if ( ! unusedRequests_.empty() )
+    {
+      fragmentRequest = unusedRequests_.back();
+      unusedRequests_.pop_back();
+    }
+  }
+  if ( ! fragmentRequest )
+    fragmentRequest = new FragmentRequest;
+
+  // the deleter keeps the pool alive until the last request has been recycled
+  return FragmentRequestPtr( fragmentRequest,
+                             boost::bind(&FragmentRequestPool::recycle,shared_from_this(),_1) );
+}
+
+
+void evb::readoutunit::FragmentRequestPool::recycle(FragmentRequest* fragmentRequest)
+{
+  fragmentRequest->evbIds.clear();
+  fragmentRequest->ruTids.clear();
+
+  boost::mutex::scoped_lock sl(mutex_);
+  unusedRequests_.push_back(fragmentRequest);
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -36,7 +36,7 @@ class case_2x1_corruptedEvents(TestCase):
         self.checkRU(8192)
         self.checkBU(14336)
         self.checkIt()
-        dumps = self.getFiles("dump_run000001_event[0-9]+_fed0002.txt$",app="EVM")
+        dumps = self.getFiles("dump_run000001_event[0-9]+_fed0002.dump$",app="EVM")
         if len(dumps) != 1:
             raise ValueException("Expected one dump file from FED 2, but found: "+str(dumps))
 
@@ -47,7 +47,7 @@ class case_2x1_corruptedEvents(TestCase):
         print(" done")
         self.checkAppState("MissingData","EVM")
         self.checkAppState("Enabled","BU")
-        dumps = self.getFiles("dump_run000001_event[0-9]+_fed0007.txt$",app="EVM")
+        dumps = self.getFiles("dump_run000001_event[0-9]+_fed0007.dump$",app="EVM")
         if len(dumps) != 1:
             raise ValueException("Expected one dump file from FED 7, but found: "+str(dumps))
 
@@ -71,7 +71,7 @@ class case_2x1_corruptedEvents(TestCase):
         self.checkRU(8192)
         self.checkBU(14336)
         self.checkIt()
-        dumps = self.getFiles("dump_run000001_event[0-9]+_fed0002.txt$",app="EVM")
+        dumps = self.getFiles("dump_run000001_event[0-9]+_fed0002.dump$",app="EVM")
         if len(dumps) != 1:
             raise ValueException("Expected one dump file from FED 2, but found: "+str(dumps))
         self.sendResync()
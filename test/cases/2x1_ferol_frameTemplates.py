@@ -0,0 +1,61 @@
+import operator
+import time
+
+from TestCase import *
+from Context import FEROL,RU,BU
+
+
+class case_2x1_ferol_frameTemplates(TestCase):
+
+    def checkIt(self,crcErrors=0):
+        self.checkEVM(8192)
+        self.checkRU(8192)
+        self.checkBU(16384)
+        self.checkAppParam('nbCorruptedEvents','unsignedLong',0,operator.eq,"BU")
+        self.checkAppParam('nbEventsWithCRCerrors','unsignedLong',crcErrors,operator.eq,"BU")
+
+
+    def runTest(self):
+        self.configureEvB()
+        self.enableEvB()
+        self.checkIt()
+        self.checkAppParam('eventRate','unsignedInt',1000,operator.gt,"EVM")
+        self.checkAppParam('fragmentRate','unsignedInt',3000,operator.lt,"FEROL",4)
+
+        print("1 CRC error on FED 1")
+        self.setAppParam('nbFedCRCerrors','unsignedInt','1','FEROL',1)
+        time.sleep(2)
+        self.checkState("Enabled")
+        self.checkIt(1)
+        self.haltEvB()
+
+
+    def fillConfiguration(self,symbolMap):
+        evm = RU(symbolMap,[
+             ('inputSource','string','Socket'),
+             ('checkCRC','unsignedInt','1')
+            ])
+        for id in range(0,4):
+            self._config.add( FEROL(symbolMap,evm,id,[
+                ('useFrameTemplates','boolean','true'),
+                ('framesPerSend','unsignedInt','4')
+                ]) )
+
+        ru = RU(symbolMap,[
+             ('inputSource','string','Socket'),
+             ('checkCRC','unsignedInt','1')
+            ])
+        for id in range(4,8):
+            self._config.add( FEROL(symbolMap,ru,id,[
+                ('useFrameTemplates','boolean','true'),
+                ('maxThroughput','unsignedInt','5')
+                ]) )
+
+        self._config.add( evm )
+        self._config.add( ru )
+
+        self._config.add( BU(symbolMap,[
+             ('checkCRC','unsignedInt','1'),
+             ('dropEventData','boolean','true'),
+             ('lumiSectionTimeout','unsignedInt','0')
+            ]) )
@@ -27,7 +27,7 @@ class case_2x1_mismatch(TestCase):
         self.checkAppState("Enabled","BU")
         self.checkAppParam('eventRate','unsignedInt',0,operator.eq,"EVM")
         self.checkAppParam('fragmentRate','unsignedInt',0,operator.eq,"FEROL")
-        dumps = self.getFiles("dump_run000001_event[0-9]+_fed[0-9]+.txt$",app="EVM")
+        dumps = self.getFiles("dump_run000001_event[0-9]+_fed[0-9]+.dump$",app="EVM")
         if len(dumps) != 1:
             raise ValueException("Expected one FED dump file, but found: "+str(dumps))
         self.haltEvB()
@@ -46,7 +46,7 @@ class case_2x1_mismatch(TestCase):
         self.checkAppState("Enabled","BU")
         self.checkAppParam('eventRate','unsignedInt',0,operator.eq,"EVM")
         self.checkAppParam('fragmentRate','unsignedInt',0,operator.eq,"FEROL")
-        dumps = self.getFiles("dump_run000002_event[0-9]+_fed[0-9]+.txt$",app="EVM")
+        dumps = self.getFiles("dump_run000002_event[0-9]+_fed[0-9]+.dump$",app="EVM")
         if len(dumps) != 1:
             raise ValueException("Expected one FED dump file, but found: "+str(dumps))
         self.haltEvB()
@@ -65,7 +65,7 @@ class case_2x1_mismatch(TestCase):
         self.checkAppState("Enabled","BU")
         self.checkAppParam('eventRate','unsignedInt',0,operator.eq,"EVM")
         self.checkAppParam('fragmentRate','unsignedInt',0,operator.eq,"FEROL")
-        dumps = self.getFiles("dump_run000003_event[0-9]+_fed[0-9]+.txt$",app="RU")
+        dumps = self.getFiles("dump_run000003_event[0-9]+_fed[0-9]+.dump$",app="RU")
         if len(dumps) != 1:
             raise ValueException("Expected one FED dump file, but found: "+str(dumps))
         self.haltEvB()
@@ -84,7 +84,7 @@ class case_2x1_mismatch(TestCase):
         self.checkAppState("Enabled","BU")
         self.checkAppParam('eventRate','unsignedInt',0,operator.eq,"EVM")
         self.checkAppParam('fragmentRate','unsignedInt',0,operator.eq,"FEROL")
-        dumps = self.getFiles("dump_run000004_event[0-9]+_fed[0-9]+.txt$",app="RU")
+        dumps = self.getFiles("dump_run000004_event[0-9]+_fed[0-9]+.dump$",app="RU")
         if len(dumps) != 1:
             raise ValueException("Expected one FED dump file, but found: "+str(dumps))
         self.haltEvB()
@@ -103,7 +103,7 @@ class case_2x1_mismatch(TestCase):
         self.checkAppState("Enabled","BU")
         self.checkAppParam('eventRate','unsignedInt',0,operator.eq,"EVM")
         self.checkAppParam('fragmentRate','unsignedInt',0,operator.eq,"FEROL")
-        dumps = self.getFiles("dump_run000005_event[0-9]+_fed[0-9]+.txt$",app="EVM")
+        dumps = self.getFiles("dump_run000005_event[0-9]+_fed[0-9]+.dump$",app="EVM")
         if len(dumps) != 1:
             raise ValueException("Expected one FED dump file, but found: "+str(dumps))
         self.haltEvB()
@@ -122,7 +122,7 @@ class case_2x1_mismatch(TestCase):
         self.checkAppState("Enabled","BU")
         self.checkAppParam('eventRate','unsignedInt',0,operator.eq,"EVM")
         self.checkAppParam('fragmentRate','unsignedInt',0,operator.eq,"FEROL")
-        dumps = self.getFiles("dump_run000006_event[0-9]+_fed[0-9]+.txt$",app="EVM")
+        dumps = self.getFiles("dump_run000006_event[0-9]+_fed[0-9]+.dump$",app="EVM")
         if len(dumps) != 1:
             raise ValueException("Expected one FED dump file, but found: "+str(dumps))
         self.haltEvB()
@@ -0,0 +1,114 @@
+import glob
+import json
+import mmap
+import operator
+import os
+import struct
+import sys
+import threading
+import time
+
+from TestCase import *
+from Context import RU,BU
+
+
+class RingConsumer(threading.Thread):
+    """
+    Consume the events from a shared-memory ring of the BU.
+    There is a single consumer per ring, thus the read index
+    can be advanced without an atomic operation.
+    """
+
+    def __init__(self,ringName):
+        threading.Thread.__init__(self)
+        self.ringFile = '/dev/shm'+ringName
+        self.nbEvents = 0
+        self.error = None
+
+    def run(self):
+        try:
+            while not os.path.exists(self.ringFile):
+                time.sleep(0.1)
+            with open(self.ringFile,'r+b') as file:
+                ring = mmap.mmap(file.fileno(),0)
+                while struct.unpack_from('<I',ring,0)[0] != 0x52427645:
+                    time.sleep(0.01)
+                (magic,version,nbSlots,slotSize,runNumber,closed) = struct.unpack_from('<6I',ring,0)
+                slotStride = 64 + (slotSize+63)//64*64
+                while True:
+                    closed = struct.unpack_from('<I',ring,20)[0]
+                    writeIndex = struct.unpack_from('<Q',ring,64)[0]
+                    readIndex = struct.unpack_from('<Q',ring,128)[0]
+                    if readIndex >= writeIndex:
+                        if closed:
+                            break
+                        time.sleep(0.001)
+                        continue
+                    slot = 4096 + (readIndex % nbSlots) * slotStride
+                    (sequence,state,size) = struct.unpack_from('<QII',ring,slot)
+                    if sequence != readIndex or state != 1:
+                        raise ValueException("slot for sequence "+str(readIndex)+" in "+self.ringFile+" has not been published")
+                    (eventInfoVersion,run,lumi,event,eventSize,crc) = struct.unpack_from('<6I',ring,slot+64)
+                    if run != runNumber or size != 24+eventSize:
+                        raise ValueException("bad EventInfo for event "+str(event)+" in "+self.ringFile)
+                    struct.pack_into('<Q',ring,128,readIndex+1)
+                    struct.pack_into('<I',ring,slot+8,0)
+                    self.nbEvents += 1
+                ring.close()
+        except Exception as e:
+            self.error = e
+
+
+class case_2x1_sharedMemory(TestCase):
+
+    def runTest(self):
+        testDir="/tmp/evb_test/ramdisk"
+        runNumber=time.strftime("%s",time.localtime())
+        self.prepareAppliance(testDir,runNumber)
+        self.setAppParam('rawDataDir','string',testDir,'BU')
+        self.setAppParam('metaDataDir','string',testDir,'BU')
+        self.configureEvB()
+        self.setAppParam('hltParameterSetURL','string','file://'+testDir,'BU')
+        consumers = [RingConsumer('/evb_bu0_stream'+str(i)) for i in range(2)]
+        for consumer in consumers:
+            consumer.start()
+        self.enableEvB(sleepTime=15,runNumber=runNumber)
+        self.checkEVM(2048)
+        self.checkRU(24576)
+        self.checkBU(26624)
+        self.stopEvB()
+        for consumer in consumers:
+            consumer.join(60)
+            if consumer.error:
+                raise consumer.error
+        nbEventsConsumed = sum(consumer.nbEvents for consumer in consumers)
+
+        runDir = testDir+"/run"+runNumber
+        if glob.glob(runDir+"/*.raw"):
+            raise FileException("found raw data files in "+runDir)
+        nbEventsAccounted = 0
+        for eolsFile in glob.glob(runDir+"/*_EoLS.jsn"):
+            with open(eolsFile) as file:
+                nbEventsAccounted += int(json.load(file)['data'][0])
+        if nbEventsAccounted != nbEventsConsumed:
+            raise ValueException("expected "+str(nbEventsAccounted)+" events from the EoLS files, but consumed "+str(nbEventsConsumed)+" events")
+
+
+    def fillConfiguration(self,symbolMap):
+        self._config.add( RU(symbolMap,[
+             ('inputSource','string','Local'),
+             ('fedSourceIds','unsignedInt',(512,)),
+             ('fakeLumiSectionDuration','unsignedInt','4')
+            ]) )
+        self._config.add( RU(symbolMap,[
+             ('inputSource','string','Local'),
+             ('fedSourceIds','unsignedInt',range(1,13))
+            ]) )
+        self._config.add( BU(symbolMap,[
+             ('lumiSectionTimeout','unsignedInt','6'),
+             ('staleResourceTime','unsignedInt','0'),
+             ('numberOfBuilders','unsignedInt','2'),
+             ('useSharedMemory','boolean','true'),
+             ('sharedMemorySlots','unsignedInt','64'),
+             ('sharedMemorySlotSize','unsignedInt','65536')
+            ]) )
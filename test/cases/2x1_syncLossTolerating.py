@@ -47,7 +47,7 @@ class case_2x1_syncLossTolerating(TestCase):
             self.checkEVM(8192)
             self.checkRU(6144)
         self.checkAppState("Enabled","BU")
-        dumps = self.getFiles("dump_run[0-9]+_event[0-9]+_fed"+str(fed).zfill(4)+".txt$",app=app)
+        dumps = self.getFiles("dump_run[0-9]+_event[0-9]+_fed"+str(fed).zfill(4)+".dump$",app=app)
         if len(dumps) != 1:
             raise ValueException("Expected one FED dump file on "+app+", but found: "+str(dumps))
         time.sleep(10)
@@ -63,8 +63,8 @@ class case_2x1_tolerateMismatch(TestCase):
                     raise e
 
         self.checkAppParam('nbEventsMissingData','unsignedLong',1000,operator.ge,"BU")
-        dumps = self.getFiles("dump_run"+str(self.runNumber).zfill(6)+"_event[0-9]+_fed000[0-3]+.txt$",app="EVM")
-        dumps.extend( self.getFiles("dump_run"+str(self.runNumber).zfill(6)+"_event[0-9]+_fed000[4-7]+.txt$",app="RU") )
+        dumps = self.getFiles("dump_run"+str(self.runNumber).zfill(6)+"_event[0-9]+_fed000[0-3]+.dump$",app="EVM")
+        dumps.extend( self.getFiles("dump_run"+str(self.runNumber).zfill(6)+"_event[0-9]+_fed000[4-7]+.dump$",app="RU") )
         if nbDumps is None:
             nbDumps = len(missingFeds)
         if len(dumps) != nbDumps:
@@ -168,7 +168,7 @@ class case_2x1_tolerateMismatch(TestCase):
         self.checkAppParam('eventRate','unsignedInt',0,operator.eq,"EVM")
         self.checkAppParam('fragmentRate','unsignedInt',0,operator.eq,"FEROL")
         self.checkAppParam('nbEventsMissingData','unsignedLong',0,operator.eq,"BU")
-        dumps = self.getFiles("dump_run"+str(self.runNumber).zfill(6)+"_event[0-9]+_fed[0-9]+.txt$",app="EVM")
+        dumps = self.getFiles("dump_run"+str(self.runNumber).zfill(6)+"_event[0-9]+_fed[0-9]+.dump$",app="EVM")
         if len(dumps) != 1:
             raise ValueException("Expected one FED dump file, but found: "+str(dumps))
         self.haltEvB()
@@ -185,7 +185,7 @@ class case_2x1_tolerateMismatch(TestCase):
         self.checkAppParam('eventRate','unsignedInt',0,operator.eq,"EVM")
         self.checkAppParam('fragmentRate','unsignedInt',0,operator.eq,"FEROL")
         self.checkAppParam('nbEventsMissingData','unsignedLong',0,operator.eq,"BU")
-        dumps = self.getFiles("dump_run"+str(self.runNumber).zfill(6)+"_event[0-9]+_fed[0-9]+.txt$",app="EVM")
+        dumps = self.getFiles("dump_run"+str(self.runNumber).zfill(6)+"_event[0-9]+_fed[0-9]+.dump$",app="EVM")
         if len(dumps) != 1:
             raise ValueException("Expected one FED dump file, but found: "+str(dumps))
         self.haltEvB()
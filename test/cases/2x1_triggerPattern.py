@@ -0,0 +1,43 @@
+import operator
+import time
+
+from TestCase import TestCase
+from Context import RU,BU
+
+
+class case_2x1_triggerPattern(TestCase):
+
+    def runTest(self):
+        self.configureEvB()
+        self.enableEvB(sleepTime=5)
+        # the dead time of 100 us reduces the rate of random triggers to r/(1+r*100us)
+        self.checkEVM(8192,1500)
+        self.checkAppParam("eventRate","unsignedInt",1800,operator.lt,"EVM")
+        self.checkRU(24576)
+        self.checkBU(32768,1500)
+        print("Setting trigger rate to 20 kHz")
+        self.setAppParam("maxTriggerRate","unsignedInt",20000,"EVM")
+        time.sleep(5)
+        self.checkEVM(8192,6000)
+        self.checkAppParam("eventRate","unsignedInt",7300,operator.lt,"EVM")
+        self.stopEvB()
+        self.haltEvB()
+
+
+    def fillConfiguration(self,symbolMap):
+        self._config.add( RU(symbolMap,[
+             ('inputSource','string','Local'),
+             ('fedSourceIds','unsignedInt',range(512,516)),
+             ('maxTriggerRate','unsignedInt',2000),
+             ('triggerPattern','string','bunchTrain'),
+             ('triggerRules','string','1/3,2/25,3/100,4/240'),
+             ('triggerDeadTime','unsignedInt',100000)
+            ]) )
+        self._config.add( RU(symbolMap,[
+             ('inputSource','string','Local'),
+             ('fedSourceIds','unsignedInt',range(1,13))
+            ]) )
+        self._config.add( BU(symbolMap,[
+             ('dropEventData','boolean','true'),
+             ('lumiSectionTimeout','unsignedInt','0')
+            ]) )
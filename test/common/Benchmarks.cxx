@@ -0,0 +1,525 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sched.h>
+#include <sstream>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "cgicc/HTMLClasses.h"
+#include "evb/CRCCalculator.h"
+#include "evb/Constants.h"
+#include "evb/Dumper.h"
+#include "evb/EvBid.h"
+#include "evb/EvBidFactory.h"
+#include "evb/FragmentTracker.h"
+#include "evb/I2OMessages.h"
+#include "evb/OneToManyQueue.h"
+#include "evb/OneToOneQueue.h"
+#include "evb/TimeStamp.h"
+#include "evb/bu/Event.h"
+#include "evb/readoutunit/FedFragment.h"
+#include "evb/readoutunit/SocketBuffer.h"
+#include "interface/shared/ferol_header.h"
+#include "toolbox/mem/HeapAllocator.h"
+#include "toolbox/mem/MemoryPoolFactory.h"
+#include "toolbox/mem/Pool.h"
+#include "toolbox/mem/Reference.h"
+#include "toolbox/net/URN.h"
+
+// Micro-benchmarks of the EvB hot paths which run without any XDAQ application.
+// Each case is repeated for a fixed time and the best of several repetitions
+// is reported to get numbers which can be compared between releases.
+
+using namespace evb;
+
+class EvBApplication
+{
+public:
+  void registerQueueCallback(const std::string name, boost::function<cgicc::div()>) {};
+  void registerQueueFillLevel(const std::string name, const void*, boost::function<uint32_t()>, boost::function<uint32_t()>) {};
+  void unregisterQueueFillLevel(const std::string name, const void*) {};
+  std::string getURN() { return "urn:dummy:benchmarks"; }
+} evbApplication;
+
+
+const uint32_t fedSize = 2048;
+const uint32_t nbFragmentsPerBuffer = 64;
+const uint32_t parseFedSizes[] = {256, 2048, 8192, 32768};
+const uint32_t nbRUs = 8;
+const uint32_t nbFedsPerRU = 8;
+const uint32_t nbResponders[] = {1, 2, 4, 8};
+const uint32_t runNumber = 1;
+
+const uint32_t nbRepetitions = 5;
+const uint64_t repetitionTime = 100000000; // ns
+
+
+// Return the best time per operation in ns of the case executing opsPerCall operations per call
+double measure(boost::function<void()> benchmarkCase, const uint32_t opsPerCall)
+{
+  // warm up caches and branch predictors
+  for (uint32_t i = 0; i < 10; ++i)
+    benchmarkCase();
+
+  double best = std::numeric_limits<double>::max();
+  for (uint32_t i = 0; i < nbRepetitions; ++i)
+  {
+    const uint64_t start = getMonotonicTimeStamp();
+    uint64_t calls = 0;
+    uint64_t elapsed = 0;
+    do
+    {
+      benchmarkCase();
+      ++calls;
+      elapsed = getMonotonicTimeStamp() - start;
+    } while ( elapsed < repetitionTime );
+    best = std::min(best, static_cast<double>(elapsed) / (calls*opsPerCall));
+  }
+  return best;
+}
+
+
+void report(const std::string& name, const double nsPerOp, const uint32_t bytesPerOp)
+{
+  std::cout << std::left << std::setw(40) << name << std::right
+    << std::fixed << std::setprecision(1) << std::setw(12) << nsPerOp << " ns/op";
+  if ( bytesPerOp > 0 )
+    std::cout << std::setprecision(2) << std::setw(10) << bytesPerOp/nsPerOp << " GB/s";
+  std::cout << std::endl;
+}
+
+
+toolbox::mem::Reference* getFrame(toolbox::mem::Pool* pool, const uint32_t size)
+{
+  toolbox::mem::Reference* bufRef = toolbox::mem::getMemoryPoolFactory()->getFrame(pool,size);
+  memset(bufRef->getDataLocation(),0,size);
+  bufRef->setDataSize(size);
+  return bufRef;
+}
+
+
+// Write a FED fragment split into FEROL blocks as sent by the FEROL. Returns the number of Bytes used.
+uint32_t writeFerolFragment(FragmentTracker& fragmentTracker, const EvBid& evbId, const uint16_t fedId, unsigned char* frame)
+{
+  const uint32_t ferolPayloadSize = FEROL_BLOCK_SIZE - sizeof(ferolh_t);
+  uint32_t remainingFedSize = fragmentTracker.startFragment(evbId);
+  uint32_t packetNumber = 0;
+  unsigned char* pos = frame;
+
+  while ( remainingFedSize > 0 )
+  {
+    ferolh_t* ferolHeader = (ferolh_t*)pos;
+    ferolHeader->set_signature();
+    ferolHeader->set_packet_number(packetNumber);
+    if ( packetNumber == 0 )
+      ferolHeader->set_first_packet();
+
+    uint32_t length = ferolPayloadSize;
+    if ( remainingFedSize <= ferolPayloadSize )
+    {
+      length = remainingFedSize;
+      ferolHeader->set_last_packet();
+    }
+    remainingFedSize -= length;
+    pos += sizeof(ferolh_t);
+
+    const size_t filledBytes = fragmentTracker.fillData(pos, length);
+    ferolHeader->set_data_length(filledBytes);
+    ferolHeader->set_fed_id(fedId);
+    ferolHeader->set_event_number(evbId.eventNumber());
+
+    pos += filledBytes;
+    ++packetNumber;
+  }
+  return pos - frame;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// CRCCalculator
+//////////////////////////////////////////////////////////////////////////
+
+void crc16(const CRCCalculator* crcCalculator, const std::vector<unsigned char>* buffer, volatile uint16_t* crc)
+{
+  *crc = crcCalculator->compute(&(*buffer)[0], buffer->size());
+}
+
+
+void crc32c(const CRCCalculator* crcCalculator, const std::vector<unsigned char>* buffer, volatile uint32_t* crc)
+{
+  *crc = crcCalculator->crc32c(0, &(*buffer)[0], buffer->size());
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// OneToOneQueue
+//////////////////////////////////////////////////////////////////////////
+
+const uint32_t queueBatch = 1024;
+
+void queueRoundTrip(OneToOneQueue<uint32_t>* queue)
+{
+  uint32_t element = 0;
+  for (uint32_t i = 0; i < queueBatch; ++i)
+    queue->enq(i);
+  for (uint32_t i = 0; i < queueBatch; ++i)
+    queue->deq(element);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// FedFragment parsing and block packing on the RU
+//////////////////////////////////////////////////////////////////////////
+
+struct FerolData
+{
+  toolbox::mem::Reference* bufRef;
+  readoutunit::SocketBuffer::ReleaseFunction releaseFunction;
+  readoutunit::SocketBufferPtr socketBuffer;
+  EvBidFactoryPtr evbIdFactory;
+  std::string subSystem;
+  uint32_t fedErrorCount;
+  uint32_t crcErrors;
+  std::vector<unsigned char> block;
+};
+
+
+void keepSocketBuffer(toolbox::mem::Reference*) {}
+
+
+void parseFedFragments(FerolData* data)
+{
+  data->evbIdFactory->reset(runNumber);
+  uint32_t usedSize = 0;
+  while ( usedSize < data->bufRef->getDataSize() )
+  {
+    readoutunit::FedFragment fedFragment(0,false,data->subSystem,data->evbIdFactory,0,
+                                         &data->fedErrorCount,&data->crcErrors);
+    if ( ! fedFragment.append(data->socketBuffer,usedSize) )
+      throw std::string("Incomplete FED fragment in socket buffer");
+  }
+}
+
+
+void packFedFragments(FerolData* data, const bool calculateCRC32c)
+{
+  data->evbIdFactory->reset(runNumber);
+  uint32_t usedSize = 0;
+  uint32_t blockOffset = 0;
+  uint32_t crc32c = 0;
+  while ( usedSize < data->bufRef->getDataSize() )
+  {
+    readoutunit::FedFragment fedFragment(0,false,data->subSystem,data->evbIdFactory,0,
+                                         &data->fedErrorCount,&data->crcErrors);
+    fedFragment.append(data->socketBuffer,usedSize);
+
+    uint32_t copiedSize = 0;
+    while ( ! fedFragment.fillData(&data->block[blockOffset],data->block.size()-blockOffset,copiedSize,
+                                   calculateCRC32c ? &crc32c : 0) )
+      blockOffset = 0;
+    blockOffset += copiedSize;
+  }
+}
+
+
+void benchmarkFedFragments(toolbox::mem::Pool* pool, const uint32_t fedSize)
+{
+  const uint32_t ferolPayloadSize = FEROL_BLOCK_SIZE - sizeof(ferolh_t);
+  const uint32_t ferolBlocks = (fedSize + ferolPayloadSize - 1)/ferolPayloadSize;
+
+  FerolData data;
+  data.bufRef = getFrame(pool,nbFragmentsPerBuffer*(fedSize+ferolBlocks*sizeof(ferolh_t)));
+  data.releaseFunction = &keepSocketBuffer;
+  data.socketBuffer.reset( new readoutunit::SocketBuffer(data.bufRef,data.releaseFunction) );
+  data.evbIdFactory.reset( new EvBidFactory() );
+  data.evbIdFactory->reset(runNumber);
+  data.subSystem = "benchmark";
+  data.fedErrorCount = 0;
+  data.crcErrors = 0;
+  data.block.resize(65536);
+
+  FragmentTracker fragmentTracker(0,fedSize,0,fedSize,fedSize,true);
+  EvBidFactory evbIdFactory;
+  evbIdFactory.reset(runNumber);
+  unsigned char* frame = (unsigned char*)data.bufRef->getDataLocation();
+  for (uint32_t i = 0; i < nbFragmentsPerBuffer; ++i)
+    frame += writeFerolFragment(fragmentTracker,evbIdFactory.getEvBid(),0,frame);
+  data.bufRef->setDataSize(frame - (unsigned char*)data.bufRef->getDataLocation());
+
+  std::ostringstream size;
+  size << " " << fedSize << " B";
+  report("FedFragment::append (parse)"+size.str(),
+         measure(boost::bind(&parseFedFragments,&data),nbFragmentsPerBuffer), fedSize);
+  report("FedFragment::fillData (pack)"+size.str(),
+         measure(boost::bind(&packFedFragments,&data,false),nbFragmentsPerBuffer), fedSize);
+  report("FedFragment::fillData (pack w/ CRC32c)"+size.str(),
+         measure(boost::bind(&packFedFragments,&data,true),nbFragmentsPerBuffer), fedSize);
+
+  data.socketBuffer.reset();
+  data.bufRef->release();
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// Responder scaling on the RU
+//////////////////////////////////////////////////////////////////////////
+
+const uint32_t nbRequestsPerBatch = 256;
+
+typedef std::vector<const unsigned char*> FedLocations;
+typedef boost::shared_ptr<FedLocations> FedLocationsPtr;
+
+struct ResponderData
+{
+  std::vector<unsigned char> fedData;
+  boost::mutex extractionMutex;
+  OneToManyQueue<FedLocationsPtr>* assembledRequests;
+  volatile uint32_t nextRequest;
+  volatile uint32_t packedRequests;
+  volatile bool assembling;
+};
+
+
+// Stand-in for Input::getSuperFragmentWithEvBid
+FedLocationsPtr extractSuperFragment(const ResponderData* data)
+{
+  FedLocationsPtr fedLocations( new FedLocations );
+  fedLocations->reserve(nbFedsPerRU);
+  for (uint32_t fed = 0; fed < nbFedsPerRU; ++fed)
+    fedLocations->push_back(&data->fedData[fed*fedSize]);
+  return fedLocations;
+}
+
+
+// Stand-in for BUproxy::sendData
+void packSuperFragment(const FedLocationsPtr& fedLocations, std::vector<unsigned char>& block)
+{
+  unsigned char* payload = &block[0];
+  for (FedLocations::const_iterator it = fedLocations->begin(), itEnd = fedLocations->end();
+       it != itEnd; ++it)
+  {
+    memcpy(payload,*it,fedSize);
+    payload += fedSize;
+  }
+}
+
+
+// Each responder extracts the super fragments while holding a global mutex
+void mutexResponder(ResponderData* data)
+{
+  std::vector<unsigned char> block(nbFedsPerRU*fedSize);
+  while (1)
+  {
+    FedLocationsPtr fedLocations;
+    {
+      boost::mutex::scoped_lock sl(data->extractionMutex);
+      if ( data->nextRequest == nbRequestsPerBatch ) return;
+      ++data->nextRequest;
+      fedLocations = extractSuperFragment(data);
+    }
+    packSuperFragment(fedLocations,block);
+  }
+}
+
+
+void runMutexResponders(ResponderData* data, const uint32_t nbThreads)
+{
+  data->nextRequest = 0;
+  boost::thread_group threads;
+  for (uint32_t i = 0; i < nbThreads; ++i)
+    threads.create_thread(boost::bind(&mutexResponder,data));
+  threads.join_all();
+}
+
+
+// A single assembler extracts the super fragments, the responders only pack them
+void assembler(ResponderData* data)
+{
+  for (uint32_t i = 0; i < nbRequestsPerBatch; ++i)
+    data->assembledRequests->enqWait(extractSuperFragment(data),data->assembling);
+}
+
+
+void assembledResponder(ResponderData* data)
+{
+  std::vector<unsigned char> block(nbFedsPerRU*fedSize);
+  FedLocationsPtr fedLocations;
+  while ( data->packedRequests < nbRequestsPerBatch )
+  {
+    if ( data->assembledRequests->deq(fedLocations) )
+    {
+      packSuperFragment(fedLocations,block);
+      __sync_add_and_fetch(&data->packedRequests,1);
+    }
+    else
+    {
+      sched_yield();
+    }
+  }
+}
+
+
+void runAssembledResponders(ResponderData* data, const uint32_t nbThreads)
+{
+  data->packedRequests = 0;
+  data->assembling = true;
+  boost::thread_group threads;
+  threads.create_thread(boost::bind(&assembler,data));
+  for (uint32_t i = 0; i < nbThreads; ++i)
+    threads.create_thread(boost::bind(&assembledResponder,data));
+  threads.join_all();
+}
+
+
+void benchmarkResponders(const uint32_t nbThreads)
+{
+  ResponderData data;
+  data.fedData.resize(nbFedsPerRU*fedSize);
+  for (uint32_t i = 0; i < data.fedData.size(); ++i)
+    data.fedData[i] = i * 37;
+  OneToManyQueue<FedLocationsPtr> assembledRequests(&evbApplication,"assembledRequests");
+  assembledRequests.resize(16*nbThreads);
+  data.assembledRequests = &assembledRequests;
+
+  std::ostringstream threads;
+  threads << " " << nbThreads;
+  report("Responders w/ mutex"+threads.str(),
+         measure(boost::bind(&runMutexResponders,&data,nbThreads),nbRequestsPerBatch), nbFedsPerRU*fedSize);
+  report("Responders w/ assembler"+threads.str(),
+         measure(boost::bind(&runAssembledResponders,&data,nbThreads),nbRequestsPerBatch), nbFedsPerRU*fedSize);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// Event building on the BU
+//////////////////////////////////////////////////////////////////////////
+
+struct SuperFragmentData
+{
+  std::vector<toolbox::mem::Reference*> bufRefs;
+  std::vector<EvBid> evbIds;
+  msg::RUtids ruTids;
+  Dumper* dumper;
+};
+
+
+void buildEvents(SuperFragmentData* data, const bool check)
+{
+  for (uint32_t event = 0; event < data->evbIds.size(); ++event)
+  {
+    bu::Event bu_event(data->evbIds[event],data->ruTids,1,check,false);
+    for (uint32_t ru = 0; ru < nbRUs; ++ru)
+    {
+      toolbox::mem::Reference* bufRef = data->bufRefs[event*nbRUs + ru];
+      bu_event.appendSuperFragment(data->ruTids[ru],bufRef->duplicate(),
+                                   (unsigned char*)bufRef->getDataLocation());
+    }
+    if ( ! bu_event.isComplete() )
+      throw std::string("Incomplete event");
+    if ( check )
+      bu_event.checkEvent(*data->dumper);
+  }
+}
+
+
+int main()
+{
+  toolbox::net::URN urn("toolbox-mem-pool","benchmarks");
+  toolbox::mem::Pool* pool =
+    toolbox::mem::getMemoryPoolFactory()->createPool(urn,new toolbox::mem::HeapAllocator());
+
+  CRCCalculator crcCalculator;
+  std::vector<unsigned char> buffer(fedSize);
+  for (uint32_t i = 0; i < buffer.size(); ++i)
+    buffer[i] = i * 37;
+  volatile uint16_t crc16Result;
+  volatile uint32_t crc32cResult;
+
+  report("CRCCalculator::compute",
+         measure(boost::bind(&crc16,&crcCalculator,&buffer,&crc16Result),1), fedSize);
+  report("CRCCalculator::crc32c",
+         measure(boost::bind(&crc32c,&crcCalculator,&buffer,&crc32cResult),1), fedSize);
+
+  OneToOneQueue<uint32_t> queue(&evbApplication,"queue");
+  queue.resize(queueBatch);
+  report("OneToOneQueue enq/deq",
+         measure(boost::bind(&queueRoundTrip,&queue),queueBatch), 0);
+
+  for (uint32_t i = 0; i < sizeof(parseFedSizes)/sizeof(uint32_t); ++i)
+    benchmarkFedFragments(pool,parseFedSizes[i]);
+
+  for (uint32_t i = 0; i < sizeof(nbResponders)/sizeof(uint32_t); ++i)
+    benchmarkResponders(nbResponders[i]);
+
+  {
+    SuperFragmentData data;
+    Dumper dumper;
+    data.dumper = &dumper;
+    for (uint32_t ru = 0; ru < nbRUs; ++ru)
+      data.ruTids.push_back(ru+1);
+
+    std::vector<FragmentTracker*> fragmentTrackers;
+    for (uint16_t fedId = 0; fedId < nbRUs*nbFedsPerRU; ++fedId)
+      fragmentTrackers.push_back( new FragmentTracker(fedId,fedSize,0,fedSize,fedSize,true) );
+
+    const uint32_t superFragmentSize = nbFedsPerRU*fedSize;
+    const uint32_t headerSize = ((sizeof(msg::SuperFragment) + 7) / 8) * 8;
+    EvBidFactory evbIdFactory;
+    evbIdFactory.reset(runNumber);
+    for (uint32_t event = 0; event < 16; ++event)
+    {
+      const EvBid evbId = evbIdFactory.getEvBid();
+      data.evbIds.push_back(evbId);
+      for (uint32_t ru = 0; ru < nbRUs; ++ru)
+      {
+        toolbox::mem::Reference* bufRef = getFrame(pool,headerSize+superFragmentSize);
+        msg::SuperFragment* superFragmentMsg = (msg::SuperFragment*)bufRef->getDataLocation();
+        superFragmentMsg->headerSize = headerSize;
+        superFragmentMsg->superFragmentNb = event;
+        superFragmentMsg->totalSize = superFragmentSize;
+        superFragmentMsg->partSize = superFragmentSize;
+        superFragmentMsg->crc32c = 0;
+        superFragmentMsg->hasCRC32c = 0;
+        superFragmentMsg->nbDroppedFeds = 0;
+        unsigned char* payload = (unsigned char*)bufRef->getDataLocation() + headerSize;
+        for (uint32_t fed = 0; fed < nbFedsPerRU; ++fed)
+        {
+          FragmentTracker* fragmentTracker = fragmentTrackers[ru*nbFedsPerRU + fed];
+          fragmentTracker->startFragment(evbId);
+          payload += fragmentTracker->fillData(payload,fedSize);
+        }
+        data.bufRefs.push_back(bufRef);
+      }
+    }
+
+    report("Event::appendSuperFragment",
+           measure(boost::bind(&buildEvents,&data,false),data.evbIds.size()), nbRUs*superFragmentSize);
+    report("Event::checkEvent w/ CRC",
+           measure(boost::bind(&buildEvents,&data,true),data.evbIds.size()), nbRUs*superFragmentSize);
+
+    for (std::vector<toolbox::mem::Reference*>::iterator it = data.bufRefs.begin(); it != data.bufRefs.end(); ++it)
+      (*it)->release();
+    for (std::vector<FragmentTracker*>::iterator it = fragmentTrackers.begin(); it != fragmentTrackers.end(); ++it)
+      delete *it;
+  }
+
+  toolbox::mem::getMemoryPoolFactory()->destroyPool(urn);
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,154 @@
+#include <assert.h>
+#include <iostream>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "evb/CRCCalculator.h"
+#include "evb/bu/Compression.h"
+#include "evb/bu/EventInfo.h"
+
+// Verify compressed raw-data files written by the BU:
+//   CompressedRawFile file.raw [file.raw ...]
+// Without arguments, a round trip through a temporary file is tested.
+
+using namespace evb::bu;
+
+evb::CRCCalculator crcCalculator;
+
+
+uint32_t verifyFile(const std::string& fileName)
+{
+  compression::FileReader reader(fileName);
+  std::vector<unsigned char> buffer;
+  uint32_t nbEvents = 0;
+  uint64_t uncompressedSize = 0;
+  uint64_t compressedSize = 0;
+
+  for ( uint32_t frame = 0; frame < reader.getNbFrames(); ++frame )
+  {
+    const compression::FrameHeader header = reader.readFrame(frame,buffer);
+    const unsigned char* pos = &buffer[0];
+    const unsigned char* end = pos + buffer.size();
+
+    for ( uint32_t i = 0; i < header.nbEvents; ++i )
+    {
+      assert( pos + sizeof(EventInfo) <= end );
+      const EventInfo* eventInfo = reinterpret_cast<const EventInfo*>(pos);
+      pos += sizeof(EventInfo);
+
+      assert( eventInfo->version() == EventInfo::currentVersion );
+      assert( i > 0 || eventInfo->eventNumber() == header.firstEventNumber );
+      assert( pos + eventInfo->eventSize() <= end );
+
+      if ( eventInfo->crc32c() != 0 )
+        assert( crcCalculator.crc32c(0,pos,eventInfo->eventSize()) == eventInfo->crc32c() );
+
+      pos += eventInfo->eventSize();
+      ++nbEvents;
+    }
+    assert( pos == end );
+
+    uncompressedSize += header.uncompressedSize;
+    compressedSize += header.compressedSize;
+  }
+
+  std::cout << fileName << ": " << reader.getNbFrames() << " frames with "
+    << nbEvents << " events, compression ratio "
+    << (compressedSize > 0 ? static_cast<double>(uncompressedSize)/compressedSize : 0) << std::endl;
+
+  return nbEvents;
+}
+
+
+void writeTestFile(const std::string& fileName, const compression::Algorithm algorithm)
+{
+  compression::Codec codec(algorithm,1);
+  std::vector<compression::IndexEntry> index;
+  FILE* file = fopen(fileName.c_str(),"wb");
+  assert( file );
+  uint64_t offset = 0;
+  uint32_t eventNumber = 1;
+
+  for ( uint32_t frame = 0; frame < 5; ++frame )
+  {
+    std::vector<unsigned char> events;
+    for ( uint32_t i = 0; i < 10; ++i, ++eventNumber )
+    {
+      std::vector<unsigned char> data(1024 + rand() % 4096);
+      for ( size_t j = 0; j < data.size(); ++j )
+        data[j] = (j % 64 == 0) ? rand() : j;
+
+      EventInfo eventInfo(1,1,eventNumber);
+      eventInfo.addFedSize(data.size());
+      iovec loc;
+      loc.iov_base = &data[0];
+      loc.iov_len = data.size();
+      eventInfo.updateCRC32(loc);
+
+      const unsigned char* info = reinterpret_cast<const unsigned char*>(&eventInfo);
+      events.insert(events.end(),info,info+sizeof(EventInfo));
+      events.insert(events.end(),data.begin(),data.end());
+    }
+
+    std::vector<unsigned char> compressed( codec.compressBound(events.size()) );
+    compression::FrameHeader header;
+    header.magic = compression::frameMagic;
+    header.algorithm = algorithm;
+    header.nbEvents = 10;
+    header.firstEventNumber = eventNumber - 10;
+    header.uncompressedSize = events.size();
+    header.compressedSize = codec.compress(&events[0],events.size(),&compressed[0],compressed.size());
+
+    compression::IndexEntry indexEntry;
+    indexEntry.offset = offset;
+    indexEntry.firstEventNumber = header.firstEventNumber;
+    indexEntry.nbEvents = header.nbEvents;
+    indexEntry.uncompressedSize = header.uncompressedSize;
+    indexEntry.compressedSize = header.compressedSize;
+    index.push_back(indexEntry);
+
+    fwrite(&header,sizeof(header),1,file);
+    fwrite(&compressed[0],header.compressedSize,1,file);
+    offset += sizeof(header) + header.compressedSize;
+  }
+
+  compression::FileTrailer trailer;
+  trailer.indexOffset = offset;
+  trailer.nbFrames = index.size();
+  trailer.magic = compression::trailerMagic;
+  fwrite(&index[0],sizeof(compression::IndexEntry),index.size(),file);
+  fwrite(&trailer,sizeof(trailer),1,file);
+  fclose(file);
+}
+
+
+int main( int argc, const char* argv[] )
+{
+  if ( argc > 1 )
+  {
+    for ( int i = 1; i < argc; ++i )
+      verifyFile(argv[i]);
+    return 0;
+  }
+
+  const std::string fileName = "/tmp/evb_test_compressed.raw";
+
+  writeTestFile(fileName,compression::LZ4);
+  assert( verifyFile(fileName) == 50 );
+
+  writeTestFile(fileName,compression::ZSTD);
+  assert( verifyFile(fileName) == 50 );
+
+  remove(fileName.c_str());
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
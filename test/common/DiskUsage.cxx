@@ -0,0 +1,86 @@
+#include <assert.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdint.h>
+#include <unistd.h>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "evb/bu/DiskUsage.h"
+
+using namespace evb::bu;
+
+
+const uint32_t predictionHorizon(5);
+
+
+// Write bytesPerStep every 100 ms and update the disk usage after each step,
+// while requests look at the threshold every 10 ms. Return the shortest time
+// to full seen during the steps, or -1 if the usage was never increasing.
+float updateFor(DiskUsage& diskUsage, const uint32_t steps, const uint64_t bytesPerStep,
+                const boost::filesystem::path& dir = boost::filesystem::path())
+{
+  const std::vector<char> data(bytesPerStep, 'x');
+  float minTimeToFull = -1;
+
+  for (uint32_t i = 0; i < steps; ++i)
+  {
+    if ( ! dir.empty() )
+    {
+      std::ostringstream fileName;
+      fileName << "file" << i;
+      std::ofstream file((dir / fileName.str()).string().c_str(), std::ios::binary);
+      file.write(&data[0], data.size());
+    }
+    for (uint32_t j = 0; j < 10; ++j)
+    {
+      diskUsage.bytesWritten(bytesPerStep/10);
+      ::usleep(10000);
+      diskUsage.overThreshold();
+      const float timeToFull = diskUsage.timeToFull();
+      if ( timeToFull >= 0 && (minTimeToFull < 0 || timeToFull < minTimeToFull) )
+        minTimeToFull = timeToFull;
+    }
+    diskUsage.update();
+  }
+
+  return minTimeToFull;
+}
+
+
+int main()
+{
+  const boost::filesystem::path dir = "/tmp/evb_test_diskUsage";
+  boost::filesystem::remove_all(dir);
+  boost::filesystem::create_directories(dir);
+
+  DiskUsage diskUsage(dir, 0.95, 0.99, predictionHorizon);
+  ::usleep(100000);
+  assert( diskUsage.diskSizeGB() > 0 );
+
+  // the BU writes 10 GB/s, but the consumers delete the files as fast:
+  // the disk usage does not change and nothing is extrapolated
+  const float timeToFullWhenConsumed = updateFor(diskUsage, 20, 1000000000);
+  std::cout << "Time to full while the files are consumed: " << timeToFullWhenConsumed << "s" << std::endl;
+  assert( timeToFullWhenConsumed < 0 || timeToFullWhenConsumed > 3600 );
+
+  // the files are not consumed: the disk fills at 100 MB/s
+  const float timeToFullWhenFilling = updateFor(diskUsage, 20, 10000000, dir);
+  std::cout << "Time to full while the disk fills: " << timeToFullWhenFilling << "s" << std::endl;
+  assert( timeToFullWhenFilling >= 0 );
+  assert( timeToFullWhenFilling < timeToFullWhenConsumed || timeToFullWhenConsumed < 0 );
+
+  boost::filesystem::remove_all(dir);
+
+  std::cout << "DiskUsage test passed" << std::endl;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,113 @@
+#include <assert.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "evb/Dumper.h"
+
+using namespace evb;
+
+
+std::vector<char> readFile(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::binary);
+  assert( file.is_open() );
+  return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+
+DumpPtr createDump(const uint32_t eventNumber, const uint32_t fedId = Dump::noFedId)
+{
+  const DumpPtr dump( new Dump(123, eventNumber, fedId) );
+  dump->description = "Reason for dump: test\n";
+  std::vector<uint32_t> data(16);
+  for (uint32_t i = 0; i < data.size(); ++i)
+    data[i] = eventNumber + i;
+  dump->addChunk(&data[0], 8*sizeof(uint32_t));
+  dump->addChunk(&data[8], 8*sizeof(uint32_t));
+  dump->badChunk = 1;
+  return dump;
+}
+
+
+int main()
+{
+  char dir[] = "/tmp/evb_dumper_XXXXXX";
+  const char* tmpDir = mkdtemp(dir);
+  assert( tmpDir );
+
+  {
+    Dumper dumper(dir);
+    dumper.configure(4, 2);
+
+    // the burst is limited to the number of dumps per second
+    assert( dumper.accept() );
+    dumper.write( createDump(1) );
+    assert( dumper.accept() );
+    dumper.write( createDump(2, 512) );
+    assert( ! dumper.accept() );
+    assert( dumper.getNbDumpsDropped() == 1 );
+
+    // forced dumps are only limited by the queue capacity
+    assert( dumper.accept(true) );
+    dumper.write( createDump(3) );
+
+    dumper.drain();
+    assert( dumper.getNbDumpsWritten() == 3 );
+
+    // tokens are refilled over time
+    ::usleep(600000);
+    assert( dumper.accept() );
+    dumper.write( createDump(4) );
+    assert( ! dumper.accept() );
+    assert( dumper.getNbDumpsDropped() == 2 );
+  } // the dumper writes any queued dumps when destroyed
+
+  const std::string eventFile = std::string(dir) + "/dump_run000123_event00000001.dump";
+  const std::vector<char> content = readFile(eventFile);
+  const uint32_t* header = reinterpret_cast<const uint32_t*>(&content[0]);
+  assert( memcmp(&content[0], "EvBdump", 8) == 0 );
+  assert( header[2] == 1 );                  // version
+  assert( header[3] == 40 );                 // header size
+  assert( header[4] == 123 );                // run number
+  assert( header[5] == 1 );                  // event number
+  assert( header[6] == Dump::noFedId );
+  assert( header[7] == 1 );                  // bad chunk
+  assert( header[8] == 2 );                  // number of chunks
+  assert( header[9] == 22 );                 // description size
+  assert( std::string(&content[40], 22) == "Reason for dump: test\n" );
+  const uint32_t* chunkSizes = reinterpret_cast<const uint32_t*>(&content[62]);
+  assert( chunkSizes[0] == 32 && chunkSizes[1] == 32 );
+  assert( content.size() == 40 + 22 + 2*4 + 64 );
+  const uint32_t* data = reinterpret_cast<const uint32_t*>(&content[70]);
+  for (uint32_t i = 0; i < 16; ++i)
+    assert( data[i] == 1 + i );
+
+  const std::string files[] = {
+    eventFile,
+    std::string(dir) + "/dump_run000123_event00000002_fed0512.dump",
+    std::string(dir) + "/dump_run000123_event00000003.dump",
+    std::string(dir) + "/dump_run000123_event00000004.dump"
+  };
+  for (uint32_t i = 0; i < 4; ++i)
+  {
+    assert( ::access(files[i].c_str(), R_OK) == 0 );
+    ::unlink(files[i].c_str());
+  }
+  assert( ::rmdir(dir) == 0 );
+
+  std::cout << "Dumper test passed" << std::endl;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
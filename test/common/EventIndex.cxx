@@ -0,0 +1,176 @@
+#include <assert.h>
+#include <iostream>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "evb/DataLocations.h"
+#include "evb/bu/EventIndex.h"
+#include "evb/bu/EventInfo.h"
+#include "interface/shared/fed_header.h"
+#include "interface/shared/fed_trailer.h"
+
+// Verify the index files written by the BU against the raw-data files:
+//   EventIndex file.raw [file.raw ...]
+// Without arguments, events with FEDs split over several data chunks are indexed and read back.
+
+using namespace evb::bu;
+
+
+std::vector<unsigned char> readFile(const std::string& fileName)
+{
+  std::vector<unsigned char> buffer;
+  FILE* file = fopen(fileName.c_str(),"rb");
+  assert( file );
+  fseek(file,0,SEEK_END);
+  buffer.resize(ftell(file));
+  fseek(file,0,SEEK_SET);
+  if ( ! buffer.empty() )
+    assert( fread(&buffer[0],1,buffer.size(),file) == buffer.size() );
+  fclose(file);
+  return buffer;
+}
+
+
+uint32_t verifyFile(const std::string& rawFileName, const std::string& indexFileName)
+{
+  const std::vector<unsigned char> raw = readFile(rawFileName);
+  const std::vector<unsigned char> index = readFile(indexFileName);
+
+  assert( index.size() >= sizeof(EventIndexHeader) );
+  const EventIndexHeader* header = reinterpret_cast<const EventIndexHeader*>(&index[0]);
+  assert( header->magic == eventIndexMagic );
+  assert( header->version == eventIndexVersion );
+  assert( index.size() == sizeof(EventIndexHeader) +
+          header->nbEvents * sizeof(EventIndexEntry) + header->nbFeds * sizeof(FedIndexEntry) );
+
+  const EventIndexEntry* events = reinterpret_cast<const EventIndexEntry*>(header + 1);
+  const FedIndexEntry* feds = reinterpret_cast<const FedIndexEntry*>(events + header->nbEvents);
+  uint64_t offset = 0;
+
+  for ( uint32_t i = 0; i < header->nbEvents; ++i )
+  {
+    const EventIndexEntry& event = events[i];
+    assert( event.offset == offset );
+
+    const EventInfo* eventInfo = reinterpret_cast<const EventInfo*>(&raw[event.offset]);
+    assert( eventInfo->runNumber() == header->runNumber );
+    assert( eventInfo->lumiSection() == header->lumiSection );
+    assert( eventInfo->eventNumber() == event.eventNumber );
+    assert( eventInfo->eventSize() == event.eventSize );
+
+    const unsigned char* data = &raw[event.offset + sizeof(EventInfo)];
+    uint32_t fedOffset = 0;
+    for ( uint32_t f = event.firstFed; f < event.firstFed + event.nbFeds; ++f )
+    {
+      assert( feds[f].offset == fedOffset );
+      const fedh_t* fedHeader = reinterpret_cast<const fedh_t*>(data + feds[f].offset);
+      const fedt_t* fedTrailer = reinterpret_cast<const fedt_t*>(data + feds[f].offset + feds[f].size - sizeof(fedt_t));
+      assert( FED_SOID_EXTRACT(fedHeader->sourceid) == feds[f].fedId );
+      assert( FED_LVL1_EXTRACT(fedHeader->eventid) == event.eventNumber );
+      assert( (FED_EVSZ_EXTRACT(fedTrailer->eventsize)<<3) == feds[f].size );
+      fedOffset += feds[f].size;
+    }
+    assert( fedOffset == event.eventSize );
+
+    offset += sizeof(EventInfo) + event.eventSize;
+  }
+  assert( offset == raw.size() );
+
+  std::cout << rawFileName << ": " << header->nbEvents << " events with "
+    << header->nbFeds << " FEDs" << std::endl;
+
+  return header->nbEvents;
+}
+
+
+void writeTestFiles(const std::string& rawFileName, const std::string& indexFileName)
+{
+  EventIndex eventIndex;
+  FILE* file = fopen(rawFileName.c_str(),"wb");
+  assert( file );
+  uint64_t offset = 0;
+
+  for ( uint32_t eventNumber = 1; eventNumber <= 20; ++eventNumber )
+  {
+    std::vector<unsigned char> data;
+    std::vector<size_t> splitPoints;
+
+    for ( uint16_t fedId = 0; fedId < 1 + eventNumber % 7; ++fedId )
+    {
+      const size_t fedStart = data.size();
+      const uint32_t fedSize = 16 + 8 * (rand() % 512);
+      data.resize(fedStart + fedSize, 0xa5);
+
+      fedh_t* fedHeader = reinterpret_cast<fedh_t*>(&data[fedStart]);
+      fedHeader->sourceid = (fedId + 10) << FED_SOID_SHIFT;
+      fedHeader->eventid = (FED_SLINK_START_MARKER << FED_HCTRLID_SHIFT) | eventNumber;
+      fedt_t* fedTrailer = reinterpret_cast<fedt_t*>(&data[fedStart + fedSize - sizeof(fedt_t)]);
+      fedTrailer->eventsize = (FED_SLINK_END_MARKER << FED_TCTRLID_SHIFT) | (fedSize >> 3);
+      fedTrailer->conscheck = 0;
+
+      // split the data of some FEDs into separate chunks, keeping headers and trailers intact
+      if ( fedSize > 32 && rand() % 2 )
+        splitPoints.push_back(fedStart + 8 + 8 * (rand() % ((fedSize - 24) / 8)));
+      splitPoints.push_back(fedStart + fedSize);
+    }
+
+    EventInfoPtr eventInfo( new EventInfo(1,2,eventNumber) );
+    eventInfo->addFedSize(data.size());
+
+    evb::DataLocations locs;
+    size_t chunkStart = 0;
+    for ( std::vector<size_t>::const_iterator it = splitPoints.begin(); it != splitPoints.end(); ++it )
+    {
+      iovec loc;
+      loc.iov_base = &data[chunkStart];
+      loc.iov_len = *it - chunkStart;
+      locs.push_back(loc);
+      chunkStart = *it;
+    }
+
+    eventIndex.addEvent(offset, eventInfo, locs);
+
+    fwrite(eventInfo.get(),sizeof(EventInfo),1,file);
+    fwrite(&data[0],data.size(),1,file);
+    offset += sizeof(EventInfo) + data.size();
+  }
+  fclose(file);
+
+  assert( eventIndex.getNbEvents() == 20 );
+  eventIndex.write(indexFileName);
+}
+
+
+int main( int argc, const char* argv[] )
+{
+  if ( argc > 1 )
+  {
+    for ( int i = 1; i < argc; ++i )
+    {
+      std::string indexFileName = argv[i];
+      indexFileName.replace(indexFileName.rfind(".raw"),4,".idx");
+      verifyFile(argv[i],indexFileName);
+    }
+    return 0;
+  }
+
+  const std::string rawFileName = "/tmp/evb_test_index.raw";
+  const std::string indexFileName = "/tmp/evb_test_index.idx";
+
+  writeTestFiles(rawFileName,indexFileName);
+  assert( verifyFile(rawFileName,indexFileName) == 20 );
+
+  remove(rawFileName.c_str());
+  remove(indexFileName.c_str());
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,150 @@
+#include <assert.h>
+#include <iostream>
+#include <sched.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "evb/LumiSectionCounters.h"
+
+using namespace evb;
+
+
+const uint32_t window(64);
+const uint16_t nbThreads(4);
+const uint32_t nbLumiSections(50);
+LumiSectionCounters counters(window,nbThreads);
+volatile uint32_t currentLumiSection(0);
+volatile bool counting(false);
+volatile uint64_t countedEvents(0);
+
+
+void countEvents(const uint16_t thread)
+{
+  uint64_t count = 0;
+  while ( counting )
+  {
+    counters.increment(currentLumiSection,thread);
+    ++count;
+  }
+  __sync_add_and_fetch(&countedEvents,count);
+}
+
+
+// concurrent counting and closing of lumi sections
+LumiSectionCounters closingCounters(window,1);
+const uint32_t nbClosingLumiSections(2000);
+const uint32_t maxEventsPerLumiSection(1000);
+std::vector<uint32_t> acceptedEvents(nbClosingLumiSections,0);
+std::vector<uint32_t> eventsWhenClosed(nbClosingLumiSections,0);
+
+
+void countEventsUntilClosed()
+{
+  for (uint32_t ls = 0; ls < nbClosingLumiSections; ++ls)
+  {
+    // only a limited number of lumi sections can be open at the same time
+    while ( ls >= closingCounters.getOldestOpen() + window ) sched_yield();
+
+    closingCounters.open(ls);
+    for (uint32_t i = 0; i < maxEventsPerLumiSection; ++i)
+    {
+      if ( ! closingCounters.incrementIfNotClosed(ls) ) break;
+      ++acceptedEvents[ls];
+    }
+  }
+}
+
+
+void closeLumiSections()
+{
+  uint32_t ls;
+  while ( (ls = closingCounters.getOldestOpen()) < nbClosingLumiSections )
+  {
+    const uint32_t nbEvents = closingCounters.getCount(ls);
+    if ( closingCounters.closeIfCountIs(ls,nbEvents) )
+      eventsWhenClosed[ls] = nbEvents;
+  }
+}
+
+
+int main()
+{
+  // single thread
+  LumiSectionCounters ring(4,2);
+  assert( ! ring.isOpen(0) );
+  assert( ring.getCount(0) == 0 );
+
+  ring.open(0);
+  assert( ring.isOpen(0) );
+  ring.increment(0);
+  ring.increment(0,1);
+  ring.increment(0,1);
+  assert( ring.getCount(0) == 3 );
+
+  for (uint32_t ls = 1; ls <= 4; ++ls)
+  {
+    ring.open(ls);
+    ring.increment(ls,ls%2);
+  }
+  // lumi section 0 has been dropped when opening lumi section 4
+  assert( ! ring.isOpen(0) );
+  assert( ring.getCount(0) == 0 );
+  assert( ring.getCount(4) == 1 );
+  assert( ring.getCount(5) == 0 );
+
+  ring.clear();
+  assert( ! ring.isOpen(4) );
+
+  // concurrent counting while lumi sections are being opened
+  counters.open(0);
+  counting = true;
+  boost::thread_group countingThreads;
+  for (uint16_t thread = 0; thread < nbThreads; ++thread)
+    countingThreads.create_thread( boost::bind(&countEvents,thread) );
+
+  for (uint32_t ls = 1; ls <= nbLumiSections; ++ls)
+  {
+    ::usleep(10000);
+    counters.open(ls);
+    currentLumiSection = ls;
+  }
+  counting = false;
+  countingThreads.join_all();
+
+  uint64_t sum = 0;
+  for (uint32_t ls = 0; ls <= nbLumiSections; ++ls)
+    sum += counters.getCount(ls);
+
+  std::cout << "Counted " << countedEvents << " events in " << nbLumiSections+1 << " lumi sections" << std::endl;
+  assert( sum == countedEvents );
+
+  // each event accepted by the counting thread must be seen when closing its lumi section
+  boost::thread counter( &countEventsUntilClosed );
+  boost::thread closer( &closeLumiSections );
+  counter.join();
+  closer.join();
+
+  uint32_t nbClosedEarly = 0;
+  for (uint32_t ls = 0; ls < nbClosingLumiSections; ++ls)
+  {
+    assert( eventsWhenClosed[ls] == acceptedEvents[ls] );
+    if ( acceptedEvents[ls] < maxEventsPerLumiSection ) ++nbClosedEarly;
+  }
+  assert( ! closingCounters.incrementIfNotClosed(nbClosingLumiSections-1) );
+
+  std::cout << nbClosedEarly << " of " << nbClosingLumiSections << " lumi sections were closed while counting" << std::endl;
+
+  std::cout << "LumiSectionCounters test passed" << std::endl;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
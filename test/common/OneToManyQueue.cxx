@@ -0,0 +1,114 @@
+#include <iostream>
+#include <sstream>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "cgicc/HTMLClasses.h"
+#include "evb/OneToManyQueue.h"
+
+class EvBApplication
+{
+public:
+  void registerQueueFillLevel(const std::string name, const void*, boost::function<uint32_t()>, boost::function<uint32_t()>) {};
+  void unregisterQueueFillLevel(const std::string name, const void*) {};
+} evbApplication;
+
+
+evb::OneToManyQueue<uint32_t> queue(&evbApplication,"queue");
+volatile bool generating(false);
+volatile bool consuming(false);
+const size_t queueSize(64);
+const uint32_t nbSinks(4);
+const uint32_t testDuration(15);
+uint64_t enqueuedSum(0);
+volatile uint64_t dequeuedSum(0);
+volatile uint64_t dequeuedCount(0);
+
+void source()
+{
+  uint32_t counter = 0;
+  while ( generating )
+  {
+    if ( queue.enq(counter) )
+    {
+      enqueuedSum += counter;
+      ++counter;
+    }
+  }
+  std::cout << "Enqueued " << counter << " elements" << std::endl;
+}
+
+void sink()
+{
+  uint32_t counter = 0;
+  uint32_t count = 0;
+  uint32_t last = 0;
+  uint64_t sum = 0;
+  while ( consuming || !queue.empty() )
+  {
+    if ( queue.deq(counter) )
+    {
+      // each sink must see the elements in the order they were enqueued
+      if ( count > 0 && counter <= last )
+      {
+        std::ostringstream oss;
+        oss << "Dequeued " << counter << " after " << last;
+        throw( oss.str() );
+      }
+      last = counter;
+      sum += counter;
+      ++count;
+    }
+  }
+  __sync_add_and_fetch(&dequeuedSum,sum);
+  __sync_add_and_fetch(&dequeuedCount,count);
+}
+
+int main( int argc, const char* argv[] )
+{
+  // the size is rounded up to a power of 2 such that the pointers can wrap
+  queue.resize(0);
+  if ( queue.size() != 1 ) throw( std::string("Queue of size 0 not rounded up to 1") );
+  queue.resize(100);
+  if ( queue.size() != 128 ) throw( std::string("Queue of size 100 not rounded up to 128") );
+
+  queue.resize(queueSize);
+  generating = true;
+  consuming = true;
+
+  boost::thread sourceThread(source);
+  boost::thread_group sinkThreads;
+  for (uint32_t i = 0; i < nbSinks; ++i)
+    sinkThreads.create_thread(sink);
+
+  ::sleep(testDuration);
+
+  std::cout << "Stopping source thread..." << std::endl;
+  generating = false;
+  sourceThread.join();
+
+  std::cout << "Stopping sink threads..." << std::endl;
+  consuming = false;
+  sinkThreads.join_all();
+
+  std::cout << "Dequeued " << dequeuedCount << " elements" << std::endl;
+  if ( dequeuedSum != enqueuedSum )
+  {
+    std::ostringstream oss;
+    oss << "The sum of the dequeued elements " << dequeuedSum
+      << " does not match the sum of the enqueued elements " << enqueuedSum;
+    throw( oss.str() );
+  }
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
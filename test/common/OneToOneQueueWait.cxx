@@ -12,6 +12,8 @@ class EvBApplication
 {
 public:
   void registerQueueCallback(const std::string name, boost::function<cgicc::div()>) {};
+  void registerQueueFillLevel(const std::string name, const void*, boost::function<uint32_t()>, boost::function<uint32_t()>) {};
+  void unregisterQueueFillLevel(const std::string name, const void*) {};
   std::string getURN() { return "urn:dummy:foo"; }
 } evbApplication;
 
@@ -0,0 +1,124 @@
+#include <assert.h>
+#include <fstream>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+#include "evb/Exception.h"
+#include "evb/bu/ResourceSummary.h"
+
+using namespace evb::bu;
+
+
+const std::string summary =
+  "{\"ramdisk_occupancy\": 0.123, \"broken\": 0, \"idle\": 16, \"used\": 144"
+  ", \"activeFURun\": 123456, \"active_resources\": 160, \"quarantined\": 2"
+  ", \"stale_resources\": 1, \"activeRunCMSSWMaxLS\": -1, \"bu_stop_requests_flag\": false"
+  ", \"activeRunNumQueuedLS\": 3, \"activeRunLSBWMB\": 12.5, \"cloud\": 0}";
+
+
+bool parseFails(const std::string& json)
+{
+  ResourceSummary::Values values;
+  try
+  {
+    ResourceSummary::parse(json.c_str(), json.size(), values);
+  }
+  catch(evb::exception::FFF& e)
+  {
+    return true;
+  }
+  return false;
+}
+
+
+void writeSummary(const boost::filesystem::path& path, const std::string& json)
+{
+  std::ofstream file(path.string().c_str());
+  file << json;
+}
+
+
+int main()
+{
+  ResourceSummary::Values values;
+  ResourceSummary::parse(summary.c_str(), summary.size(), values);
+  assert( values.activeResources == 160 );
+  assert( values.cloud == 0 );
+  assert( values.quarantined == 2 );
+  assert( values.staleResources == 1 );
+  assert( values.activeRunNumQueuedLS == 3 );
+  assert( values.activeFURun == 123456 );
+  assert( values.activeRunCMSSWMaxLS == -1 );
+  assert( values.activeRunLSBWMB == 12.5 );
+  assert( ! values.stopRequests );
+
+  // values written as strings and white space are accepted
+  const std::string quoted =
+    "{\n  \"active_resources\" : \"8\",\n  \"cloud\" : 1,\n  \"quarantined\" : 0,\n"
+    "  \"stale_resources\" : 0,\n  \"activeRunNumQueuedLS\" : 0,\n  \"activeFURun\" : 1,\n"
+    "  \"activeRunCMSSWMaxLS\" : 5,\n  \"activeRunLSBWMB\" : 1e2,\n  \"bu_stop_requests_flag\" : true\n}\n";
+  ResourceSummary::parse(quoted.c_str(), quoted.size(), values);
+  assert( values.activeResources == 8 );
+  assert( values.cloud == 1 );
+  assert( values.activeRunLSBWMB == 100 );
+  assert( values.stopRequests );
+
+  assert( parseFails("") );
+  assert( parseFails("{\"active_resources\": 160}") );
+  assert( parseFails(summary.substr(0,summary.size()/2)) );
+  std::string corrupted = summary;
+  corrupted.replace(corrupted.find("160"), 3, "1x0");
+  assert( parseFails(corrupted) );
+
+  // the watcher reacts to a rewrite of the file
+  char dir[] = "/tmp/evb_resourceSummary_XXXXXX";
+  const char* tmpDir = mkdtemp(dir);
+  assert( tmpDir );
+  const boost::filesystem::path path = boost::filesystem::path(dir) / "resource_summary";
+  writeSummary(path, summary);
+
+  ResourceSummary resourceSummary(path);
+  assert( resourceSummary.waitForUpdate(1000) );
+  assert( resourceSummary.modified() );
+  resourceSummary.read();
+  assert( resourceSummary.getValues().activeResources == 160 );
+  assert( ! resourceSummary.modified() );
+  assert( ! resourceSummary.waitForUpdate(10) );
+
+  std::string updated = summary;
+  updated.replace(updated.find("160"), 3, "42");
+  writeSummary(path, updated);
+  assert( resourceSummary.waitForUpdate(1000) );
+  assert( resourceSummary.modified() );
+  resourceSummary.read();
+  assert( resourceSummary.getValues().activeResources == 42 );
+
+  std::cout << "Resource summary read " << resourceSummary.getLatency() << " ms after it was written" << std::endl;
+
+  // a corrupted file is re-read until it is valid again
+  writeSummary(path, corrupted);
+  assert( resourceSummary.waitForUpdate(1000) );
+  assert( resourceSummary.modified() );
+  try
+  {
+    resourceSummary.read();
+    assert( false );
+  }
+  catch(evb::exception::FFF& e) {}
+  assert( resourceSummary.getValues().activeResources == 42 );
+  assert( resourceSummary.modified() );
+
+  ::unlink(path.string().c_str());
+  ::rmdir(dir);
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
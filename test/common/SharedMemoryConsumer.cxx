@@ -0,0 +1,135 @@
+#include <assert.h>
+#include <iostream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "evb/CRCCalculator.h"
+#include "evb/DataLocations.h"
+#include "evb/bu/EventInfo.h"
+#include "evb/bu/SharedMemoryRing.h"
+
+// Consume the events published by a BU into its shared-memory rings:
+//   SharedMemoryConsumer /evb_bu0_stream0 [/evb_bu0_stream1 ...]
+// Each ring is read until the BU closes it at the end of the run.
+// Without arguments, a producer and two consumers exchange events through a test ring.
+
+using namespace evb::bu;
+
+evb::CRCCalculator crcCalculator;
+
+
+uint64_t consume(const std::string& ringName)
+{
+  // wait for the BU to create the ring
+  SharedMemoryReader* reader = 0;
+  while ( ! reader )
+  {
+    try
+    {
+      reader = new SharedMemoryReader(ringName);
+    }
+    catch(...)
+    {
+      ::usleep(100000);
+    }
+  }
+
+  uint64_t nbEvents = 0;
+  uint64_t nbBytes = 0;
+  uint64_t sequence;
+  const EventInfo* eventInfo;
+  const unsigned char* data;
+
+  while ( ! reader->isDone() )
+  {
+    if ( ! reader->claim(sequence,eventInfo,data) )
+    {
+      ::usleep(100);
+      continue;
+    }
+
+    assert( eventInfo->version() == EventInfo::currentVersion );
+    assert( eventInfo->runNumber() == reader->getRunNumber() );
+    if ( eventInfo->crc32c() != 0 )
+      assert( crcCalculator.crc32c(0,data,eventInfo->eventSize()) == eventInfo->crc32c() );
+
+    ++nbEvents;
+    nbBytes += eventInfo->eventSize();
+
+    reader->acknowledge(sequence);
+  }
+
+  std::cout << ringName << ": consumed " << nbEvents << " events with "
+    << nbBytes << " Bytes from run " << reader->getRunNumber() << std::endl;
+
+  delete reader;
+  return nbEvents;
+}
+
+
+void consumeInto(const std::string& ringName, uint64_t* nbEvents)
+{
+  *nbEvents = consume(ringName);
+}
+
+
+int main( int argc, const char* argv[] )
+{
+  if ( argc > 1 )
+  {
+    boost::thread_group consumers;
+    std::vector<uint64_t> nbEvents(argc-1);
+    for ( int i = 1; i < argc; ++i )
+      consumers.create_thread( boost::bind(&consumeInto,std::string(argv[i]),&nbEvents[i-1]) );
+    consumers.join_all();
+    return 0;
+  }
+
+  const std::string ringName = "/evb_test_ring";
+  const uint32_t nbEventsToPublish = 10000;
+  SharedMemoryRingPtr ring( new SharedMemoryRing(ringName,8,16384) );
+  ring->open(1);
+
+  uint64_t nbEvents[2] = {0,0};
+  boost::thread_group consumers;
+  consumers.create_thread( boost::bind(&consumeInto,ringName,&nbEvents[0]) );
+  consumers.create_thread( boost::bind(&consumeInto,ringName,&nbEvents[1]) );
+
+  std::vector<unsigned char> data(16384 - sizeof(EventInfo));
+  for ( uint32_t eventNumber = 1; eventNumber <= nbEventsToPublish; ++eventNumber )
+  {
+    const size_t eventSize = 8 * (1 + rand() % (data.size() / 8));
+    for ( size_t i = 0; i < eventSize; ++i )
+      data[i] = eventNumber + i;
+
+    iovec loc;
+    loc.iov_base = &data[0];
+    loc.iov_len = eventSize;
+    evb::DataLocations locs(1,loc);
+
+    EventInfo eventInfo(1,1,eventNumber);
+    eventInfo.addFedSize(eventSize);
+    eventInfo.updateCRC32(loc);
+
+    assert( ring->publish(eventInfo,locs) );
+  }
+  ring->close();
+  consumers.join_all();
+
+  assert( nbEvents[0] + nbEvents[1] == nbEventsToPublish );
+  assert( ring->getOccupancy() == 0 );
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
@@ -0,0 +1,61 @@
+#include <assert.h>
+#include <iostream>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "evb/SteadyStateMonitor.h"
+#include "evb/TimeStamp.h"
+
+using namespace evb;
+
+
+int32_t measureTimeToSteadyState(const uint32_t rampUpTimeMS, const uint32_t eventsDuringRampUp)
+{
+  SteadyStateMonitor monitor(1000);
+  monitor.start();
+
+  const uint64_t start = getMonotonicTimeStamp();
+  uint64_t now = start;
+  while ( now < start + 1100000000ULL )
+  {
+    // 100 kHz in steady state
+    monitor.eventsDone( now < start + rampUpTimeMS*1000000ULL ? eventsDuringRampUp : 10 );
+    ::usleep(100);
+    now = getMonotonicTimeStamp();
+  }
+
+  const int32_t timeToSteadyState = monitor.getTimeToSteadyState();
+  std::cout << "ramp up of " << rampUpTimeMS << " ms: time to steady state is "
+    << timeToSteadyState << " ms" << std::endl;
+  return timeToSteadyState;
+}
+
+
+int main()
+{
+  // nothing happened
+  SteadyStateMonitor monitor(100);
+  monitor.start();
+  assert( monitor.getTimeToSteadyState() == -1 );
+  ::usleep(150000);
+  assert( monitor.getTimeToSteadyState() == -1 );
+
+  int32_t timeToSteadyState = measureTimeToSteadyState(0,10);
+  assert( timeToSteadyState >= 0 && timeToSteadyState <= 20 );
+
+  timeToSteadyState = measureTimeToSteadyState(200,0);
+  assert( timeToSteadyState >= 180 && timeToSteadyState <= 230 );
+
+  timeToSteadyState = measureTimeToSteadyState(300,5);
+  assert( timeToSteadyState >= 270 && timeToSteadyState <= 330 );
+
+  std::cout << "SteadyStateMonitor test passed" << std::endl;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
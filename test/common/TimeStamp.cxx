@@ -0,0 +1,81 @@
+#include <assert.h>
+#include <iomanip>
+#include <iostream>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "evb/Constants.h"
+#include "evb/TimeStamp.h"
+
+using namespace evb;
+
+
+const uint32_t nbCalls = 10000000;
+
+
+template<typename Clock>
+void measureCallCost(const std::string& name, Clock clock)
+{
+  uint64_t sum = 0;
+  const uint64_t start = MonotonicClock::getRawTime();
+  for (uint32_t i = 0; i < nbCalls; ++i)
+    sum += clock();
+  const uint64_t stop = MonotonicClock::getRawTime();
+
+  std::cout << std::setw(24) << std::left << name << ": "
+    << std::fixed << std::setprecision(1) << static_cast<double>(stop - start) / nbCalls
+    << " ns per call" << std::endl;
+  assert( sum > 0 );
+}
+
+
+uint64_t getMonotonicClockTimeStamp()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (ts.tv_sec*1000000000ULL + ts.tv_nsec);
+}
+
+
+int main()
+{
+  MonotonicClock::calibrate();
+
+  std::cout << "Monotonic time stamps use the "
+    << (MonotonicClock::usesTSC() ? "TSC" : "raw clock");
+  if ( MonotonicClock::usesTSC() )
+    std::cout << " at " << std::setprecision(3) << MonotonicClock::getTSCfrequency() << " GHz";
+  std::cout << std::endl;
+
+  // the time never goes backwards
+  uint64_t last = getMonotonicTimeStamp();
+  for (uint32_t i = 0; i < 1000000; ++i)
+  {
+    const uint64_t now = getMonotonicTimeStamp();
+    assert( now >= last );
+    last = now;
+  }
+
+  // intervals agree with the raw clock
+  const uint64_t rawStart = MonotonicClock::getRawTime();
+  const uint64_t start = getMonotonicTimeStamp();
+  ::usleep(200000);
+  const uint64_t stop = getMonotonicTimeStamp();
+  const uint64_t rawStop = MonotonicClock::getRawTime();
+  const double ratio = static_cast<double>(stop - start) / (rawStop - rawStart);
+  assert( ratio > 0.99 && ratio < 1.01 );
+
+  measureCallCost("getMonotonicTimeStamp", getMonotonicTimeStamp);
+  measureCallCost("CLOCK_MONOTONIC_RAW", MonotonicClock::getRawTime);
+  measureCallCost("CLOCK_MONOTONIC", getMonotonicClockTimeStamp);
+  measureCallCost("getTimeStamp (realtime)", getTimeStamp);
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
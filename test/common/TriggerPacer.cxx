@@ -0,0 +1,117 @@
+#include <assert.h>
+#include <iostream>
+#include <stdint.h>
+#include <time.h>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "evb/TimeStamp.h"
+#include "evb/TriggerPacer.h"
+
+using namespace evb;
+
+
+double measureRate(TriggerPacer& pacer, const uint64_t duration, uint64_t& triggerNumber)
+{
+  const uint64_t start = getMonotonicTimeStamp();
+  const uint64_t firstTrigger = triggerNumber;
+  while ( getMonotonicTimeStamp() < start + duration )
+    triggerNumber += pacer.waitForTrigger(triggerNumber);
+  return (triggerNumber - firstTrigger) / ((getMonotonicTimeStamp() - start) / 1e9);
+}
+
+
+double measureRate(const std::string& pattern, const std::string& rules, const uint32_t deadTime, const uint32_t rate)
+{
+  TriggerPacer pacer;
+  pacer.configure(pattern,rules,deadTime);
+  pacer.setRate(rate);
+  pacer.start();
+  uint64_t triggerNumber = 0;
+  const double measuredRate = measureRate(pacer,500000000,triggerNumber);
+  std::cout << pattern << " '" << rules << "' deadTime=" << deadTime << " at " << rate << " Hz: "
+    << measuredRate << " Hz with " << pacer.getNbVetoedTriggers() << " vetoed triggers" << std::endl;
+  return measuredRate;
+}
+
+
+void consumeTriggers(TriggerPacer* pacer, const uint64_t stopTime, uint64_t* triggerNumber)
+{
+  while ( getMonotonicTimeStamp() < stopTime )
+    *triggerNumber += pacer->waitForTrigger(*triggerNumber);
+}
+
+
+int main()
+{
+  // the CPU is not kept busy while waiting for triggers
+  const clock_t cpuStart = clock();
+  double rate = measureRate("constant","",0,20000);
+  assert( rate > 19000 && rate < 21000 );
+  assert( clock() - cpuStart < CLOCKS_PER_SEC/4 );
+
+  rate = measureRate("poisson","",0,20000);
+  assert( rate > 18000 && rate < 22000 );
+
+  rate = measureRate("bunchTrain","",0,20000);
+  assert( rate > 18000 && rate < 22000 );
+
+  // at most 1 trigger in 4000 bunch crossings (~100 us)
+  rate = measureRate("poisson","1/4000",0,100000);
+  assert( rate < 10100 );
+
+  // a dead time of 200 us after each trigger
+  rate = measureRate("constant","",200000,10000);
+  assert( rate > 4500 && rate < 5100 );
+
+  // CMS-like trigger rules do not change moderate rates much
+  rate = measureRate("bunchTrain","1/3,2/25,3/100,4/240",0,50000);
+  assert( rate > 45000 && rate < 55000 );
+
+  // no limitation
+  TriggerPacer pacer;
+  pacer.configure("constant","",0);
+  pacer.start();
+  uint64_t triggerNumber = 0;
+  rate = measureRate(pacer,100000000,triggerNumber);
+  assert( rate > 1000000 );
+
+  // switching to a limited rate continues after the triggers handed out
+  pacer.setRate(1000);
+  rate = measureRate(pacer,200000000,triggerNumber);
+  assert( rate > 900 && rate < 1100 );
+
+  // all streams get the same triggers
+  pacer.setRate(10000);
+  pacer.start();
+  const uint64_t stopTime = getMonotonicTimeStamp() + 300000000;
+  uint64_t triggerNumbers[4] = {0,0,0,0};
+  boost::thread_group streams;
+  for (int i = 0; i < 4; ++i)
+    streams.create_thread( boost::bind(&consumeTriggers,&pacer,stopTime,&triggerNumbers[i]) );
+  streams.join_all();
+  for (int i = 0; i < 4; ++i)
+  {
+    assert( triggerNumbers[i] > 2700 && triggerNumbers[i] < 3300 );
+    assert( triggerNumbers[i] + 10 > triggerNumbers[0] && triggerNumbers[i] < triggerNumbers[0] + 10 );
+  }
+
+  // stopping wakes up waiting streams
+  pacer.setRate(1);
+  pacer.start();
+  boost::thread stream( boost::bind(&consumeTriggers,&pacer,getMonotonicTimeStamp()+10000000,&triggerNumbers[0]) );
+  ::usleep(20000);
+  pacer.stop();
+  stream.join();
+
+  std::cout << "TriggerPacer test passed" << std::endl;
+}
+
+
+/// emacs configuration
+/// Local Variables: -
+/// mode: c++ -
+/// c-basic-offset: 2 -
+/// indent-tabs-mode: nil -
+/// End: -
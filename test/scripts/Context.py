@@ -450,6 +450,40 @@ class RUBU(RU):
         return policyElements
 
 
+class Loopback(Context):
+    """
+    Runs the EVM, RUs and BUs as applications of a single XDAQ process
+    on the host of RU0. No peer transport is configured: the executive
+    passes the I2O frames between the applications in memory.
+    """
+
+    def __init__(self,symbolMap):
+        Context.__init__(self,'Loopback',symbolMap.getHostInfo('RU0'))
+        self.ruInstance = 0
+        self.buInstance = 0
+
+
+    def addRU(self,properties=[]):
+        if self.ruInstance == 0:
+            app = Application.Application('evb::EVM',self.ruInstance,properties)
+            app.params['tid'] = '1'
+            app.params['id'] = '50'
+        else:
+            app = Application.Application('evb::RU',self.ruInstance,properties)
+            app.params['tid'] = str(10+self.ruInstance)
+            app.params['id'] = str(50+self.ruInstance)
+        self.applications.append(app)
+        self.ruInstance += 1
+
+
+    def addBU(self,properties=[]):
+        app = Application.Application('evb::BU',self.buInstance,properties)
+        app.params['tid'] = str(100+self.buInstance)
+        app.params['id'] = str(100+self.buInstance)
+        self.applications.append(app)
+        self.buInstance += 1
+
+
 def resetInstanceNumbers():
     # resets all instance numbers of the above classes
     # (these are class wide / static variables)
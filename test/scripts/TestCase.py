@@ -9,6 +9,7 @@ import re
 import shutil
 import signal
 import socket
+import struct
 import subprocess
 import sys
 import time
@@ -613,7 +614,7 @@ class TestCase:
         for eolsFile in sorted(glob.glob(runDir+"/*_EoLS.jsn")):
             lumiSection = lsRegex.match(eolsFile).group(1)
             with open(eolsFile) as file:
-                eolsData = [int(f) for f in json.load(file)['data']]
+                eolsData = [int(f) for f in json.load(file)['data'][:5]]
             totalEvents = eolsData[0] + eolsData[3]
             if buInstance is None and totalEvents != eolsData[2]:
                 raise ValueException("Total event count from EVM "+str(eolsData[2])+" does not match "+str(totalEvents)+" in "+eolsFile)
@@ -628,8 +629,11 @@ class TestCase:
                 runFileCounter += fileCounter
                 for jsonFile in jsonFiles:
                     with open(jsonFile) as file:
-                        jsonData = [int(f) for f in json.load(file)['data']]
+                        jsonContent = json.load(file)
+                    jsonData = [int(f) for f in jsonContent['data']]
                     eventCounter += jsonData[0]
+                    if 'index' in jsonContent:
+                        self.checkEventIndex(jsonContent['index'],jsonData[0])
                     if eventSize:
                         rawFile = jsonFile.replace('.jsn','.raw')
                         try:
@@ -672,6 +676,21 @@ class TestCase:
         shutil.rmtree(runDir)
 
 
+    def checkEventIndex(self,indexFile,nbEvents):
+        try:
+            with open(indexFile,'rb') as file:
+                (magic,version,run,lumi,nbIndexedEvents,nbFeds) = struct.unpack('<6I',file.read(24))
+        except IOError:
+            raise FileException(indexFile+" does not exist")
+        if magic != 0x58427645:
+            raise FileException(indexFile+" is not a valid event index file")
+        if nbIndexedEvents != nbEvents:
+            raise ValueException("expected "+str(nbEvents)+" events, but found "+str(nbIndexedEvents)+" events in index file "+indexFile)
+        expectedSize = 24 + 24*nbIndexedEvents + 12*nbFeds
+        if os.path.getsize(indexFile) != expectedSize:
+            raise ValueException("expected a size of "+str(expectedSize)+" Bytes for index file "+indexFile)
+
+
     def getDataPoint(self):
         """
         retrieves super fragment size from the EVM and RUs,
@@ -700,6 +719,18 @@ class TestCase:
         return int(size*rate/1000000)
 
 
+    def printStageThroughputs(self,dataPoints):
+        """
+        prints the average event rate and throughput of each EvB application
+        """
+        if not dataPoints:
+            return
+        for app in sorted(dataPoints[0]['rates'].keys()):
+            rate = sum(x['rates'][app] for x in dataPoints)/float(len(dataPoints))
+            size = sum(x['sizes'].get(app,0) for x in dataPoints)/float(len(dataPoints))
+            print("%-8s %10.0f events/s %8.3f GB/s" % (app,rate,rate*size/1e9))
+
+
     def calculateFedSize(self,fedId,fragSize,fragSizeRMS):
         if fedId == self._config.evmFedId:
             return 1024,0
@@ -791,6 +822,7 @@ class TestCase:
                     self._origStdout.flush()
                 else:
                     print("%dB:%dMB/s" % (fragSize,self.getThroughputMB(dataPoints)))
+                self.printStageThroughputs(dataPoints)
                 if args['long']:
                     time.sleep(60)
                 return dataPoints
@@ -9,7 +9,7 @@ from Configuration import Configuration
 from TestRunner import TestRunner,Tee,BadConfig
 from SymbolMap import SymbolMap
 from TestCase import TestCase
-from Context import Context,RU,BU,RUBU, resetInstanceNumbers
+from Context import Context,RU,BU,RUBU,Loopback, resetInstanceNumbers
 
 
 class RunBenchmarks(TestRunner):
@@ -17,6 +17,7 @@ class RunBenchmarks(TestRunner):
     def __init__(self):
         TestRunner.__init__(self)
         self._symbolMap = None
+        self._nBuilders = None
 
     def addOptions(self,parser):
         TestRunner.addOptions(self,parser)
@@ -26,6 +27,8 @@ class RunBenchmarks(TestRunner):
         parser.add_argument("--nRUs",default=1,type=int,help="number of RUs, excl. EVM [default: %(default)s]")
         parser.add_argument("--nBUs",default=1,type=int,help="number of BUs [default: %(default)s]")
         parser.add_argument("--nRUBUs",default=0,type=int,help="number of RUBUs, excl. EVM [default: %(default)s]")
+        parser.add_argument("--nBuilders",default=(5,),nargs="+",type=int,help="number of builder threads on each BU to scan [default: %(default)s]")
+        parser.add_argument("--loopback",action='store_true',help="run all applications in a single XDAQ process on the RU0 host [default: %(default)s]")
         parser.add_argument("--outputDisk",help="full path to output directory. If not specified, the data is dropped on the BU")
         try:
             symbolMapfile = self._evbTesterHome + '/cases/' + os.environ["EVB_SYMBOL_MAP"]
@@ -60,10 +63,21 @@ class RunBenchmarks(TestRunner):
 
 
     def getBenchmarkName(self):
-        return "benchmark_"+str(self.args['nRUs'])+"x"+str(self.args['nBUs'])+"x"+str(self.args['nRUBUs'])
+        name = "benchmark_"+str(self.args['nRUs'])+"x"+str(self.args['nBUs'])+"x"+str(self.args['nRUBUs'])
+        if self.args['loopback']:
+            name += "_loopback"
+        if self._nBuilders is not None and len(self.args['nBuilders']) > 1:
+            name += "_"+str(self._nBuilders)+"builders"
+        return name
 
     def doIt(self):
         self.createSymbolMap()
+        for nBuilders in self.args['nBuilders']:
+            self._nBuilders = nBuilders
+            self.doBenchmark()
+
+
+    def doBenchmark(self):
         benchmark = self.getBenchmarkName()
 
         logFile = open(self.args['outputDir']+"/"+benchmark+".txt",'w',0)
@@ -127,7 +141,7 @@ class RunBenchmarks(TestRunner):
             ('maxEvtsUnderConstruction','unsignedInt','320'),
             ('eventsPerRequest','unsignedInt','8'),
             ('superFragmentFIFOCapacity','unsignedInt','12800'),
-            ('numberOfBuilders','unsignedInt','5')
+            ('numberOfBuilders','unsignedInt',str(self._nBuilders or self.args['nBuilders'][0]))
             ]
         if self.args['outputDisk']:
             buConfig.append( ('dropEventData','boolean','false') )
@@ -139,6 +153,9 @@ class RunBenchmarks(TestRunner):
         else:
             buConfig.append( ('dropEventData','boolean','true') )
 
+        if self.args['loopback']:
+            return self.getLoopbackConfiguration(evmConfig,ruConfig,buConfig)
+
         config = Configuration(self._symbolMap,self.args['numa'])
         # EVM
         if self.args['foldedEVM']:
@@ -164,6 +181,25 @@ class RunBenchmarks(TestRunner):
         return config
 
 
+    def getLoopbackConfiguration(self,evmConfig,ruConfig,buConfig):
+        """All applications run in one XDAQ process. RUBUs become a RU and a BU in this process."""
+        loopback = Loopback(self._symbolMap)
+        loopback.addRU(evmConfig)
+        if self.args['foldedEVM']:
+            loopback.addBU(buConfig)
+        for ru in range(self.args['nRUs']):
+            loopback.addRU(ruConfig + [('fedSourceIds','unsignedInt',range(8*ru,8*ru+8)),])
+        for bu in range(self.args['nBUs']):
+            loopback.addBU(buConfig)
+        for rubu in range(self.args['nRUBUs']):
+            loopback.addRU(ruConfig + [('fedSourceIds','unsignedInt',range(8*rubu+1100,8*rubu+1108)),])
+            loopback.addBU(buConfig)
+
+        config = Configuration(self._symbolMap,False)
+        config.add(loopback)
+        return config
+
+
     def runBenchmark(self,benchmark,stdout):
         config = self.getConfiguration()
         testCase = TestCase(config,stdout)
@@ -110,7 +110,7 @@ class xdaqLauncher:
 
     def cleanTempFiles(self):
         try:
-            for file in glob.glob("/tmp/dump_*txt"):
+            for file in glob.glob("/tmp/dump_*dump"):
                 os.remove(file)
             shutil.rmtree("/tmp/evb_test")
         except OSError: